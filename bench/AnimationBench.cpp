@@ -0,0 +1,74 @@
+#include "Bench.hpp"
+#include "SyntheticGlb.hpp"
+#include "GlbParser/AnimationRuntime.hpp"
+#include <cmath>
+
+namespace Bench
+{
+    // a crowd of instances, each playing one of the clips forward at its own offset, one frame per run
+    struct AnimationCrowd
+    {
+        std::vector<Glb::AnimationClip> clips;
+        std::vector<std::vector<Glb::LocalTransform>> poses;
+        std::vector<Glb::ClipCursor> cursors;
+        size_t frame;
+
+        std::vector<Glb::ClipEvaluation> NextFrame()
+        {
+            std::vector<Glb::ClipEvaluation> evaluations;
+            for (size_t i = 0; i < poses.size(); i++)
+            {
+                const Glb::AnimationClip &clip = clips[i % clips.size()];
+                float time = std::fmod((frame + i * 7) / 60.0f, clip.duration);
+                evaluations.push_back({&clip, time, &cursors[i], poses[i].data(), poses[i].size()});
+            }
+            frame++;
+            return (evaluations);
+        }
+    };
+
+    std::vector<BenchResult> RunAnimationCase(const BenchOptions &options)
+    {
+        SyntheticGlbOptions glbOptions;
+        glbOptions.nbVertex = 100;
+        glbOptions.nbNode = 128;
+        glbOptions.nbAnimation = 4;
+        glbOptions.nbKeyframe = 600;
+        std::string glb = GenerateSyntheticGlb(glbOptions);
+        Glb::GltfData data = Glb::LoadGltf(Glb::ParseGlbView(glb));
+
+        AnimationCrowd crowd;
+        for (const Glb::Animation &animation: data.animations)
+            crowd.clips.push_back(Glb::BuildAnimationClip(animation));
+        size_t nbInstance = options.quick ? 64 : 512;
+        crowd.poses.assign(nbInstance, Glb::GetRestPose(data.nodes));
+        crowd.cursors.resize(nbInstance);
+        crowd.frame = 0;
+
+        // every channel is sampled each frame
+        size_t nbChannel = 0;
+        for (size_t i = 0; i < nbInstance; i++)
+            nbChannel += crowd.clips[i % crowd.clips.size()].channels.size();
+
+        Glb::AnimationEvaluator slerp(Glb::RotationBlend::SLERP);
+        Glb::AnimationEvaluator nlerp(Glb::RotationBlend::NLERP);
+        std::vector<BenchResult> results;
+        results.push_back(MeasureCase("animation", "SLERP", "channels", nbChannel, options, [&]()
+        {
+            slerp.Evaluate(crowd.NextFrame());
+        }));
+        results.push_back(MeasureCase("animation", "NLERP", "channels", nbChannel, options, [&]()
+        {
+            nlerp.Evaluate(crowd.NextFrame());
+        }));
+        if (options.nbThread > 0)
+        {
+            Glb::ThreadPool pool(options.nbThread);
+            results.push_back(MeasureCase("animation", "SLERP_POOL_" + std::to_string(options.nbThread), "channels", nbChannel, options, [&]()
+            {
+                slerp.Evaluate(crowd.NextFrame(), pool);
+            }));
+        }
+        return (results);
+    }
+}
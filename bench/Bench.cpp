@@ -0,0 +1,81 @@
+#include "Bench.hpp"
+#include <chrono>
+#include <cstdio>
+
+namespace Bench
+{
+    std::vector<CorpusEntry> BuildCorpus(bool quick)
+    {
+        size_t scale = quick ? 10 : 1;
+        std::vector<CorpusEntry> corpus;
+
+        CorpusEntry meshes;
+        meshes.name = "meshes-interleaved";
+        meshes.options.nbMesh = 64;
+        meshes.options.nbVertex = 20000 / scale;
+        meshes.options.nbNode = 64;
+        corpus.push_back(meshes);
+        meshes.name = "meshes-packed";
+        meshes.options.interleaved = false;
+        corpus.push_back(meshes);
+
+        CorpusEntry bigMesh;
+        bigMesh.name = "big-mesh-interleaved";
+        bigMesh.options.nbVertex = 2000000 / scale; // 32 bits indices
+        corpus.push_back(bigMesh);
+        bigMesh.name = "big-mesh-packed";
+        bigMesh.options.interleaved = false;
+        corpus.push_back(bigMesh);
+
+        CorpusEntry nodes;
+        nodes.name = "nodes";
+        nodes.options.nbMesh = 16;
+        nodes.options.nbVertex = 500;
+        nodes.options.nbNode = 50000 / scale;
+        corpus.push_back(nodes);
+
+        CorpusEntry skinned;
+        skinned.name = "skinned";
+        skinned.options.nbMesh = 4;
+        skinned.options.nbVertex = 100000 / scale;
+        skinned.options.nbNode = 128;
+        skinned.options.nbJoint = 128;
+        corpus.push_back(skinned);
+
+        CorpusEntry animations;
+        animations.name = "animations";
+        animations.options.nbVertex = 1000;
+        animations.options.nbNode = 128;
+        animations.options.nbAnimation = 4;
+        animations.options.nbKeyframe = 5000 / scale;
+        corpus.push_back(animations);
+
+        return (corpus);
+    }
+
+    BenchResult MeasureCase(const std::string &file, const std::string &stage, const std::string &unit, size_t amount, const BenchOptions &options, const std::function<void()> &function)
+    {
+        function();
+
+        BenchResult result;
+        result.file = file;
+        result.stage = stage;
+        result.unit = unit;
+        for (size_t i = 0; i < options.iterations; i++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            function();
+            result.stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            result.stats.count++;
+            result.stats.bytes += amount;
+        }
+        PrintCaseResult(result, options.iterations);
+        return (result);
+    }
+
+    void PrintCaseResult(const BenchResult &result, size_t iterations)
+    {
+        std::string rate = (result.unit == "MB" ? "MB" : "M " + result.unit) + "/s";
+        printf("    %-24s %10.3f ms %10.1f %s\n", result.stage.c_str(), result.stats.seconds / iterations * 1e3, result.stats.MegabytesPerSecond(), rate.c_str());
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include "GlbParser/LoadStats.hpp"
+#include "SyntheticGlb.hpp"
+
+namespace Bench
+{
+    struct BenchOptions
+    {
+        std::string corpus; // directory of the generated files
+        size_t iterations;
+        size_t nbThread; // 0 loads on the calling thread
+        bool dom; // LoadJson and the Json::Node LoadGltf instead of the streaming reader
+        bool quick; // a tenth of the data, for a smoke run
+        std::string only; // runs the files and cases whose name contains it
+        std::string traceDirectory; // one Chrome trace per file when set
+        std::string csv;
+        std::string baseline; // csv of a previous run, slower stages fail the run
+        double tolerance; // relative throughput drop allowed against the baseline
+
+        BenchOptions()
+        {
+            corpus = "bench_corpus";
+            iterations = 5;
+            nbThread = 0;
+            dom = false;
+            quick = false;
+            tolerance = 0.1;
+        }
+    };
+
+    // throughput of one stage of a file, of its whole load with the "TOTAL" stage, or of a case.
+    // stats.bytes counts units, bytes for "MB", so stats.MegabytesPerSecond() is millions of units per second
+    struct BenchResult
+    {
+        std::string file;
+        std::string stage;
+        std::string unit;
+        Glb::StageStats stats;
+
+        BenchResult()
+        {
+            unit = "MB";
+        }
+    };
+
+    // a generated file of the corpus, the same options always give the same bytes
+    struct CorpusEntry
+    {
+        std::string name;
+        SyntheticGlbOptions options;
+    };
+
+    std::vector<CorpusEntry> BuildCorpus(bool quick); // quick divides the sizes by 10
+
+    // runs function once to warm up, then options.iterations times; amount is the units one run goes through
+    BenchResult MeasureCase(const std::string &file, const std::string &stage, const std::string &unit, size_t amount, const BenchOptions &options, const std::function<void()> &function);
+    void PrintCaseResult(const BenchResult &result, size_t iterations);
+
+    // the cases besides the corpus loads, each returns its results already printed
+    std::vector<BenchResult> RunKernelCase(const BenchOptions &options);
+    std::vector<BenchResult> RunCacheCase(const BenchOptions &options);
+    std::vector<BenchResult> RunThreadCase(const BenchOptions &options);
+    std::vector<BenchResult> RunWriteCase(const BenchOptions &options);
+    std::vector<BenchResult> RunAnimationCase(const BenchOptions &options);
+    std::vector<BenchResult> RunSceneGraphCase(const BenchOptions &options);
+    std::vector<BenchResult> RunSkinningCase(const BenchOptions &options);
+    std::vector<BenchResult> RunBvhCase(const BenchOptions &options);
+    std::vector<BenchResult> RunQuantizationCase(const BenchOptions &options);
+    std::vector<BenchResult> RunOptimizerCase(const BenchOptions &options);
+    std::vector<BenchResult> RunMeshoptCase(const BenchOptions &options);
+}
@@ -0,0 +1,148 @@
+#include "Bench.hpp"
+#include "SyntheticGlb.hpp"
+#include "GlbParser/SceneBvh.hpp"
+#include <cmath>
+
+namespace Bench
+{
+    // column major perspective view projection of a camera at eye turned by yaw around Y, 60 degrees wide
+    static Glb::Frustum GetFrustum(const float *eye, float yaw)
+    {
+        float f = 1.0f / std::tan(0.5236f);
+        float zNear = 0.1f;
+        float zFar = 100.0f;
+        float viewRows[3][3] = {{std::cos(yaw), 0, std::sin(yaw)}, {0, 1, 0}, {-std::sin(yaw), 0, std::cos(yaw)}};
+        float scales[3] = {f, f, (zFar + zNear) / (zNear - zFar)};
+
+        float viewProjection[16] = {};
+        for (int r = 0; r < 3; r++)
+        {
+            float translation = -(viewRows[r][0] * eye[0] + viewRows[r][1] * eye[1] + viewRows[r][2] * eye[2]);
+            for (int c = 0; c < 3; c++)
+                viewProjection[c * 4 + r] = scales[r] * viewRows[r][c];
+            viewProjection[12 + r] = scales[r] * translation;
+            if (r == 2)
+            {
+                // w is minus the view space z
+                for (int c = 0; c < 3; c++)
+                    viewProjection[c * 4 + 3] = -viewRows[2][c];
+                viewProjection[15] = -translation;
+                viewProjection[14] += 2 * zFar * zNear / (zNear - zFar);
+            }
+        }
+        return (Glb::ExtractFrustum(viewProjection));
+    }
+
+    // SceneBvh over the primitives of a 20k nodes scene: building it with and without the triangle Bvhs, refitting
+    // it, culling frustums turning around the center of the scene (in items culled per second, frustums times items),
+    // and rays from around it to random points of it
+    std::vector<BenchResult> RunBvhCase(const BenchOptions &options)
+    {
+        SyntheticGlbOptions glbOptions;
+        glbOptions.nbMesh = 16;
+        glbOptions.nbVertex = 256;
+        glbOptions.nbNode = options.quick ? 2000 : 20000;
+        std::string glb = GenerateSyntheticGlb(glbOptions);
+        Glb::GltfData data = Glb::LoadGltf(Glb::ParseGlbView(glb));
+
+        Glb::SceneGraph graph(data);
+        graph.UpdateWorldTransforms();
+        Glb::SceneBvhOptions triangleOptions;
+        triangleOptions.triangles = true;
+        Glb::SceneBvh bvh(data, graph);
+        Glb::SceneBvh triangleBvh(data, graph, triangleOptions);
+        size_t nbItem = bvh.GetNbItem();
+
+        const Glb::Bounds &sceneBounds = bvh.GetBvh().GetNodes()[0].bounds;
+        float center[3];
+        float extent[3];
+        for (int i = 0; i < 3; i++)
+        {
+            center[i] = (sceneBounds.min[i] + sceneBounds.max[i]) / 2;
+            extent[i] = sceneBounds.max[i] - sceneBounds.min[i];
+        }
+
+        size_t nbFrustum = 64;
+        std::vector<Glb::Frustum> frustums;
+        for (size_t i = 0; i < nbFrustum; i++)
+            frustums.push_back(GetFrustum(center, 6.2832f * i / nbFrustum));
+
+        // from outside the scene bounds toward a point inside them, a fixed seed so every run casts the same rays
+        size_t nbRay = options.quick ? 1000 : 10000;
+        std::vector<Glb::Ray> rays(nbRay);
+        uint32_t seed = 1;
+        auto random = [&]()
+        {
+            seed = seed * 1664525 + 1013904223;
+            return ((seed >> 8) / 16777216.0f);
+        };
+        for (Glb::Ray &ray: rays)
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                float target = sceneBounds.min[i] + random() * extent[i];
+                ray.origin[i] = center[i] + (random() - 0.5f) * 2 * extent[i];
+                ray.direction[i] = target - ray.origin[i];
+            }
+        }
+
+        std::vector<BenchResult> results;
+        results.push_back(MeasureCase("bvh", "BUILD", "items", nbItem, options, [&]()
+        {
+            Glb::SceneBvh built(data, graph);
+        }));
+        results.push_back(MeasureCase("bvh", "BUILD_TRIANGLES", "items", nbItem, options, [&]()
+        {
+            Glb::SceneBvh built(data, graph, triangleOptions);
+        }));
+        results.push_back(MeasureCase("bvh", "REFIT", "items", nbItem, options, [&]()
+        {
+            bvh.Refit(graph);
+        }));
+
+        size_t nbVisible = 0;
+        std::vector<uint32_t> visible;
+        results.push_back(MeasureCase("bvh", "CULL_FRUSTUM", "items", nbFrustum * nbItem, options, [&]()
+        {
+            nbVisible = 0;
+            for (const Glb::Frustum &frustum: frustums)
+            {
+                bvh.CullFrustum(frustum, visible);
+                nbVisible += visible.size();
+            }
+        }));
+
+        size_t nbHit = 0;
+        results.push_back(MeasureCase("bvh", "CAST_RAY", "rays", nbRay, options, [&]()
+        {
+            nbHit = 0;
+            for (const Glb::Ray &ray: rays)
+                nbHit += bvh.CastRay(ray).item != -1;
+        }));
+        size_t nbTriangleHit = 0;
+        results.push_back(MeasureCase("bvh", "CAST_RAY_TRIANGLES", "rays", nbRay, options, [&]()
+        {
+            nbTriangleHit = 0;
+            for (const Glb::Ray &ray: rays)
+                nbTriangleHit += triangleBvh.CastRay(ray).item != -1;
+        }));
+
+        if (options.nbThread > 0)
+        {
+            Glb::ThreadPool pool(options.nbThread);
+            std::vector<std::vector<uint32_t>> visibles;
+            results.push_back(MeasureCase("bvh", "CULL_FRUSTUMS_POOL_" + std::to_string(options.nbThread), "items", nbFrustum * nbItem, options, [&]()
+            {
+                bvh.CullFrustums(frustums, visibles, pool);
+            }));
+            std::vector<Glb::RayHit> hits;
+            results.push_back(MeasureCase("bvh", "CAST_RAYS_POOL_" + std::to_string(options.nbThread), "rays", nbRay, options, [&]()
+            {
+                triangleBvh.CastRays(rays, hits, pool);
+            }));
+        }
+        printf("    %zu items, %zu visible per frustum, %zu of %zu rays hit a box and %zu a triangle\n",
+            nbItem, nbVisible / nbFrustum, nbHit, nbRay, nbTriangleHit);
+        return (results);
+    }
+}
@@ -0,0 +1,52 @@
+#include "Bench.hpp"
+#include "SyntheticGlb.hpp"
+#include "GlbParser/Cache.hpp"
+#include <filesystem>
+
+namespace Bench
+{
+    // a cold start parsing the .glb against a warm start from its .glbc, both from the files in the corpus
+    // directory. The warm start is counted in bytes of the .glb too, so the two rates compare
+    std::vector<BenchResult> RunCacheCase(const BenchOptions &options)
+    {
+        size_t scale = options.quick ? 10 : 1;
+        SyntheticGlbOptions glbOptions;
+        glbOptions.nbMesh = 64;
+        glbOptions.nbVertex = 20000 / scale;
+        glbOptions.nbNode = 256;
+        glbOptions.nbJoint = 64;
+        glbOptions.nbAnimation = 2;
+        glbOptions.nbKeyframe = 2000 / scale;
+        std::string path = options.corpus + "/cache.glb";
+        std::string cachePath = options.corpus + "/cache.glbc";
+        size_t size = WriteSyntheticGlb(glbOptions, path);
+
+        uint64_t hash = Glb::HashFile(path);
+        std::vector<BenchResult> results;
+        results.push_back(MeasureCase("cache", "COLD_GLB", "MB", size, options, [&]()
+        {
+            Glb::MappedGlb glb(path);
+            Glb::LoadGltf(glb.GetView());
+        }));
+        {
+            Glb::MappedGlb glb(path);
+            Glb::GltfData data = Glb::LoadGltf(glb.GetView());
+            results.push_back(MeasureCase("cache", "SAVE_CACHE", "MB", size, options, [&]()
+            {
+                Glb::SaveCache(data, cachePath, hash);
+            }));
+        }
+        results.push_back(MeasureCase("cache", "HASH_SOURCE", "MB", size, options, [&]()
+        {
+            Glb::HashFile(path);
+        }));
+        results.push_back(MeasureCase("cache", "WARM_CACHE", "MB", size, options, [&]()
+        {
+            Glb::LoadCache(cachePath, hash);
+        }));
+
+        printf("    cache file %.1f MB for %.1f MB of glb, warm start x%.2f faster (x%.2f with the hash)\n", std::filesystem::file_size(cachePath) / 1e6, size / 1e6,
+            results[0].stats.seconds / results[3].stats.seconds, results[0].stats.seconds / (results[2].stats.seconds + results[3].stats.seconds));
+        return (results);
+    }
+}
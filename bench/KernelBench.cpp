@@ -0,0 +1,90 @@
+#include "Bench.hpp"
+#include "GlbParser/GlbParser.hpp"
+#include "GlbParser/VertexKernels.hpp"
+#include <cstring>
+
+namespace Bench
+{
+    // keeps the outputs of the scalar loops alive
+    static volatile uint32_t sink;
+
+    static void InterleaveFloatsScalar(const unsigned char *src, size_t srcStride, size_t nbFloat, float *dst, size_t dstStride, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            const float *in = reinterpret_cast<const float*>(src + i * srcStride);
+            float *out = reinterpret_cast<float*>(reinterpret_cast<unsigned char*>(dst) + i * dstStride);
+            for (size_t j = 0; j < nbFloat; j++)
+                out[j] = in[j];
+        }
+    }
+
+    static void InterleaveJointsU8Scalar(const unsigned char *src, size_t srcStride, uint16_t *dst, size_t dstStride, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            uint16_t *out = reinterpret_cast<uint16_t*>(reinterpret_cast<unsigned char*>(dst) + i * dstStride);
+            for (size_t j = 0; j < 4; j++)
+                out[j] = src[i * srcStride + j];
+        }
+    }
+
+    static void WidenU16ToU32Scalar(const uint16_t *src, uint32_t *dst, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            dst[i] = src[i];
+    }
+
+    // the kernels the decoders use against the plain loops they replaced, on the same data,
+    // the loops as the compiler makes them (it may vectorize them too)
+    std::vector<BenchResult> RunKernelCase(const BenchOptions &options)
+    {
+        size_t count = options.quick ? 200000 : 2000000;
+        size_t stride = sizeof(Glb::Vertex);
+        std::vector<float> positions(count * 3);
+        std::vector<uint8_t> joints(count * 4);
+        std::vector<uint16_t> shortIndices(count * 3);
+        for (size_t i = 0; i < positions.size(); i++)
+            positions[i] = i * 0.5f;
+        for (size_t i = 0; i < joints.size(); i++)
+            joints[i] = i % 251;
+        for (size_t i = 0; i < shortIndices.size(); i++)
+            shortIndices[i] = i % 65521;
+
+        std::vector<Glb::Vertex> vertices(count);
+        std::vector<uint32_t> indices(shortIndices.size());
+        const unsigned char *positionBytes = reinterpret_cast<const unsigned char*>(positions.data());
+        std::string kernels = Glb::Kernels::GetName();
+        printf("    kernels: %s\n", kernels.c_str());
+
+        std::vector<BenchResult> results;
+        results.push_back(MeasureCase("kernels", "INTERLEAVE_VEC3", "MB", count * 12, options, [&]()
+        {
+            Glb::Kernels::InterleaveFloats(positionBytes, 12, 3, &vertices[0].x, stride, count);
+        }));
+        results.push_back(MeasureCase("kernels", "INTERLEAVE_VEC3_SCALAR", "MB", count * 12, options, [&]()
+        {
+            InterleaveFloatsScalar(positionBytes, 12, 3, &vertices[0].x, stride, count);
+            sink = sink + vertices[count / 2].x;
+        }));
+        results.push_back(MeasureCase("kernels", "JOINTS_U8", "MB", count * 8, options, [&]()
+        {
+            Glb::Kernels::InterleaveJointsU8(joints.data(), 4, &vertices[0].j1, stride, count);
+        }));
+        results.push_back(MeasureCase("kernels", "JOINTS_U8_SCALAR", "MB", count * 8, options, [&]()
+        {
+            InterleaveJointsU8Scalar(joints.data(), 4, &vertices[0].j1, stride, count);
+            sink = sink + vertices[count / 2].j1;
+        }));
+        results.push_back(MeasureCase("kernels", "WIDEN_U16_U32", "MB", indices.size() * 4, options, [&]()
+        {
+            Glb::Kernels::WidenU16ToU32(shortIndices.data(), indices.data(), indices.size());
+        }));
+        results.push_back(MeasureCase("kernels", "WIDEN_U16_U32_SCALAR", "MB", indices.size() * 4, options, [&]()
+        {
+            WidenU16ToU32Scalar(shortIndices.data(), indices.data(), indices.size());
+            sink = sink + indices[indices.size() / 2];
+        }));
+        return (results);
+    }
+}
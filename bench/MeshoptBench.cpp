@@ -0,0 +1,67 @@
+#include "Bench.hpp"
+#include "SyntheticGlb.hpp"
+#include "GlbParser/GlbParser.hpp"
+#include <cstdio>
+
+namespace Bench
+{
+    static void LoadFile(const std::string &path)
+    {
+        Glb::MappedGlb glb(path);
+        Glb::LoadGltf(glb.GetView());
+    }
+
+    // the same meshes stored as is and with EXT_meshopt_compression, both loaded in full in vertices per second.
+    // the load stats give the share of the compressed load spent in the meshopt decoders
+    std::vector<BenchResult> RunMeshoptCase(const BenchOptions &options)
+    {
+        size_t scale = options.quick ? 10 : 1;
+        SyntheticGlbOptions glbOptions;
+        glbOptions.nbMesh = 64;
+        glbOptions.nbVertex = 20000 / scale;
+        glbOptions.nbNode = 64;
+        std::string plainPath = options.corpus + "/meshopt-plain.glb";
+        std::string compressedPath = options.corpus + "/meshopt-compressed.glb";
+        size_t plainSize = WriteSyntheticGlb(glbOptions, plainPath);
+        glbOptions.meshopt = true;
+        size_t compressedSize = WriteSyntheticGlb(glbOptions, compressedPath);
+
+        size_t nbVertex = 0;
+        {
+            Glb::MappedGlb glb(plainPath);
+            for (const Glb::Mesh &mesh: Glb::LoadGltf(glb.GetView()).meshes)
+            {
+                for (const Glb::Primitive &primitive: mesh.primitives)
+                    nbVertex += primitive.vertices.size();
+            }
+        }
+
+        std::vector<BenchResult> results;
+        results.push_back(MeasureCase("meshopt", "LOAD_PLAIN", "vertices", nbVertex, options, [&]()
+        {
+            LoadFile(plainPath);
+        }));
+
+        Glb::LoadStats stats;
+        Glb::SetLoadStats(&stats);
+        results.push_back(MeasureCase("meshopt", "LOAD_COMPRESSED", "vertices", nbVertex, options, [&]()
+        {
+            LoadFile(compressedPath);
+        }));
+        Glb::SetLoadStats(NULL);
+
+        // MeasureCase runs once more to warm up, the stats saw that run too
+        BenchResult decode;
+        decode.file = "meshopt";
+        decode.stage = Glb::ToString(Glb::LoadStage::MESHOPT_DECODE);
+        decode.stats = stats.Get(Glb::LoadStage::MESHOPT_DECODE);
+        PrintCaseResult(decode, options.iterations + 1);
+        results.push_back(decode);
+
+        double compressedSeconds = results[1].stats.seconds / options.iterations;
+        printf("    %.1f MB as is, %.1f MB compressed (%.0f%% smaller), the compressed load is x%.2f the plain one and %.0f%% of it is decoding\n",
+            plainSize / 1e6, compressedSize / 1e6, 100.0 * (plainSize - compressedSize) / plainSize, compressedSeconds / (results[0].stats.seconds / options.iterations),
+            100.0 * decode.stats.seconds / (options.iterations + 1) / compressedSeconds);
+        return (results);
+    }
+}
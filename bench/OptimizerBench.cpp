@@ -0,0 +1,77 @@
+#include "Bench.hpp"
+#include "GlbParser/MeshOptimizer.hpp"
+#include <cmath>
+
+namespace Bench
+{
+    // heightfield with hills hiding each other from the side views, its triangles in a random order
+    static Glb::Primitive MakeTerrain(uint32_t size)
+    {
+        Glb::Primitive primitive;
+        for (uint32_t y = 0; y < size; y++)
+        {
+            for (uint32_t x = 0; x < size; x++)
+            {
+                Glb::Vertex vertex = Glb::Vertex();
+                vertex.x = x;
+                vertex.y = (std::sin(x * 0.15f) + std::cos(y * 0.11f)) * size / 8;
+                vertex.z = y;
+                vertex.ny = 1;
+                vertex.w1 = 1;
+                primitive.vertices.push_back(vertex);
+            }
+        }
+
+        std::vector<uint32_t> triangles;
+        for (uint32_t y = 0; y + 1 < size; y++)
+        {
+            for (uint32_t x = 0; x + 1 < size; x++)
+                triangles.push_back(y * size + x);
+        }
+        uint32_t seed = 7;
+        for (size_t i = triangles.size() - 1; i > 0; i--)
+        {
+            seed = seed * 1664525 + 1013904223;
+            std::swap(triangles[i], triangles[(seed >> 8) % (i + 1)]);
+        }
+        std::vector<uint32_t> indices;
+        for (uint32_t i: triangles)
+            indices.insert(indices.end(), {i, i + size, i + 1, i + 1, i + size, i + size + 1});
+        primitive.indices.Assign(indices, primitive.vertices.size());
+        return (primitive);
+    }
+
+    // OptimizePrimitive on a shuffled terrain and on the row ordered grid of the generator, with the ACMR,
+    // ATVR and overdraw before and after; the time includes copying the primitive each run
+    std::vector<BenchResult> RunOptimizerCase(const BenchOptions &options)
+    {
+        SyntheticGlbOptions glbOptions;
+        glbOptions.nbVertex = options.quick ? 20000 : 200000;
+        std::string glb = GenerateSyntheticGlb(glbOptions);
+        Glb::GltfData data = Glb::LoadGltf(Glb::ParseGlbView(glb));
+
+        std::vector<std::pair<std::string, Glb::Primitive>> meshes;
+        meshes.push_back({"terrain", MakeTerrain(options.quick ? 100 : 300)});
+        meshes.push_back({"grid", data.meshes[0].primitives[0]});
+
+        std::vector<BenchResult> results;
+        for (const std::pair<std::string, Glb::Primitive> &mesh: meshes)
+        {
+            const Glb::Primitive &source = mesh.second;
+            Glb::Primitive optimized = source;
+            Glb::MeshOptimizationStats stats = Glb::OptimizePrimitive(optimized);
+            float overdrawBefore = Glb::ComputeOverdraw(source.vertices, source.indices.ToUint32());
+            float overdrawAfter = Glb::ComputeOverdraw(optimized.vertices, optimized.indices.ToUint32());
+
+            size_t nbTriangle = source.indices.Size() / 3;
+            results.push_back(MeasureCase("optimizer", "OPTIMIZE_" + mesh.first, "triangles", nbTriangle, options, [&]()
+            {
+                Glb::Primitive primitive = source;
+                Glb::OptimizePrimitive(primitive);
+            }));
+            printf("    %s: %zu triangles, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, overdraw %.3f -> %.3f\n", mesh.first.c_str(), nbTriangle,
+                stats.acmrBefore, stats.acmrAfter, stats.atvrBefore, stats.atvrAfter, overdrawBefore, overdrawAfter);
+        }
+        return (results);
+    }
+}
@@ -0,0 +1,59 @@
+#include "Bench.hpp"
+#include "GlbParser/GlbParser.hpp"
+
+namespace Bench
+{
+    // resident bytes of the primitives of every corpus file decoded into Vertex and into QuantizedVertex,
+    // vertices and indices, then the speed of both decodes in vertices per second
+    std::vector<BenchResult> RunQuantizationCase(const BenchOptions &options)
+    {
+        std::vector<BenchResult> results;
+        size_t totalVertexBytes = 0;
+        size_t totalQuantizedBytes = 0;
+        for (const CorpusEntry &entry: BuildCorpus(options.quick))
+        {
+            std::string glb = GenerateSyntheticGlb(entry.options);
+            Glb::GltfData data;
+            Glb::GltfSources sources = Glb::LoadGltfSources(Glb::ParseGlbView(glb), data);
+
+            size_t nbVertex = 0;
+            size_t vertexBytes = 0;
+            size_t quantizedBytes = 0;
+            for (const Glb::MeshSource &mesh: sources.meshes)
+            {
+                for (const Glb::PrimitiveSource &source: mesh.primitives)
+                {
+                    Glb::Primitive primitive = Glb::DecodePrimitive(source);
+                    Glb::QuantizedPrimitive quantized = Glb::DecodeQuantizedPrimitive(source);
+                    nbVertex += primitive.vertices.size();
+                    vertexBytes += primitive.vertices.size() * sizeof(Glb::Vertex) + primitive.indices.data.size();
+                    quantizedBytes += quantized.vertices.size() * sizeof(Glb::QuantizedVertex) + quantized.indices.data.size();
+                }
+            }
+            totalVertexBytes += vertexBytes;
+            totalQuantizedBytes += quantizedBytes;
+            printf("    %s: Vertex %.1f MB, QuantizedVertex %.1f MB, %.0f%% less\n", entry.name.c_str(), vertexBytes / 1e6, quantizedBytes / 1e6,
+                100.0 * (vertexBytes - quantizedBytes) / vertexBytes);
+
+            results.push_back(MeasureCase("quantization/" + entry.name, "DECODE_VERTEX", "vertices", nbVertex, options, [&]()
+            {
+                for (const Glb::MeshSource &mesh: sources.meshes)
+                {
+                    for (const Glb::PrimitiveSource &source: mesh.primitives)
+                        Glb::DecodePrimitive(source);
+                }
+            }));
+            results.push_back(MeasureCase("quantization/" + entry.name, "DECODE_QUANTIZED", "vertices", nbVertex, options, [&]()
+            {
+                for (const Glb::MeshSource &mesh: sources.meshes)
+                {
+                    for (const Glb::PrimitiveSource &source: mesh.primitives)
+                        Glb::DecodeQuantizedPrimitive(source);
+                }
+            }));
+        }
+        printf("    corpus: Vertex %.1f MB, QuantizedVertex %.1f MB, %.0f%% less (%zu and %zu bytes per vertex)\n", totalVertexBytes / 1e6,
+            totalQuantizedBytes / 1e6, 100.0 * (totalVertexBytes - totalQuantizedBytes) / totalVertexBytes, sizeof(Glb::Vertex), sizeof(Glb::QuantizedVertex));
+        return (results);
+    }
+}
@@ -0,0 +1,59 @@
+#include "Bench.hpp"
+#include "SyntheticGlb.hpp"
+#include "GlbParser/SceneGraph.hpp"
+
+namespace Bench
+{
+    // world transform updates of a 100k nodes tree (4 children per node), in world matrices computed per second
+    std::vector<BenchResult> RunSceneGraphCase(const BenchOptions &options)
+    {
+        SyntheticGlbOptions glbOptions;
+        glbOptions.nbVertex = 16;
+        glbOptions.nbNode = options.quick ? 10000 : 100000;
+        std::string glb = GenerateSyntheticGlb(glbOptions);
+        Glb::GltfData data = Glb::LoadGltf(Glb::ParseGlbView(glb));
+
+        Glb::SceneGraph graph(data);
+        size_t nbNode = graph.GetNbNode();
+        graph.UpdateWorldTransforms();
+
+        // each run moves the nodes a bit further, so every update has something to do
+        size_t frame = 0;
+        auto move = [&](size_t index)
+        {
+            Glb::LocalTransform transform = graph.GetLocalTransform(index);
+            transform.translation[0] += (frame % 2 ? 0.01f : -0.01f);
+            graph.SetLocalTransform(index, transform);
+        };
+        // one node in a hundred, spread over the tree but never the root
+        auto movePercent = [&]()
+        {
+            for (size_t i = 0; i < nbNode / 100; i++)
+                move((i + 1) * 7919 % nbNode);
+            frame++;
+            return (graph.UpdateWorldTransforms());
+        };
+        size_t nbPercentComputed = movePercent();
+
+        std::vector<BenchResult> results;
+        results.push_back(MeasureCase("scene-graph", "ROOT_MOVED", "nodes", nbNode, options, [&]()
+        {
+            move(0);
+            frame++;
+            graph.UpdateWorldTransforms();
+        }));
+        results.push_back(MeasureCase("scene-graph", "ALL_MOVED", "nodes", nbNode, options, [&]()
+        {
+            for (size_t i = 0; i < nbNode; i++)
+                move(i);
+            frame++;
+            graph.UpdateWorldTransforms();
+        }));
+        results.push_back(MeasureCase("scene-graph", "PERCENT_MOVED", "nodes", nbPercentComputed, options, [&]()
+        {
+            movePercent();
+        }));
+        printf("    %zu nodes, moving 1%% of them recomputes %zu world matrices\n", nbNode, nbPercentComputed);
+        return (results);
+    }
+}
@@ -0,0 +1,63 @@
+#include "Bench.hpp"
+#include "SyntheticGlb.hpp"
+#include "GlbParser/Skinning.hpp"
+#include "GlbParser/VertexKernels.hpp"
+
+namespace Bench
+{
+    // linear blend skinning of one big primitive with 64 joints, the SIMD kernel against its scalar reference
+    // on the same inputs, then through SkinPrimitive (which checks the joints first), in vertices per second
+    std::vector<BenchResult> RunSkinningCase(const BenchOptions &options)
+    {
+        SyntheticGlbOptions glbOptions;
+        glbOptions.nbVertex = options.quick ? 20000 : 200000;
+        glbOptions.nbNode = 64;
+        glbOptions.nbJoint = 64;
+        std::string glb = GenerateSyntheticGlb(glbOptions);
+        Glb::GltfData data = Glb::LoadGltf(Glb::ParseGlbView(glb));
+
+        Glb::SceneGraph graph(data);
+        graph.UpdateWorldTransforms();
+        const Glb::Skin &skin = data.skins[0];
+        std::vector<float> palette = Glb::BuildJointPalette(skin, graph);
+        const Glb::Primitive &primitive = data.meshes[0].primitives[0];
+        size_t nbVertex = primitive.vertices.size();
+        std::vector<float> positions(nbVertex * 3);
+        std::vector<float> normals(nbVertex * 3);
+
+        Glb::Kernels::SkinningInput input;
+        input.positions = &primitive.vertices[0].x;
+        input.normals = &primitive.vertices[0].nx;
+        input.joints = &primitive.vertices[0].j1;
+        input.weights = &primitive.vertices[0].w1;
+        input.stride = sizeof(Glb::Vertex);
+
+        std::vector<BenchResult> results;
+        results.push_back(MeasureCase("skinning", "KERNEL", "vertices", nbVertex, options, [&]()
+        {
+            Glb::Kernels::SkinVertices(palette.data(), input, positions.data(), normals.data(), 0, nbVertex);
+        }));
+        results.push_back(MeasureCase("skinning", "KERNEL_SCALAR", "vertices", nbVertex, options, [&]()
+        {
+            Glb::Kernels::SkinVerticesScalar(palette.data(), input, positions.data(), normals.data(), 0, nbVertex);
+        }));
+        results.push_back(MeasureCase("skinning", "SKIN_PRIMITIVE", "vertices", nbVertex, options, [&]()
+        {
+            Glb::SkinPrimitive(primitive, palette.data(), skin.joints.size(), positions.data(), normals.data());
+        }));
+        results.push_back(MeasureCase("skinning", "POSITIONS_ONLY", "vertices", nbVertex, options, [&]()
+        {
+            Glb::SkinPrimitive(primitive, palette.data(), skin.joints.size(), positions.data(), NULL);
+        }));
+        if (options.nbThread > 0)
+        {
+            Glb::ThreadPool pool(options.nbThread);
+            results.push_back(MeasureCase("skinning", "POOL_" + std::to_string(options.nbThread), "vertices", nbVertex, options, [&]()
+            {
+                Glb::SkinPrimitive(primitive, palette.data(), skin.joints.size(), positions.data(), normals.data(), pool);
+            }));
+        }
+        printf("    kernel x%.2f against scalar (%s)\n", results[1].stats.seconds / results[0].stats.seconds, Glb::Kernels::GetName());
+        return (results);
+    }
+}
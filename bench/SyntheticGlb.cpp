@@ -0,0 +1,741 @@
+#include "SyntheticGlb.hpp"
+#include "GlbParser/GlbView.hpp"
+#include "GlbParser/JsonWriter.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace Bench
+{
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#accessor-data-types
+    constexpr int componentUnsignedShort = 5123;
+    constexpr int componentUnsignedInt = 5125;
+    constexpr int componentFloat = 5126;
+    constexpr int targetArrayBuffer = 34962;
+    constexpr int targetElementArrayBuffer = 34963;
+
+    // xorshift32, the std distributions don't give the same numbers on every platform
+    class Random
+    {
+        private:
+            uint32_t state;
+
+        public:
+            Random(uint32_t seed) { state = seed ? seed : 1; }
+
+            uint32_t Next()
+            {
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                return (state);
+            }
+
+            float Float(float min, float max) { return (min + (max - min) * (Next() >> 8) / 16777216.0f); }
+    };
+
+    struct SyntheticBufferView
+    {
+        size_t byteOffset;
+        size_t byteLength;
+        size_t byteStride; // 0 when tightly packed
+        int target; // 0 for none
+        const char *meshoptMode; // NULL when stored as is, the view is otherwise in the fallback buffer
+        size_t compressedOffset; // in the BIN chunk
+        size_t compressedLength;
+        size_t elementSize;
+    };
+
+    // EXT_meshopt_compression encoders, only the parts of the codecs the decoder needs to read them back
+
+    static void AppendByte(std::string &out, unsigned int value)
+    {
+        out.push_back(static_cast<char>(value));
+    }
+
+    // 16 values of bits bits, most significant first, the ones with all bits set are stored in full after the group
+    static void PackByteGroup(std::string &out, const unsigned char *values, int bits)
+    {
+        const unsigned char sentinel = (1 << bits) - 1;
+        std::vector<unsigned char> packed(16 * bits / 8, 0);
+        for (size_t i = 0; i < 16; i++)
+            packed[i * bits / 8] |= std::min(values[i], sentinel) << (8 - bits - (i * bits) % 8);
+        out.append(reinterpret_cast<const char*>(packed.data()), packed.size());
+        for (size_t i = 0; i < 16; i++)
+        {
+            if (values[i] >= sentinel)
+                AppendByte(out, values[i]);
+        }
+    }
+
+    // 2 bits of header per group of 16 bytes: zeros, 2 bits, 4 bits or the 16 bytes as is, whichever is smallest
+    static void EncodeBytes(std::string &out, const unsigned char *buffer, size_t size)
+    {
+        size_t nbGroup = size / 16;
+        size_t header = out.size();
+        out.append((nbGroup + 3) / 4, '\0');
+        for (size_t group = 0; group < nbGroup; group++)
+        {
+            const unsigned char *values = buffer + group * 16;
+            bool zero = true;
+            size_t size2 = 4;
+            size_t size4 = 8;
+            for (size_t i = 0; i < 16; i++)
+            {
+                zero = zero && values[i] == 0;
+                size2 += values[i] >= 3;
+                size4 += values[i] >= 15;
+            }
+
+            int mode = zero ? 0 : size2 <= size4 && size2 <= 16 ? 1 : size4 <= 16 ? 2 : 3;
+            out[header + group / 4] = static_cast<char>(out[header + group / 4] | mode << ((group % 4) * 2));
+            if (mode == 1)
+                PackByteGroup(out, values, 2);
+            else if (mode == 2)
+                PackByteGroup(out, values, 4);
+            else if (mode == 3)
+                out.append(reinterpret_cast<const char*>(values), 16);
+        }
+    }
+
+    // ATTRIBUTES: zigzag byte deltas against the previous vertex, one row per byte of the vertex and per block
+    static std::string EncodeMeshoptVertices(const unsigned char *vertices, size_t count, size_t byteStride)
+    {
+        std::string out;
+        AppendByte(out, 0xa0);
+
+        size_t blockSize = std::min<size_t>(256, (8192 / byteStride) & ~size_t(15));
+        std::vector<unsigned char> first(byteStride, 0);
+        if (count > 0)
+            first.assign(vertices, vertices + byteStride);
+        std::vector<unsigned char> last = first;
+        std::vector<unsigned char> deltas(blockSize);
+        for (size_t offset = 0; offset < count; offset += blockSize)
+        {
+            size_t nbVertex = std::min(blockSize, count - offset);
+            for (size_t k = 0; k < byteStride; k++)
+            {
+                std::fill(deltas.begin(), deltas.end(), 0);
+                for (size_t i = 0; i < nbVertex; i++)
+                {
+                    unsigned char value = vertices[(offset + i) * byteStride + k];
+                    unsigned char delta = value - last[k];
+                    deltas[i] = static_cast<unsigned char>((delta << 1) ^ (static_cast<signed char>(delta) >> 7));
+                    last[k] = value;
+                }
+                EncodeBytes(out, deltas.data(), (nbVertex + 15) & ~size_t(15));
+            }
+        }
+
+        // the tail ends with the first vertex, the deltas start from it
+        out.append(std::max<size_t>(32, byteStride) - byteStride, '\0');
+        out.append(reinterpret_cast<const char*>(first.data()), byteStride);
+        return (out);
+    }
+
+    // INDICES: a vbyte per index, the zigzag delta against the closest of 2 baselines and the baseline in the low bit
+    static std::string EncodeMeshoptIndices(const uint32_t *indices, size_t count)
+    {
+        std::string out;
+        AppendByte(out, 0xd1);
+
+        uint32_t last[2] = {0, 0};
+        for (size_t i = 0; i < count; i++)
+        {
+            int32_t deltas[2] = {static_cast<int32_t>(indices[i] - last[0]), static_cast<int32_t>(indices[i] - last[1])};
+            uint32_t baseline = std::abs(static_cast<int64_t>(deltas[1])) < std::abs(static_cast<int64_t>(deltas[0])) ? 1 : 0;
+            int32_t delta = deltas[baseline];
+            uint32_t value = ((static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31)) << 1 | baseline;
+            last[baseline] = indices[i];
+
+            for (; value >= 128; value >>= 7)
+                AppendByte(out, (value & 127) | 128);
+            AppendByte(out, value);
+        }
+
+        out.append(4, '\0');
+        return (out);
+    }
+
+    struct SyntheticAccessor
+    {
+        size_t bufferView;
+        size_t byteOffset;
+        size_t count;
+        int componentType;
+        const char *type;
+        std::vector<float> min; // empty for none
+        std::vector<float> max;
+    };
+
+    // one mesh, attributes side by side before being laid out in the BIN chunk
+    struct SyntheticMesh
+    {
+        size_t count;
+        std::vector<float> positions;
+        std::vector<float> normals;
+        std::vector<float> uvs;
+        std::vector<uint16_t> joints;
+        std::vector<float> weights;
+        std::vector<uint32_t> indices;
+        float min[3];
+        float max[3];
+    };
+
+    class SyntheticGlbBuilder
+    {
+        private:
+            const SyntheticGlbOptions &options;
+            Random random;
+            std::string bin;
+            size_t fallbackSize; // of the buffer holding the compressed bufferViews
+            std::vector<SyntheticBufferView> bufferViews;
+            std::vector<SyntheticAccessor> accessors;
+            Glb::JsonWriter json;
+
+            size_t AddBufferView(const void *bytes, size_t size, size_t stride, int target)
+            {
+                bin.resize((bin.size() + 3) & ~size_t(3), '\0');
+                bufferViews.push_back({bin.size(), size, stride, target, NULL, 0, 0, 0});
+                bin.append(static_cast<const char*>(bytes), size);
+                return (bufferViews.size() - 1);
+            }
+
+            // the compressed bytes go in the BIN chunk, the view itself in the fallback buffer which has no data
+            size_t AddCompressedBufferView(const std::string &compressed, size_t size, size_t elementSize, size_t stride, int target, const char *mode)
+            {
+                bin.resize((bin.size() + 3) & ~size_t(3), '\0');
+                fallbackSize = (fallbackSize + 3) & ~size_t(3);
+                bufferViews.push_back({fallbackSize, size, stride, target, mode, bin.size(), compressed.size(), elementSize});
+                bin += compressed;
+                fallbackSize += size;
+                return (bufferViews.size() - 1);
+            }
+
+            size_t AddVertexBufferView(const void *bytes, size_t count, size_t elementSize, size_t stride)
+            {
+                if (!options.meshopt)
+                    return (AddBufferView(bytes, count * elementSize, stride, targetArrayBuffer));
+                std::string compressed = EncodeMeshoptVertices(static_cast<const unsigned char*>(bytes), count, elementSize);
+                return (AddCompressedBufferView(compressed, count * elementSize, elementSize, stride, targetArrayBuffer, "ATTRIBUTES"));
+            }
+
+            size_t AddIndexBufferView(const std::vector<uint32_t> &indices, size_t indexSize)
+            {
+                if (options.meshopt)
+                    return (AddCompressedBufferView(EncodeMeshoptIndices(indices.data(), indices.size()), indices.size() * indexSize, indexSize, 0, targetElementArrayBuffer, "INDICES"));
+                if (indexSize == sizeof(uint32_t))
+                    return (AddBufferView(indices.data(), indices.size() * sizeof(uint32_t), 0, targetElementArrayBuffer));
+                std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+                return (AddBufferView(shortIndices.data(), shortIndices.size() * sizeof(uint16_t), 0, targetElementArrayBuffer));
+            }
+
+            size_t AddAccessor(size_t bufferView, size_t byteOffset, size_t count, int componentType, const char *type)
+            {
+                accessors.push_back({bufferView, byteOffset, count, componentType, type, {}, {}});
+                return (accessors.size() - 1);
+            }
+
+            SyntheticMesh GenerateMesh(size_t meshIndex);
+            void WriteMesh(size_t meshIndex);
+            void WriteNodes();
+            void WriteSkin();
+            void WriteAnimation(size_t animationIndex);
+            void WriteAccessors();
+            void WriteBufferViews();
+
+        public:
+            SyntheticGlbBuilder(const SyntheticGlbOptions &options) : options(options), random(options.seed) { fallbackSize = 0; }
+
+            std::string Build();
+    };
+
+    SyntheticMesh SyntheticGlbBuilder::GenerateMesh(size_t meshIndex)
+    {
+        // a bumpy grid, width * height is the closest to nbVertex
+        size_t width = std::max<size_t>(2, std::ceil(std::sqrt(static_cast<double>(options.nbVertex))));
+        size_t height = std::max<size_t>(2, options.nbVertex / width);
+
+        SyntheticMesh mesh;
+        mesh.count = width * height;
+        mesh.positions.reserve(mesh.count * 3);
+        mesh.normals.reserve(mesh.count * 3);
+        mesh.uvs.reserve(mesh.count * 2);
+        for (size_t y = 0; y < height; y++)
+        {
+            for (size_t x = 0; x < width; x++)
+            {
+                float u = x / float(width - 1);
+                float v = y / float(height - 1);
+                mesh.positions.insert(mesh.positions.end(), {u + meshIndex, random.Float(-0.05f, 0.05f), v});
+
+                float nx = random.Float(-0.2f, 0.2f);
+                float nz = random.Float(-0.2f, 0.2f);
+                float length = std::sqrt(nx * nx + 1 + nz * nz);
+                mesh.normals.insert(mesh.normals.end(), {nx / length, 1 / length, nz / length});
+                mesh.uvs.insert(mesh.uvs.end(), {u, v});
+            }
+        }
+
+        for (size_t i = 0; i < 3; i++)
+        {
+            mesh.min[i] = mesh.positions[i];
+            mesh.max[i] = mesh.positions[i];
+        }
+        for (size_t i = 0; i < mesh.positions.size(); i++)
+        {
+            mesh.min[i % 3] = std::min(mesh.min[i % 3], mesh.positions[i]);
+            mesh.max[i % 3] = std::max(mesh.max[i % 3], mesh.positions[i]);
+        }
+
+        if (options.nbJoint > 0)
+        {
+            mesh.joints.reserve(mesh.count * 4);
+            mesh.weights.reserve(mesh.count * 4);
+            for (size_t i = 0; i < mesh.count; i++)
+            {
+                float weights[4];
+                float sum = 0;
+                for (size_t j = 0; j < 4; j++)
+                {
+                    mesh.joints.push_back(random.Next() % options.nbJoint);
+                    weights[j] = random.Float(0.01f, 1.0f);
+                    sum += weights[j];
+                }
+                for (size_t j = 0; j < 4; j++)
+                    mesh.weights.push_back(weights[j] / sum);
+            }
+        }
+
+        mesh.indices.reserve((width - 1) * (height - 1) * 6);
+        for (size_t y = 0; y + 1 < height; y++)
+        {
+            for (size_t x = 0; x + 1 < width; x++)
+            {
+                uint32_t i = y * width + x;
+                mesh.indices.insert(mesh.indices.end(), {i, uint32_t(i + width), uint32_t(i + 1), uint32_t(i + 1), uint32_t(i + width), uint32_t(i + width + 1)});
+            }
+        }
+
+        return (mesh);
+    }
+
+    void SyntheticGlbBuilder::WriteMesh(size_t meshIndex)
+    {
+        SyntheticMesh mesh = GenerateMesh(meshIndex);
+        bool skinned = options.nbJoint > 0;
+
+        // POSITION, NORMAL, TEXCOORD_0 then JOINTS_0 and WEIGHTS_0 when skinned
+        const void *streams[5] = {mesh.positions.data(), mesh.normals.data(), mesh.uvs.data(), mesh.joints.data(), mesh.weights.data()};
+        const size_t sizes[5] = {12, 12, 8, 8, 16};
+        const int componentTypes[5] = {componentFloat, componentFloat, componentFloat, componentUnsignedShort, componentFloat};
+        const char *types[5] = {"VEC3", "VEC3", "VEC2", "VEC4", "VEC4"};
+        size_t nbAttribute = skinned ? 5 : 3;
+
+        size_t attributes[5];
+        if (options.interleaved)
+        {
+            size_t stride = 0;
+            size_t offsets[5];
+            for (size_t a = 0; a < nbAttribute; a++)
+            {
+                offsets[a] = stride;
+                stride += sizes[a];
+            }
+
+            std::vector<unsigned char> vertices(mesh.count * stride);
+            for (size_t i = 0; i < mesh.count; i++)
+            {
+                for (size_t a = 0; a < nbAttribute; a++)
+                    std::memcpy(&vertices[i * stride + offsets[a]], static_cast<const unsigned char*>(streams[a]) + i * sizes[a], sizes[a]);
+            }
+            size_t bufferView = AddVertexBufferView(vertices.data(), mesh.count, stride, stride);
+            for (size_t a = 0; a < nbAttribute; a++)
+                attributes[a] = AddAccessor(bufferView, offsets[a], mesh.count, componentTypes[a], types[a]);
+        }
+        else
+        {
+            for (size_t a = 0; a < nbAttribute; a++)
+                attributes[a] = AddAccessor(AddVertexBufferView(streams[a], mesh.count, sizes[a], 0), 0, mesh.count, componentTypes[a], types[a]);
+        }
+        accessors[attributes[0]].min.assign(mesh.min, mesh.min + 3);
+        accessors[attributes[0]].max.assign(mesh.max, mesh.max + 3);
+
+        bool shortIndices = mesh.count <= 0xFFFF;
+        size_t indexBufferView = AddIndexBufferView(mesh.indices, shortIndices ? sizeof(uint16_t) : sizeof(uint32_t));
+        size_t indices = AddAccessor(indexBufferView, 0, mesh.indices.size(), shortIndices ? componentUnsignedShort : componentUnsignedInt, "SCALAR");
+
+        static const char *names[5] = {"POSITION", "NORMAL", "TEXCOORD_0", "JOINTS_0", "WEIGHTS_0"};
+        json.BeginObject();
+        json.Key("name");
+        json.String("mesh" + std::to_string(meshIndex));
+        json.Key("primitives");
+        json.BeginArray();
+        json.BeginObject();
+        json.Key("attributes");
+        json.BeginObject();
+        for (size_t a = 0; a < nbAttribute; a++)
+        {
+            json.Key(names[a]);
+            json.Size(attributes[a]);
+        }
+        json.EndObject();
+        json.Key("indices");
+        json.Size(indices);
+        json.Key("material");
+        json.Int(0);
+        json.EndObject();
+        json.EndArray();
+        json.EndObject();
+    }
+
+    void SyntheticGlbBuilder::WriteNodes()
+    {
+        for (size_t i = 0; i < options.nbNode; i++)
+        {
+            json.BeginObject();
+            json.Key("name");
+            json.String("node" + std::to_string(i));
+
+            if (4 * i + 1 < options.nbNode)
+            {
+                json.Key("children");
+                json.BeginArray();
+                for (size_t child = 4 * i + 1; child <= 4 * i + 4 && child < options.nbNode; child++)
+                    json.Size(child);
+                json.EndArray();
+            }
+
+            float translation[3] = {random.Float(-1, 1), random.Float(-1, 1), random.Float(-1, 1)};
+            json.Key("translation");
+            json.Floats(translation, 3);
+
+            if (options.nbMesh > 0)
+            {
+                json.Key("mesh");
+                json.Size(i % options.nbMesh);
+                if (options.nbJoint > 0)
+                {
+                    json.Key("skin");
+                    json.Int(0);
+                }
+            }
+            json.EndObject();
+        }
+    }
+
+    void SyntheticGlbBuilder::WriteSkin()
+    {
+        std::vector<float> inverseBindMatrices(options.nbJoint * 16, 0.0f);
+        for (size_t i = 0; i < options.nbJoint; i++)
+        {
+            float *matrix = &inverseBindMatrices[i * 16];
+            matrix[0] = matrix[5] = matrix[10] = matrix[15] = 1;
+            for (size_t j = 0; j < 3; j++)
+                matrix[12 + j] = random.Float(-1, 1);
+        }
+        size_t accessor = AddAccessor(AddBufferView(inverseBindMatrices.data(), inverseBindMatrices.size() * sizeof(float), 0, 0), 0, options.nbJoint, componentFloat, "MAT4");
+
+        json.BeginObject();
+        json.Key("name");
+        json.String("skin0");
+        json.Key("inverseBindMatrices");
+        json.Size(accessor);
+        json.Key("joints");
+        json.BeginArray();
+        for (size_t i = 0; i < options.nbJoint; i++)
+            json.Size(i);
+        json.EndArray();
+        json.EndObject();
+    }
+
+    void SyntheticGlbBuilder::WriteAnimation(size_t animationIndex)
+    {
+        // one input shared by every sampler, a translation and a rotation sampler per node
+        std::vector<float> times(options.nbKeyframe);
+        for (size_t i = 0; i < times.size(); i++)
+            times[i] = i / 30.0f;
+        size_t input = AddAccessor(AddBufferView(times.data(), times.size() * sizeof(float), 0, 0), 0, times.size(), componentFloat, "SCALAR");
+        accessors[input].min.assign(1, times.front());
+        accessors[input].max.assign(1, times.back());
+
+        std::vector<size_t> outputs;
+        std::vector<float> keys;
+        for (size_t node = 0; node < options.nbNode; node++)
+        {
+            keys.clear();
+            for (size_t i = 0; i < options.nbKeyframe; i++)
+                keys.insert(keys.end(), {random.Float(-1, 1), random.Float(-1, 1), random.Float(-1, 1)});
+            outputs.push_back(AddAccessor(AddBufferView(keys.data(), keys.size() * sizeof(float), 0, 0), 0, options.nbKeyframe, componentFloat, "VEC3"));
+
+            keys.clear();
+            for (size_t i = 0; i < options.nbKeyframe; i++)
+            {
+                float q[4] = {random.Float(-1, 1), random.Float(-1, 1), random.Float(-1, 1), random.Float(-1, 1)};
+                float length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+                for (float component: q)
+                    keys.push_back(component / length);
+            }
+            outputs.push_back(AddAccessor(AddBufferView(keys.data(), keys.size() * sizeof(float), 0, 0), 0, options.nbKeyframe, componentFloat, "VEC4"));
+        }
+
+        json.BeginObject();
+        json.Key("name");
+        json.String("animation" + std::to_string(animationIndex));
+        json.Key("samplers");
+        json.BeginArray();
+        for (size_t output: outputs)
+        {
+            json.BeginObject();
+            json.Key("input");
+            json.Size(input);
+            json.Key("output");
+            json.Size(output);
+            json.Key("interpolation");
+            json.String("LINEAR");
+            json.EndObject();
+        }
+        json.EndArray();
+        json.Key("channels");
+        json.BeginArray();
+        for (size_t i = 0; i < outputs.size(); i++)
+        {
+            json.BeginObject();
+            json.Key("sampler");
+            json.Size(i);
+            json.Key("target");
+            json.BeginObject();
+            json.Key("node");
+            json.Size(i / 2);
+            json.Key("path");
+            json.String(i % 2 ? "rotation" : "translation");
+            json.EndObject();
+            json.EndObject();
+        }
+        json.EndArray();
+        json.EndObject();
+    }
+
+    void SyntheticGlbBuilder::WriteAccessors()
+    {
+        json.Key("accessors");
+        json.BeginArray();
+        for (const SyntheticAccessor &accessor: accessors)
+        {
+            json.BeginObject();
+            json.Key("bufferView");
+            json.Size(accessor.bufferView);
+            if (accessor.byteOffset)
+            {
+                json.Key("byteOffset");
+                json.Size(accessor.byteOffset);
+            }
+            json.Key("componentType");
+            json.Int(accessor.componentType);
+            json.Key("count");
+            json.Size(accessor.count);
+            json.Key("type");
+            json.String(accessor.type);
+            if (!accessor.min.empty())
+            {
+                json.Key("min");
+                json.Floats(accessor.min.data(), accessor.min.size());
+                json.Key("max");
+                json.Floats(accessor.max.data(), accessor.max.size());
+            }
+            json.EndObject();
+        }
+        json.EndArray();
+    }
+
+    void SyntheticGlbBuilder::WriteBufferViews()
+    {
+        json.Key("bufferViews");
+        json.BeginArray();
+        for (const SyntheticBufferView &bufferView: bufferViews)
+        {
+            json.BeginObject();
+            json.Key("buffer");
+            json.Int(bufferView.meshoptMode ? 1 : 0);
+            json.Key("byteOffset");
+            json.Size(bufferView.byteOffset);
+            json.Key("byteLength");
+            json.Size(bufferView.byteLength);
+            if (bufferView.byteStride)
+            {
+                json.Key("byteStride");
+                json.Size(bufferView.byteStride);
+            }
+            if (bufferView.target)
+            {
+                json.Key("target");
+                json.Int(bufferView.target);
+            }
+            if (bufferView.meshoptMode)
+            {
+                json.Key("extensions");
+                json.BeginObject();
+                json.Key("EXT_meshopt_compression");
+                json.BeginObject();
+                json.Key("buffer");
+                json.Int(0);
+                json.Key("byteOffset");
+                json.Size(bufferView.compressedOffset);
+                json.Key("byteLength");
+                json.Size(bufferView.compressedLength);
+                json.Key("byteStride");
+                json.Size(bufferView.elementSize);
+                json.Key("count");
+                json.Size(bufferView.byteLength / bufferView.elementSize);
+                json.Key("mode");
+                json.String(bufferView.meshoptMode);
+                json.EndObject();
+                json.EndObject();
+            }
+            json.EndObject();
+        }
+        json.EndArray();
+    }
+
+    std::string SyntheticGlbBuilder::Build()
+    {
+        if (options.nbJoint > options.nbNode)
+            throw(std::runtime_error("synthetic glb needs at least as many nodes as joints"));
+
+        json.BeginObject();
+        json.Key("asset");
+        json.BeginObject();
+        json.Key("version");
+        json.String("2.0");
+        json.Key("generator");
+        json.String("GlbBench");
+        json.EndObject();
+
+        if (options.meshopt)
+        {
+            for (const char *key: {"extensionsUsed", "extensionsRequired"})
+            {
+                json.Key(key);
+                json.BeginArray();
+                json.String("EXT_meshopt_compression");
+                json.EndArray();
+            }
+        }
+
+        json.Key("scene");
+        json.Int(0);
+        json.Key("scenes");
+        json.BeginArray();
+        json.BeginObject();
+        json.Key("name");
+        json.String("scene0");
+        json.Key("nodes");
+        json.BeginArray();
+        if (options.nbNode > 0)
+            json.Int(0);
+        json.EndArray();
+        json.EndObject();
+        json.EndArray();
+
+        json.Key("nodes");
+        json.BeginArray();
+        WriteNodes();
+        json.EndArray();
+
+        json.Key("meshes");
+        json.BeginArray();
+        for (size_t i = 0; i < options.nbMesh; i++)
+            WriteMesh(i);
+        json.EndArray();
+
+        json.Key("materials");
+        json.BeginArray();
+        json.BeginObject();
+        json.Key("name");
+        json.String("material0");
+        json.EndObject();
+        json.EndArray();
+
+        if (options.nbJoint > 0)
+        {
+            json.Key("skins");
+            json.BeginArray();
+            WriteSkin();
+            json.EndArray();
+        }
+
+        if (options.nbAnimation > 0 && options.nbKeyframe > 0)
+        {
+            json.Key("animations");
+            json.BeginArray();
+            for (size_t i = 0; i < options.nbAnimation; i++)
+                WriteAnimation(i);
+            json.EndArray();
+        }
+
+        WriteAccessors();
+        WriteBufferViews();
+        json.Key("buffers");
+        json.BeginArray();
+        json.BeginObject();
+        json.Key("byteLength");
+        json.Size(bin.size());
+        json.EndObject();
+        if (options.meshopt)
+        {
+            json.BeginObject();
+            json.Key("byteLength");
+            json.Size(fallbackSize);
+            json.Key("extensions");
+            json.BeginObject();
+            json.Key("EXT_meshopt_compression");
+            json.BeginObject();
+            json.Key("fallback");
+            json.Bool(true);
+            json.EndObject();
+            json.EndObject();
+            json.EndObject();
+        }
+        json.EndArray();
+        json.EndObject();
+
+        // both chunks padded to 4 bytes, the JSON with spaces
+        std::string &jsonChunk = json.GetJson();
+        jsonChunk.resize((jsonChunk.size() + 3) & ~size_t(3), ' ');
+        bin.resize((bin.size() + 3) & ~size_t(3), '\0');
+
+        uint32_t header[5] = {Glb::glbMagic, Glb::glbVersion, uint32_t(12 + 8 + jsonChunk.size() + 8 + bin.size()), uint32_t(jsonChunk.size()), Glb::chunkTypeJson};
+        uint32_t binHeader[2] = {uint32_t(bin.size()), Glb::chunkTypeBin};
+
+        std::string glb;
+        glb.reserve(header[2]);
+        glb.append(reinterpret_cast<const char*>(header), sizeof(header));
+        glb += jsonChunk;
+        glb.append(reinterpret_cast<const char*>(binHeader), sizeof(binHeader));
+        glb += bin;
+        return (glb);
+    }
+
+    std::string GenerateSyntheticGlb(const SyntheticGlbOptions &options)
+    {
+        SyntheticGlbBuilder builder(options);
+        return (builder.Build());
+    }
+
+    size_t WriteSyntheticGlb(const SyntheticGlbOptions &options, const std::string &path)
+    {
+        std::string glb = GenerateSyntheticGlb(options);
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file)
+            throw(std::runtime_error("failed to open " + path));
+        file.write(glb.data(), glb.size());
+        if (!file)
+            throw(std::runtime_error("failed to write " + path));
+        return (glb.size());
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+namespace Bench
+{
+    struct SyntheticGlbOptions
+    {
+        size_t nbMesh; // one primitive each, a grid of about nbVertex vertices
+        size_t nbVertex;
+        size_t nbNode; // a tree with 4 children per node, node i shows mesh i % nbMesh
+        size_t nbJoint; // the first nbJoint nodes skin every mesh, 0 for no skin
+        size_t nbAnimation; // each one moves every node, rotation and translation
+        size_t nbKeyframe;
+        bool interleaved; // one bufferView per mesh with a byteStride, or one tightly packed bufferView per attribute
+        bool meshopt; // vertex and index bufferViews compressed with EXT_meshopt_compression, the values are the same
+        uint32_t seed;
+
+        SyntheticGlbOptions()
+        {
+            nbMesh = 1;
+            nbVertex = 10000;
+            nbNode = 1;
+            nbJoint = 0;
+            nbAnimation = 0;
+            nbKeyframe = 0;
+            interleaved = true;
+            meshopt = false;
+            seed = 1;
+        }
+    };
+
+    // same options and seed, same bytes
+    std::string GenerateSyntheticGlb(const SyntheticGlbOptions &options);
+    size_t WriteSyntheticGlb(const SyntheticGlbOptions &options, const std::string &path); // returns the size of the file
+}
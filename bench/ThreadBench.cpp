@@ -0,0 +1,46 @@
+#include "Bench.hpp"
+#include "SyntheticGlb.hpp"
+#include "GlbParser/GlbParser.hpp"
+#include <thread>
+
+namespace Bench
+{
+    // the same file through LoadGltf on the calling thread, then on pools of 1, 2, 4 .. threads,
+    // up to the hardware threads or --threads when it is more
+    std::vector<BenchResult> RunThreadCase(const BenchOptions &options)
+    {
+        size_t scale = options.quick ? 10 : 1;
+        SyntheticGlbOptions glbOptions;
+        glbOptions.nbMesh = 64;
+        glbOptions.nbVertex = 20000 / scale;
+        glbOptions.nbNode = 64;
+        glbOptions.nbJoint = 32;
+        glbOptions.nbAnimation = 4;
+        glbOptions.nbKeyframe = 2000 / scale;
+        std::string glb = GenerateSyntheticGlb(glbOptions);
+        Glb::GlbView view = Glb::ParseGlbView(glb);
+
+        std::vector<BenchResult> results;
+        results.push_back(MeasureCase("threads", "CALLING_THREAD", "MB", glb.size(), options, [&]()
+        {
+            Glb::LoadGltf(view);
+        }));
+
+        size_t maxThread = std::max<size_t>(std::max<size_t>(std::thread::hardware_concurrency(), options.nbThread), 1);
+        for (size_t nbThread = 1; ; nbThread = std::min(nbThread * 2, maxThread))
+        {
+            Glb::ThreadPool pool(nbThread);
+            results.push_back(MeasureCase("threads", "POOL_" + std::to_string(nbThread), "MB", glb.size(), options, [&]()
+            {
+                Glb::LoadGltf(view, pool);
+            }));
+            if (nbThread == maxThread)
+                break;
+        }
+
+        double single = results[1].stats.MegabytesPerSecond();
+        for (size_t i = 2; i < results.size() && single > 0; i++)
+            printf("    %-24s x%.2f against POOL_1\n", results[i].stage.c_str(), results[i].stats.MegabytesPerSecond() / single);
+        return (results);
+    }
+}
@@ -0,0 +1,34 @@
+#include "Bench.hpp"
+#include "SyntheticGlb.hpp"
+#include "GlbParser/GlbWriter.hpp"
+
+namespace Bench
+{
+    // SerializeGlb in memory and WriteGlb to the corpus directory, over the decoded meshes, skin and animations
+    std::vector<BenchResult> RunWriteCase(const BenchOptions &options)
+    {
+        size_t scale = options.quick ? 10 : 1;
+        SyntheticGlbOptions glbOptions;
+        glbOptions.nbMesh = 16;
+        glbOptions.nbVertex = 50000 / scale;
+        glbOptions.nbNode = 128;
+        glbOptions.nbJoint = 64;
+        glbOptions.nbAnimation = 2;
+        glbOptions.nbKeyframe = 1000 / scale;
+        std::string glb = GenerateSyntheticGlb(glbOptions);
+        Glb::GltfData data = Glb::LoadGltf(Glb::ParseGlbView(glb));
+
+        size_t size = Glb::SerializeGlb(data).size();
+        std::string path = options.corpus + "/write.glb";
+        std::vector<BenchResult> results;
+        results.push_back(MeasureCase("write", "SERIALIZE", "MB", size, options, [&]()
+        {
+            Glb::SerializeGlb(data);
+        }));
+        results.push_back(MeasureCase("write", "WRITE_FILE", "MB", size, options, [&]()
+        {
+            Glb::WriteGlb(data, path);
+        }));
+        return (results);
+    }
+}
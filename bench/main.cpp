@@ -0,0 +1,244 @@
+#include "Bench.hpp"
+#include "SyntheticGlb.hpp"
+#include "GlbParser/GlbParser.hpp"
+#include "GlbParser/LoadStats.hpp"
+#include "GlbParser/ThreadPool.hpp"
+#include <map>
+#include <chrono>
+#include <memory>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <filesystem>
+
+using Bench::BenchOptions;
+using Bench::BenchResult;
+using Bench::CorpusEntry;
+
+// a case besides the corpus loads
+struct BenchCase
+{
+    const char *name;
+    std::vector<BenchResult> (*run)(const BenchOptions &options);
+};
+
+static const BenchCase cases[] = {
+    {"kernels", Bench::RunKernelCase},
+    {"threads", Bench::RunThreadCase},
+    {"cache", Bench::RunCacheCase},
+    {"write", Bench::RunWriteCase},
+    {"animation", Bench::RunAnimationCase},
+    {"scene-graph", Bench::RunSceneGraphCase},
+    {"skinning", Bench::RunSkinningCase},
+    {"bvh", Bench::RunBvhCase},
+    {"quantization", Bench::RunQuantizationCase},
+    {"optimizer", Bench::RunOptimizerCase},
+    {"meshopt", Bench::RunMeshoptCase},
+};
+
+
+static void PrintUsage()
+{
+    std::cout << "usage: GlbBench [--corpus dir] [--iterations n] [--threads n] [--dom] [--quick] [--only name]" << std::endl;
+    std::cout << "                [--trace dir] [--csv file] [--baseline file] [--tolerance ratio]" << std::endl;
+}
+
+static bool ParseArguments(int argc, char **argv, BenchOptions &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--dom")
+            options.dom = true;
+        else if (arg == "--quick")
+            options.quick = true;
+        else if (arg == "--corpus" && hasValue)
+            options.corpus = argv[++i];
+        else if (arg == "--iterations" && hasValue)
+            options.iterations = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--threads" && hasValue)
+            options.nbThread = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--only" && hasValue)
+            options.only = argv[++i];
+        else if (arg == "--trace" && hasValue)
+            options.traceDirectory = argv[++i];
+        else if (arg == "--csv" && hasValue)
+            options.csv = argv[++i];
+        else if (arg == "--baseline" && hasValue)
+            options.baseline = argv[++i];
+        else if (arg == "--tolerance" && hasValue)
+            options.tolerance = std::atof(argv[++i]);
+        else
+            return (false);
+    }
+    return (true);
+}
+
+static double LoadOnce(const std::string &path, const BenchOptions &options, Glb::ThreadPool *pool)
+{
+    auto start = std::chrono::steady_clock::now();
+    double seconds;
+    {
+        Glb::MappedFile file(path, true);
+        Glb::GlbView view = Glb::ParseGlbView(file.GetBytes());
+        Glb::GltfData data;
+        if (options.dom)
+        {
+            Json::Node gltfJson = Glb::LoadJson(view);
+            data = pool ? Glb::LoadGltf(gltfJson, view, *pool) : Glb::LoadGltf(gltfJson, view);
+        }
+        else
+            data = pool ? Glb::LoadGltf(view, *pool) : Glb::LoadGltf(view);
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return (seconds);
+}
+
+static std::vector<BenchResult> RunFile(const CorpusEntry &entry, const std::string &path, size_t fileSize, const BenchOptions &options, Glb::ThreadPool *pool)
+{
+    LoadOnce(path, options, pool); // warms the page cache and the allocator
+
+    Glb::LoadStats stats(!options.traceDirectory.empty());
+    Glb::SetLoadStats(&stats);
+    BenchResult total;
+    total.file = entry.name;
+    total.stage = "TOTAL";
+    double best = 0;
+    for (size_t i = 0; i < options.iterations; i++)
+    {
+        double seconds = LoadOnce(path, options, pool);
+        best = i == 0 ? seconds : std::min(best, seconds);
+        total.stats.count++;
+        total.stats.bytes += fileSize;
+        total.stats.seconds += seconds;
+    }
+    Glb::SetLoadStats(NULL);
+
+    printf("%-22s %8.1f MB  best %8.2f ms  mean %8.2f ms  %8.1f MB/s\n", entry.name.c_str(), fileSize / 1e6, best * 1e3, total.stats.seconds / options.iterations * 1e3, total.stats.MegabytesPerSecond());
+
+    std::vector<BenchResult> results;
+    results.push_back(total);
+    for (size_t s = 0; s < Glb::nbLoadStage; s++)
+    {
+        Glb::LoadStage stage = static_cast<Glb::LoadStage>(s);
+        BenchResult result;
+        result.file = entry.name;
+        result.stage = Glb::ToString(stage);
+        result.stats = stats.Get(stage);
+        if (result.stats.count == 0)
+            continue;
+        printf("    %-18s %8zu runs %10.1f MB %10.2f ms %10.1f MB/s\n", result.stage.c_str(), result.stats.count / options.iterations, result.stats.bytes / 1e6 / options.iterations, result.stats.seconds / options.iterations * 1e3, result.stats.MegabytesPerSecond());
+        results.push_back(result);
+    }
+
+    if (!options.traceDirectory.empty())
+        stats.WriteChromeTrace(options.traceDirectory + "/" + entry.name + ".json");
+    return (results);
+}
+
+static void WriteCsv(const std::string &path, const std::vector<BenchResult> &results)
+{
+    std::ofstream file(path);
+    if (!file)
+        throw(std::runtime_error("failed to open " + path));
+    // amount in units, rate in millions of units per second
+    file << "file,stage,count,amount,seconds,rate,unit\n";
+    for (const BenchResult &result: results)
+        file << result.file << ',' << result.stage << ',' << result.stats.count << ',' << result.stats.bytes << ',' << result.stats.seconds << ',' << result.stats.MegabytesPerSecond() << ',' << result.unit << '\n';
+}
+
+// returns the number of stages slower than the baseline by more than the tolerance
+static size_t CompareBaseline(const std::string &path, const std::vector<BenchResult> &results, double tolerance)
+{
+    std::ifstream file(path);
+    if (!file)
+        throw(std::runtime_error("failed to open " + path));
+
+    std::map<std::string, double> baseline;
+    std::string line;
+    std::getline(file, line); // header
+    while (std::getline(file, line))
+    {
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, ','))
+            fields.push_back(field);
+        if (fields.size() >= 6) // the csv of older runs has no unit column
+            baseline[fields[0] + "/" + fields[1]] = std::atof(fields[5].c_str());
+    }
+
+    size_t nbRegression = 0;
+    for (const BenchResult &result: results)
+    {
+        auto it = baseline.find(result.file + "/" + result.stage);
+        if (it == baseline.end() || it->second <= 0)
+            continue;
+        double ratio = result.stats.MegabytesPerSecond() / it->second;
+        if (ratio < 1 - tolerance)
+        {
+            printf("REGRESSION %s %s: %.1f against %.1f %s/s (%+.1f%%)\n", result.file.c_str(), result.stage.c_str(), result.stats.MegabytesPerSecond(), it->second, result.unit.c_str(), (ratio - 1) * 100);
+            nbRegression++;
+        }
+    }
+    return (nbRegression);
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions options;
+    if (!ParseArguments(argc, argv, options))
+    {
+        PrintUsage();
+        return (1);
+    }
+
+    try
+    {
+        std::filesystem::create_directories(options.corpus);
+        if (!options.traceDirectory.empty())
+            std::filesystem::create_directories(options.traceDirectory);
+
+        std::unique_ptr<Glb::ThreadPool> pool;
+        if (options.nbThread > 0)
+            pool = std::make_unique<Glb::ThreadPool>(options.nbThread);
+
+        printf("%s loader, %zu threads, %zu iterations\n", options.dom ? "Json::Node" : "streaming", options.nbThread, options.iterations);
+        std::vector<BenchResult> results;
+        for (const CorpusEntry &entry: Bench::BuildCorpus(options.quick))
+        {
+            if (entry.name.find(options.only) == std::string::npos)
+                continue;
+
+            // the files are deterministic, generating them again gives the same bytes
+            std::string path = options.corpus + "/" + entry.name + ".glb";
+            size_t fileSize = Bench::WriteSyntheticGlb(entry.options, path);
+            std::vector<BenchResult> fileResults = RunFile(entry, path, fileSize, options, pool.get());
+            results.insert(results.end(), fileResults.begin(), fileResults.end());
+        }
+
+        for (const BenchCase &benchCase: cases)
+        {
+            if (std::string(benchCase.name).find(options.only) == std::string::npos)
+                continue;
+
+            printf("%s\n", benchCase.name);
+            std::vector<BenchResult> caseResults = benchCase.run(options);
+            results.insert(results.end(), caseResults.begin(), caseResults.end());
+        }
+
+        if (!options.csv.empty())
+            WriteCsv(options.csv, results);
+        if (!options.baseline.empty() && CompareBaseline(options.baseline, results, options.tolerance) > 0)
+            return (2);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return (1);
+    }
+    return (0);
+}
@@ -0,0 +1,92 @@
+#include "GlbParser/Accessor.hpp"
+#include <stdexcept>
+
+namespace Glb
+{
+    size_t ComponentSize(ComponentType componentType)
+    {
+        switch (componentType)
+        {
+            case ComponentType::BYTE:
+            case ComponentType::UNSIGNED_BYTE:
+                return (1);
+            case ComponentType::SHORT:
+            case ComponentType::UNSIGNED_SHORT:
+                return (2);
+            case ComponentType::UNSIGNED_INT:
+            case ComponentType::FLOAT:
+                return (4);
+        }
+        throw(std::runtime_error("component type unknown: " + std::to_string(static_cast<int>(componentType))));
+    }
+
+    AccessorType ParseAccessorType(const std::string &type)
+    {
+        if (type == "SCALAR")
+            return (AccessorType::SCALAR);
+        else if (type == "VEC2")
+            return (AccessorType::VEC2);
+        else if (type == "VEC3")
+            return (AccessorType::VEC3);
+        else if (type == "VEC4")
+            return (AccessorType::VEC4);
+        else if (type == "MAT2")
+            return (AccessorType::MAT2);
+        else if (type == "MAT3")
+            return (AccessorType::MAT3);
+        else if (type == "MAT4")
+            return (AccessorType::MAT4);
+        throw(std::runtime_error("type unknown: " + type));
+    }
+
+    size_t NbComponent(AccessorType type)
+    {
+        switch (type)
+        {
+            case AccessorType::SCALAR:
+                return (1);
+            case AccessorType::VEC2:
+                return (2);
+            case AccessorType::VEC3:
+                return (3);
+            case AccessorType::VEC4:
+            case AccessorType::MAT2:
+                return (4);
+            case AccessorType::MAT3:
+                return (9);
+            case AccessorType::MAT4:
+                return (16);
+        }
+        return (0);
+    }
+
+    size_t NbComponent(const std::string &type)
+    {
+        return (NbComponent(ParseAccessorType(type)));
+    }
+
+    size_t NbRow(AccessorType type)
+    {
+        switch (type)
+        {
+            case AccessorType::MAT2:
+                return (2);
+            case AccessorType::MAT3:
+                return (3);
+            case AccessorType::MAT4:
+                return (4);
+            default:
+                return (NbComponent(type));
+        }
+    }
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#data-alignment
+    // only MAT2 of 1 byte components and MAT3 of 1 or 2 bytes components are padded
+    size_t ColumnStride(AccessorType type, ComponentType componentType)
+    {
+        size_t columnSize = NbRow(type) * ComponentSize(componentType);
+        if (type == AccessorType::MAT2 || type == AccessorType::MAT3 || type == AccessorType::MAT4)
+            return ((columnSize + 3) & ~static_cast<size_t>(3));
+        return (columnSize);
+    }
+}
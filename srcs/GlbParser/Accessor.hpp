@@ -0,0 +1,200 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Glb
+{
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#accessor-data-types
+    enum class ComponentType
+    {
+        BYTE = 5120,
+        UNSIGNED_BYTE = 5121,
+        SHORT = 5122,
+        UNSIGNED_SHORT = 5123,
+        UNSIGNED_INT = 5125,
+        FLOAT = 5126
+    };
+
+    enum class AccessorType
+    {
+        SCALAR,
+        VEC2,
+        VEC3,
+        VEC4,
+        MAT2,
+        MAT3,
+        MAT4
+    };
+
+    size_t ComponentSize(ComponentType componentType);
+    AccessorType ParseAccessorType(const std::string &type);
+    size_t NbComponent(AccessorType type);
+    size_t NbComponent(const std::string &type);
+    size_t NbRow(AccessorType type); // components per matrix column, NbComponent for the other types
+    size_t ColumnStride(AccessorType type, ComponentType componentType); // bytes between two matrix columns, which start on 4 bytes boundaries
+
+    template <typename T> struct ComponentTypeOf;
+    template <> struct ComponentTypeOf<int8_t> { static constexpr ComponentType value = ComponentType::BYTE; };
+    template <> struct ComponentTypeOf<uint8_t> { static constexpr ComponentType value = ComponentType::UNSIGNED_BYTE; };
+    template <> struct ComponentTypeOf<int16_t> { static constexpr ComponentType value = ComponentType::SHORT; };
+    template <> struct ComponentTypeOf<uint16_t> { static constexpr ComponentType value = ComponentType::UNSIGNED_SHORT; };
+    template <> struct ComponentTypeOf<uint32_t> { static constexpr ComponentType value = ComponentType::UNSIGNED_INT; };
+    template <> struct ComponentTypeOf<float> { static constexpr ComponentType value = ComponentType::FLOAT; };
+
+    struct CompressedBufferView;
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-accessor
+    // resolved accessor: data already points to the first element inside the BIN chunk,
+    // or inside the decoded bufferView once LoadedBufferViews::Load has read a compressed one
+    struct Accessor
+    {
+        const unsigned char *data; // NULL when the accessor has no bufferView, elements are then zeros
+        const CompressedBufferView *compressed; // NULL unless the bufferView is compressed
+        size_t compressedOffset; // of the first element in the decoded bufferView
+        size_t count;
+        size_t nbComponent;
+        size_t nbRow; // components per column of a matrix, nbComponent for the other types
+        size_t columnStride; // bytes between two columns, with the padding of MAT2 and MAT3 of small components
+        size_t byteStride; // bytes between two elements, never 0
+        ComponentType componentType;
+        bool normalized;
+        bool hasBounds; // min and max are only filled for FLOAT accessors, up to 4 components
+        float min[4];
+        float max[4];
+    };
+
+    // bytes of one element, padding included
+    inline size_t ElementSize(const Accessor &accessor)
+    {
+        return (accessor.nbComponent / accessor.nbRow * accessor.columnStride);
+    }
+
+    template <typename T, typename Raw>
+    T ConvertRawComponent(const unsigned char *src, bool normalized, float maxValue)
+    {
+        Raw value;
+        std::memcpy(&value, src, sizeof(Raw));
+        if (std::is_floating_point<T>::value && normalized)
+            return (static_cast<T>(std::max(static_cast<float>(value) / maxValue, -1.0f)));
+        return (static_cast<T>(value));
+    }
+
+    // normalized integers are mapped to [0, 1] or [-1, 1] when T is a floating point type
+    template <typename T>
+    T ConvertComponent(const unsigned char *src, ComponentType componentType, bool normalized)
+    {
+        switch (componentType)
+        {
+            case ComponentType::BYTE:
+                return (ConvertRawComponent<T, int8_t>(src, normalized, 127.0f));
+            case ComponentType::UNSIGNED_BYTE:
+                return (ConvertRawComponent<T, uint8_t>(src, normalized, 255.0f));
+            case ComponentType::SHORT:
+                return (ConvertRawComponent<T, int16_t>(src, normalized, 32767.0f));
+            case ComponentType::UNSIGNED_SHORT:
+                return (ConvertRawComponent<T, uint16_t>(src, normalized, 65535.0f));
+            case ComponentType::UNSIGNED_INT:
+                return (ConvertRawComponent<T, uint32_t>(src, normalized, 4294967295.0f));
+            case ComponentType::FLOAT:
+                return (ConvertRawComponent<T, float>(src, false, 1.0f));
+        }
+        return (T());
+    }
+
+    // typed view over an accessor, converts every component to T while reading
+    template <typename T>
+    class AccessorView
+    {
+        private:
+            Accessor accessor;
+            size_t componentSize;
+            bool padded; // columns of a matrix aren't contiguous
+
+            bool IsRawCopy() const
+            {
+                return (accessor.componentType == ComponentTypeOf<T>::value && !padded
+                    && (!accessor.normalized || !std::is_floating_point<T>::value));
+            }
+
+        public:
+            AccessorView(const Accessor &accessor)
+            {
+                if (accessor.compressed && !accessor.data && accessor.count > 0)
+                    throw(std::logic_error("accessor of a compressed bufferView read before being loaded"));
+                this->accessor = accessor;
+                componentSize = ComponentSize(accessor.componentType);
+                padded = accessor.columnStride != accessor.nbRow * componentSize;
+            }
+
+            size_t Count() const { return (accessor.count); }
+            size_t NbComponent() const { return (accessor.nbComponent); }
+            const Accessor &GetAccessor() const { return (accessor); }
+
+            T Get(size_t index, size_t component) const
+            {
+                if (!accessor.data)
+                    return (T());
+                const unsigned char *src = accessor.data + index * accessor.byteStride;
+                if (padded)
+                    src += component / accessor.nbRow * accessor.columnStride + component % accessor.nbRow * componentSize;
+                else
+                    src += component * componentSize;
+                return (ConvertComponent<T>(src, accessor.componentType, accessor.normalized));
+            }
+
+            // writes the nbComponent values of one element in out
+            void Read(size_t index, T *out) const
+            {
+                for (size_t c = 0; c < accessor.nbComponent; c++)
+                    out[c] = Get(index, c);
+            }
+
+            // writes every element in dst, dstStride being the number of bytes between two elements in dst
+            void CopyTo(T *dst, size_t dstStride) const
+            {
+                unsigned char *dstBytes = reinterpret_cast<unsigned char*>(dst);
+                size_t elementSize = accessor.nbComponent * sizeof(T);
+
+                if (!accessor.data)
+                {
+                    for (size_t i = 0; i < accessor.count; i++)
+                        std::memset(dstBytes + i * dstStride, 0, elementSize);
+                }
+                else if (IsRawCopy())
+                {
+                    if (accessor.byteStride == elementSize && dstStride == elementSize)
+                        std::memcpy(dstBytes, accessor.data, accessor.count * elementSize);
+                    else
+                    {
+                        for (size_t i = 0; i < accessor.count; i++)
+                            std::memcpy(dstBytes + i * dstStride, accessor.data + i * accessor.byteStride, elementSize);
+                    }
+                }
+                else
+                {
+                    for (size_t i = 0; i < accessor.count; i++)
+                        Read(i, reinterpret_cast<T*>(dstBytes + i * dstStride));
+                }
+            }
+
+            // writes every element tightly packed in dst, dst must hold Count() * NbComponent() values
+            void CopyTo(T *dst) const
+            {
+                CopyTo(dst, accessor.nbComponent * sizeof(T));
+            }
+
+            std::vector<T> ToVector() const
+            {
+                std::vector<T> values(accessor.count * accessor.nbComponent);
+                if (!values.empty())
+                    CopyTo(values.data());
+                return (values);
+            }
+    };
+}
@@ -0,0 +1,349 @@
+#include "GlbParser/AnimationRuntime.hpp"
+#include "GlbParser/VertexKernels.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace Glb
+{
+    static size_t PathNbComponent(AnimationPath path)
+    {
+        return (path == AnimationPath::ROTATION ? 4 : 3);
+    }
+
+    AnimationClip BuildAnimationClip(const Animation &animation)
+    {
+        AnimationClip clip;
+        clip.name = std::string(animation.name);
+        clip.duration = 0;
+
+        // Animation holds one copy of the sampler per channel, channel.sampler still is the glTF index
+        std::map<int, size_t> samplerIndices;
+        for (size_t i = 0; i < animation.channels.size(); i++)
+        {
+            const Channel &channel = animation.channels[i];
+            const Sampler &sampler = animation.samplers.at(i);
+
+            ClipChannel clipChannel;
+            clipChannel.node = channel.node;
+            clipChannel.path = channel.path;
+
+            auto it = samplerIndices.find(channel.sampler);
+            if (it != samplerIndices.end())
+            {
+                clipChannel.sampler = it->second;
+                clip.channels.push_back(clipChannel);
+                continue;
+            }
+
+            ClipSampler clipSampler;
+            clipSampler.timecodes = sampler.timecodes;
+            clipSampler.data = sampler.data;
+            clipSampler.nbComponent = sampler.nbElement;
+            clipSampler.interpolation = sampler.interpolation;
+
+            size_t nbValuePerKey = clipSampler.interpolation == Interpolation::CUBICSPLINE ? 3 : 1;
+            if (clipChannel.path != AnimationPath::WEIGHTS)
+            {
+                if (clipSampler.nbComponent != PathNbComponent(clipChannel.path))
+                    throw(std::runtime_error(std::string(ToString(channel.path)) + " sampler has " + std::to_string(clipSampler.nbComponent) + " components"));
+                if (clipSampler.timecodes.empty() || clipSampler.data.size() < clipSampler.timecodes.size() * nbValuePerKey * clipSampler.nbComponent)
+                    throw(std::runtime_error(std::string(ToString(channel.path)) + " sampler has fewer values than timecodes"));
+            }
+            if (!clipSampler.timecodes.empty())
+                clip.duration = std::max(clip.duration, clipSampler.timecodes.back());
+
+            clipChannel.sampler = clip.samplers.size();
+            samplerIndices[channel.sampler] = clipChannel.sampler;
+            clip.samplers.push_back(std::move(clipSampler));
+            clip.channels.push_back(clipChannel);
+        }
+
+        return (clip);
+    }
+
+    LocalTransform::LocalTransform()
+    {
+        translation[0] = translation[1] = translation[2] = 0;
+        rotation[0] = rotation[1] = rotation[2] = 0;
+        rotation[3] = 1;
+        scale[0] = scale[1] = scale[2] = 1;
+    }
+
+    // transform[row][col], no shear expected since nodes are built from TRS
+    LocalTransform DecomposeTransform(const ml::mat4 &transform)
+    {
+        LocalTransform local;
+
+        float columns[3][3];
+        for (int col = 0; col < 3; col++)
+        {
+            local.translation[col] = transform[col][3];
+            for (int row = 0; row < 3; row++)
+                columns[col][row] = transform[row][col];
+            local.scale[col] = std::sqrt(columns[col][0] * columns[col][0] + columns[col][1] * columns[col][1] + columns[col][2] * columns[col][2]);
+        }
+
+        float determinant = columns[0][0] * (columns[1][1] * columns[2][2] - columns[2][1] * columns[1][2])
+                          - columns[1][0] * (columns[0][1] * columns[2][2] - columns[2][1] * columns[0][2])
+                          + columns[2][0] * (columns[0][1] * columns[1][2] - columns[1][1] * columns[0][2]);
+        if (determinant < 0)
+            local.scale[0] = -local.scale[0];
+
+        for (int col = 0; col < 3; col++)
+        {
+            if (local.scale[col] == 0)
+                return (local);
+            for (int row = 0; row < 3; row++)
+                columns[col][row] /= local.scale[col];
+        }
+
+        // https://www.euclideanspace.com/maths/geometry/rotations/conversions/matrixToQuaternion/
+        float m00 = columns[0][0], m11 = columns[1][1], m22 = columns[2][2];
+        float trace = m00 + m11 + m22;
+        float *q = local.rotation;
+        if (trace > 0)
+        {
+            float s = std::sqrt(trace + 1.0f) * 2;
+            q[3] = 0.25f * s;
+            q[0] = (columns[1][2] - columns[2][1]) / s;
+            q[1] = (columns[2][0] - columns[0][2]) / s;
+            q[2] = (columns[0][1] - columns[1][0]) / s;
+        }
+        else if (m00 > m11 && m00 > m22)
+        {
+            float s = std::sqrt(1.0f + m00 - m11 - m22) * 2;
+            q[3] = (columns[1][2] - columns[2][1]) / s;
+            q[0] = 0.25f * s;
+            q[1] = (columns[1][0] + columns[0][1]) / s;
+            q[2] = (columns[2][0] + columns[0][2]) / s;
+        }
+        else if (m11 > m22)
+        {
+            float s = std::sqrt(1.0f + m11 - m00 - m22) * 2;
+            q[3] = (columns[2][0] - columns[0][2]) / s;
+            q[0] = (columns[1][0] + columns[0][1]) / s;
+            q[1] = 0.25f * s;
+            q[2] = (columns[2][1] + columns[1][2]) / s;
+        }
+        else
+        {
+            float s = std::sqrt(1.0f + m22 - m00 - m11) * 2;
+            q[3] = (columns[0][1] - columns[1][0]) / s;
+            q[0] = (columns[2][0] + columns[0][2]) / s;
+            q[1] = (columns[2][1] + columns[1][2]) / s;
+            q[2] = 0.25f * s;
+        }
+
+        return (local);
+    }
+
+    std::vector<LocalTransform> GetRestPose(const std::vector<Node> &nodes)
+    {
+        std::vector<LocalTransform> pose;
+        pose.reserve(nodes.size());
+        for (const Node &node: nodes)
+            pose.push_back(DecomposeTransform(node.transform));
+        return (pose);
+    }
+
+    // returns k so that timecodes[k] <= time < timecodes[k + 1], timecodes has at least 2 keys
+    static size_t FindKey(const std::vector<float> &timecodes, float time, size_t &cursor)
+    {
+        size_t last = timecodes.size() - 1;
+        if (cursor < last && timecodes[cursor] <= time)
+        {
+            for (int step = 0; step < 4 && cursor < last; step++)
+            {
+                if (time < timecodes[cursor + 1])
+                    return (cursor);
+                cursor++;
+            }
+        }
+
+        cursor = std::upper_bound(timecodes.begin(), timecodes.end(), time) - timecodes.begin();
+        cursor = std::min(std::max(cursor, static_cast<size_t>(1)), last) - 1;
+        return (cursor);
+    }
+
+    static void PushKey(std::vector<float> &keys, const float *value, size_t nbComponent)
+    {
+        for (size_t c = 0; c < 4; c++)
+            keys.push_back(c < nbComponent ? value[c] : 0.0f);
+    }
+
+    static void PushSlerpWeights(std::vector<float> &weights, const float *q0, const float *q1, float factor, RotationBlend rotationBlend)
+    {
+        float dot = q0[0] * q1[0] + q0[1] * q1[1] + q0[2] * q1[2] + q0[3] * q1[3];
+        float sign = dot < 0 ? -1.0f : 1.0f; // shortest path
+        dot = std::fabs(dot);
+
+        float w0 = 1.0f - factor;
+        float w1 = factor;
+        if (rotationBlend == RotationBlend::SLERP && dot < 0.9995f)
+        {
+            float theta = std::acos(dot);
+            float sinTheta = std::sin(theta);
+            w0 = std::sin((1.0f - factor) * theta) / sinTheta;
+            w1 = std::sin(factor * theta) / sinTheta;
+        }
+        weights.insert(weights.end(), {w0, w1 * sign, 0.0f, 0.0f});
+    }
+
+    // turns one channel into a weighted sum of 4 keys
+    static void PushBlend(std::vector<float> &keys, std::vector<float> &weights, const ClipSampler &sampler, float time, size_t &cursor, bool rotation, RotationBlend rotationBlend)
+    {
+        const std::vector<float> &timecodes = sampler.timecodes;
+        size_t nbComponent = sampler.nbComponent;
+        bool cubic = sampler.interpolation == Interpolation::CUBICSPLINE;
+        size_t keyStride = (cubic ? 3 : 1) * nbComponent;
+        size_t valueOffset = cubic ? nbComponent : 0;
+
+        size_t single;
+        bool isSingle = true;
+        if (timecodes.size() == 1 || time <= timecodes.front())
+            single = 0;
+        else if (time >= timecodes.back())
+            single = timecodes.size() - 1;
+        else
+            isSingle = false;
+
+        if (isSingle)
+        {
+            PushKey(keys, sampler.data.data() + single * keyStride + valueOffset, nbComponent);
+            keys.insert(keys.end(), 12, 0.0f);
+            weights.insert(weights.end(), {1.0f, 0.0f, 0.0f, 0.0f});
+            return;
+        }
+
+        size_t k = FindKey(timecodes, time, cursor);
+        const float *key0 = sampler.data.data() + k * keyStride;
+        const float *key1 = key0 + keyStride;
+        float delta = timecodes[k + 1] - timecodes[k];
+        float factor = (time - timecodes[k]) / delta;
+
+        switch (sampler.interpolation)
+        {
+            case Interpolation::STEP:
+                PushKey(keys, key0, nbComponent);
+                keys.insert(keys.end(), 12, 0.0f);
+                weights.insert(weights.end(), {1.0f, 0.0f, 0.0f, 0.0f});
+                break;
+            case Interpolation::LINEAR:
+                PushKey(keys, key0, nbComponent);
+                PushKey(keys, key1, nbComponent);
+                keys.insert(keys.end(), 8, 0.0f);
+                if (rotation)
+                    PushSlerpWeights(weights, key0, key1, factor, rotationBlend);
+                else
+                    weights.insert(weights.end(), {1.0f - factor, factor, 0.0f, 0.0f});
+                break;
+            case Interpolation::CUBICSPLINE:
+            {
+                // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#interpolation-cubic
+                float t2 = factor * factor;
+                float t3 = t2 * factor;
+                PushKey(keys, key0 + nbComponent, nbComponent); // value k
+                PushKey(keys, key0 + 2 * nbComponent, nbComponent); // out tangent k
+                PushKey(keys, key1 + nbComponent, nbComponent); // value k + 1
+                PushKey(keys, key1, nbComponent); // in tangent k + 1
+                weights.insert(weights.end(), {2 * t3 - 3 * t2 + 1, delta * (t3 - 2 * t2 + factor), -2 * t3 + 3 * t2, delta * (t3 - t2)});
+                break;
+            }
+        }
+    }
+
+    AnimationEvaluator::AnimationEvaluator(RotationBlend rotationBlend)
+    {
+        this->rotationBlend = rotationBlend;
+    }
+
+    size_t AnimationEvaluator::Evaluate(const ClipEvaluation *evaluations, size_t count, Scratch &scratch)
+    {
+        scratch.keys.clear();
+        scratch.weights.clear();
+        scratch.targets.clear();
+        scratch.nbComponents.clear();
+
+        // first pass: key search and weights, scalar
+        for (size_t i = 0; i < count; i++)
+        {
+            const ClipEvaluation &evaluation = evaluations[i];
+            const AnimationClip &clip = *evaluation.clip;
+            std::vector<size_t> &cursors = evaluation.cursor->keys;
+            if (cursors.size() != clip.samplers.size())
+                cursors.assign(clip.samplers.size(), 0);
+
+            for (const ClipChannel &channel: clip.channels)
+            {
+                if (channel.path == AnimationPath::WEIGHTS)
+                    continue;
+                if (channel.node < 0 || static_cast<size_t>(channel.node) >= evaluation.nbTransform)
+                    throw(std::runtime_error("animation " + clip.name + " targets node " + std::to_string(channel.node) + " out of the transforms"));
+
+                LocalTransform &transform = evaluation.transforms[channel.node];
+                bool rotation = channel.path == AnimationPath::ROTATION;
+                if (channel.path == AnimationPath::TRANSLATION)
+                    scratch.targets.push_back(transform.translation);
+                else if (rotation)
+                    scratch.targets.push_back(transform.rotation);
+                else
+                    scratch.targets.push_back(transform.scale);
+                scratch.nbComponents.push_back(rotation ? 0 : 3);
+
+                PushBlend(scratch.keys, scratch.weights, clip.samplers[channel.sampler], evaluation.time, cursors[channel.sampler], rotation, rotationBlend);
+            }
+        }
+
+        // second pass: every blend at once with the SIMD kernel
+        size_t nbBlend = scratch.targets.size();
+        scratch.results.resize(nbBlend * 4);
+        Kernels::BlendVec4(scratch.keys.data(), scratch.weights.data(), scratch.results.data(), nbBlend);
+
+        for (size_t i = 0; i < nbBlend; i++)
+        {
+            float *result = scratch.results.data() + i * 4;
+            if (scratch.nbComponents[i] == 0)
+            {
+                float length = std::sqrt(result[0] * result[0] + result[1] * result[1] + result[2] * result[2] + result[3] * result[3]);
+                if (length > 0)
+                {
+                    for (size_t c = 0; c < 4; c++)
+                        scratch.targets[i][c] = result[c] / length;
+                }
+            }
+            else
+                std::copy(result, result + scratch.nbComponents[i], scratch.targets[i]);
+        }
+
+        return (nbBlend);
+    }
+
+    size_t AnimationEvaluator::Evaluate(const std::vector<ClipEvaluation> &evaluations)
+    {
+        if (scratches.empty())
+            scratches.resize(1);
+        return (Evaluate(evaluations.data(), evaluations.size(), scratches[0]));
+    }
+
+    size_t AnimationEvaluator::Evaluate(const std::vector<ClipEvaluation> &evaluations, ThreadPool &pool)
+    {
+        size_t nbChunk = std::min(evaluations.size(), std::max(pool.GetNbThread(), static_cast<size_t>(1)) * 4);
+        if (nbChunk <= 1)
+            return (Evaluate(evaluations));
+
+        if (scratches.size() < nbChunk)
+            scratches.resize(nbChunk);
+        std::vector<size_t> nbChannels(nbChunk);
+        pool.ParallelFor(nbChunk, [&](size_t chunk)
+        {
+            size_t begin = chunk * evaluations.size() / nbChunk;
+            size_t end = (chunk + 1) * evaluations.size() / nbChunk;
+            nbChannels[chunk] = Evaluate(evaluations.data() + begin, end - begin, scratches[chunk]);
+        });
+
+        size_t nbChannel = 0;
+        for (size_t count: nbChannels)
+            nbChannel += count;
+        return (nbChannel);
+    }
+}
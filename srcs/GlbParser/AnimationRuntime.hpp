@@ -0,0 +1,94 @@
+#pragma once
+
+#include "GlbParser/GlbParser.hpp"
+
+namespace Glb
+{
+    struct ClipSampler
+    {
+        std::vector<float> timecodes;
+        std::vector<float> data; // CUBICSPLINE stores in tangent, value, out tangent for each key
+        size_t nbComponent;
+        Interpolation interpolation;
+    };
+
+    struct ClipChannel
+    {
+        size_t sampler;
+        int node;
+        AnimationPath path;
+    };
+
+    // Animation ready to be sampled: samplers shared by several channels are stored once
+    struct AnimationClip
+    {
+        std::string name;
+        std::vector<ClipSampler> samplers;
+        std::vector<ClipChannel> channels;
+        float duration; // last timecode of all the samplers
+    };
+
+    AnimationClip BuildAnimationClip(const Animation &animation);
+
+    struct LocalTransform
+    {
+        float translation[3];
+        float rotation[4]; // quaternion x, y, z, w
+        float scale[3];
+
+        LocalTransform();
+    };
+
+    LocalTransform DecomposeTransform(const ml::mat4 &transform);
+    std::vector<LocalTransform> GetRestPose(const std::vector<Node> &nodes); // starting point of the evaluations
+
+    // key found by the previous evaluation of each sampler, playing forward only looks at the next keys
+    struct ClipCursor
+    {
+        std::vector<size_t> keys;
+    };
+
+    // samples every channel of clip at time and writes the animated fields of transforms[channel.node],
+    // time is clamped to the clip, WEIGHTS channels are skipped
+    struct ClipEvaluation
+    {
+        const AnimationClip *clip;
+        float time;
+        ClipCursor *cursor;
+        LocalTransform *transforms;
+        size_t nbTransform;
+    };
+
+    enum class RotationBlend
+    {
+        SLERP,
+        NLERP
+    };
+
+    // keeps its scratch buffers between calls, one evaluator per thread calling Evaluate
+    class AnimationEvaluator
+    {
+        private:
+            struct Scratch
+            {
+                std::vector<float> keys; // 4 float4 per blend
+                std::vector<float> weights; // 4 per blend
+                std::vector<float> results; // 1 float4 per blend
+                std::vector<float*> targets;
+                std::vector<unsigned char> nbComponents; // 0 for rotations, normalized before being written
+            };
+
+            std::vector<Scratch> scratches;
+            RotationBlend rotationBlend;
+
+            size_t Evaluate(const ClipEvaluation *evaluations, size_t count, Scratch &scratch);
+
+        public:
+            AnimationEvaluator(RotationBlend rotationBlend = RotationBlend::SLERP);
+
+            // both return the number of channels evaluated, on the pool the evaluations
+            // must not write to the same transforms
+            size_t Evaluate(const std::vector<ClipEvaluation> &evaluations);
+            size_t Evaluate(const std::vector<ClipEvaluation> &evaluations, ThreadPool &pool);
+    };
+}
@@ -0,0 +1,289 @@
+#include "GlbParser/AssetCache.hpp"
+#include <algorithm>
+
+namespace Glb
+{
+    static size_t GetDecodedBytes(const Mesh &mesh)
+    {
+        size_t bytes = sizeof(Mesh);
+        for (const Primitive &primitive: mesh.primitives)
+            bytes += sizeof(Primitive) + primitive.vertices.size() * sizeof(Vertex) + primitive.indices.data.size();
+        return (bytes);
+    }
+
+    static size_t GetDecodedBytes(const Skin &skin)
+    {
+        return (sizeof(Skin) + skin.joints.size() * sizeof(Joint));
+    }
+
+    static size_t GetDecodedBytes(const Animation &animation)
+    {
+        size_t bytes = sizeof(Animation) + animation.channels.size() * sizeof(Channel);
+        for (const Sampler &sampler: animation.samplers)
+            bytes += sizeof(Sampler) + (sampler.timecodes.size() + sampler.data.size()) * sizeof(float);
+        return (bytes);
+    }
+
+    static size_t GetDecodedBytes(const DecodedImage &image)
+    {
+        size_t bytes = sizeof(DecodedImage);
+        for (const std::vector<uint8_t> &level: image.levels)
+            bytes += level.size();
+        return (bytes);
+    }
+
+    AssetCache::AssetCache(size_t byteBudget)
+    {
+        this->byteBudget = byteBudget;
+        bytes = 0;
+        clock = 0;
+        ResetStats();
+    }
+
+    std::shared_ptr<const void> AssetCache::Find(const ContentKey &key)
+    {
+        Shard &shard = GetShard(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end())
+            return (NULL);
+
+        Entry &entry = *it->second;
+        entry.lastUse.store(clock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+        nbHit.fetch_add(1, std::memory_order_relaxed);
+        bytesSaved.fetch_add(entry.bytes, std::memory_order_relaxed);
+        return (entry.value);
+    }
+
+    std::shared_ptr<const void> AssetCache::Insert(const ContentKey &key, const std::shared_ptr<const void> &value, size_t bytes)
+    {
+        {
+            Shard &shard = GetShard(key);
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            std::shared_ptr<Entry> &entry = shard.entries[key];
+            if (entry)
+            {
+                // another thread decoded the same content meanwhile
+                entry->lastUse.store(clock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+                return (entry->value);
+            }
+
+            entry = std::make_shared<Entry>();
+            entry->value = value;
+            entry->bytes = bytes;
+            entry->lastUse = clock.fetch_add(1, std::memory_order_relaxed);
+            this->bytes += bytes;
+        }
+
+        // down to 7/8 of the budget, so an insertion doesn't sort the entries every time
+        size_t budget = byteBudget;
+        if (this->bytes > budget)
+            Evict(budget - budget / 8);
+        return (value);
+    }
+
+    void AssetCache::Evict(size_t target)
+    {
+        std::lock_guard<std::mutex> evictionLock(evictionMutex);
+        if (bytes <= target)
+            return;
+
+        struct Candidate
+        {
+            uint64_t lastUse;
+            size_t shard;
+            ContentKey key;
+        };
+
+        std::vector<Candidate> candidates;
+        for (size_t i = 0; i < nbShard; i++)
+        {
+            std::shared_lock<std::shared_mutex> lock(shards[i].mutex);
+            for (const auto &it: shards[i].entries)
+                candidates.push_back({it.second->lastUse.load(std::memory_order_relaxed), i, it.first});
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) { return (a.lastUse < b.lastUse); });
+
+        for (const Candidate &candidate: candidates)
+        {
+            if (bytes <= target)
+                break;
+
+            // an entry used since the snapshot is skipped, its tick moved
+            Shard &shard = shards[candidate.shard];
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.entries.find(candidate.key);
+            if (it == shard.entries.end() || it->second->lastUse.load(std::memory_order_relaxed) != candidate.lastUse)
+                continue;
+            bytes -= it->second->bytes;
+            shard.entries.erase(it);
+            nbEviction.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T, typename Decode>
+    std::shared_ptr<const T> AssetCache::GetOrDecode(const ContentKey &key, Decode decode)
+    {
+        std::shared_ptr<const void> found = Find(key);
+        if (found)
+            return (std::static_pointer_cast<const T>(found));
+
+        nbMiss.fetch_add(1, std::memory_order_relaxed);
+        std::shared_ptr<const T> value = decode();
+        return (std::static_pointer_cast<const T>(Insert(key, value, GetDecodedBytes(*value))));
+    }
+
+    std::shared_ptr<const Mesh> AssetCache::GetMesh(const MeshSource &source)
+    {
+        return (GetOrDecode<Mesh>(GetContentKey(source), [&source]()
+        {
+            Mesh mesh = DecodeMesh(source);
+            mesh.name = std::string_view(); // shared by assets naming it differently, the name would point into the arena of the first one
+            return (std::make_shared<const Mesh>(std::move(mesh)));
+        }));
+    }
+
+    std::shared_ptr<const Skin> AssetCache::GetSkin(const SkinSource &source)
+    {
+        return (GetOrDecode<Skin>(GetContentKey(source), [&source]()
+        {
+            Skin skin = DecodeSkin(source);
+            skin.name = std::string_view(); // like the meshes
+            return (std::make_shared<const Skin>(std::move(skin)));
+        }));
+    }
+
+    std::shared_ptr<const Animation> AssetCache::GetAnimation(const AnimationSource &source)
+    {
+        return (GetOrDecode<Animation>(GetContentKey(source), [&source]()
+        {
+            Animation animation = DecodeAnimation(source);
+            animation.name = std::string_view(); // like the meshes
+            return (std::make_shared<const Animation>(std::move(animation)));
+        }));
+    }
+
+    std::shared_ptr<const DecodedImage> AssetCache::GetImage(const Image &image, const ImageDecodeOptions &options)
+    {
+        // like the ImagePipeline, images with the same bytes share the name of the first one
+        ContentKeyBuilder builder(ContentKind::IMAGE);
+        builder.Add(options.generateMips);
+        builder.Add(static_cast<bool>(options.decoder));
+        builder.AddSpan(image.buffer, image.bufferLength);
+
+        return (GetOrDecode<DecodedImage>(builder.Finish(), [&image, &options]()
+        {
+            return (std::make_shared<const DecodedImage>(DecodeImage(std::string(image.name), image.buffer, image.bufferLength, options)));
+        }));
+    }
+
+    void AssetCache::SetByteBudget(size_t byteBudget)
+    {
+        this->byteBudget = byteBudget;
+        if (bytes > byteBudget)
+            Evict(byteBudget);
+    }
+
+    void AssetCache::Clear()
+    {
+        std::lock_guard<std::mutex> evictionLock(evictionMutex);
+        for (Shard &shard: shards)
+        {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            for (const auto &it: shard.entries)
+                bytes -= it.second->bytes;
+            shard.entries.clear();
+        }
+    }
+
+    AssetCacheStats AssetCache::GetStats() const
+    {
+        AssetCacheStats stats;
+        stats.nbHit = nbHit;
+        stats.nbMiss = nbMiss;
+        stats.nbEviction = nbEviction;
+        stats.nbEntry = 0;
+        for (const Shard &shard: shards)
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            stats.nbEntry += shard.entries.size();
+        }
+        stats.bytes = bytes;
+        stats.byteBudget = byteBudget;
+        stats.bytesSaved = bytesSaved;
+        return (stats);
+    }
+
+    void AssetCache::ResetStats()
+    {
+        nbHit = 0;
+        nbMiss = 0;
+        nbEviction = 0;
+        bytesSaved = 0;
+    }
+
+    AssetCache &GetAssetCache()
+    {
+        static AssetCache cache;
+        return (cache);
+    }
+
+    static void SetNames(SharedGltf &shared, const GltfSources &sources)
+    {
+        for (const MeshSource &source: sources.meshes)
+            shared.meshNames.push_back(source.name);
+        for (const SkinSource &source: sources.skins)
+            shared.skinNames.push_back(source.name);
+        for (const AnimationSource &source: sources.animations)
+            shared.animationNames.push_back(source.name);
+    }
+
+    SharedGltf LoadSharedGltf(const GlbView &glb, AssetCache &cache)
+    {
+        SharedGltf shared;
+        GltfSources sources = LoadGltfSources(glb, shared.data);
+
+        SetNames(shared, sources);
+        for (const MeshSource &source: sources.meshes)
+            shared.meshes.push_back(cache.GetMesh(source));
+        for (const SkinSource &source: sources.skins)
+            shared.skins.push_back(cache.GetSkin(source));
+        for (const AnimationSource &source: sources.animations)
+            shared.animations.push_back(cache.GetAnimation(source));
+
+        return (shared);
+    }
+
+    SharedGltf LoadSharedGltf(const GlbView &glb, ThreadPool &pool, AssetCache &cache)
+    {
+        SharedGltf shared;
+        GltfSources sources = LoadGltfSources(glb, shared.data);
+        SetNames(shared, sources);
+        shared.meshes.resize(sources.meshes.size());
+        shared.skins.resize(sources.skins.size());
+        shared.animations.resize(sources.animations.size());
+
+        // one job per part, hashing is most of the work on a hit
+        size_t nbJob = sources.meshes.size() + sources.skins.size() + sources.animations.size();
+        pool.ParallelFor(nbJob, [&](size_t job)
+        {
+            if (job < sources.meshes.size())
+            {
+                shared.meshes[job] = cache.GetMesh(sources.meshes[job]);
+                return;
+            }
+            job -= sources.meshes.size();
+
+            if (job < sources.skins.size())
+            {
+                shared.skins[job] = cache.GetSkin(sources.skins[job]);
+                return;
+            }
+            job -= sources.skins.size();
+
+            shared.animations[job] = cache.GetAnimation(sources.animations[job]);
+        });
+
+        return (shared);
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <shared_mutex>
+#include <unordered_map>
+#include "GlbParser/ContentKey.hpp"
+#include "GlbParser/ImagePipeline.hpp"
+
+namespace Glb
+{
+    struct AssetCacheStats
+    {
+        size_t nbHit;
+        size_t nbMiss;
+        size_t nbEviction;
+        size_t nbEntry;
+        size_t bytes; // decoded bytes held by the cache
+        size_t byteBudget;
+        size_t bytesSaved; // decoded bytes handed out by hits instead of being decoded again
+
+        double HitRate() const { return (nbHit + nbMiss ? nbHit / double(nbHit + nbMiss) : 0); }
+    };
+
+    // decoded meshes, skins, animations and images shared between every asset using the same content.
+    // They are keyed by their ContentKey (with the decode options for the images), so two files holding
+    // the same mesh get the same handle, whatever they name it: the meshes, skins and animations handed out
+    // have an empty name. Handles are immutable and stay valid after an eviction,
+    // the least recently used entries are evicted when the decoded bytes go over the budget.
+    // Lookups only take a shared lock on one of the shards, two threads missing the same content at once
+    // both decode it and the first one inserted is kept
+    class AssetCache
+    {
+        private:
+            struct Entry
+            {
+                std::shared_ptr<const void> value;
+                size_t bytes;
+                std::atomic<uint64_t> lastUse; // tick of the cache clock, written by the lookups under the shared lock
+            };
+
+            struct Shard
+            {
+                mutable std::shared_mutex mutex;
+                std::unordered_map<ContentKey, std::shared_ptr<Entry>, ContentKeyHash> entries;
+            };
+
+            static constexpr size_t nbShard = 16;
+
+            Shard shards[nbShard];
+            std::atomic<size_t> byteBudget;
+            std::atomic<size_t> bytes;
+            std::atomic<uint64_t> clock;
+            std::atomic<size_t> nbHit;
+            std::atomic<size_t> nbMiss;
+            std::atomic<size_t> nbEviction;
+            std::atomic<size_t> bytesSaved;
+            std::mutex evictionMutex;
+
+            Shard &GetShard(const ContentKey &key) { return (shards[(key.hash >> 32) % nbShard]); }
+            std::shared_ptr<const void> Find(const ContentKey &key);
+            std::shared_ptr<const void> Insert(const ContentKey &key, const std::shared_ptr<const void> &value, size_t bytes);
+            void Evict(size_t target);
+
+            template <typename T, typename Decode>
+            std::shared_ptr<const T> GetOrDecode(const ContentKey &key, Decode decode);
+
+        public:
+            AssetCache(size_t byteBudget = 1ull << 30);
+            AssetCache(const AssetCache &) = delete;
+
+            AssetCache &operator=(const AssetCache &) = delete;
+
+            std::shared_ptr<const Mesh> GetMesh(const MeshSource &source);
+            std::shared_ptr<const Skin> GetSkin(const SkinSource &source);
+            std::shared_ptr<const Animation> GetAnimation(const AnimationSource &source);
+            // the custom decoder of the options can't be hashed, only whether there is one is part of the key
+            std::shared_ptr<const DecodedImage> GetImage(const Image &image, const ImageDecodeOptions &options = ImageDecodeOptions());
+
+            void SetByteBudget(size_t byteBudget); // evicts right away when lowered
+            void Clear(); // the handles already returned stay valid
+            AssetCacheStats GetStats() const;
+            void ResetStats();
+    };
+
+    AssetCache &GetAssetCache(); // process-wide, 1 GiB budget
+
+    // a GltfData whose meshes, skins and animations come from an AssetCache, the vectors of data are empty.
+    // The cached parts have no name, their names in this asset are in the name vectors, owned by data.arena
+    struct SharedGltf
+    {
+        GltfData data;
+        std::vector<std::shared_ptr<const Mesh>> meshes;
+        std::vector<std::shared_ptr<const Skin>> skins;
+        std::vector<std::shared_ptr<const Animation>> animations;
+        std::vector<std::string_view> meshNames;
+        std::vector<std::string_view> skinNames;
+        std::vector<std::string_view> animationNames;
+    };
+
+    SharedGltf LoadSharedGltf(const GlbView &glb, AssetCache &cache = GetAssetCache());
+    SharedGltf LoadSharedGltf(const GlbView &glb, ThreadPool &pool, AssetCache &cache = GetAssetCache());
+}
@@ -0,0 +1,266 @@
+#include "GlbParser/BatchLoader.hpp"
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <atomic>
+#include <condition_variable>
+
+namespace Glb
+{
+    template <typename T>
+    class BoundedQueue
+    {
+        private:
+            std::mutex mutex;
+            std::condition_variable notFull;
+            std::condition_variable notEmpty;
+            std::deque<T> items;
+            size_t capacity;
+            bool closed;
+
+        public:
+            explicit BoundedQueue(size_t capacity)
+            {
+                this->capacity = capacity > 0 ? capacity : 1;
+                closed = false;
+            }
+
+            void Push(T item)
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                notFull.wait(lock, [this]() { return (items.size() < capacity); });
+                items.push_back(std::move(item));
+                notEmpty.notify_one();
+            }
+
+            // false once the queue is closed and empty
+            bool Pop(T &item)
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                notEmpty.wait(lock, [this]() { return (!items.empty() || closed); });
+                if (items.empty())
+                    return (false);
+                item = std::move(items.front());
+                items.pop_front();
+                notFull.notify_one();
+                return (true);
+            }
+
+            void Close()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                closed = true;
+                notEmpty.notify_all();
+            }
+    };
+
+    class MemoryBudget
+    {
+        private:
+            std::mutex mutex;
+            std::condition_variable released;
+            size_t budget;
+            size_t used;
+
+        public:
+            explicit MemoryBudget(size_t budget)
+            {
+                this->budget = budget;
+                used = 0;
+            }
+
+            void Acquire(size_t bytes)
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                released.wait(lock, [&]() { return (used == 0 || used + bytes <= budget); });
+                used += bytes;
+            }
+
+            void Release(size_t bytes)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                used -= bytes;
+                released.notify_all();
+            }
+    };
+
+    struct PendingAsset
+    {
+        LoadedAsset asset;
+        GltfSources sources;
+    };
+
+    static double SecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // a stage closes the queue after it once its last worker is done
+    static void RunStage(size_t nbThread, std::vector<std::thread> &threads, const std::function<void()> &work, const std::function<void()> &onDone)
+    {
+        std::shared_ptr<std::atomic<size_t>> nbRunning = std::make_shared<std::atomic<size_t>>(nbThread);
+        for (size_t i = 0; i < nbThread; i++)
+        {
+            threads.emplace_back([work, onDone, nbRunning]()
+            {
+                work();
+                if (--(*nbRunning) == 0)
+                    onDone();
+            });
+        }
+    }
+
+    LoadManyStats LoadMany(const std::vector<std::string> &paths, const LoadManyCallback &callback, const LoadManyOptions &options)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        BoundedQueue<std::unique_ptr<PendingAsset>> parseQueue(options.queueSize);
+        BoundedQueue<std::unique_ptr<PendingAsset>> decodeQueue(options.queueSize);
+        MemoryBudget budget(options.memoryBudget);
+        std::atomic<size_t> nextPath(0);
+        std::mutex statsMutex;
+        std::mutex callbackMutex;
+
+        LoadManyStats stats = LoadManyStats();
+        stats.nbFile = paths.size();
+
+        // the pending asset is handed to the callback, failed or not, and its bytes leave the budget
+        auto finish = [&](std::unique_ptr<PendingAsset> pending, double decodeSeconds)
+        {
+            size_t byteSize = pending->asset.byteSize;
+            {
+                std::lock_guard<std::mutex> lock(statsMutex);
+                stats.decodeSeconds += decodeSeconds;
+                stats.nbByte += byteSize;
+                if (pending->asset.error)
+                    stats.nbFailed++;
+            }
+            {
+                std::lock_guard<std::mutex> lock(callbackMutex);
+                callback(pending->asset);
+            }
+            pending.reset();
+            budget.Release(byteSize);
+        };
+
+        auto read = [&]()
+        {
+            double seconds = 0;
+            for (size_t index = nextPath++; index < paths.size(); index = nextPath++)
+            {
+                std::unique_ptr<PendingAsset> pending = std::make_unique<PendingAsset>();
+                pending->asset.index = index;
+                pending->asset.path = paths[index];
+                pending->asset.byteSize = 0;
+
+                std::error_code error;
+                size_t byteSize = std::filesystem::file_size(paths[index], error);
+                pending->asset.byteSize = error ? 0 : byteSize;
+                budget.Acquire(pending->asset.byteSize);
+
+                std::chrono::steady_clock::time_point stageStart = std::chrono::steady_clock::now();
+                try
+                {
+                    pending->asset.file = std::make_shared<const MappedFile>(paths[index], options.populate);
+                }
+                catch (...)
+                {
+                    pending->asset.error = std::current_exception();
+                }
+                seconds += SecondsSince(stageStart);
+                parseQueue.Push(std::move(pending));
+            }
+            std::lock_guard<std::mutex> lock(statsMutex);
+            stats.readSeconds += seconds;
+        };
+
+        auto parse = [&]()
+        {
+            double seconds = 0;
+            std::unique_ptr<PendingAsset> pending;
+            while (parseQueue.Pop(pending))
+            {
+                std::chrono::steady_clock::time_point stageStart = std::chrono::steady_clock::now();
+                if (!pending->asset.error)
+                {
+                    try
+                    {
+                        GlbView glb = ParseGlbView(pending->asset.file->GetBytes());
+                        pending->sources = LoadGltfSources(glb, pending->asset.data);
+                    }
+                    catch (...)
+                    {
+                        pending->asset.error = std::current_exception();
+                        pending->asset.data = GltfData();
+                    }
+                }
+                seconds += SecondsSince(stageStart);
+                decodeQueue.Push(std::move(pending));
+            }
+            std::lock_guard<std::mutex> lock(statsMutex);
+            stats.parseSeconds += seconds;
+        };
+
+        auto decode = [&]()
+        {
+            std::unique_ptr<PendingAsset> pending;
+            while (decodeQueue.Pop(pending))
+            {
+                std::chrono::steady_clock::time_point stageStart = std::chrono::steady_clock::now();
+                if (!pending->asset.error)
+                {
+                    try
+                    {
+                        DecodeSources(pending->asset.data, pending->sources);
+                    }
+                    catch (...)
+                    {
+                        pending->asset.error = std::current_exception();
+                        pending->asset.data = GltfData();
+                    }
+                }
+                pending->sources = GltfSources(); // the decoded data doesn't point into the sources
+                finish(std::move(pending), SecondsSince(stageStart));
+            }
+        };
+
+        std::vector<std::thread> threads;
+        RunStage(std::max<size_t>(options.nbReadThread, 1), threads, read, [&]() { parseQueue.Close(); });
+        RunStage(std::max<size_t>(options.nbParseThread, 1), threads, parse, [&]() { decodeQueue.Close(); });
+        RunStage(std::max<size_t>(options.nbDecodeThread, 1), threads, decode, []() {});
+        for (std::thread &thread: threads)
+            thread.join();
+
+        stats.seconds = SecondsSince(start);
+        if (stats.seconds > 0)
+        {
+            stats.filesPerSecond = stats.nbFile / stats.seconds;
+            stats.megabytesPerSecond = stats.nbByte / (1024.0 * 1024.0) / stats.seconds;
+        }
+        return (stats);
+    }
+
+    std::vector<std::string> ListGlbFiles(const std::string &directory, bool recursive)
+    {
+        std::vector<std::string> paths;
+        auto add = [&](const std::filesystem::directory_entry &entry)
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".glb")
+                paths.push_back(entry.path().string());
+        };
+
+        if (recursive)
+        {
+            for (const std::filesystem::directory_entry &entry: std::filesystem::recursive_directory_iterator(directory))
+                add(entry);
+        }
+        else
+        {
+            for (const std::filesystem::directory_entry &entry: std::filesystem::directory_iterator(directory))
+                add(entry);
+        }
+        std::sort(paths.begin(), paths.end());
+        return (paths);
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <thread>
+#include <exception>
+#include "GlbParser/GlbParser.hpp"
+
+namespace Glb
+{
+    struct LoadManyOptions
+    {
+        size_t nbReadThread; // maps and reads the files
+        size_t nbParseThread; // JSON chunk and accessor resolution
+        size_t nbDecodeThread; // meshes, skins and animations
+        size_t queueSize; // files waiting between two stages, a full queue blocks the stage before it
+        size_t memoryBudget; // bytes of files between the read stage and the callback, a bigger file still goes through alone
+        bool populate; // reads the whole file in the read stage instead of page faulting while decoding
+
+        LoadManyOptions()
+        {
+            nbReadThread = 2;
+            nbParseThread = 2;
+            nbDecodeThread = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() : 1;
+            queueSize = 16;
+            memoryBudget = 1ull << 30;
+            populate = true;
+        }
+    };
+
+    struct LoadedAsset
+    {
+        size_t index; // in the paths given to LoadMany
+        std::string path;
+        size_t byteSize;
+        std::shared_ptr<const MappedFile> file; // images point into it
+        GltfData data;
+        std::exception_ptr error; // the file failed to load when set, data is then empty
+    };
+
+    struct LoadManyStats
+    {
+        size_t nbFile;
+        size_t nbFailed;
+        size_t nbByte;
+        double seconds;
+        double filesPerSecond;
+        double megabytesPerSecond;
+        double readSeconds; // summed over the workers of each stage
+        double parseSeconds;
+        double decodeSeconds;
+    };
+
+    // called from the decode workers, one asset at a time, in completion order; the asset can be moved out,
+    // the callback must not throw
+    typedef std::function<void(LoadedAsset &asset)> LoadManyCallback;
+
+    // loads every file through a read, parse and decode pipeline, each stage on its own threads,
+    // returns once all the files went through the callback
+    LoadManyStats LoadMany(const std::vector<std::string> &paths, const LoadManyCallback &callback, const LoadManyOptions &options = LoadManyOptions());
+    std::vector<std::string> ListGlbFiles(const std::string &directory, bool recursive = true); // sorted
+}
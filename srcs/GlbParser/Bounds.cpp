@@ -0,0 +1,26 @@
+#include "GlbParser/Bounds.hpp"
+
+namespace Glb
+{
+    // every output axis is the translation plus the extremes of each column term, which is exact for a box
+    Bounds TransformBounds(const Bounds &bounds, const float *matrix)
+    {
+        if (bounds.IsEmpty())
+            return (bounds);
+
+        Bounds transformed;
+        for (int r = 0; r < 3; r++)
+        {
+            transformed.min[r] = matrix[12 + r];
+            transformed.max[r] = matrix[12 + r];
+            for (int c = 0; c < 3; c++)
+            {
+                float a = matrix[c * 4 + r] * bounds.min[c];
+                float b = matrix[c * 4 + r] * bounds.max[c];
+                transformed.min[r] += std::min(a, b);
+                transformed.max[r] += std::max(a, b);
+            }
+        }
+        return (transformed);
+    }
+}
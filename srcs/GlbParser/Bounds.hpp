@@ -0,0 +1,57 @@
+#pragma once
+
+#include <limits>
+#include <algorithm>
+
+namespace Glb
+{
+    // axis aligned box, a default one is empty and extending it with a point gives that point
+    struct Bounds
+    {
+        float min[3];
+        float max[3];
+
+        Bounds()
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                min[i] = std::numeric_limits<float>::max();
+                max[i] = -std::numeric_limits<float>::max();
+            }
+        }
+
+        bool IsEmpty() const { return (min[0] > max[0] || min[1] > max[1] || min[2] > max[2]); }
+
+        void Extend(const float *point)
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                min[i] = std::min(min[i], point[i]);
+                max[i] = std::max(max[i], point[i]);
+            }
+        }
+
+        void Extend(const Bounds &bounds)
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                min[i] = std::min(min[i], bounds.min[i]);
+                max[i] = std::max(max[i], bounds.max[i]);
+            }
+        }
+
+        // half of the surface area, what the SAH compares
+        float HalfArea() const
+        {
+            if (IsEmpty())
+                return (0);
+            float x = max[0] - min[0];
+            float y = max[1] - min[1];
+            float z = max[2] - min[2];
+            return (x * y + y * z + z * x);
+        }
+    };
+
+    // box of the transformed box, matrix is 16 floats column major and affine
+    Bounds TransformBounds(const Bounds &bounds, const float *matrix);
+}
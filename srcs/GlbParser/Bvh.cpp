@@ -0,0 +1,199 @@
+#include "GlbParser/Bvh.hpp"
+#include <stdexcept>
+
+namespace Glb
+{
+    constexpr size_t maxBvhBin = 32;
+    constexpr size_t sahMaxDepth = 64;
+
+    struct BvhBuilder
+    {
+        const std::vector<Bounds> &bounds;
+        const BvhOptions &options;
+        std::vector<float> centroids; // 3 floats per item
+        std::vector<BvhNode> &nodes;
+        std::vector<uint32_t> &items;
+        size_t nbBin;
+        size_t maxLeafSize;
+
+        BvhBuilder(const std::vector<Bounds> &bounds, const BvhOptions &options, std::vector<BvhNode> &nodes, std::vector<uint32_t> &items):
+            bounds(bounds), options(options), nodes(nodes), items(items)
+        {
+            nbBin = std::min(std::max<size_t>(options.nbBin, 2), maxBvhBin);
+            maxLeafSize = std::max<size_t>(options.maxLeafSize, 1);
+        }
+
+        float Centroid(uint32_t item, size_t axis) const
+        {
+            return (centroids[item * 3 + axis]);
+        }
+
+        // best SAH split over the bins of every axis, false when keeping a leaf is cheaper or nothing can be split
+        bool FindSplit(const Bounds &nodeBounds, const Bounds &centroidBounds, size_t begin, size_t end, size_t &splitAxis, float &splitPosition) const
+        {
+            size_t count = end - begin;
+            float bestCost = static_cast<float>(count);
+            bool found = false;
+            float nodeArea = nodeBounds.HalfArea();
+            if (nodeArea <= 0)
+                return (false);
+
+            for (size_t axis = 0; axis < 3; axis++)
+            {
+                float low = centroidBounds.min[axis];
+                float extent = centroidBounds.max[axis] - low;
+                if (extent <= 0)
+                    continue;
+
+                Bounds binBounds[maxBvhBin];
+                size_t binCounts[maxBvhBin] = {};
+                float scale = nbBin / extent;
+                for (size_t i = begin; i < end; i++)
+                {
+                    size_t bin = std::min(static_cast<size_t>((Centroid(items[i], axis) - low) * scale), nbBin - 1);
+                    binBounds[bin].Extend(bounds[items[i]]);
+                    binCounts[bin]++;
+                }
+
+                // right side areas and counts for a split after each bin
+                float rightAreas[maxBvhBin];
+                size_t rightCounts[maxBvhBin];
+                Bounds right;
+                size_t rightCount = 0;
+                for (size_t bin = nbBin - 1; bin > 0; bin--)
+                {
+                    right.Extend(binBounds[bin]);
+                    rightCount += binCounts[bin];
+                    rightAreas[bin - 1] = right.HalfArea();
+                    rightCounts[bin - 1] = rightCount;
+                }
+
+                Bounds left;
+                size_t leftCount = 0;
+                for (size_t bin = 0; bin + 1 < nbBin; bin++)
+                {
+                    left.Extend(binBounds[bin]);
+                    leftCount += binCounts[bin];
+                    if (leftCount == 0 || rightCounts[bin] == 0)
+                        continue;
+
+                    float cost = options.traversalCost + (left.HalfArea() * leftCount + rightAreas[bin] * rightCounts[bin]) / nodeArea;
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        splitAxis = axis;
+                        splitPosition = low + (bin + 1) / scale;
+                        found = true;
+                    }
+                }
+            }
+            return (found);
+        }
+
+        // half of the items on each side along the longest centroid axis
+        size_t MedianSplit(const Bounds &centroidBounds, size_t begin, size_t end)
+        {
+            size_t axis = 0;
+            for (size_t i = 1; i < 3; i++)
+            {
+                if (centroidBounds.max[i] - centroidBounds.min[i] > centroidBounds.max[axis] - centroidBounds.min[axis])
+                    axis = i;
+            }
+
+            size_t middle = begin + (end - begin) / 2;
+            std::nth_element(items.begin() + begin, items.begin() + middle, items.begin() + end, [&](uint32_t a, uint32_t b)
+            {
+                return (Centroid(a, axis) < Centroid(b, axis));
+            });
+            return (middle);
+        }
+
+        void Build(size_t begin, size_t end, size_t depth)
+        {
+            size_t nodeIndex = nodes.size();
+            nodes.emplace_back();
+
+            Bounds nodeBounds;
+            Bounds centroidBounds;
+            for (size_t i = begin; i < end; i++)
+            {
+                nodeBounds.Extend(bounds[items[i]]);
+                centroidBounds.Extend(&centroids[items[i] * 3]);
+            }
+            nodes[nodeIndex].bounds = nodeBounds;
+
+            size_t count = end - begin;
+            size_t middle = end;
+            size_t axis = 0;
+            float position = 0;
+            if (depth < sahMaxDepth && FindSplit(nodeBounds, centroidBounds, begin, end, axis, position))
+            {
+                middle = std::partition(items.begin() + begin, items.begin() + end, [&](uint32_t item)
+                {
+                    return (Centroid(item, axis) < position);
+                }) - items.begin();
+                // float rounding can put a whole bin on the wrong side
+                if (middle == begin || middle == end)
+                    middle = MedianSplit(centroidBounds, begin, end);
+            }
+            else if (count > maxLeafSize)
+                middle = MedianSplit(centroidBounds, begin, end);
+
+            if (middle == end)
+            {
+                nodes[nodeIndex].offset = static_cast<uint32_t>(begin);
+                nodes[nodeIndex].count = static_cast<uint32_t>(count);
+                return;
+            }
+
+            Build(begin, middle, depth + 1);
+            nodes[nodeIndex].offset = static_cast<uint32_t>(nodes.size());
+            nodes[nodeIndex].count = 0;
+            Build(middle, end, depth + 1);
+        }
+    };
+
+    void Bvh::Build(const std::vector<Bounds> &bounds, const BvhOptions &options)
+    {
+        if (bounds.size() > UINT32_MAX)
+            throw(std::runtime_error("too many items for a Bvh"));
+
+        nodes.clear();
+        items.resize(bounds.size());
+        if (bounds.empty())
+            return;
+
+        BvhBuilder builder(bounds, options, nodes, items);
+        builder.centroids.resize(bounds.size() * 3);
+        for (size_t i = 0; i < bounds.size(); i++)
+        {
+            items[i] = static_cast<uint32_t>(i);
+            for (size_t axis = 0; axis < 3; axis++)
+                builder.centroids[i * 3 + axis] = (bounds[i].min[axis] + bounds[i].max[axis]) * 0.5f;
+        }
+
+        nodes.reserve(2 * bounds.size() / std::max<size_t>(options.maxLeafSize, 1) + 1);
+        builder.Build(0, bounds.size(), 0);
+        nodes.shrink_to_fit();
+    }
+
+    void Bvh::Refit(const std::vector<Bounds> &bounds)
+    {
+        // children are after their parent, walking backwards updates them first
+        for (size_t i = nodes.size(); i-- > 0;)
+        {
+            BvhNode &node = nodes[i];
+            node.bounds = Bounds();
+            if (node.count > 0)
+            {
+                for (uint32_t k = 0; k < node.count; k++)
+                    node.bounds.Extend(bounds[items[node.offset + k]]);
+            }
+            else
+            {
+                node.bounds.Extend(nodes[i + 1].bounds);
+                node.bounds.Extend(nodes[node.offset].bounds);
+            }
+        }
+    }
+}
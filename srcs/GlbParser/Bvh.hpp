@@ -0,0 +1,155 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "GlbParser/Bounds.hpp"
+
+namespace Glb
+{
+    // nodes are stored depth first, the left child of an inner node is the node right after it
+    struct BvhNode
+    {
+        Bounds bounds;
+        uint32_t offset; // inner node: right child, leaf: first item in Bvh::GetItems()
+        uint32_t count; // items of the leaf, 0 for an inner node
+    };
+
+    struct BvhOptions
+    {
+        size_t maxLeafSize;
+        size_t nbBin; // candidate split planes per axis, clamped to [2, 32]
+        float traversalCost; // cost of visiting a node relative to testing an item
+
+        BvhOptions()
+        {
+            maxLeafSize = 4;
+            nbBin = 16;
+            traversalCost = 1.0f;
+        }
+    };
+
+    // slab test, tEntry is where the ray enters the box (0 when it starts inside),
+    // inverse is 1 / direction per axis
+    inline bool IntersectBounds(const Bounds &bounds, const float *origin, const float *inverse, float tMax, float &tEntry)
+    {
+        float tNear = 0;
+        float tFar = tMax;
+        for (int i = 0; i < 3; i++)
+        {
+            float t0 = (bounds.min[i] - origin[i]) * inverse[i];
+            float t1 = (bounds.max[i] - origin[i]) * inverse[i];
+            tNear = std::max(tNear, std::min(t0, t1));
+            tFar = std::min(tFar, std::max(t0, t1));
+        }
+        tEntry = tNear;
+        return (tNear <= tFar);
+    }
+
+    // bounding volume hierarchy over boxes built with binned SAH, the items are indices in the boxes given to Build
+    class Bvh
+    {
+        private:
+            std::vector<BvhNode> nodes;
+            std::vector<uint32_t> items; // leaves point to ranges of it
+
+        public:
+            static constexpr size_t maxDepth = 96; // past 64 levels the splits are median ones
+
+            void Build(const std::vector<Bounds> &bounds, const BvhOptions &options = BvhOptions()); // boxes must not be empty
+            void Refit(const std::vector<Bounds> &bounds); // same items that moved, only the node boxes are recomputed
+
+            bool IsEmpty() const { return (nodes.empty()); }
+            const std::vector<BvhNode> &GetNodes() const { return (nodes); }
+            const std::vector<uint32_t> &GetItems() const { return (items); }
+
+            // visit(item) for the items of every leaf whose path only went through boxes where overlap(bounds) is true
+            template <typename Overlap, typename Visit>
+            void Query(const Overlap &overlap, const Visit &visit) const
+            {
+                if (nodes.empty())
+                    return;
+
+                uint32_t stack[maxDepth + 1];
+                size_t size = 0;
+                stack[size++] = 0;
+                while (size > 0)
+                {
+                    uint32_t index = stack[--size];
+                    const BvhNode &node = nodes[index];
+                    if (!overlap(node.bounds))
+                        continue;
+                    if (node.count > 0)
+                    {
+                        for (uint32_t i = 0; i < node.count; i++)
+                            visit(items[node.offset + i]);
+                        continue;
+                    }
+                    stack[size++] = node.offset;
+                    stack[size++] = index + 1;
+                }
+            }
+
+            // intersect(item, tMax) for the items of the leaves the ray goes through, nearest boxes first.
+            // it lowers tMax when the item is hit, the boxes behind are then skipped
+            template <typename Intersect>
+            void Raycast(const float *origin, const float *direction, float &tMax, const Intersect &intersect) const
+            {
+                if (nodes.empty())
+                    return;
+
+                float inverse[3];
+                for (int i = 0; i < 3; i++)
+                    inverse[i] = 1.0f / direction[i];
+
+                float tEntry;
+                if (!IntersectBounds(nodes[0].bounds, origin, inverse, tMax, tEntry))
+                    return;
+
+                struct Entry
+                {
+                    uint32_t node;
+                    float tEntry;
+                };
+                Entry stack[maxDepth + 1];
+                size_t size = 0;
+                stack[size++] = {0, tEntry};
+                while (size > 0)
+                {
+                    Entry entry = stack[--size];
+                    if (entry.tEntry > tMax)
+                        continue;
+
+                    const BvhNode &node = nodes[entry.node];
+                    if (node.count > 0)
+                    {
+                        for (uint32_t i = 0; i < node.count; i++)
+                            intersect(items[node.offset + i], tMax);
+                        continue;
+                    }
+
+                    float tLeft;
+                    float tRight;
+                    bool hitLeft = IntersectBounds(nodes[entry.node + 1].bounds, origin, inverse, tMax, tLeft);
+                    bool hitRight = IntersectBounds(nodes[node.offset].bounds, origin, inverse, tMax, tRight);
+                    if (hitLeft && hitRight)
+                    {
+                        // the nearest child is popped first
+                        if (tLeft <= tRight)
+                        {
+                            stack[size++] = {node.offset, tRight};
+                            stack[size++] = {entry.node + 1, tLeft};
+                        }
+                        else
+                        {
+                            stack[size++] = {entry.node + 1, tLeft};
+                            stack[size++] = {node.offset, tRight};
+                        }
+                    }
+                    else if (hitLeft)
+                        stack[size++] = {entry.node + 1, tLeft};
+                    else if (hitRight)
+                        stack[size++] = {node.offset, tRight};
+                }
+            }
+    };
+}
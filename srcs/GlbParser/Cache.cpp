@@ -0,0 +1,429 @@
+#include "GlbParser/Cache.hpp"
+#include <stdexcept>
+#include <fstream>
+#include <cstring>
+
+namespace Glb
+{
+    constexpr size_t cacheAlignment = 16;
+    constexpr size_t cacheHeaderSize = 32;
+
+    uint64_t HashFile(const std::string &path)
+    {
+        MappedFile file(path);
+        return (HashBytes(file.GetBytes()));
+    }
+
+    class CacheWriter
+    {
+        private:
+            std::ofstream file;
+            size_t offset;
+
+        public:
+            CacheWriter(const std::string &path)
+            {
+                file.open(path, std::ios::binary | std::ios::trunc);
+                if (!file.is_open())
+                    throw(std::runtime_error("failed to open " + path));
+                offset = 0;
+            }
+
+            void Write(const void *data, size_t size)
+            {
+                file.write(static_cast<const char*>(data), size);
+                offset += size;
+            }
+
+            template <typename T>
+            void WriteValue(T value)
+            {
+                Write(&value, sizeof(T));
+            }
+
+            void Align()
+            {
+                static const char padding[cacheAlignment] = {};
+                if (offset % cacheAlignment != 0)
+                    Write(padding, cacheAlignment - offset % cacheAlignment);
+            }
+
+            void WriteString(std::string_view str)
+            {
+                WriteValue<uint64_t>(str.size());
+                Write(str.data(), str.size());
+            }
+
+            void WriteBytes(const void *data, size_t size)
+            {
+                WriteValue<uint64_t>(size);
+                Align();
+                Write(data, size);
+            }
+
+            template <typename T, typename Allocator>
+            void WriteArray(const std::vector<T, Allocator> &values)
+            {
+                WriteValue<uint64_t>(values.size());
+                Align();
+                Write(values.data(), values.size() * sizeof(T));
+            }
+
+            void WriteMatrix(const ml::mat4 &matrix)
+            {
+                for (int i = 0; i < 4; i++)
+                    for (int j = 0; j < 4; j++)
+                        WriteValue<float>(matrix[i][j]);
+            }
+
+            void Finish(uint64_t sourceHash)
+            {
+                uint64_t size = offset;
+                file.seekp(0);
+                WriteValue<uint32_t>(cacheMagic);
+                WriteValue<uint32_t>(cacheVersion);
+                WriteValue<uint64_t>(sourceHash);
+                WriteValue<uint64_t>(size);
+                if (!file.good())
+                    throw(std::runtime_error("failed to write cache"));
+            }
+    };
+
+    class CacheReader
+    {
+        private:
+            std::string_view bytes;
+            size_t pos;
+
+        public:
+            CacheReader(std::string_view bytes, size_t pos)
+            {
+                this->bytes = bytes;
+                this->pos = pos;
+            }
+
+            const char *Read(size_t size)
+            {
+                if (size > bytes.size() - pos)
+                    throw(std::runtime_error("truncated cache"));
+                const char *data = bytes.data() + pos;
+                pos += size;
+                return (data);
+            }
+
+            template <typename T>
+            T ReadValue()
+            {
+                T value;
+                std::memcpy(&value, Read(sizeof(T)), sizeof(T));
+                return (value);
+            }
+
+            void Align()
+            {
+                if (pos % cacheAlignment != 0)
+                    Read(cacheAlignment - pos % cacheAlignment);
+            }
+
+            std::string_view ReadString()
+            {
+                size_t size = ReadValue<uint64_t>();
+                return (std::string_view(Read(size), size));
+            }
+
+            std::string_view ReadBytes()
+            {
+                size_t size = ReadValue<uint64_t>();
+                Align();
+                return (std::string_view(Read(size), size));
+            }
+
+            template <typename T, typename Allocator>
+            void ReadArray(std::vector<T, Allocator> &values)
+            {
+                size_t count = ReadValue<uint64_t>();
+                Align();
+                if (count > (bytes.size() - pos) / sizeof(T))
+                    throw(std::runtime_error("truncated cache"));
+                values.resize(count);
+                if (count != 0)
+                    std::memcpy(values.data(), Read(count * sizeof(T)), count * sizeof(T));
+            }
+
+            ml::mat4 ReadMatrix()
+            {
+                ml::mat4 matrix;
+                for (int i = 0; i < 4; i++)
+                    for (int j = 0; j < 4; j++)
+                        matrix[i][j] = ReadValue<float>();
+                return (matrix);
+            }
+    };
+
+    void SaveCache(const GltfData &data, const std::string &path, uint64_t sourceHash)
+    {
+        CacheWriter writer(path);
+
+        // header is written last, once the size is known
+        char header[cacheHeaderSize] = {};
+        writer.Write(header, cacheHeaderSize);
+
+        writer.WriteValue<int32_t>(data.rootScene);
+
+        writer.WriteValue<uint64_t>(data.scenes.size());
+        for (const Scene &scene: data.scenes)
+        {
+            writer.WriteString(scene.name);
+            writer.WriteArray(scene.nodes);
+        }
+
+        writer.WriteValue<uint64_t>(data.nodes.size());
+        for (const Node &node: data.nodes)
+        {
+            writer.WriteString(node.name);
+            writer.WriteMatrix(node.transform);
+            writer.WriteArray(node.children);
+            writer.WriteValue<int32_t>(node.mesh);
+            writer.WriteValue<int32_t>(node.skin);
+        }
+
+        writer.WriteValue<uint64_t>(data.meshes.size());
+        for (const Mesh &mesh: data.meshes)
+        {
+            writer.WriteString(mesh.name);
+            writer.WriteValue<uint64_t>(mesh.primitives.size());
+            for (const Primitive &primitive: mesh.primitives)
+            {
+                writer.WriteArray(primitive.vertices);
+                writer.WriteValue<uint32_t>(static_cast<uint32_t>(primitive.indices.componentType));
+                writer.WriteArray(primitive.indices.data);
+                writer.WriteValue<int32_t>(primitive.material);
+                for (int i = 0; i < 3; i++)
+                    writer.WriteValue<float>(primitive.bounds.min[i]);
+                for (int i = 0; i < 3; i++)
+                    writer.WriteValue<float>(primitive.bounds.max[i]);
+            }
+        }
+
+        writer.WriteValue<uint64_t>(data.skins.size());
+        for (const Skin &skin: data.skins)
+        {
+            writer.WriteString(skin.name);
+            writer.WriteValue<uint64_t>(skin.joints.size());
+            for (const Joint &joint: skin.joints)
+            {
+                writer.WriteValue<int32_t>(joint.nodeIndex);
+                writer.WriteMatrix(joint.inverseBindMatrix);
+            }
+        }
+
+        writer.WriteValue<uint64_t>(data.materials.size());
+        for (const Material &material: data.materials)
+        {
+            writer.WriteString(material.name);
+            for (int i = 0; i < 4; i++)
+                writer.WriteValue<float>(material.pbr.baseColorFactor[i]);
+            writer.WriteValue<int32_t>(material.pbr.baseColorTexture);
+            writer.WriteValue<float>(material.pbr.metallicFactor);
+            writer.WriteValue<float>(material.pbr.roughnessFactor);
+            writer.WriteValue<int32_t>(material.pbr.metallicRoughnessTexture);
+            writer.WriteValue<int32_t>(material.normalTexture);
+            writer.WriteValue<int32_t>(material.occlusionTexture);
+            writer.WriteValue<int32_t>(material.emissiveTexture);
+            for (int i = 0; i < 3; i++)
+                writer.WriteValue<float>(material.emissiveFactor[i]);
+            writer.WriteValue<uint8_t>(static_cast<uint8_t>(material.alphaMode));
+            writer.WriteValue<float>(material.alphaCutoff);
+            writer.WriteValue<uint8_t>(material.doubleSided);
+        }
+
+        writer.WriteValue<uint64_t>(data.images.size());
+        for (const Image &image: data.images)
+        {
+            writer.WriteString(image.name);
+            writer.WriteBytes(image.buffer, image.bufferLength);
+        }
+
+        writer.WriteValue<uint64_t>(data.textures.size());
+        for (const Texture &texture: data.textures)
+            writer.WriteValue<int32_t>(texture.source);
+
+        writer.WriteValue<uint64_t>(data.animations.size());
+        for (const Animation &animation: data.animations)
+        {
+            writer.WriteString(animation.name);
+            writer.WriteValue<uint64_t>(animation.channels.size());
+            for (size_t i = 0; i < animation.channels.size(); i++)
+            {
+                const Channel &channel = animation.channels[i];
+                writer.WriteValue<int32_t>(channel.sampler);
+                writer.WriteValue<int32_t>(channel.node);
+                writer.WriteValue<uint8_t>(static_cast<uint8_t>(channel.path));
+
+                const Sampler &sampler = animation.samplers[i];
+                writer.WriteArray(sampler.timecodes);
+                writer.WriteArray(sampler.data);
+                writer.WriteValue<uint64_t>(sampler.nbElement);
+                writer.WriteValue<uint8_t>(static_cast<uint8_t>(sampler.interpolation));
+            }
+        }
+
+        writer.Finish(sourceHash);
+    }
+
+    static bool CheckHeader(std::string_view bytes, uint64_t sourceHash)
+    {
+        if (bytes.size() < cacheHeaderSize)
+            return (false);
+
+        CacheReader reader(bytes, 0);
+        if (reader.ReadValue<uint32_t>() != cacheMagic)
+            return (false);
+        if (reader.ReadValue<uint32_t>() != cacheVersion)
+            return (false);
+        if (reader.ReadValue<uint64_t>() != sourceHash)
+            return (false);
+        if (reader.ReadValue<uint64_t>() != bytes.size())
+            return (false);
+        return (true);
+    }
+
+    bool IsCacheValid(const std::string &path, uint64_t sourceHash)
+    {
+        try
+        {
+            MappedFile file(path);
+            return (CheckHeader(file.GetBytes(), sourceHash));
+        }
+        catch (const std::exception &)
+        {
+            return (false);
+        }
+    }
+
+    CachedGltf LoadCache(const std::string &path, uint64_t sourceHash)
+    {
+        CachedGltf cache;
+        cache.file = MappedFile(path);
+        if (!CheckHeader(cache.file.GetBytes(), sourceHash))
+            throw(std::runtime_error(path + " is outdated or isn't a cache"));
+
+        GltfData &data = cache.data;
+        GltfArena &arena = *data.arena;
+        CacheReader reader(cache.file.GetBytes(), cacheHeaderSize);
+
+        data.rootScene = reader.ReadValue<int32_t>();
+
+        // scenes and nodes are built in place so their index lists are allocated in the arena
+        size_t nbScene = reader.ReadValue<uint64_t>();
+        data.scenes.reserve(nbScene);
+        for (size_t i = 0; i < nbScene; i++)
+        {
+            Scene &scene = data.scenes.emplace_back(arena.GetResource());
+            scene.name = arena.Intern(reader.ReadString());
+            reader.ReadArray(scene.nodes);
+        }
+
+        size_t nbNode = reader.ReadValue<uint64_t>();
+        data.nodes.reserve(nbNode);
+        for (size_t i = 0; i < nbNode; i++)
+        {
+            Node &node = data.nodes.emplace_back(arena.GetResource());
+            node.name = arena.Intern(reader.ReadString());
+            node.transform = reader.ReadMatrix();
+            reader.ReadArray(node.children);
+            node.mesh = reader.ReadValue<int32_t>();
+            node.skin = reader.ReadValue<int32_t>();
+        }
+
+        data.meshes.resize(reader.ReadValue<uint64_t>());
+        for (Mesh &mesh: data.meshes)
+        {
+            mesh.name = arena.Intern(reader.ReadString());
+            mesh.primitives.resize(reader.ReadValue<uint64_t>());
+            for (Primitive &primitive: mesh.primitives)
+            {
+                reader.ReadArray(primitive.vertices);
+                primitive.indices.componentType = static_cast<ComponentType>(reader.ReadValue<uint32_t>());
+                reader.ReadArray(primitive.indices.data);
+                primitive.material = reader.ReadValue<int32_t>();
+                for (int i = 0; i < 3; i++)
+                    primitive.bounds.min[i] = reader.ReadValue<float>();
+                for (int i = 0; i < 3; i++)
+                    primitive.bounds.max[i] = reader.ReadValue<float>();
+            }
+        }
+
+        data.skins.resize(reader.ReadValue<uint64_t>());
+        for (Skin &skin: data.skins)
+        {
+            skin.name = arena.Intern(reader.ReadString());
+            skin.joints.resize(reader.ReadValue<uint64_t>());
+            for (Joint &joint: skin.joints)
+            {
+                joint.nodeIndex = reader.ReadValue<int32_t>();
+                joint.inverseBindMatrix = reader.ReadMatrix();
+            }
+        }
+
+        data.materials.resize(reader.ReadValue<uint64_t>());
+        for (Material &material: data.materials)
+        {
+            material.name = arena.Intern(reader.ReadString());
+            float baseColorFactor[4];
+            for (int i = 0; i < 4; i++)
+                baseColorFactor[i] = reader.ReadValue<float>();
+            material.pbr.baseColorFactor = ml::vec4(baseColorFactor[0], baseColorFactor[1], baseColorFactor[2], baseColorFactor[3]);
+            material.pbr.baseColorTexture = reader.ReadValue<int32_t>();
+            material.pbr.metallicFactor = reader.ReadValue<float>();
+            material.pbr.roughnessFactor = reader.ReadValue<float>();
+            material.pbr.metallicRoughnessTexture = reader.ReadValue<int32_t>();
+            material.normalTexture = reader.ReadValue<int32_t>();
+            material.occlusionTexture = reader.ReadValue<int32_t>();
+            material.emissiveTexture = reader.ReadValue<int32_t>();
+            float emissiveFactor[3];
+            for (int i = 0; i < 3; i++)
+                emissiveFactor[i] = reader.ReadValue<float>();
+            material.emissiveFactor = ml::vec3(emissiveFactor[0], emissiveFactor[1], emissiveFactor[2]);
+            material.alphaMode = static_cast<AlphaMode>(reader.ReadValue<uint8_t>());
+            material.alphaCutoff = reader.ReadValue<float>();
+            material.doubleSided = reader.ReadValue<uint8_t>();
+        }
+
+        data.images.resize(reader.ReadValue<uint64_t>());
+        for (Image &image: data.images)
+        {
+            image.name = arena.Intern(reader.ReadString());
+            std::string_view bytes = reader.ReadBytes();
+            image.buffer = (unsigned char*)bytes.data();
+            image.bufferLength = bytes.size();
+        }
+
+        data.textures.resize(reader.ReadValue<uint64_t>());
+        for (Texture &texture: data.textures)
+            texture.source = reader.ReadValue<int32_t>();
+
+        data.animations.resize(reader.ReadValue<uint64_t>());
+        for (Animation &animation: data.animations)
+        {
+            animation.name = arena.Intern(reader.ReadString());
+            animation.channels.resize(reader.ReadValue<uint64_t>());
+            animation.samplers.resize(animation.channels.size());
+            for (size_t i = 0; i < animation.channels.size(); i++)
+            {
+                Channel &channel = animation.channels[i];
+                channel.sampler = reader.ReadValue<int32_t>();
+                channel.node = reader.ReadValue<int32_t>();
+                channel.path = static_cast<AnimationPath>(reader.ReadValue<uint8_t>());
+
+                Sampler &sampler = animation.samplers[i];
+                reader.ReadArray(sampler.timecodes);
+                reader.ReadArray(sampler.data);
+                sampler.nbElement = reader.ReadValue<uint64_t>();
+                sampler.interpolation = static_cast<Interpolation>(reader.ReadValue<uint8_t>());
+            }
+        }
+
+        return (cache);
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "GlbParser/GlbParser.hpp"
+#include "GlbParser/MappedFile.hpp"
+#include "GlbParser/Hash.hpp"
+
+namespace Glb
+{
+    // .glbc: flat binary copy of a GltfData, every array is stored 16-byte aligned
+    // as a count followed by its raw bytes, so loading it is a memcpy per array.
+    // the header holds the format version and a hash of the source .glb, a cache
+    // written by another version or from another source is refused
+    constexpr uint32_t cacheMagic = 0x43424C47; // "GLBC"
+    constexpr uint32_t cacheVersion = 6;
+
+    // images point into the mapped cache file, so it is kept alongside the data
+    struct CachedGltf
+    {
+        MappedFile file;
+        GltfData data;
+    };
+
+    uint64_t HashFile(const std::string &path);
+
+    void SaveCache(const GltfData &data, const std::string &path, uint64_t sourceHash);
+    bool IsCacheValid(const std::string &path, uint64_t sourceHash);
+    CachedGltf LoadCache(const std::string &path, uint64_t sourceHash);
+}
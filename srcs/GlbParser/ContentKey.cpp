@@ -0,0 +1,167 @@
+#include "GlbParser/ContentKey.hpp"
+#include "GlbParser/Hash.hpp"
+#include "GlbParser/GltfIndex.hpp"
+#include <cstring>
+#include <algorithm>
+
+namespace Glb
+{
+    void ContentKeyBuilder::AddFloat(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        Add(bits);
+    }
+
+    void ContentKeyBuilder::AddString(std::string_view string)
+    {
+        Add(string.size());
+        Add(HashBytes(string));
+    }
+
+    void ContentKeyBuilder::AddSpan(const unsigned char *data, size_t size)
+    {
+        spans.push_back({data, data ? data + size : data});
+    }
+
+    void ContentKeyBuilder::AddAccessor(const Accessor &accessor)
+    {
+        Add(accessor.count);
+        Add(accessor.nbComponent);
+        Add(accessor.nbRow);
+        Add(accessor.byteStride);
+        Add(static_cast<uint64_t>(accessor.componentType));
+        Add(accessor.normalized);
+        Add(accessor.hasBounds);
+        if (accessor.hasBounds)
+        {
+            for (size_t i = 0; i < std::min<size_t>(accessor.nbComponent, 4); i++)
+            {
+                AddFloat(accessor.min[i]);
+                AddFloat(accessor.max[i]);
+            }
+        }
+
+        // a compressed bufferView is hashed as stored, the same bytes decode to the same elements
+        if (accessor.compressed && !accessor.data)
+        {
+            const MeshoptCompression &compression = accessor.compressed->compression;
+            Add(accessor.compressedOffset);
+            Add(compression.byteStride);
+            Add(compression.count);
+            Add(static_cast<uint64_t>(compression.mode));
+            Add(static_cast<uint64_t>(compression.filter));
+            AddSpan(accessor.compressed->src, compression.byteLength);
+            return;
+        }
+
+        size_t size = 0;
+        if (accessor.data && accessor.count > 0)
+            size = (accessor.count - 1) * accessor.byteStride + ElementSize(accessor);
+        AddSpan(accessor.data, size);
+    }
+
+    ContentKey ContentKeyBuilder::Finish()
+    {
+        std::vector<Span> regions;
+        for (const Span &span: spans)
+        {
+            if (span.begin != span.end)
+                regions.push_back(span);
+        }
+        std::sort(regions.begin(), regions.end(), [](const Span &a, const Span &b) { return (a.begin < b.begin); });
+
+        size_t nbRegion = 0;
+        for (const Span &span: regions)
+        {
+            if (nbRegion > 0 && span.begin < regions[nbRegion - 1].end)
+                regions[nbRegion - 1].end = std::max(regions[nbRegion - 1].end, span.end);
+            else
+                regions[nbRegion++] = span;
+        }
+        regions.resize(nbRegion);
+
+        ContentKey key;
+        key.sourceBytes = 0;
+        key.kind = kind;
+        for (const Span &region: regions)
+        {
+            size_t size = region.end - region.begin;
+            Add(size);
+            Add(HashBytes(std::string_view(reinterpret_cast<const char*>(region.begin), size)));
+            key.sourceBytes += size;
+        }
+
+        for (const Span &span: spans)
+        {
+            if (span.begin == span.end)
+            {
+                Add(~uint64_t(0));
+                continue;
+            }
+            auto region = std::upper_bound(regions.begin(), regions.end(), span.begin, [](const unsigned char *begin, const Span &region) { return (begin < region.begin); }) - 1;
+            Add(region - regions.begin());
+            Add(span.begin - region->begin);
+        }
+
+        key.hash = HashBytes(std::string_view(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(uint64_t)));
+        return (key);
+    }
+
+    ContentKey GetContentKey(const MeshSource &source)
+    {
+        ContentKeyBuilder builder(ContentKind::MESH);
+        builder.Add(source.primitives.size());
+        for (const PrimitiveSource &primitive: source.primitives)
+        {
+            builder.Add(primitive.attributes.size());
+            for (const auto &attribute: primitive.attributes)
+            {
+                builder.AddString(attribute.first);
+                builder.AddAccessor(attribute.second);
+            }
+            builder.Add(primitive.hasIndices);
+            if (primitive.hasIndices)
+                builder.AddAccessor(primitive.indices);
+            builder.Add(static_cast<uint64_t>(primitive.material));
+        }
+        return (builder.Finish());
+    }
+
+    ContentKey GetContentKey(const SkinSource &source)
+    {
+        ContentKeyBuilder builder(ContentKind::SKIN);
+        builder.Add(source.joints.size());
+        for (int joint: source.joints)
+            builder.Add(static_cast<uint64_t>(joint));
+        builder.AddAccessor(source.inverseBindMatrices);
+        return (builder.Finish());
+    }
+
+    ContentKey GetContentKey(const AnimationSource &source)
+    {
+        ContentKeyBuilder builder(ContentKind::ANIMATION);
+        builder.Add(source.channels.size());
+        for (const Channel &channel: source.channels)
+        {
+            builder.Add(static_cast<uint64_t>(channel.sampler));
+            builder.Add(static_cast<uint64_t>(channel.node));
+            builder.Add(static_cast<uint64_t>(channel.path));
+        }
+        builder.Add(source.samplers.size());
+        for (const SamplerSource &sampler: source.samplers)
+        {
+            builder.Add(static_cast<uint64_t>(sampler.interpolation));
+            builder.AddAccessor(sampler.input);
+            builder.AddAccessor(sampler.output);
+        }
+        return (builder.Finish());
+    }
+
+    ContentKey GetContentKey(const Image &image)
+    {
+        ContentKeyBuilder builder(ContentKind::IMAGE);
+        builder.AddSpan(image.buffer, image.bufferLength);
+        return (builder.Finish());
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "GlbParser/GlbParser.hpp"
+
+namespace Glb
+{
+    enum class ContentKind
+    {
+        MESH,
+        SKIN,
+        ANIMATION,
+        IMAGE
+    };
+
+    // what a decoded part depends on: a hash of the bytes its accessors read, of their layouts and of the
+    // fields copied in the decoded value (materials, joints, channels). The names are left out, they belong
+    // to the asset and not to the content. Two parts with the same key decode to the same value, apart from
+    // the name, wherever their file is mapped
+    struct ContentKey
+    {
+        uint64_t hash;
+        size_t sourceBytes; // checked with the hash, like the ImagePipeline does with the length
+        ContentKind kind; // checked too, a collision between kinds would hand out a value of another type
+
+        bool operator==(const ContentKey &other) const { return (hash == other.hash && sourceBytes == other.sourceBytes && kind == other.kind); }
+        bool operator!=(const ContentKey &other) const { return (!(*this == other)); }
+    };
+
+    struct ContentKeyHash
+    {
+        size_t operator()(const ContentKey &key) const { return (key.hash); }
+    };
+
+    // the bytes read by the accessors are merged into regions hashed once each, so interleaved attributes
+    // don't hash their bufferView several times, and every accessor is located by its region and offset
+    class ContentKeyBuilder
+    {
+        private:
+            struct Span
+            {
+                const unsigned char *begin;
+                const unsigned char *end;
+            };
+
+            ContentKind kind;
+            std::vector<uint64_t> words;
+            std::vector<Span> spans; // one per AddSpan, empty for the accessors without data
+
+        public:
+            ContentKeyBuilder(ContentKind kind) : kind(kind) { Add(static_cast<uint64_t>(kind)); }
+
+            void Add(uint64_t word) { words.push_back(word); }
+            void AddFloat(float value);
+            void AddString(std::string_view string);
+            void AddSpan(const unsigned char *data, size_t size);
+            void AddAccessor(const Accessor &accessor);
+
+            ContentKey Finish();
+    };
+
+    ContentKey GetContentKey(const MeshSource &source);
+    ContentKey GetContentKey(const SkinSource &source);
+    ContentKey GetContentKey(const AnimationSource &source);
+    ContentKey GetContentKey(const Image &image); // its bytes
+}
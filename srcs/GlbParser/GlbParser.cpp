@@ -1,5 +1,6 @@
 #include "GlbParser/GlbParser.hpp"
-#include "Toolbox.hpp"
+#include "GlbParser/VertexKernels.hpp"
+#include "GlbParser/LoadStats.hpp"
 #include <stdexcept>
 #include <iostream>
 #include <fstream>
@@ -8,101 +9,221 @@ namespace Glb
 {
     std::pair<Json::Node, std::string> LoadBinaryFile(const std::string &path, bool generateFiles)
     {
-        if (!Toolbox::checkExtension(path, ".glb"))
-            throw(std::runtime_error("wrong extension, only parse .glb file"));
+        MappedGlb glb(path);
+        Json::Node gltfJson = LoadJson(glb.GetView());
+        std::string binStr(glb.GetView().bin);
 
-        std::string data = Toolbox::readFile(path, std::ios::binary);
-
-        if (data.size() < 12)            
-            throw(std::runtime_error("Invalid GLB file!"));
-
-        // Read GLB Header
-        uint32_t jsonLength = *reinterpret_cast<uint32_t*>(&data[12]);
-        std::string jsonStr(data.begin() + 20, data.begin() + 20 + jsonLength);
-        
-        // Parse JSON
-        stringIt it = jsonStr.begin();
-        Json::Node gltfJson = Json::ParseJson(jsonStr, it);
-        
-        // Extract binary buffer
-        uint32_t binOffset = 20 + jsonLength;
-        if (binOffset >= data.size())
-            throw(std::runtime_error("Invalid GLB file!"));
-        std::string binStr(data.begin() + binOffset + 8, data.end());
-        
         // Generate Files
         if (generateFiles)
         {
             std::string filename = path.substr(0, path.find_last_of("."));
             std::ofstream binFile(filename + ".bin", std::ios::binary);
-            binFile << binStr;
+            binFile.write(binStr.data(), binStr.size());
 
             gltfJson["buffers"][0]["bin"] = filename.substr(filename.find_last_of("/") + 1, filename.size()) + ".bin";
             std::ofstream gltfFile(filename + ".gltf");
             gltfFile << gltfJson;
         }
 
-        return (std::make_pair(gltfJson, binStr));
+        return (std::make_pair(std::move(gltfJson), std::move(binStr)));
+    }
+
+    Json::Node LoadJson(const GlbView &glb)
+    {
+        StageTimer timer(LoadStage::JSON_PARSE, glb.json.size());
+
+        // Json::ParseJson only works on std::string, the JSON chunk is small compared to the BIN one
+        std::string jsonStr(glb.json);
+        stringIt it = jsonStr.begin();
+        return (Json::ParseJson(jsonStr, it));
     }
 
     GltfData LoadGltf(Json::Node &gltfJson, const std::string &binStr)
+    {
+        GlbView glb;
+        glb.bin = binStr;
+        return (LoadGltf(gltfJson, glb));
+    }
+
+    GltfData LoadGltf(Json::Node &gltfJson, const GlbView &glb)
+    {
+        GltfData data;
+        GltfArena &arena = *data.arena;
+        GltfIndex gltfIndex = LoadIndex(gltfJson);
+
+        data.rootScene = gltfJson["scene"];
+
+        for (auto &&sceneJson: gltfJson["scenes"])
+            data.scenes.push_back(LoadScene(sceneJson, arena));
+
+        for (auto &&nodeJson: gltfJson["nodes"])
+            data.nodes.push_back(LoadNode(nodeJson, arena));
+
+        for (auto &&meshJson: gltfJson["meshes"])
+            data.meshes.push_back(LoadMesh(meshJson, gltfIndex, glb, arena));
+
+        if (gltfJson.KeyExist("skins"))
+        {
+            for (auto &&skinJson: gltfJson["skins"])
+                data.skins.push_back(LoadSkin(skinJson, gltfIndex, glb, arena));
+        }
+
+        if (gltfJson.KeyExist("materials"))
+        {
+            for (auto &&materialJson: gltfJson["materials"])
+                data.materials.push_back(LoadMaterial(materialJson, arena));
+        }
+
+        if (gltfJson.KeyExist("images"))
+        {
+            for (auto &&imageJson: gltfJson["images"])
+                data.images.push_back(LoadImage(imageJson, gltfIndex, glb, arena));
+        }
+
+        if (gltfJson.KeyExist("textures"))
+        {
+            for (auto &&textureJson: gltfJson["textures"])
+                data.textures.push_back(LoadTexture(textureJson));
+        }
+
+        if (gltfJson.KeyExist("animations"))
+        {
+            for (auto &&animationJson: gltfJson["animations"])
+                data.animations.push_back(LoadAnimation(animationJson, gltfIndex, glb, arena));
+        }
+
+        return (data);
+    }
+
+    GltfData LoadGltf(Json::Node &gltfJson, const GlbView &glb, ThreadPool &pool)
     {
         GltfData data;
+        GltfArena &arena = *data.arena;
 
+        // everything reading the JSON stays on this thread, the workers only read the BIN chunk
+        GltfIndex gltfIndex = LoadIndex(gltfJson);
         data.rootScene = gltfJson["scene"];
 
-        for (auto sceneJson: gltfJson["scenes"])
-            data.scenes.push_back(LoadScene(sceneJson));
+        for (auto &&sceneJson: gltfJson["scenes"])
+            data.scenes.push_back(LoadScene(sceneJson, arena));
 
-        for (auto nodeJson: gltfJson["nodes"])
-            data.nodes.push_back(LoadNode(nodeJson));
+        for (auto &&nodeJson: gltfJson["nodes"])
+            data.nodes.push_back(LoadNode(nodeJson, arena));
 
-        for (auto meshJson: gltfJson["meshes"])
-            data.meshes.push_back(LoadMesh(meshJson, gltfJson, binStr));
+        GltfSources sources;
+        sources.decodedViews = gltfIndex.decodedViews;
+        for (auto &&meshJson: gltfJson["meshes"])
+            sources.meshes.push_back(LoadMeshSource(meshJson, gltfIndex, glb, arena));
 
         if (gltfJson.KeyExist("skins"))
         {
-            for (auto skinJson: gltfJson["skins"])
-                data.skins.push_back(LoadSkin(skinJson, gltfJson, binStr));
+            for (auto &&skinJson: gltfJson["skins"])
+                sources.skins.push_back(LoadSkinSource(skinJson, gltfIndex, glb, arena));
         }
 
         if (gltfJson.KeyExist("materials"))
         {
-            for (auto materialJson: gltfJson["materials"])
-                data.materials.push_back(LoadMaterial(materialJson));
+            for (auto &&materialJson: gltfJson["materials"])
+                data.materials.push_back(LoadMaterial(materialJson, arena));
         }
 
         if (gltfJson.KeyExist("images"))
         {
-            for (auto imageJson: gltfJson["images"])
-                data.images.push_back(LoadImage(imageJson, gltfJson, binStr));
+            for (auto &&imageJson: gltfJson["images"])
+                data.images.push_back(LoadImage(imageJson, gltfIndex, glb, arena));
+        }
+
+        if (gltfJson.KeyExist("textures"))
+        {
+            for (auto &&textureJson: gltfJson["textures"])
+                data.textures.push_back(LoadTexture(textureJson));
         }
 
         if (gltfJson.KeyExist("animations"))
         {
-            for (auto animationJson: gltfJson["animations"])
-                data.animations.push_back(LoadAnimation(animationJson, gltfJson, binStr));
+            for (auto &&animationJson: gltfJson["animations"])
+                sources.animations.push_back(LoadAnimationSource(animationJson, gltfIndex, glb, arena));
         }
 
+        DecodeSources(data, sources, pool);
+
         return (data);
     }
 
-    Scene LoadScene(Json::Node &sceneJson)
+    GltfData LoadGltf(Json::Node &gltfJson, const GlbView &glb, size_t nbThread)
+    {
+        ThreadPool pool(nbThread);
+        return (LoadGltf(gltfJson, glb, pool));
+    }
+
+    void DecodeSources(GltfData &data, const GltfSources &sources)
+    {
+        for (const MeshSource &meshSource: sources.meshes)
+            data.meshes.push_back(DecodeMesh(meshSource));
+        for (const SkinSource &skinSource: sources.skins)
+            data.skins.push_back(DecodeSkin(skinSource));
+        for (const AnimationSource &animationSource: sources.animations)
+            data.animations.push_back(DecodeAnimation(animationSource));
+    }
+
+    void DecodeSources(GltfData &data, const GltfSources &sources, ThreadPool &pool)
     {
-        Scene scene;
+        const std::vector<MeshSource> &meshSources = sources.meshes;
+        const std::vector<SkinSource> &skinSources = sources.skins;
+        const std::vector<AnimationSource> &animationSources = sources.animations;
+
+        // every job writes in its own preallocated slot, so the result doesn't depend on scheduling
+        std::vector<std::pair<size_t, size_t>> primitiveJobs;
+        data.meshes.resize(meshSources.size());
+        for (size_t i = 0; i < meshSources.size(); i++)
+        {
+            data.meshes[i].name = meshSources[i].name;
+            data.meshes[i].primitives.resize(meshSources[i].primitives.size());
+            for (size_t j = 0; j < meshSources[i].primitives.size(); j++)
+                primitiveJobs.push_back({i, j});
+        }
+        data.skins.resize(skinSources.size());
+        data.animations.resize(animationSources.size());
+
+        size_t nbJob = primitiveJobs.size() + skinSources.size() + animationSources.size();
+        pool.ParallelFor(nbJob, [&](size_t job)
+        {
+            if (job < primitiveJobs.size())
+            {
+                size_t mesh = primitiveJobs[job].first;
+                size_t primitive = primitiveJobs[job].second;
+                data.meshes[mesh].primitives[primitive] = DecodePrimitive(meshSources[mesh].primitives[primitive]);
+                return;
+            }
+            job -= primitiveJobs.size();
+
+            if (job < skinSources.size())
+            {
+                data.skins[job] = DecodeSkin(skinSources[job]);
+                return;
+            }
+            job -= skinSources.size();
 
-        scene.name = std::string(sceneJson["name"]);
+            data.animations[job] = DecodeAnimation(animationSources[job]);
+        });
+    }
+
+    Scene LoadScene(Json::Node &sceneJson, GltfArena &arena)
+    {
+        Scene scene(arena.GetResource());
+
+        scene.name = arena.Intern(std::string(sceneJson["name"]));
         for (size_t nodeIndex: sceneJson["nodes"])
             scene.nodes.push_back(nodeIndex);
 
         return (scene);
     }
     
-    Node LoadNode(Json::Node &nodeJson)
+    Node LoadNode(Json::Node &nodeJson, GltfArena &arena)
     {
-        Node node;
+        Node node(arena.GetResource());
         
-        node.name = std::string(nodeJson["name"]);
+        node.name = arena.Intern(std::string(nodeJson["name"]));
         node.transform = CalculateTransform(nodeJson);
 
         if (nodeJson.KeyExist("children"))
@@ -138,6 +259,11 @@ namespace Glb
         if (nodeJson.KeyExist("rotation"))
             quat = {nodeJson["rotation"][0], nodeJson["rotation"][1], nodeJson["rotation"][2], nodeJson["rotation"][3]};
 
+        return (CalculateTransform(translate, quat, scale));
+    }
+
+    ml::mat4 CalculateTransform(ml::vec3 translate, ml::vec4 quat, ml::vec3 scale)
+    {
         ml::mat4 transform = ml::translate(ml::mat4(1.0f), translate)
                 * ml::rotate(ml::mat4(1.0f), quat)
                 * ml::scale(ml::mat4(1.0f), scale);  
@@ -145,202 +271,270 @@ namespace Glb
         return (transform);
     }
 
-    Mesh LoadMesh(Json::Node &meshJson, Json::Node &gltfJson, const std::string &binStr)
+    Mesh LoadMesh(Json::Node &meshJson, const GltfIndex &gltfIndex, const GlbView &glb, GltfArena &arena)
+    {
+        return (DecodeMesh(LoadMeshSource(meshJson, gltfIndex, glb, arena)));
+    }
+
+    MeshSource LoadMeshSource(Json::Node &meshJson, const GltfIndex &gltfIndex, const GlbView &glb, GltfArena &arena)
+    {
+        MeshSource source;
+
+        source.name = arena.Intern(std::string(meshJson["name"]));
+        for (auto &&primitiveJson: meshJson["primitives"])
+            source.primitives.push_back(LoadPrimitiveSource(primitiveJson, gltfIndex, glb));
+
+        return (source);
+    }
+
+    Mesh DecodeMesh(const MeshSource &source)
     {
         Mesh mesh;
 
-        mesh.name = std::string(meshJson["name"]);
-        for (auto primitiveJson: meshJson["primitives"])
-            mesh.primitives.push_back(LoadPrimitive(primitiveJson, gltfJson, binStr));
+        mesh.name = source.name;
+        mesh.primitives.reserve(source.primitives.size());
+        for (const PrimitiveSource &primitiveSource: source.primitives)
+            mesh.primitives.push_back(DecodePrimitive(primitiveSource));
 
         return (mesh);
     }
 
-    Primitive LoadPrimitive(Json::Node &primitiveJson, Json::Node &gltfJson, const std::string &binStr)
+    Primitive LoadPrimitive(Json::Node &primitiveJson, const GltfIndex &gltfIndex, const GlbView &glb)
     {
-        Primitive primitive;
+        return (DecodePrimitive(LoadPrimitiveSource(primitiveJson, gltfIndex, glb)));
+    }
+
+    PrimitiveSource LoadPrimitiveSource(Json::Node &primitiveJson, const GltfIndex &gltfIndex, const GlbView &glb)
+    {
+        PrimitiveSource source;
+
+        Json::Node &attributes = primitiveJson["attributes"];
+        for (auto it = attributes.begin(); it != attributes.end(); it++)
+            source.attributes[it.key()] = ResolveAccessor(gltfIndex, glb, (int)it.value());
+
+        source.hasIndices = primitiveJson.KeyExist("indices");
+        if (source.hasIndices)
+            source.indices = ResolveAccessor(gltfIndex, glb, primitiveJson["indices"]);
 
-        LoadVertices(primitive, gltfJson, binStr, primitiveJson["attributes"]);
-        LoadIndices(primitive, gltfJson, binStr, primitiveJson["indices"]);
         if (primitiveJson.KeyExist("material"))
-            primitive.material = primitiveJson["material"];
+            source.material = primitiveJson["material"];
         else
-            primitive.material = -1;
+            source.material = -1;
 
-        return (primitive);
+        return (source);
     }
 
-    void LoadVertices(Primitive &primitive, Json::Node &gltfJson, const std::string &binStr, Json::Node &attributes)
+    Primitive DecodePrimitive(const PrimitiveSource &source)
     {
-        std::vector<float> positions;
-        std::vector<float> textureCoords;
-        std::vector<float> normals;
-        std::vector<uint16_t> joints;
-        std::vector<float> weights;
+        Primitive primitive;
 
-        for (auto it = attributes.begin(); it != attributes.end(); it++)
+        DecodeVertices(primitive, source.attributes);
+        if (source.hasIndices)
+            DecodeIndices(primitive, source.indices);
+        primitive.material = source.material;
+
+        // min and max are required on POSITION accessors, the positions are only scanned without them
+        const Accessor &position = source.attributes.at("POSITION");
+        if (position.hasBounds && position.nbComponent == nbFloatPerPosition)
         {
-            auto accessor = gltfJson["accessors"][(int)it.value()];
-            size_t bufferViewIndex = accessor["bufferView"];
-            size_t count = accessor["count"];
-            size_t componentType = accessor["componentType"];
-            std::string type = accessor["type"];
-            
-            size_t nbFloat = 0;
-            if (type == "VEC2")
-                nbFloat = 2;
-            else if (type == "VEC3")
-                nbFloat = 3;
-            else if (type == "VEC4")
-                nbFloat = 4;
-            else
-                std::cerr << "type unknown: " << type << std::endl;
-            
-            auto bufferView = gltfJson["bufferViews"][bufferViewIndex];
-            size_t byteOffset = bufferView["byteOffset"];
-            void* buffer = (void*)(binStr.data() + byteOffset);
-
-            size_t size = count * nbFloat;
-            if (it.key() == "POSITION")
-            {
-                float *data = (float*)buffer;
-                positions.reserve(size);
-                for (size_t i = 0; i < size; i++)
-                    positions.push_back(data[i]);
-            }
-            else if (it.key() == "TEXCOORD_0")
-            {
-                float *data = (float*)buffer;
-                textureCoords.reserve(size);
-                for (size_t i = 0; i < size; i++)
-                    textureCoords.push_back(data[i]);
-            }
-            else if (it.key() == "NORMAL")
-            {
-                float *data = (float*)buffer;
-                normals.reserve(size);
-                for (size_t i = 0; i < size; i++)
-                    normals.push_back(data[i]);
-            }
-            else if (it.key() == "JOINTS_0")
-            {
-                joints.reserve(size);
-                if (componentType == 5121) // GL_UNSIGNED_BYTE
-                {
-                    uint8_t *data = (uint8_t*)buffer;
-                    for (size_t i = 0; i < size; i++)
-                        joints.push_back((uint16_t)data[i]);
-                }
-                else if (componentType == 5123) // GL_UNSIGNED_SHORT
-                {
-                    uint16_t *data = (uint16_t*)buffer;
-                    for (size_t i = 0; i < size; i++)
-                        joints.push_back(data[i]);
-                }
-            }
-            else if (it.key() == "WEIGHTS_0")
-            {
-                float *data = (float*)buffer;
-                weights.reserve(size);
-                for (size_t i = 0; i < size; i++)
-                    weights.push_back(data[i]);
-            }
+            std::copy(position.min, position.min + 3, primitive.bounds.min);
+            std::copy(position.max, position.max + 3, primitive.bounds.max);
         }
-        
-        size_t count = positions.size() / 3;
-        std::vector<Vertex> vertices(count);
-        for (size_t i = 0; i < count; i++)
-        {
-            vertices[i].x = positions[i * nbFloatPerPosition + 0];
-            vertices[i].y = positions[i * nbFloatPerPosition + 1];
-            vertices[i].z = positions[i * nbFloatPerPosition + 2];
-            if (textureCoords.size() != 0)
-            {
-                vertices[i].u = textureCoords[i * nbFloatPerTexCoord + 0];
-                vertices[i].v = textureCoords[i * nbFloatPerTexCoord + 1];
-            }
-            if (normals.size() != 0)
-            {
-                vertices[i].nx = normals[i * nbFloatPerNormal + 0];
-                vertices[i].ny = normals[i * nbFloatPerNormal + 1];
-                vertices[i].nz = normals[i * nbFloatPerNormal + 2];
-            }
-            if (joints.size() != 0)
-            {
-                vertices[i].j1 = joints[i * nbFloatPerJoint + 0];
-                vertices[i].j2 = joints[i * nbFloatPerJoint + 1];
-                vertices[i].j3 = joints[i * nbFloatPerJoint + 2];
-                vertices[i].j4 = joints[i * nbFloatPerJoint + 3];
-            }
-            if (weights.size() != 0)
-            {
-                vertices[i].w1 = weights[i * nbFloatPerWeight + 0];
-                vertices[i].w2 = weights[i * nbFloatPerWeight + 1];
-                vertices[i].w3 = weights[i * nbFloatPerWeight + 2];
-                vertices[i].w4 = weights[i * nbFloatPerWeight + 3];
-            }
+        else
+            primitive.bounds = ComputeBounds(primitive.vertices);
 
-        }
-        primitive.vertices = vertices;
+        return (primitive);
     }
 
-    void LoadIndices(Primitive &primitive, Json::Node &gltfJson, const std::string &binStr, int indiceIndex)
+    Bounds ComputeBounds(const std::vector<Vertex> &vertices)
     {
-        auto accessor = gltfJson["accessors"][indiceIndex];
-        size_t bufferViewIndex = accessor["bufferView"];
-        size_t count = accessor["count"];
-        
-        auto bufferView = gltfJson["bufferViews"][bufferViewIndex];
-        size_t byteOffset = bufferView["byteOffset"];
-        uint16_t* buffer = (uint16_t*)(binStr.data() + byteOffset);
-        std::vector<uint16_t> indices;
-        for (size_t i = 0; i < count; i++)
-            indices.push_back(buffer[i]);
-        
-        primitive.indices = indices;
+        Bounds bounds;
+        if (!vertices.empty())
+            Kernels::PositionBounds(&vertices[0].x, sizeof(Vertex), vertices.size(), bounds.min, bounds.max);
+        return (bounds);
     }
 
-    Skin LoadSkin(Json::Node &skinJson, Json::Node &gltfJson, const std::string &binStr)
+    QuantizedPrimitive LoadQuantizedPrimitive(Json::Node &primitiveJson, const GltfIndex &gltfIndex, const GlbView &glb, const QuantizationOptions &options)
     {
-        Skin skin;
+        return (DecodeQuantizedPrimitive(LoadPrimitiveSource(primitiveJson, gltfIndex, glb), options));
+    }
+
+    QuantizedPrimitive DecodeQuantizedPrimitive(const PrimitiveSource &source, const QuantizationOptions &options)
+    {
+        QuantizedPrimitive primitive;
+
+        DecodeQuantizedVertices(primitive.vertices, primitive.dequantization, source.attributes, options);
+        if (source.hasIndices)
+            DecodeIndices(primitive.indices, source.indices);
+        primitive.material = source.material;
+
+        return (primitive);
+    }
+
+    // decodes one attribute straight into its field of every vertex
+    template <typename T>
+    static void LoadAttribute(const std::map<std::string, Accessor> &accessors, const std::string &name, T *field, size_t nbComponent, size_t count)
+    {
+        auto it = accessors.find(name);
+        if (it == accessors.end())
+            return;
+
+        const Accessor &accessor = it->second;
+        if (accessor.count != count)
+            throw(std::runtime_error(name + " has " + std::to_string(accessor.count) + " elements instead of " + std::to_string(count)));
+        if (accessor.nbComponent != nbComponent)
+            throw(std::runtime_error(name + " has " + std::to_string(accessor.nbComponent) + " components instead of " + std::to_string(nbComponent)));
 
+        DecodeAttribute(accessor, field, sizeof(Vertex));
+    }
+
+    void LoadVertices(Primitive &primitive, const GltfIndex &gltfIndex, const GlbView &glb, Json::Node &attributes)
+    {
+        std::map<std::string, Accessor> accessors;
+        for (auto it = attributes.begin(); it != attributes.end(); it++)
+            accessors[it.key()] = ResolveAccessor(gltfIndex, glb, (int)it.value());
+
+        DecodeVertices(primitive, accessors);
+    }
+
+    void DecodeVertices(Primitive &primitive, const std::map<std::string, Accessor> &resolvedAccessors)
+    {
+        LoadedBufferViews views;
+        const std::map<std::string, Accessor> &accessors = views.Load(resolvedAccessors);
+        auto position = accessors.find("POSITION");
+        if (position == accessors.end())
+            throw(std::runtime_error("primitive without POSITION attribute"));
+
+        size_t count = position->second.count;
+        StageTimer timer(LoadStage::VERTEX_INTERLEAVE, count * sizeof(Vertex));
+        primitive.vertices.assign(count, Vertex());
+        if (count == 0)
+            return;
+
+        Vertex &vertices = primitive.vertices[0];
+        LoadAttribute(accessors, "POSITION", &vertices.x, nbFloatPerPosition, count);
+        LoadAttribute(accessors, "TEXCOORD_0", &vertices.u, nbFloatPerTexCoord, count);
+        LoadAttribute(accessors, "NORMAL", &vertices.nx, nbFloatPerNormal, count);
+        LoadAttribute(accessors, "JOINTS_0", &vertices.j1, nbFloatPerJoint, count);
+        LoadAttribute(accessors, "WEIGHTS_0", &vertices.w1, nbFloatPerWeight, count);
+    }
+
+    VertexBuffer DecodeVertexBuffer(const PrimitiveSource &source, const VertexLayout &layout)
+    {
+        return (DecodeVertexBuffer(source.attributes, layout));
+    }
+
+    void LoadIndices(Primitive &primitive, const GltfIndex &gltfIndex, const GlbView &glb, int indiceIndex)
+    {
+        DecodeIndices(primitive, ResolveAccessor(gltfIndex, glb, indiceIndex));
+    }
+
+    void DecodeIndices(Primitive &primitive, const Accessor &accessor)
+    {
+        DecodeIndices(primitive.indices, accessor);
+    }
+
+    Skin LoadSkin(Json::Node &skinJson, const GltfIndex &gltfIndex, const GlbView &glb, GltfArena &arena)
+    {
+        return (DecodeSkin(LoadSkinSource(skinJson, gltfIndex, glb, arena)));
+    }
+
+    SkinSource LoadSkinSource(Json::Node &skinJson, const GltfIndex &gltfIndex, const GlbView &glb, GltfArena &arena)
+    {
+        SkinSource source;
+
+        source.name = arena.Intern(std::string(skinJson["name"]));
         size_t matrixIndex = skinJson["inverseBindMatrices"];
+        source.inverseBindMatrices = ResolveAccessor(gltfIndex, glb, matrixIndex);
+        for (int joint: skinJson["joints"])
+            source.joints.push_back(joint);
 
-        auto accessor = gltfJson["accessors"][matrixIndex];
-        size_t bufferViewIndex = accessor["bufferView"];
-        size_t count = accessor["count"];
-        
-        auto bufferView = gltfJson["bufferViews"][bufferViewIndex];
-        size_t byteOffset = bufferView["byteOffset"];
-        float* buffer = (float*)(binStr.data() + byteOffset);
-        
+        return (source);
+    }
+
+    Skin DecodeSkin(const SkinSource &source)
+    {
+        LoadedBufferViews views;
+        Accessor inverseBindMatrices = views.Load(source.inverseBindMatrices);
+        StageTimer timer(LoadStage::SKIN, source.joints.size() * 16 * sizeof(float));
+        Skin skin;
+
+        skin.name = source.name;
         size_t nbFloat = 16;
-        std::vector<ml::mat4> matrices;
-        matrices.reserve(count);
-        for (size_t i = 0; i < count; i++)
+        if (inverseBindMatrices.nbComponent != nbFloat)
+            throw(std::runtime_error("skin inverse bind matrices have " + std::to_string(inverseBindMatrices.nbComponent) + " components instead of 16"));
+        AccessorView<float> view(inverseBindMatrices);
+        if (view.Count() < source.joints.size())
+            throw(std::runtime_error("skin has less inverse bind matrices than joints"));
+
+        skin.joints.reserve(source.joints.size());
+        for (size_t i = 0; i < source.joints.size(); i++)
         {
+            float buffer[16];
+            view.Read(i, buffer);
+
             ml::mat4 matrix;
             for (size_t j = 0; j < nbFloat; j++)
-                matrix[j % 4][j / 4] = buffer[i * nbFloat + j];
-            matrices.push_back(matrix);
+                matrix[j % 4][j / 4] = buffer[j];
+            skin.joints.push_back({source.joints[i], matrix});
         }
 
-        size_t i = 0;
-        for (auto joint: skinJson["joints"])
+        return (skin);
+    }
+
+    AnimationPath ParseAnimationPath(std::string_view path)
+    {
+        if (path == "translation")
+            return (AnimationPath::TRANSLATION);
+        else if (path == "rotation")
+            return (AnimationPath::ROTATION);
+        else if (path == "scale")
+            return (AnimationPath::SCALE);
+        else if (path == "weights")
+            return (AnimationPath::WEIGHTS);
+        throw(std::runtime_error("animation path unknown: " + std::string(path)));
+    }
+
+    Interpolation ParseInterpolation(std::string_view interpolation)
+    {
+        if (interpolation == "LINEAR" || interpolation.empty())
+            return (Interpolation::LINEAR);
+        else if (interpolation == "STEP")
+            return (Interpolation::STEP);
+        else if (interpolation == "CUBICSPLINE")
+            return (Interpolation::CUBICSPLINE);
+        throw(std::runtime_error("interpolation unknown: " + std::string(interpolation)));
+    }
+
+    AlphaMode ParseAlphaMode(std::string_view alphaMode)
+    {
+        if (alphaMode == "OPAQUE")
+            return (AlphaMode::OPAQUE);
+        else if (alphaMode == "MASK")
+            return (AlphaMode::MASK);
+        else if (alphaMode == "BLEND")
+            return (AlphaMode::BLEND);
+        throw(std::runtime_error("alpha mode unknown: " + std::string(alphaMode)));
+    }
+
+    const char *ToString(AnimationPath path)
+    {
+        switch (path)
         {
-            skin.joints.push_back({joint, matrices[i]});
-            i++;
+            case AnimationPath::TRANSLATION: return ("translation");
+            case AnimationPath::ROTATION: return ("rotation");
+            case AnimationPath::SCALE: return ("scale");
+            case AnimationPath::WEIGHTS: return ("weights");
         }
-
-        return (skin);
+        return ("unknown");
     }
 
-    Material LoadMaterial(Json::Node &materialJson)
+    Material LoadMaterial(Json::Node &materialJson, GltfArena &arena)
     {
         Material material;
 
         if (materialJson.KeyExist("name"))
-            material.name = std::string(materialJson["name"]);
+            material.name = arena.Intern(std::string(materialJson["name"]));
         if (materialJson.KeyExist("pbrMetallicRoughness"))
             material.pbr = LoadPBR(materialJson["pbrMetallicRoughness"]);
         if (materialJson.KeyExist("normalTexture"))
@@ -352,7 +546,7 @@ namespace Glb
         if (materialJson.KeyExist("emissiveFactor"))
             material.emissiveFactor = ml::vec3(materialJson["emissiveFactor"][0], materialJson["emissiveFactor"][1], materialJson["emissiveFactor"][2]);
         if (materialJson.KeyExist("alphaMode"))
-            material.alphaMode = std::string(materialJson["alphaMode"]);
+            material.alphaMode = ParseAlphaMode(std::string(materialJson["alphaMode"]));
         if (materialJson.KeyExist("alphaCutoff"))
             material.alphaCutoff = materialJson["alphaCutoff"];
         if (materialJson.KeyExist("doubleSided"))
@@ -379,81 +573,93 @@ namespace Glb
         return (pbr);
     }
 
-    Image LoadImage(Json::Node &imageJson, Json::Node &gltfJson, const std::string &binStr)
+    Image LoadImage(Json::Node &imageJson, const GltfIndex &gltfIndex, const GlbView &glb, GltfArena &arena)
     {
         Image image;
 
-        image.name = std::string(imageJson["name"]);
-        size_t bufferViewIndex = imageJson["bufferView"];
-        auto bufferView = gltfJson["bufferViews"][bufferViewIndex];
-        size_t byteOffset = bufferView["byteOffset"];
-        
-        image.buffer = (unsigned char*)(binStr.data() + byteOffset);
-        image.bufferLength = bufferView["byteLength"];
+        image.name = arena.Intern(std::string(imageJson["name"]));
+        std::string_view bufferView = ResolveImageBufferView(gltfIndex, glb, imageJson["bufferView"]);
+        image.buffer = (unsigned char*)bufferView.data();
+        image.bufferLength = bufferView.size();
 
         return (image);
     }
 
-    Animation LoadAnimation(Json::Node &animationJson, Json::Node &gltfJson, const std::string &binStr)
+    Texture LoadTexture(Json::Node &textureJson)
     {
-        Animation animation;
-        animation.name = std::string(animationJson["name"]);
-        for (auto channelJson: animationJson["channels"])
+        Texture texture;
+
+        if (textureJson.KeyExist("source"))
+            texture.source = textureJson["source"];
+
+        return (texture);
+    }
+
+    Animation LoadAnimation(Json::Node &animationJson, const GltfIndex &gltfIndex, const GlbView &glb, GltfArena &arena)
+    {
+        return (DecodeAnimation(LoadAnimationSource(animationJson, gltfIndex, glb, arena)));
+    }
+
+    AnimationSource LoadAnimationSource(Json::Node &animationJson, const GltfIndex &gltfIndex, const GlbView &glb, GltfArena &arena)
+    {
+        AnimationSource source;
+
+        source.name = arena.Intern(std::string(animationJson["name"]));
+        for (auto &&channelJson: animationJson["channels"])
         {
             Channel channel;
             channel.sampler = channelJson["sampler"];
             channel.node = channelJson["target"]["node"];
-            channel.type = std::string(channelJson["target"]["path"]);
-            
-            auto samplerJson = animationJson["samplers"][channel.sampler];
-            Sampler sampler;
-            sampler.interpolation = std::string(samplerJson["interpolation"]);
+            channel.path = ParseAnimationPath(std::string(channelJson["target"]["path"]));
+            source.channels.push_back(channel);
+        }
 
-            // input = timecodes
-            {
-                size_t input = samplerJson["input"];
-                auto accessor = gltfJson["accessors"][input];
-                size_t bufferViewIndex = accessor["bufferView"];
-                size_t count = accessor["count"];
+        for (auto &&samplerJson: animationJson["samplers"])
+        {
+            SamplerSource sampler;
+            sampler.interpolation = Interpolation::LINEAR;
+            if (samplerJson.KeyExist("interpolation"))
+                sampler.interpolation = ParseInterpolation(std::string(samplerJson["interpolation"]));
+            sampler.input = ResolveAccessor(gltfIndex, glb, samplerJson["input"]); // timecodes
+            sampler.output = ResolveAccessor(gltfIndex, glb, samplerJson["output"]); // data
+            source.samplers.push_back(sampler);
+        }
 
-                auto bufferView = gltfJson["bufferViews"][bufferViewIndex];
-                size_t byteOffset = bufferView["byteOffset"];
-                float* buffer = (float*)(binStr.data() + byteOffset);
+        return (source);
+    }
 
-                for (size_t i = 0; i < count; i++)
-                    sampler.timecodes.push_back(buffer[i]);
-            }
+    Animation DecodeAnimation(const AnimationSource &source)
+    {
+        LoadedBufferViews views;
+        std::vector<SamplerSource> samplers = source.samplers;
+        for (SamplerSource &sampler: samplers)
+        {
+            sampler.input = views.Load(sampler.input);
+            sampler.output = views.Load(sampler.output);
+        }
+        StageTimer timer(LoadStage::ANIMATION);
+        Animation animation;
 
-            // output = data
-            {
-                size_t output = samplerJson["output"];
-                auto accessor = gltfJson["accessors"][output];
-                size_t bufferViewIndex = accessor["bufferView"];
-                size_t count = accessor["count"];
-                std::string type = accessor["type"];
-
-                sampler.nbElement = 0;
-                if (type == "SCALAR")
-                    sampler.nbElement = 1;
-                else if (type == "VEC2")
-                    sampler.nbElement = 2;
-                else if (type == "VEC3")
-                    sampler.nbElement = 3;
-                else if (type == "VEC4")
-                    sampler.nbElement = 4;
-                else
-                    std::cerr << "type unknown: " << type << std::endl;
-
-                auto bufferView = gltfJson["bufferViews"][bufferViewIndex];
-                size_t byteOffset = bufferView["byteOffset"];
-                float* buffer = (float*)(binStr.data() + byteOffset);
-
-                for (size_t i = 0; i < count * sampler.nbElement; i++)
-                    sampler.data.push_back(buffer[i]);
-            }
+        animation.name = source.name;
+        animation.channels.reserve(source.channels.size());
+        animation.samplers.reserve(source.channels.size());
+        size_t bytes = 0;
+        for (const Channel &channel: source.channels)
+        {
+            const SamplerSource &samplerSource = samplers.at(channel.sampler);
+
+            Sampler sampler;
+            sampler.interpolation = samplerSource.interpolation;
+            sampler.timecodes = AccessorView<float>(samplerSource.input).ToVector();
+            AccessorView<float> output(samplerSource.output);
+            sampler.nbElement = output.NbComponent();
+            sampler.data = output.ToVector();
+
+            bytes += (sampler.timecodes.size() + sampler.data.size()) * sizeof(float);
             animation.channels.push_back(channel);
             animation.samplers.push_back(sampler);
         }
+        timer.SetBytes(bytes);
 
         return (animation);
     }
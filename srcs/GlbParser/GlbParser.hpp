@@ -4,14 +4,55 @@
 #include <map>
 #include "Json/Json.hpp"
 #include "Matrix/Matrix.hpp"
+#include "GlbParser/GlbView.hpp"
+#include "GlbParser/Accessor.hpp"
+#include "GlbParser/IndexBuffer.hpp"
+#include "GlbParser/GltfIndex.hpp"
+#include "GlbParser/VertexLayout.hpp"
+#include "GlbParser/Quantization.hpp"
+#include "GlbParser/ThreadPool.hpp"
+#include "GlbParser/GltfArena.hpp"
+#include "GlbParser/Bounds.hpp"
 
 namespace Glb
 {
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-animation-channel-target
+    enum class AnimationPath
+    {
+        TRANSLATION,
+        ROTATION,
+        SCALE,
+        WEIGHTS
+    };
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-animation-sampler
+    enum class Interpolation
+    {
+        STEP,
+        LINEAR,
+        CUBICSPLINE
+    };
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#alpha-coverage
+    enum class AlphaMode
+    {
+        OPAQUE,
+        MASK,
+        BLEND
+    };
+
+    AnimationPath ParseAnimationPath(std::string_view path);
+    Interpolation ParseInterpolation(std::string_view interpolation); // empty is LINEAR, the default
+    AlphaMode ParseAlphaMode(std::string_view alphaMode);
+    const char *ToString(AnimationPath path);
+
+    // the names are interned in the GltfArena of the GltfData they come from and stay valid as long as it does
+
     struct Channel
     {
         int sampler;
         int node;
-        std::string type;
+        AnimationPath path;
     };
 
     struct Sampler
@@ -19,23 +60,29 @@ namespace Glb
         std::vector<float> timecodes;
         std::vector<float> data;
         size_t nbElement;
-        std::string interpolation;
+        Interpolation interpolation;
     };
 
     struct Animation
     {
-        std::string name;
+        std::string_view name;
         std::vector<Channel> channels;
         std::vector<Sampler> samplers;
     };
 
     struct Node
     {
-        std::string name;
+        std::string_view name;
         ml::mat4 transform;
-        std::vector<int> children;
+        std::pmr::vector<int> children;
         int mesh;
         int skin;
+
+        Node(std::pmr::memory_resource *resource = std::pmr::get_default_resource()): children(resource)
+        {
+            mesh = -1;
+            skin = -1;
+        }
     };
 
     constexpr int nbFloatPerPosition = 3;
@@ -52,13 +99,15 @@ namespace Glb
         uint16_t j1, j2, j3, j4;
         float w1, w2, w3, w4;
     };
+    static_assert(sizeof(Vertex) == 56, "Vertex is written as a 56 bytes stride");
 
     // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-mesh-primitive
     struct Primitive
     {
         std::vector<Vertex> vertices; // attributes
-        std::vector<uint16_t> indices;
+        IndexBuffer indices;
         int material;
+        Bounds bounds; // of the positions, in the space of the mesh
         // int mode;
         // object targets
     };
@@ -66,7 +115,7 @@ namespace Glb
     // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-mesh
     struct Mesh
     {
-        std::string name;
+        std::string_view name;
         std::vector<Primitive> primitives;
         // std::vector<float> weights;
     };
@@ -93,24 +142,23 @@ namespace Glb
     // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-material
     struct Material
     {
-        std::string name;
+        std::string_view name;
         PbrMetallicRoughness pbr;
         int normalTexture;
         int occlusionTexture;
         int emissiveTexture;
         ml::vec3 emissiveFactor;
-        std::string alphaMode;
+        AlphaMode alphaMode;
         float alphaCutoff;
         bool doubleSided;
 
         Material()
         {
-            name = "";
             normalTexture = -1;
             occlusionTexture = -1;
             emissiveTexture = -1;
             emissiveFactor = ml::vec3(0, 0, 0);
-            alphaMode = "OPAQUE";
+            alphaMode = AlphaMode::OPAQUE;
             alphaCutoff = 0.5f;
             doubleSided = false;
         }
@@ -118,11 +166,24 @@ namespace Glb
 
     struct Image
     {
-        std::string name;
+        std::string_view name;
         unsigned char *buffer;
         size_t bufferLength;
     };
 
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-texture
+    // the texture indices of the materials point here, several textures can use the same image
+    struct Texture
+    {
+        int source; // index in the images, -1 without one
+        // int sampler;
+
+        Texture()
+        {
+            source = -1;
+        }
+    };
+
     struct Joint
     {
         int nodeIndex;
@@ -131,40 +192,148 @@ namespace Glb
 
     struct Skin
     {
-        std::string name;
+        std::string_view name;
         std::vector<Joint> joints;
     };
 
     struct Scene
     {
-        std::string name;
-        std::vector<int> nodes;
+        std::string_view name;
+        std::pmr::vector<int> nodes;
+
+        Scene(std::pmr::memory_resource *resource = std::pmr::get_default_resource()): nodes(resource)
+        {
+        }
     };
 
+    // copies share the arena, their index lists are copied on the default heap
     struct GltfData
     {
-        int rootScene;
+        std::shared_ptr<GltfArena> arena;
+        int rootScene; // -1 for none, written without the scene key
         std::vector<Scene> scenes;
         std::vector<Node> nodes;
         std::vector<Mesh> meshes;
         std::vector<Skin> skins;
         std::vector<Material> materials;
         std::vector<Image> images;
+        std::vector<Texture> textures;
         std::vector<Animation> animations;
+
+        GltfData()
+        {
+            arena = std::make_shared<GltfArena>();
+            rootScene = 0;
+        }
+
+        GltfData(const GltfData &) = default;
+        GltfData(GltfData &&) = default;
+
+        // the member-wise assignment would release the previous arena before the scenes and nodes
+        // allocated in it, the previous lists leave with other and are destroyed before their arena
+        GltfData &operator=(GltfData other)
+        {
+            Swap(other);
+            return (*this);
+        }
+
+        void Swap(GltfData &other)
+        {
+            std::swap(arena, other.arena);
+            std::swap(rootScene, other.rootScene);
+            scenes.swap(other.scenes);
+            nodes.swap(other.nodes);
+            meshes.swap(other.meshes);
+            skins.swap(other.skins);
+            materials.swap(other.materials);
+            images.swap(other.images);
+            textures.swap(other.textures);
+            animations.swap(other.animations);
+        }
+    };
+
+    // JSON-free description of what has to be decoded, the Decode* functions only read the BIN chunk
+    // through the accessors so they can run on any thread
+    struct PrimitiveSource
+    {
+        std::map<std::string, Accessor> attributes;
+        Accessor indices;
+        bool hasIndices;
+        int material;
+    };
+
+    struct MeshSource
+    {
+        std::string_view name; // interned like the GltfData names
+        std::vector<PrimitiveSource> primitives;
+    };
+
+    struct SkinSource
+    {
+        std::string_view name;
+        std::vector<int> joints;
+        Accessor inverseBindMatrices;
+    };
+
+    struct SamplerSource
+    {
+        Accessor input;
+        Accessor output;
+        Interpolation interpolation;
+    };
+
+    struct AnimationSource
+    {
+        std::string_view name;
+        std::vector<Channel> channels;
+        std::vector<SamplerSource> samplers;
+    };
+
+    struct GltfSources
+    {
+        std::vector<MeshSource> meshes;
+        std::vector<SkinSource> skins;
+        std::vector<AnimationSource> animations;
+        std::shared_ptr<DecodedBufferViews> decodedViews; // the compressed bufferViews the accessors read
     };
 
     std::pair<Json::Node, std::string> LoadBinaryFile(const std::string &path, bool generateFiles = false);
+    Json::Node LoadJson(const GlbView &glb);
+    GltfData LoadGltf(Json::Node &gltfJson, const GlbView &glb);
     GltfData LoadGltf(Json::Node &gltfJson, const std::string &binStr);
-    Scene LoadScene(Json::Node &sceneJson);
-    Node LoadNode(Json::Node &nodeJson);
+    GltfData LoadGltf(Json::Node &gltfJson, const GlbView &glb, ThreadPool &pool);
+    GltfData LoadGltf(Json::Node &gltfJson, const GlbView &glb, size_t nbThread);
+    GltfData LoadGltf(const GlbView &glb);
+    GltfSources LoadGltfSources(const GlbView &glb, GltfData &data); // fills everything but meshes, skins and animations
+    GltfData LoadGltf(const GlbView &glb, ThreadPool &pool);
+    void DecodeSources(GltfData &data, const GltfSources &sources);
+    void DecodeSources(GltfData &data, const GltfSources &sources, ThreadPool &pool);
+    Scene LoadScene(Json::Node &sceneJson, GltfArena &arena);
+    Node LoadNode(Json::Node &nodeJson, GltfArena &arena);
     ml::mat4 CalculateTransform(Json::Node &nodeJson);
-    Mesh LoadMesh(Json::Node &meshJson, Json::Node &gltfJson, const std::string &binStr);
-    Primitive LoadPrimitive(Json::Node &primitiveJson, Json::Node &gltfJson, const std::string &binStr);
-    void LoadVertices(Primitive &primitive, Json::Node &gltfJson, const std::string &binStr, Json::Node &attributes);
-    void LoadIndices(Primitive &primitive, Json::Node &gltfJson, const std::string &binStr, int indiceIndex);
-    Skin LoadSkin(Json::Node &skinJson, Json::Node &gltfJson, const std::string &binStr);
-    Material LoadMaterial(Json::Node &materialJson);
+    ml::mat4 CalculateTransform(ml::vec3 translate, ml::vec4 quat, ml::vec3 scale);
+    Mesh LoadMesh(Json::Node &meshJson, const GltfIndex &gltfIndex, const GlbView &glb, GltfArena &arena);
+    MeshSource LoadMeshSource(Json::Node &meshJson, const GltfIndex &gltfIndex, const GlbView &glb, GltfArena &arena);
+    Mesh DecodeMesh(const MeshSource &source);
+    Primitive LoadPrimitive(Json::Node &primitiveJson, const GltfIndex &gltfIndex, const GlbView &glb);
+    PrimitiveSource LoadPrimitiveSource(Json::Node &primitiveJson, const GltfIndex &gltfIndex, const GlbView &glb);
+    Primitive DecodePrimitive(const PrimitiveSource &source);
+    Bounds ComputeBounds(const std::vector<Vertex> &vertices); // to refresh Primitive::bounds after changing the positions
+    QuantizedPrimitive LoadQuantizedPrimitive(Json::Node &primitiveJson, const GltfIndex &gltfIndex, const GlbView &glb, const QuantizationOptions &options = QuantizationOptions());
+    QuantizedPrimitive DecodeQuantizedPrimitive(const PrimitiveSource &source, const QuantizationOptions &options = QuantizationOptions());
+    void LoadVertices(Primitive &primitive, const GltfIndex &gltfIndex, const GlbView &glb, Json::Node &attributes);
+    void DecodeVertices(Primitive &primitive, const std::map<std::string, Accessor> &attributes);
+    VertexBuffer DecodeVertexBuffer(const PrimitiveSource &source, const VertexLayout &layout); // custom layout instead of Vertex
+    void LoadIndices(Primitive &primitive, const GltfIndex &gltfIndex, const GlbView &glb, int indiceIndex);
+    void DecodeIndices(Primitive &primitive, const Accessor &accessor);
+    Skin LoadSkin(Json::Node &skinJson, const GltfIndex &gltfIndex, const GlbView &glb, GltfArena &arena);
+    SkinSource LoadSkinSource(Json::Node &skinJson, const GltfIndex &gltfIndex, const GlbView &glb, GltfArena &arena);
+    Skin DecodeSkin(const SkinSource &source);
+    Material LoadMaterial(Json::Node &materialJson, GltfArena &arena);
     PbrMetallicRoughness LoadPBR(Json::Node &pbrJson);
-    Image LoadImage(Json::Node &imageJson, Json::Node &gltfJson, const std::string &binStr);
-    Animation LoadAnimation(Json::Node &animationJson, Json::Node &gltfJson, const std::string &binStr);
+    Image LoadImage(Json::Node &imageJson, const GltfIndex &gltfIndex, const GlbView &glb, GltfArena &arena);
+    Texture LoadTexture(Json::Node &textureJson);
+    Animation LoadAnimation(Json::Node &animationJson, const GltfIndex &gltfIndex, const GlbView &glb, GltfArena &arena);
+    AnimationSource LoadAnimationSource(Json::Node &animationJson, const GltfIndex &gltfIndex, const GlbView &glb, GltfArena &arena);
+    Animation DecodeAnimation(const AnimationSource &source);
 }
\ No newline at end of file
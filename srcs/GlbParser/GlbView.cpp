@@ -0,0 +1,64 @@
+#include "GlbParser/GlbView.hpp"
+#include "Toolbox.hpp"
+#include <stdexcept>
+#include <cstring>
+
+namespace Glb
+{
+    static uint32_t ReadUint32(std::string_view bytes, size_t offset)
+    {
+        uint32_t value;
+        std::memcpy(&value, bytes.data() + offset, sizeof(uint32_t));
+        return (value);
+    }
+
+    GlbView ParseGlbView(std::string_view bytes)
+    {
+        GlbView view;
+
+        // Read GLB Header
+        if (bytes.size() < 12)
+            throw(std::runtime_error("Invalid GLB file: file too small"));
+        if (ReadUint32(bytes, 0) != glbMagic)
+            throw(std::runtime_error("Invalid GLB file: wrong magic"));
+        if (ReadUint32(bytes, 4) != glbVersion)
+            throw(std::runtime_error("Invalid GLB file: unsupported version"));
+        size_t length = ReadUint32(bytes, 8);
+        if (length > bytes.size())
+            throw(std::runtime_error("Invalid GLB file: truncated file"));
+        bytes = bytes.substr(0, length);
+
+        // Read JSON chunk, always the first one
+        if (bytes.size() < 20)
+            throw(std::runtime_error("Invalid GLB file: missing JSON chunk"));
+        size_t jsonLength = ReadUint32(bytes, 12);
+        if (ReadUint32(bytes, 16) != chunkTypeJson)
+            throw(std::runtime_error("Invalid GLB file: first chunk is not JSON"));
+        if (jsonLength > bytes.size() - 20)
+            throw(std::runtime_error("Invalid GLB file: truncated JSON chunk"));
+        view.json = bytes.substr(20, jsonLength);
+
+        // Read BIN chunk, optional
+        size_t binOffset = 20 + jsonLength;
+        if (binOffset + 8 <= bytes.size())
+        {
+            size_t binLength = ReadUint32(bytes, binOffset);
+            if (ReadUint32(bytes, binOffset + 4) != chunkTypeBin)
+                throw(std::runtime_error("Invalid GLB file: second chunk is not BIN"));
+            if (binLength > bytes.size() - binOffset - 8)
+                throw(std::runtime_error("Invalid GLB file: truncated BIN chunk"));
+            view.bin = bytes.substr(binOffset + 8, binLength);
+        }
+
+        return (view);
+    }
+
+    MappedGlb::MappedGlb(const std::string &path)
+    {
+        if (!Toolbox::checkExtension(path, ".glb"))
+            throw(std::runtime_error("wrong extension, only parse .glb file"));
+
+        file = MappedFile(path);
+        view = ParseGlbView(file.GetBytes());
+    }
+}
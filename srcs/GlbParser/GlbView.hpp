@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include "GlbParser/MappedFile.hpp"
+
+namespace Glb
+{
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#binary-gltf-layout
+    constexpr uint32_t glbMagic = 0x46546C67; // "glTF"
+    constexpr uint32_t glbVersion = 2;
+    constexpr uint32_t chunkTypeJson = 0x4E4F534A; // "JSON"
+    constexpr uint32_t chunkTypeBin = 0x004E4942; // "BIN\0"
+
+    // non-owning spans over the chunks of a .glb file, the memory must outlive the view
+    struct GlbView
+    {
+        std::string_view json;
+        std::string_view bin;
+    };
+
+    GlbView ParseGlbView(std::string_view bytes);
+
+    // keeps the .glb file mapped in memory, views returned by GetView() stay valid as long as this object lives
+    class MappedGlb
+    {
+        private:
+            MappedFile file;
+            GlbView view;
+
+        public:
+            MappedGlb(const std::string &path);
+
+            const GlbView &GetView() const { return (view); }
+    };
+}
@@ -0,0 +1,765 @@
+#include "GlbParser/GlbWriter.hpp"
+#include "GlbParser/JsonWriter.hpp"
+#include "GlbParser/AnimationRuntime.hpp"
+#include "GlbParser/ImageDecoder.hpp"
+#include <cstddef>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+namespace Glb
+{
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-bufferview
+    constexpr int targetArrayBuffer = 34962;
+    constexpr int targetElementArrayBuffer = 34963;
+
+    static const unsigned char zeros[4] = {0, 0, 0, 0};
+    static const char spaces[4] = {' ', ' ', ' ', ' '};
+
+    struct BinSegment
+    {
+        const void *data;
+        size_t size;
+    };
+
+    struct OutputBufferView
+    {
+        size_t byteOffset;
+        size_t byteLength;
+        size_t byteStride; // 0 when tightly packed
+        int target; // 0 when none
+    };
+
+    struct OutputAccessor
+    {
+        size_t bufferView;
+        size_t byteOffset;
+        size_t count;
+        ComponentType componentType;
+        const char *type;
+        size_t nbMinMax; // components of min and max, 0 when they aren't written
+        float min[4];
+        float max[4];
+    };
+
+    static const char *GetMimeType(const Image &image)
+    {
+        const unsigned char *data = image.buffer;
+        size_t length = image.bufferLength;
+        if (IsPng(data, length))
+            return ("image/png");
+        if (IsJpeg(data, length))
+            return ("image/jpeg");
+        if (length >= 12 && std::memcmp(data, "RIFF", 4) == 0 && std::memcmp(data + 8, "WEBP", 4) == 0)
+            return ("image/webp");
+        if (length >= 12 && std::memcmp(data, "\xABKTX 20\xBB\r\n\x1A\n", 12) == 0)
+            return ("image/ktx2");
+        throw(std::runtime_error("image " + std::string(image.name) + " has an unknown format"));
+    }
+
+    static const char *GetAccessorType(size_t nbComponent)
+    {
+        switch (nbComponent)
+        {
+            case 1:
+                return ("SCALAR");
+            case 2:
+                return ("VEC2");
+            case 3:
+                return ("VEC3");
+            case 4:
+                return ("VEC4");
+            case 16:
+                return ("MAT4");
+            default:
+                throw(std::runtime_error("no accessor type has " + std::to_string(nbComponent) + " components"));
+        }
+    }
+
+    static const char *ToString(Interpolation interpolation)
+    {
+        switch (interpolation)
+        {
+            case Interpolation::STEP:
+                return ("STEP");
+            case Interpolation::CUBICSPLINE:
+                return ("CUBICSPLINE");
+            default:
+                return ("LINEAR");
+        }
+    }
+
+    static const char *ToString(AlphaMode alphaMode)
+    {
+        switch (alphaMode)
+        {
+            case AlphaMode::MASK:
+                return ("MASK");
+            case AlphaMode::BLEND:
+                return ("BLEND");
+            default:
+                return ("OPAQUE");
+        }
+    }
+
+    // fills the JSON while laying out the BIN chunk as segments pointing into the GltfData
+    class GlbBuilder
+    {
+        private:
+            const GltfData &data;
+            JsonWriter json;
+            std::vector<BinSegment> segments;
+            size_t binSize;
+            std::vector<OutputBufferView> bufferViews;
+            std::vector<OutputAccessor> accessors;
+            std::vector<std::vector<float>> copies; // data that isn't stored as it is written, like the inverse bind matrices
+            unsigned char header[20];
+            unsigned char binHeader[8];
+
+            size_t AddBufferView(const void *bytes, size_t size, size_t stride, int target)
+            {
+                // every bufferView starts on 4 bytes, which covers the alignment of all the component types
+                size_t padding = (4 - binSize % 4) % 4;
+                if (padding > 0)
+                {
+                    segments.push_back({zeros, padding});
+                    binSize += padding;
+                }
+
+                bufferViews.push_back({binSize, size, stride, target});
+                segments.push_back({bytes, size});
+                binSize += size;
+                return (bufferViews.size() - 1);
+            }
+
+            size_t AddAccessor(size_t bufferView, size_t byteOffset, size_t count, ComponentType componentType, size_t nbComponent)
+            {
+                OutputAccessor accessor;
+                accessor.bufferView = bufferView;
+                accessor.byteOffset = byteOffset;
+                accessor.count = count;
+                accessor.componentType = componentType;
+                accessor.type = GetAccessorType(nbComponent);
+                accessor.nbMinMax = 0;
+                accessors.push_back(accessor);
+                return (accessors.size() - 1);
+            }
+
+            void WriteName(std::string_view name)
+            {
+                if (name.empty())
+                    return;
+                json.Key("name");
+                json.String(name);
+            }
+
+            void WriteIndex(const char *key, int index)
+            {
+                if (index < 0)
+                    return;
+                json.Key(key);
+                json.Int(index);
+            }
+
+            void WriteTexture(const char *key, int index)
+            {
+                if (index < 0)
+                    return;
+                if (static_cast<size_t>(index) >= data.textures.size())
+                    throw(std::runtime_error(std::string(key) + " " + std::to_string(index) + " out of the " + std::to_string(data.textures.size()) + " textures"));
+                json.Key(key);
+                json.BeginObject();
+                json.Key("index");
+                json.Int(index);
+                json.EndObject();
+            }
+
+            void WriteIntArray(const char *key, const int *values, size_t count)
+            {
+                if (count == 0)
+                    return;
+                json.Key(key);
+                json.BeginArray();
+                for (size_t i = 0; i < count; i++)
+                    json.Int(values[i]);
+                json.EndArray();
+            }
+
+            void WriteScenes();
+            void WriteNodes();
+            void WriteMeshes();
+            void WritePrimitive(const Primitive &primitive);
+            void WriteMaterials();
+            void WriteImages();
+            void WriteTextures();
+            void WriteSkins();
+            void WriteAnimations();
+            void WriteAccessors();
+            void WriteBufferViews();
+
+        public:
+            GlbBuilder(const GltfData &data);
+
+            std::vector<BinSegment> GetFile(); // every segment of the file in order, headers and padding included
+    };
+
+    GlbBuilder::GlbBuilder(const GltfData &data): data(data)
+    {
+        binSize = 0;
+
+        json.BeginObject();
+        json.Key("asset");
+        json.BeginObject();
+        json.Key("version");
+        json.String("2.0");
+        json.Key("generator");
+        json.String("GlbParser");
+        json.EndObject();
+
+        WriteScenes();
+        WriteNodes();
+        WriteMeshes();
+        WriteMaterials();
+        WriteImages();
+        WriteTextures();
+        WriteSkins();
+        WriteAnimations();
+        WriteAccessors();
+        WriteBufferViews();
+        json.EndObject();
+    }
+
+    void GlbBuilder::WriteScenes()
+    {
+        if (data.scenes.empty())
+            return;
+
+        WriteIndex("scene", data.rootScene);
+        json.Key("scenes");
+        json.BeginArray();
+        for (const Scene &scene: data.scenes)
+        {
+            json.BeginObject();
+            WriteName(scene.name);
+            WriteIntArray("nodes", scene.nodes.data(), scene.nodes.size());
+            json.EndObject();
+        }
+        json.EndArray();
+    }
+
+    void GlbBuilder::WriteNodes()
+    {
+        if (data.nodes.empty())
+            return;
+
+        json.Key("nodes");
+        json.BeginArray();
+        for (const Node &node: data.nodes)
+        {
+            json.BeginObject();
+            WriteName(node.name);
+            WriteIntArray("children", node.children.data(), node.children.size());
+            WriteIndex("mesh", node.mesh);
+            WriteIndex("skin", node.skin);
+
+            // the loaders only read TRS, the default values are left out
+            LocalTransform local = DecomposeTransform(node.transform);
+            if (local.translation[0] != 0 || local.translation[1] != 0 || local.translation[2] != 0)
+            {
+                json.Key("translation");
+                json.Floats(local.translation, 3);
+            }
+            if (local.rotation[0] != 0 || local.rotation[1] != 0 || local.rotation[2] != 0 || local.rotation[3] != 1)
+            {
+                json.Key("rotation");
+                json.Floats(local.rotation, 4);
+            }
+            if (local.scale[0] != 1 || local.scale[1] != 1 || local.scale[2] != 1)
+            {
+                json.Key("scale");
+                json.Floats(local.scale, 3);
+            }
+            json.EndObject();
+        }
+        json.EndArray();
+    }
+
+    void GlbBuilder::WriteMeshes()
+    {
+        if (data.meshes.empty())
+            return;
+
+        json.Key("meshes");
+        json.BeginArray();
+        for (const Mesh &mesh: data.meshes)
+        {
+            json.BeginObject();
+            WriteName(mesh.name);
+            json.Key("primitives");
+            json.BeginArray();
+            for (const Primitive &primitive: mesh.primitives)
+                WritePrimitive(primitive);
+            json.EndArray();
+            json.EndObject();
+        }
+        json.EndArray();
+    }
+
+    void GlbBuilder::WritePrimitive(const Primitive &primitive)
+    {
+        const std::vector<Vertex> &vertices = primitive.vertices;
+        if (vertices.empty())
+            throw(std::runtime_error("a primitive without vertices can't be written"));
+
+        bool hasTexCoord = false;
+        bool hasNormal = false;
+        bool hasSkin = false;
+        for (const Vertex &vertex: vertices)
+        {
+            hasTexCoord |= vertex.u != 0 || vertex.v != 0;
+            hasNormal |= vertex.nx != 0 || vertex.ny != 0 || vertex.nz != 0;
+            hasSkin |= vertex.w1 != 0 || vertex.w2 != 0 || vertex.w3 != 0 || vertex.w4 != 0;
+        }
+
+        size_t bufferView = AddBufferView(vertices.data(), vertices.size() * sizeof(Vertex), sizeof(Vertex), targetArrayBuffer);
+        size_t count = vertices.size();
+
+        json.BeginObject();
+        json.Key("attributes");
+        json.BeginObject();
+
+        // POSITION needs min and max
+        Bounds bounds = primitive.bounds.IsEmpty() ? ComputeBounds(vertices) : primitive.bounds;
+        size_t position = AddAccessor(bufferView, offsetof(Vertex, x), count, ComponentType::FLOAT, nbFloatPerPosition);
+        accessors[position].nbMinMax = 3;
+        std::memcpy(accessors[position].min, bounds.min, sizeof(bounds.min));
+        std::memcpy(accessors[position].max, bounds.max, sizeof(bounds.max));
+        json.Key("POSITION");
+        json.Size(position);
+
+        if (hasNormal)
+        {
+            json.Key("NORMAL");
+            json.Size(AddAccessor(bufferView, offsetof(Vertex, nx), count, ComponentType::FLOAT, nbFloatPerNormal));
+        }
+        if (hasTexCoord)
+        {
+            json.Key("TEXCOORD_0");
+            json.Size(AddAccessor(bufferView, offsetof(Vertex, u), count, ComponentType::FLOAT, nbFloatPerTexCoord));
+        }
+        if (hasSkin)
+        {
+            json.Key("JOINTS_0");
+            json.Size(AddAccessor(bufferView, offsetof(Vertex, j1), count, ComponentType::UNSIGNED_SHORT, nbFloatPerJoint));
+            json.Key("WEIGHTS_0");
+            json.Size(AddAccessor(bufferView, offsetof(Vertex, w1), count, ComponentType::FLOAT, nbFloatPerWeight));
+        }
+        json.EndObject();
+
+        if (!primitive.indices.Empty())
+        {
+            const IndexBuffer &indices = primitive.indices;
+            size_t indexView = AddBufferView(indices.data.data(), indices.data.size(), 0, targetElementArrayBuffer);
+            json.Key("indices");
+            json.Size(AddAccessor(indexView, 0, indices.Size(), indices.componentType, 1));
+        }
+        WriteIndex("material", primitive.material);
+        json.EndObject();
+    }
+
+    void GlbBuilder::WriteMaterials()
+    {
+        if (data.materials.empty())
+            return;
+
+        json.Key("materials");
+        json.BeginArray();
+        for (const Material &material: data.materials)
+        {
+            json.BeginObject();
+            WriteName(material.name);
+
+            const PbrMetallicRoughness &pbr = material.pbr;
+            float baseColorFactor[4];
+            for (int i = 0; i < 4; i++)
+                baseColorFactor[i] = pbr.baseColorFactor[i];
+            json.Key("pbrMetallicRoughness");
+            json.BeginObject();
+            json.Key("baseColorFactor");
+            json.Floats(baseColorFactor, 4);
+            WriteTexture("baseColorTexture", pbr.baseColorTexture);
+            json.Key("metallicFactor");
+            json.Float(pbr.metallicFactor);
+            json.Key("roughnessFactor");
+            json.Float(pbr.roughnessFactor);
+            WriteTexture("metallicRoughnessTexture", pbr.metallicRoughnessTexture);
+            json.EndObject();
+
+            WriteTexture("normalTexture", material.normalTexture);
+            WriteTexture("occlusionTexture", material.occlusionTexture);
+            WriteTexture("emissiveTexture", material.emissiveTexture);
+            float emissiveFactor[3];
+            for (int i = 0; i < 3; i++)
+                emissiveFactor[i] = material.emissiveFactor[i];
+            json.Key("emissiveFactor");
+            json.Floats(emissiveFactor, 3);
+            json.Key("alphaMode");
+            json.String(ToString(material.alphaMode));
+            json.Key("alphaCutoff");
+            json.Float(material.alphaCutoff);
+            json.Key("doubleSided");
+            json.Bool(material.doubleSided);
+            json.EndObject();
+        }
+        json.EndArray();
+    }
+
+    void GlbBuilder::WriteImages()
+    {
+        if (data.images.empty())
+            return;
+
+        json.Key("images");
+        json.BeginArray();
+        for (const Image &image: data.images)
+        {
+            if (image.buffer == NULL || image.bufferLength == 0)
+                throw(std::runtime_error("image " + std::string(image.name) + " has no data"));
+
+            json.BeginObject();
+            WriteName(image.name);
+            json.Key("mimeType");
+            json.String(GetMimeType(image));
+            json.Key("bufferView");
+            json.Size(AddBufferView(image.buffer, image.bufferLength, 0, 0));
+            json.EndObject();
+        }
+        json.EndArray();
+    }
+
+    void GlbBuilder::WriteTextures()
+    {
+        if (data.textures.empty())
+            return;
+
+        json.Key("textures");
+        json.BeginArray();
+        for (const Texture &texture: data.textures)
+        {
+            if (texture.source >= 0 && static_cast<size_t>(texture.source) >= data.images.size())
+                throw(std::runtime_error("texture source " + std::to_string(texture.source) + " out of the " + std::to_string(data.images.size()) + " images"));
+
+            json.BeginObject();
+            WriteIndex("source", texture.source);
+            json.EndObject();
+        }
+        json.EndArray();
+    }
+
+    void GlbBuilder::WriteSkins()
+    {
+        if (data.skins.empty())
+            return;
+
+        json.Key("skins");
+        json.BeginArray();
+        for (const Skin &skin: data.skins)
+        {
+            json.BeginObject();
+            WriteName(skin.name);
+            json.Key("joints");
+            json.BeginArray();
+            for (const Joint &joint: skin.joints)
+                json.Int(joint.nodeIndex);
+            json.EndArray();
+
+            if (!skin.joints.empty())
+            {
+                // the matrices sit next to the node indices in Joint, they are the only copied data
+                copies.emplace_back(skin.joints.size() * 16);
+                std::vector<float> &matrices = copies.back();
+                for (size_t i = 0; i < skin.joints.size(); i++)
+                {
+                    for (size_t j = 0; j < 16; j++)
+                        matrices[i * 16 + j] = skin.joints[i].inverseBindMatrix[j % 4][j / 4];
+                }
+                size_t bufferView = AddBufferView(matrices.data(), matrices.size() * sizeof(float), 0, 0);
+                json.Key("inverseBindMatrices");
+                json.Size(AddAccessor(bufferView, 0, skin.joints.size(), ComponentType::FLOAT, 16));
+            }
+            json.EndObject();
+        }
+        json.EndArray();
+    }
+
+    void GlbBuilder::WriteAnimations()
+    {
+        if (data.animations.empty())
+            return;
+
+        json.Key("animations");
+        json.BeginArray();
+        for (const Animation &animation: data.animations)
+        {
+            if (animation.samplers.size() != animation.channels.size())
+                throw(std::runtime_error("animation " + std::string(animation.name) + " doesn't have one sampler per channel"));
+
+            // channels sharing a glTF sampler got a copy each, only the first one is written
+            std::map<int, size_t> samplerIndices;
+            std::vector<size_t> channelSamplers(animation.channels.size());
+            std::vector<size_t> written;
+            for (size_t i = 0; i < animation.channels.size(); i++)
+            {
+                auto it = samplerIndices.find(animation.channels[i].sampler);
+                if (it != samplerIndices.end())
+                {
+                    channelSamplers[i] = it->second;
+                    continue;
+                }
+                channelSamplers[i] = written.size();
+                samplerIndices[animation.channels[i].sampler] = written.size();
+                written.push_back(i);
+            }
+
+            json.BeginObject();
+            WriteName(animation.name);
+            json.Key("channels");
+            json.BeginArray();
+            for (size_t i = 0; i < animation.channels.size(); i++)
+            {
+                const Channel &channel = animation.channels[i];
+                json.BeginObject();
+                json.Key("sampler");
+                json.Size(channelSamplers[i]);
+                json.Key("target");
+                json.BeginObject();
+                json.Key("node");
+                json.Int(channel.node);
+                json.Key("path");
+                json.String(Glb::ToString(channel.path));
+                json.EndObject();
+                json.EndObject();
+            }
+            json.EndArray();
+
+            json.Key("samplers");
+            json.BeginArray();
+            for (size_t i: written)
+            {
+                const Sampler &sampler = animation.samplers[i];
+                if (sampler.timecodes.empty() || sampler.nbElement == 0 || sampler.data.size() % sampler.nbElement != 0)
+                    throw(std::runtime_error("animation " + std::string(animation.name) + " has an invalid sampler"));
+
+                // the input needs min and max
+                size_t inputView = AddBufferView(sampler.timecodes.data(), sampler.timecodes.size() * sizeof(float), 0, 0);
+                size_t input = AddAccessor(inputView, 0, sampler.timecodes.size(), ComponentType::FLOAT, 1);
+                accessors[input].nbMinMax = 1;
+                accessors[input].min[0] = sampler.timecodes.front();
+                accessors[input].max[0] = sampler.timecodes.back();
+                size_t outputView = AddBufferView(sampler.data.data(), sampler.data.size() * sizeof(float), 0, 0);
+                size_t output = AddAccessor(outputView, 0, sampler.data.size() / sampler.nbElement, ComponentType::FLOAT, sampler.nbElement);
+
+                json.BeginObject();
+                json.Key("input");
+                json.Size(input);
+                json.Key("output");
+                json.Size(output);
+                json.Key("interpolation");
+                json.String(ToString(sampler.interpolation));
+                json.EndObject();
+            }
+            json.EndArray();
+            json.EndObject();
+        }
+        json.EndArray();
+    }
+
+    void GlbBuilder::WriteAccessors()
+    {
+        if (accessors.empty())
+            return;
+
+        json.Key("accessors");
+        json.BeginArray();
+        for (const OutputAccessor &accessor: accessors)
+        {
+            json.BeginObject();
+            json.Key("bufferView");
+            json.Size(accessor.bufferView);
+            if (accessor.byteOffset != 0)
+            {
+                json.Key("byteOffset");
+                json.Size(accessor.byteOffset);
+            }
+            json.Key("componentType");
+            json.Int(static_cast<int>(accessor.componentType));
+            json.Key("count");
+            json.Size(accessor.count);
+            json.Key("type");
+            json.String(accessor.type);
+            if (accessor.nbMinMax > 0)
+            {
+                json.Key("min");
+                json.Floats(accessor.min, accessor.nbMinMax);
+                json.Key("max");
+                json.Floats(accessor.max, accessor.nbMinMax);
+            }
+            json.EndObject();
+        }
+        json.EndArray();
+    }
+
+    void GlbBuilder::WriteBufferViews()
+    {
+        if (bufferViews.empty())
+            return;
+
+        json.Key("bufferViews");
+        json.BeginArray();
+        for (const OutputBufferView &bufferView: bufferViews)
+        {
+            json.BeginObject();
+            json.Key("buffer");
+            json.Int(0);
+            json.Key("byteOffset");
+            json.Size(bufferView.byteOffset);
+            json.Key("byteLength");
+            json.Size(bufferView.byteLength);
+            if (bufferView.byteStride != 0)
+            {
+                json.Key("byteStride");
+                json.Size(bufferView.byteStride);
+            }
+            if (bufferView.target != 0)
+            {
+                json.Key("target");
+                json.Int(bufferView.target);
+            }
+            json.EndObject();
+        }
+        json.EndArray();
+
+        json.Key("buffers");
+        json.BeginArray();
+        json.BeginObject();
+        json.Key("byteLength");
+        json.Size(binSize);
+        json.EndObject();
+        json.EndArray();
+    }
+
+    static void WriteUint32(unsigned char *dst, uint32_t value)
+    {
+        // GLB is little endian
+        for (int i = 0; i < 4; i++)
+            dst[i] = static_cast<unsigned char>(value >> (i * 8));
+    }
+
+    std::vector<BinSegment> GlbBuilder::GetFile()
+    {
+        const std::string &jsonChunk = json.GetJson();
+        size_t jsonPadding = (4 - jsonChunk.size() % 4) % 4;
+        size_t binPadding = (4 - binSize % 4) % 4;
+        size_t jsonLength = jsonChunk.size() + jsonPadding;
+        size_t binLength = binSize + binPadding;
+        size_t fileSize = 12 + 8 + jsonLength + (binSize > 0 ? 8 + binLength : 0);
+        if (fileSize > UINT32_MAX)
+            throw(std::runtime_error("a .glb can't be bigger than 4 GB"));
+
+        WriteUint32(header, glbMagic);
+        WriteUint32(header + 4, glbVersion);
+        WriteUint32(header + 8, static_cast<uint32_t>(fileSize));
+        WriteUint32(header + 12, static_cast<uint32_t>(jsonLength));
+        WriteUint32(header + 16, chunkTypeJson);
+
+        std::vector<BinSegment> file;
+        file.reserve(segments.size() + 6);
+        file.push_back({header, sizeof(header)});
+        file.push_back({jsonChunk.data(), jsonChunk.size()});
+        file.push_back({spaces, jsonPadding});
+        if (binSize > 0)
+        {
+            WriteUint32(binHeader, static_cast<uint32_t>(binLength));
+            WriteUint32(binHeader + 4, chunkTypeBin);
+            file.push_back({binHeader, sizeof(binHeader)});
+            file.insert(file.end(), segments.begin(), segments.end());
+            file.push_back({zeros, binPadding});
+        }
+        return (file);
+    }
+
+    size_t WriteGlb(const GltfData &data, const std::string &path)
+    {
+        GlbBuilder builder(data);
+        std::vector<BinSegment> segments = builder.GetFile();
+
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd == -1)
+            throw(std::runtime_error("failed to open " + path));
+
+        // writev takes at most IOV_MAX buffers and can stop anywhere, the iovecs are advanced past what was written
+        std::vector<iovec> iovecs;
+        iovecs.reserve(segments.size());
+        size_t fileSize = 0;
+        for (const BinSegment &segment: segments)
+        {
+            if (segment.size == 0)
+                continue;
+            iovecs.push_back({const_cast<void*>(segment.data), segment.size});
+            fileSize += segment.size;
+        }
+
+        size_t first = 0;
+        while (first < iovecs.size())
+        {
+            int count = static_cast<int>(std::min<size_t>(iovecs.size() - first, IOV_MAX));
+            ssize_t written = writev(fd, &iovecs[first], count);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                close(fd);
+                unlink(path.c_str());
+                throw(std::runtime_error("failed to write " + path));
+            }
+
+            size_t remaining = static_cast<size_t>(written);
+            while (first < iovecs.size() && remaining >= iovecs[first].iov_len)
+                remaining -= iovecs[first++].iov_len;
+            if (remaining > 0)
+            {
+                iovecs[first].iov_base = static_cast<char*>(iovecs[first].iov_base) + remaining;
+                iovecs[first].iov_len -= remaining;
+            }
+        }
+
+        if (close(fd) == -1)
+            throw(std::runtime_error("failed to write " + path));
+        return (fileSize);
+    }
+
+    std::vector<unsigned char> SerializeGlb(const GltfData &data)
+    {
+        GlbBuilder builder(data);
+        std::vector<BinSegment> segments = builder.GetFile();
+
+        size_t fileSize = 0;
+        for (const BinSegment &segment: segments)
+            fileSize += segment.size;
+
+        std::vector<unsigned char> bytes(fileSize);
+        size_t offset = 0;
+        for (const BinSegment &segment: segments)
+        {
+            if (segment.size == 0)
+                continue;
+            std::memcpy(bytes.data() + offset, segment.data, segment.size);
+            offset += segment.size;
+        }
+        return (bytes);
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "GlbParser/GlbParser.hpp"
+
+namespace Glb
+{
+    // writes a GltfData as a .glb: the JSON is generated from the structures and the BIN chunk points
+    // straight into their vectors (vertices, indices, animation keys, images), which are written with
+    // writev without being concatenated. Node transforms are written as TRS, the vertices of a primitive
+    // as one interleaved bufferView of Vertex with an accessor for each attribute that isn't all zeros.
+    // Texture and image indices are checked, an out of range one throws instead of writing an invalid file
+    size_t WriteGlb(const GltfData &data, const std::string &path); // returns the size of the file
+    std::vector<unsigned char> SerializeGlb(const GltfData &data); // same bytes, in memory
+}
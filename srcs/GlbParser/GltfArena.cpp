@@ -0,0 +1,26 @@
+#include "GlbParser/GltfArena.hpp"
+#include <cstring>
+
+namespace Glb
+{
+    // enough for the names and hierarchy of a small asset, bigger ones grow it geometrically
+    constexpr size_t arenaInitialSize = 16 * 1024;
+
+    GltfArena::GltfArena(): resource(arenaInitialSize), strings(&resource)
+    {
+    }
+
+    std::string_view GltfArena::Intern(std::string_view str)
+    {
+        if (str.empty())
+            return (std::string_view());
+
+        auto it = strings.find(str);
+        if (it != strings.end())
+            return (*it);
+
+        char *chars = static_cast<char*>(resource.allocate(str.size(), 1));
+        std::memcpy(chars, str.data(), str.size());
+        return (*strings.insert(std::string_view(chars, str.size())).first);
+    }
+}
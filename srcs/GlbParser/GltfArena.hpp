@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string_view>
+#include <unordered_set>
+#include <memory_resource>
+
+namespace Glb
+{
+    // holds the small metadata of a GltfData, the interned names and the node and scene index lists,
+    // in a few large blocks released together with the arena. Vertex, index and keyframe data keep
+    // their own allocations so a mesh or an animation can still be dropped on its own.
+    // filled while parsing, not thread safe
+    class GltfArena
+    {
+        private:
+            std::pmr::monotonic_buffer_resource resource;
+            std::pmr::unordered_set<std::string_view> strings; // views into resource
+
+        public:
+            GltfArena();
+            GltfArena(const GltfArena &) = delete;
+
+            GltfArena &operator=(const GltfArena &) = delete;
+
+            std::string_view Intern(std::string_view str); // equal strings get the same characters
+            std::pmr::memory_resource *GetResource() { return (&resource); }
+            size_t GetNbString() const { return (strings.size()); }
+    };
+}
@@ -0,0 +1,150 @@
+#include "GlbParser/GltfDocument.hpp"
+#include <stdexcept>
+
+namespace Glb
+{
+    GltfDocument::GltfDocument(const std::string &path): glb(path)
+    {
+        sources = LoadGltfSources(glb.GetView(), data);
+        meshes.resize(sources.meshes.size());
+        skins.resize(sources.skins.size());
+        animations.resize(sources.animations.size());
+    }
+
+    // an element handed out can outlive the document, it keeps the arena its name points into
+    template <typename T>
+    struct ArenaHolder
+    {
+        std::shared_ptr<GltfArena> arena;
+        T value;
+    };
+
+    // decoding happens outside of the lock so other threads can keep reading,
+    // if two threads decode the same element the first one stored wins
+    template <typename T, typename Source>
+    static std::shared_ptr<const T> GetOrDecode(std::mutex &mutex, std::vector<std::shared_ptr<const T>> &cache, const std::shared_ptr<GltfArena> &arena,
+                                               const std::vector<Source> &sources, size_t index, T (*decode)(const Source &))
+    {
+        if (index >= sources.size())
+            throw(std::out_of_range("index " + std::to_string(index) + " out of range"));
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (cache[index])
+                return (cache[index]);
+        }
+
+        std::shared_ptr<ArenaHolder<T>> holder = std::make_shared<ArenaHolder<T>>(ArenaHolder<T>{arena, decode(sources[index])});
+        std::shared_ptr<const T> decoded(holder, &holder->value);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!cache[index])
+            cache[index] = decoded;
+        return (cache[index]);
+    }
+
+    std::shared_ptr<const Mesh> GltfDocument::GetMesh(size_t meshIndex)
+    {
+        return (GetOrDecode(mutex, meshes, data.arena, sources.meshes, meshIndex, DecodeMesh));
+    }
+
+    std::shared_ptr<const Skin> GltfDocument::GetSkin(size_t skinIndex)
+    {
+        return (GetOrDecode(mutex, skins, data.arena, sources.skins, skinIndex, DecodeSkin));
+    }
+
+    std::shared_ptr<const Animation> GltfDocument::GetAnimation(size_t animationIndex)
+    {
+        return (GetOrDecode(mutex, animations, data.arena, sources.animations, animationIndex, DecodeAnimation));
+    }
+
+    // the decoded compressed bufferViews only serve to decode again, they leave with the element reading them
+    static void EvictBufferView(const GltfSources &sources, const Accessor &accessor)
+    {
+        if (accessor.compressed)
+            sources.decodedViews->Evict(accessor.compressed->index);
+    }
+
+    void GltfDocument::Prefetch(size_t meshIndex)
+    {
+        GetMesh(meshIndex);
+    }
+
+    void GltfDocument::Evict(size_t meshIndex)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (meshIndex >= meshes.size())
+            return;
+        meshes[meshIndex].reset();
+        for (const PrimitiveSource &primitive: sources.meshes[meshIndex].primitives)
+        {
+            for (const auto &attribute: primitive.attributes)
+                EvictBufferView(sources, attribute.second);
+            if (primitive.hasIndices)
+                EvictBufferView(sources, primitive.indices);
+        }
+    }
+
+    void GltfDocument::PrefetchAnimation(size_t animationIndex)
+    {
+        GetAnimation(animationIndex);
+    }
+
+    void GltfDocument::EvictAnimation(size_t animationIndex)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (animationIndex >= animations.size())
+            return;
+        animations[animationIndex].reset();
+        for (const SamplerSource &sampler: sources.animations[animationIndex].samplers)
+        {
+            EvictBufferView(sources, sampler.input);
+            EvictBufferView(sources, sampler.output);
+        }
+    }
+
+    void GltfDocument::EvictAll()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto &mesh: meshes)
+            mesh.reset();
+        for (auto &skin: skins)
+            skin.reset();
+        for (auto &animation: animations)
+            animation.reset();
+        sources.decodedViews->EvictAll();
+    }
+
+    bool GltfDocument::IsMeshLoaded(size_t meshIndex) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (meshIndex < meshes.size() && meshes[meshIndex] != NULL);
+    }
+
+    size_t GltfDocument::GetResidentBytes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        size_t bytes = sources.decodedViews->GetResidentBytes();
+        for (const auto &mesh: meshes)
+        {
+            if (!mesh)
+                continue;
+            for (const Primitive &primitive: mesh->primitives)
+                bytes += primitive.vertices.size() * sizeof(Vertex) + primitive.indices.data.size();
+        }
+        for (const auto &skin: skins)
+        {
+            if (skin)
+                bytes += skin->joints.size() * sizeof(Joint);
+        }
+        for (const auto &animation: animations)
+        {
+            if (!animation)
+                continue;
+            for (const Sampler &sampler: animation->samplers)
+                bytes += (sampler.timecodes.size() + sampler.data.size()) * sizeof(float);
+        }
+        return (bytes);
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <mutex>
+#include <memory>
+#include "GlbParser/GlbParser.hpp"
+
+namespace Glb
+{
+    // lazy access to a .glb file: opening it only reads the JSON chunk,
+    // meshes, skins and animations are decoded on first access and kept until evicted
+    class GltfDocument
+    {
+        private:
+            MappedGlb glb;
+            GltfData data; // meshes, skins and animations stay empty, see sources
+            GltfSources sources;
+
+            mutable std::mutex mutex;
+            std::vector<std::shared_ptr<const Mesh>> meshes;
+            std::vector<std::shared_ptr<const Skin>> skins;
+            std::vector<std::shared_ptr<const Animation>> animations;
+
+        public:
+            GltfDocument(const std::string &path);
+            GltfDocument(const GltfDocument &) = delete;
+
+            GltfDocument &operator=(const GltfDocument &) = delete;
+
+            const GlbView &GetView() const { return (glb.GetView()); }
+            int GetRootScene() const { return (data.rootScene); }
+            const std::vector<Scene> &GetScenes() const { return (data.scenes); }
+            const std::vector<Node> &GetNodes() const { return (data.nodes); }
+            const std::vector<Material> &GetMaterials() const { return (data.materials); }
+            const std::vector<Image> &GetImages() const { return (data.images); } // points into the mapped file
+            const GltfSources &GetSources() const { return (sources); }
+
+            size_t GetNbMesh() const { return (sources.meshes.size()); }
+            size_t GetNbSkin() const { return (sources.skins.size()); }
+            size_t GetNbAnimation() const { return (sources.animations.size()); }
+
+            // decoded on first call, evicting only drops the document reference and the compressed bufferViews the element reads
+            std::shared_ptr<const Mesh> GetMesh(size_t meshIndex);
+            std::shared_ptr<const Skin> GetSkin(size_t skinIndex);
+            std::shared_ptr<const Animation> GetAnimation(size_t animationIndex);
+
+            void Prefetch(size_t meshIndex);
+            void Evict(size_t meshIndex);
+            void PrefetchAnimation(size_t animationIndex);
+            void EvictAnimation(size_t animationIndex);
+            void EvictAll();
+
+            bool IsMeshLoaded(size_t meshIndex) const;
+            size_t GetResidentBytes() const; // decoded vertex, index and animation data and compressed bufferViews currently held
+    };
+}
@@ -0,0 +1,270 @@
+#include "GlbParser/GltfIndex.hpp"
+#include "GlbParser/LoadStats.hpp"
+#include <stdexcept>
+#include <algorithm>
+
+namespace Glb
+{
+    static void LoadBounds(Json::Node &boundsJson, float *bounds)
+    {
+        size_t i = 0;
+        for (auto &&valueJson: boundsJson)
+        {
+            if (i < 4)
+                bounds[i++] = valueJson;
+        }
+    }
+
+    static MeshoptCompression LoadMeshoptCompression(Json::Node &compressionJson)
+    {
+        MeshoptCompression compression;
+        compression.buffer = compressionJson["buffer"];
+        compression.byteOffset = compressionJson.KeyExist("byteOffset") ? (size_t)compressionJson["byteOffset"] : 0;
+        compression.byteLength = compressionJson["byteLength"];
+        compression.byteStride = compressionJson["byteStride"];
+        compression.count = compressionJson["count"];
+        compression.mode = ParseMeshoptMode(compressionJson["mode"]);
+        if (compressionJson.KeyExist("filter"))
+            compression.filter = ParseMeshoptFilter(compressionJson["filter"]);
+        return (compression);
+    }
+
+    GltfIndex LoadIndex(Json::Node &gltfJson)
+    {
+        GltfIndex gltfIndex;
+
+        if (gltfJson.KeyExist("accessors"))
+        {
+            for (auto &&accessorJson: gltfJson["accessors"])
+            {
+                AccessorInfo accessor = AccessorInfo();
+                accessor.bufferView = accessorJson.KeyExist("bufferView") ? (int)accessorJson["bufferView"] : -1;
+                accessor.byteOffset = accessorJson.KeyExist("byteOffset") ? (size_t)accessorJson["byteOffset"] : 0;
+                accessor.count = accessorJson["count"];
+                accessor.componentType = static_cast<ComponentType>((int)accessorJson["componentType"]);
+                accessor.type = ParseAccessorType(accessorJson["type"]);
+                accessor.normalized = accessorJson.KeyExist("normalized") && (bool)accessorJson["normalized"];
+                accessor.hasBounds = accessorJson.KeyExist("min") && accessorJson.KeyExist("max");
+                if (accessor.hasBounds)
+                {
+                    LoadBounds(accessorJson["min"], accessor.min);
+                    LoadBounds(accessorJson["max"], accessor.max);
+                }
+                gltfIndex.accessors.push_back(accessor);
+            }
+        }
+
+        if (gltfJson.KeyExist("bufferViews"))
+        {
+            for (auto &&bufferViewJson: gltfJson["bufferViews"])
+            {
+                BufferViewInfo bufferView;
+                bufferView.buffer = bufferViewJson["buffer"];
+                bufferView.byteOffset = bufferViewJson.KeyExist("byteOffset") ? (size_t)bufferViewJson["byteOffset"] : 0;
+                bufferView.byteLength = bufferViewJson["byteLength"];
+                bufferView.byteStride = bufferViewJson.KeyExist("byteStride") ? (size_t)bufferViewJson["byteStride"] : 0;
+                bufferView.compressed = bufferViewJson.KeyExist("extensions") && bufferViewJson["extensions"].KeyExist("EXT_meshopt_compression");
+                if (bufferView.compressed)
+                    bufferView.compression = LoadMeshoptCompression(bufferViewJson["extensions"]["EXT_meshopt_compression"]);
+                gltfIndex.bufferViews.push_back(bufferView);
+            }
+        }
+
+        if (gltfJson.KeyExist("buffers"))
+        {
+            for (auto &&bufferJson: gltfJson["buffers"])
+            {
+                BufferInfo buffer;
+                buffer.byteLength = bufferJson["byteLength"];
+                gltfIndex.buffers.push_back(buffer);
+            }
+        }
+
+        return (gltfIndex);
+    }
+
+    const CompressedBufferView *DecodedBufferViews::Add(const CompressedBufferView &view)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(view.index);
+        if (it == entries.end())
+        {
+            it = entries.emplace(view.index, Entry()).first;
+            it->second.view = view;
+            it->second.view.cache = this;
+        }
+        return (&it->second.view);
+    }
+
+    std::shared_ptr<const std::vector<unsigned char>> DecodedBufferViews::Get(const CompressedBufferView &view)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const Entry &entry = entries.at(view.index);
+            if (entry.decoded)
+                return (entry.decoded);
+        }
+
+        std::shared_ptr<std::vector<unsigned char>> decoded = std::make_shared<std::vector<unsigned char>>(view.byteLength);
+        {
+            StageTimer timer(LoadStage::MESHOPT_DECODE, view.byteLength);
+            DecodeMeshopt(decoded->data(), view.compression, view.src);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        Entry &entry = entries.at(view.index);
+        if (!entry.decoded)
+            entry.decoded = decoded;
+        return (entry.decoded);
+    }
+
+    void DecodedBufferViews::Evict(size_t bufferViewIndex)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(bufferViewIndex);
+        if (it != entries.end())
+            it->second.decoded.reset();
+    }
+
+    void DecodedBufferViews::EvictAll()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto &entry: entries)
+            entry.second.decoded.reset();
+    }
+
+    size_t DecodedBufferViews::GetResidentBytes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t bytes = 0;
+        for (const auto &entry: entries)
+        {
+            if (entry.second.decoded)
+                bytes += entry.second.decoded->size();
+        }
+        return (bytes);
+    }
+
+    Accessor LoadedBufferViews::Load(const Accessor &accessor)
+    {
+        if (!accessor.compressed || accessor.data)
+            return (accessor);
+
+        std::shared_ptr<const std::vector<unsigned char>> decoded = accessor.compressed->cache->Get(*accessor.compressed);
+        views.push_back(decoded);
+        Accessor loaded = accessor;
+        loaded.data = decoded->data() + accessor.compressedOffset;
+        return (loaded);
+    }
+
+    const std::map<std::string, Accessor> &LoadedBufferViews::Load(const std::map<std::string, Accessor> &accessors)
+    {
+        bool compressed = false;
+        for (const auto &accessor: accessors)
+            compressed = compressed || (accessor.second.compressed && !accessor.second.data);
+        if (!compressed)
+            return (accessors);
+
+        attributes.clear();
+        for (const auto &accessor: accessors)
+            attributes.emplace(accessor.first, Load(accessor.second));
+        return (attributes);
+    }
+
+    // only checked here, the decoding waits for the first decode function reading it
+    static const CompressedBufferView *ResolveCompressedBufferView(const GltfIndex &gltfIndex, const GlbView &glb, size_t bufferViewIndex)
+    {
+        const BufferViewInfo &bufferView = gltfIndex.bufferViews[bufferViewIndex];
+        const MeshoptCompression &compression = bufferView.compression;
+        if (compression.buffer != 0)
+            throw(std::runtime_error("bufferView " + std::to_string(bufferViewIndex) + " compressed data isn't in the GLB BIN chunk"));
+        if (compression.byteOffset > glb.bin.size() || compression.byteLength > glb.bin.size() - compression.byteOffset)
+            throw(std::runtime_error("bufferView " + std::to_string(bufferViewIndex) + " compressed data is out of the BIN chunk"));
+        if (compression.byteStride == 0 || bufferView.byteLength % compression.byteStride != 0 || compression.count != bufferView.byteLength / compression.byteStride)
+            throw(std::runtime_error("bufferView " + std::to_string(bufferViewIndex) + " byteLength doesn't match its compressed count and byteStride"));
+
+        CompressedBufferView view;
+        view.index = bufferViewIndex;
+        view.byteLength = bufferView.byteLength;
+        view.compression = compression;
+        view.src = reinterpret_cast<const unsigned char*>(glb.bin.data()) + compression.byteOffset;
+        view.cache = NULL;
+        return (gltfIndex.decodedViews->Add(view));
+    }
+
+    std::string_view ResolveBufferView(const GltfIndex &gltfIndex, const GlbView &glb, size_t bufferViewIndex)
+    {
+        if (bufferViewIndex >= gltfIndex.bufferViews.size())
+            throw(std::runtime_error("bufferView " + std::to_string(bufferViewIndex) + " doesn't exist"));
+
+        const BufferViewInfo &bufferView = gltfIndex.bufferViews[bufferViewIndex];
+        if (bufferView.compressed)
+            throw(std::runtime_error("bufferView " + std::to_string(bufferViewIndex) + " is compressed, only its accessors can be read"));
+        if (bufferView.buffer != 0)
+            throw(std::runtime_error("bufferView " + std::to_string(bufferViewIndex) + " isn't in the GLB BIN chunk"));
+        if (bufferView.byteOffset > glb.bin.size() || bufferView.byteLength > glb.bin.size() - bufferView.byteOffset)
+            throw(std::runtime_error("bufferView " + std::to_string(bufferViewIndex) + " is out of the BIN chunk"));
+
+        return (glb.bin.substr(bufferView.byteOffset, bufferView.byteLength));
+    }
+
+    std::string_view ResolveImageBufferView(const GltfIndex &gltfIndex, const GlbView &glb, size_t bufferViewIndex)
+    {
+        if (bufferViewIndex < gltfIndex.bufferViews.size() && gltfIndex.bufferViews[bufferViewIndex].compressed)
+            throw(std::runtime_error("image bufferView " + std::to_string(bufferViewIndex) + " can't be compressed with EXT_meshopt_compression"));
+        return (ResolveBufferView(gltfIndex, glb, bufferViewIndex));
+    }
+
+    Accessor ResolveAccessor(const GltfIndex &gltfIndex, const GlbView &glb, size_t accessorIndex)
+    {
+        if (accessorIndex >= gltfIndex.accessors.size())
+            throw(std::runtime_error("accessor " + std::to_string(accessorIndex) + " doesn't exist"));
+
+        const AccessorInfo &info = gltfIndex.accessors[accessorIndex];
+
+        Accessor accessor;
+        accessor.count = info.count;
+        accessor.nbComponent = NbComponent(info.type);
+        accessor.nbRow = NbRow(info.type);
+        accessor.columnStride = ColumnStride(info.type, info.componentType);
+        accessor.componentType = info.componentType;
+        accessor.normalized = info.normalized;
+        accessor.hasBounds = info.hasBounds && info.componentType == ComponentType::FLOAT;
+        std::copy(info.min, info.min + 4, accessor.min);
+        std::copy(info.max, info.max + 4, accessor.max);
+        size_t elementSize = ElementSize(accessor);
+        accessor.byteStride = elementSize;
+        accessor.data = NULL;
+        accessor.compressed = NULL;
+        accessor.compressedOffset = 0;
+
+        if (info.bufferView < 0)
+            return (accessor);
+
+        bool compressed = static_cast<size_t>(info.bufferView) < gltfIndex.bufferViews.size() && gltfIndex.bufferViews[info.bufferView].compressed;
+        std::string_view bufferView;
+        size_t bufferViewSize;
+        if (compressed)
+        {
+            accessor.compressed = ResolveCompressedBufferView(gltfIndex, glb, info.bufferView);
+            bufferViewSize = accessor.compressed->byteLength;
+        }
+        else
+        {
+            bufferView = ResolveBufferView(gltfIndex, glb, info.bufferView);
+            bufferViewSize = bufferView.size();
+        }
+        if (gltfIndex.bufferViews[info.bufferView].byteStride != 0)
+            accessor.byteStride = gltfIndex.bufferViews[info.bufferView].byteStride;
+        // each step is checked before the next one, the sizes come from the file and the products can overflow
+        if (accessor.count != 0 && (info.byteOffset > bufferViewSize || elementSize > bufferViewSize - info.byteOffset
+            || accessor.count - 1 > (bufferViewSize - info.byteOffset - elementSize) / accessor.byteStride))
+            throw(std::runtime_error("accessor " + std::to_string(accessorIndex) + " is out of its bufferView"));
+
+        if (compressed)
+            accessor.compressedOffset = info.byteOffset;
+        else
+            accessor.data = reinterpret_cast<const unsigned char*>(bufferView.data()) + info.byteOffset;
+        return (accessor);
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include <string>
+#include <memory>
+#include <mutex>
+#include "Json/Json.hpp"
+#include "GlbParser/Accessor.hpp"
+#include "GlbParser/GlbView.hpp"
+#include "GlbParser/MeshoptDecoder.hpp"
+
+namespace Glb
+{
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-accessor
+    struct AccessorInfo
+    {
+        int bufferView; // -1 when the accessor has no bufferView
+        size_t byteOffset;
+        size_t count;
+        ComponentType componentType;
+        AccessorType type;
+        bool normalized;
+        bool hasBounds; // min and max both given, only the 4 first components are kept
+        float min[4];
+        float max[4];
+    };
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-bufferview
+    struct BufferViewInfo
+    {
+        int buffer;
+        size_t byteOffset;
+        size_t byteLength;
+        size_t byteStride; // 0 when the elements are tightly packed
+        bool compressed; // EXT_meshopt_compression, buffer is then a fallback without data
+        MeshoptCompression compression;
+    };
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-buffer
+    struct BufferInfo
+    {
+        size_t byteLength;
+    };
+
+    class DecodedBufferViews;
+
+    // a bufferView compressed with EXT_meshopt_compression, checked when resolved but decoded on first read
+    struct CompressedBufferView
+    {
+        size_t index;
+        size_t byteLength; // once decoded
+        MeshoptCompression compression;
+        const unsigned char *src; // compressed bytes in the BIN chunk
+        DecodedBufferViews *cache; // holds this description and the decoded bytes
+    };
+
+    // decoded compressed bufferViews, filled by the decode functions and evicted like the meshes.
+    // the descriptions stay until the cache is destroyed, the accessors resolved from them point there
+    class DecodedBufferViews
+    {
+        private:
+            struct Entry
+            {
+                CompressedBufferView view;
+                std::shared_ptr<const std::vector<unsigned char>> decoded; // NULL until decoded or once evicted
+            };
+
+            mutable std::mutex mutex;
+            std::map<size_t, Entry> entries; // nodes never move
+
+        public:
+            const CompressedBufferView *Add(const CompressedBufferView &view); // the first one added for an index is kept
+            // decodes outside of the lock, if two threads decode the same view the first one stored wins
+            std::shared_ptr<const std::vector<unsigned char>> Get(const CompressedBufferView &view);
+            void Evict(size_t bufferViewIndex);
+            void EvictAll();
+            size_t GetResidentBytes() const;
+    };
+
+    // accessors reading compressed bufferViews with their data set, the decoded bytes are kept while it lives
+    class LoadedBufferViews
+    {
+        private:
+            std::vector<std::shared_ptr<const std::vector<unsigned char>>> views;
+            std::map<std::string, Accessor> attributes;
+
+        public:
+            Accessor Load(const Accessor &accessor);
+            // accessors itself when none of them is compressed, a map owned by this otherwise
+            const std::map<std::string, Accessor> &Load(const std::map<std::string, Accessor> &accessors);
+    };
+
+    // flat copy of the accessors, bufferViews and buffers, built once so loaders never walk the JSON for them
+    struct GltfIndex
+    {
+        std::vector<AccessorInfo> accessors;
+        std::vector<BufferViewInfo> bufferViews;
+        std::vector<BufferInfo> buffers;
+        std::shared_ptr<DecodedBufferViews> decodedViews; // shared with whatever keeps resolved accessors
+
+        GltfIndex()
+        {
+            decodedViews = std::make_shared<DecodedBufferViews>();
+        }
+    };
+
+    GltfIndex LoadIndex(Json::Node &gltfJson);
+    Accessor ResolveAccessor(const GltfIndex &gltfIndex, const GlbView &glb, size_t accessorIndex); // doesn't decode compressed bufferViews
+    std::string_view ResolveBufferView(const GltfIndex &gltfIndex, const GlbView &glb, size_t bufferViewIndex); // throws on compressed ones
+    std::string_view ResolveImageBufferView(const GltfIndex &gltfIndex, const GlbView &glb, size_t bufferViewIndex); // images keep pointing into the BIN chunk
+}
@@ -0,0 +1,283 @@
+#include "GlbParser/GltfReload.hpp"
+#include <cstring>
+#include <unordered_map>
+
+namespace Glb
+{
+    // every job on the pool, or in order on this thread without one
+    static void RunJobs(size_t count, ThreadPool *pool, const std::function<void(size_t job)> &function)
+    {
+        if (pool)
+            pool->ParallelFor(count, function);
+        else
+        {
+            for (size_t i = 0; i < count; i++)
+                function(i);
+        }
+    }
+
+    static GltfFingerprint GetFingerprint(const GltfData &data, const GltfSources &sources, ThreadPool *pool)
+    {
+        GltfFingerprint fingerprint;
+        fingerprint.meshes.resize(sources.meshes.size());
+        fingerprint.skins.resize(sources.skins.size());
+        fingerprint.animations.resize(sources.animations.size());
+        fingerprint.images.resize(data.images.size());
+
+        // hashing is most of a reload when little changed
+        size_t nbMesh = sources.meshes.size();
+        size_t nbSkin = sources.skins.size();
+        size_t nbAnimation = sources.animations.size();
+        RunJobs(nbMesh + nbSkin + nbAnimation + data.images.size(), pool, [&](size_t job)
+        {
+            if (job < nbMesh)
+                fingerprint.meshes[job] = GetContentKey(sources.meshes[job]);
+            else if ((job -= nbMesh) < nbSkin)
+                fingerprint.skins[job] = GetContentKey(sources.skins[job]);
+            else if ((job -= nbSkin) < nbAnimation)
+                fingerprint.animations[job] = GetContentKey(sources.animations[job]);
+            else
+                fingerprint.images[job - nbAnimation] = GetContentKey(data.images[job - nbAnimation]);
+        });
+
+        return (fingerprint);
+    }
+
+    static void DecodeSources(GltfData &data, const GltfSources &sources, ThreadPool *pool)
+    {
+        if (pool)
+            DecodeSources(data, sources, *pool);
+        else
+            DecodeSources(data, sources);
+    }
+
+    static ReloadableGltf LoadReloadableGltf(const GlbView &glb, ThreadPool *pool)
+    {
+        ReloadableGltf gltf;
+        GltfSources sources = LoadGltfSources(glb, gltf.data);
+        DecodeSources(gltf.data, sources, pool);
+        gltf.fingerprint = GetFingerprint(gltf.data, sources, pool);
+        return (gltf);
+    }
+
+    ReloadableGltf LoadReloadableGltf(const GlbView &glb)
+    {
+        return (LoadReloadableGltf(glb, NULL));
+    }
+
+    ReloadableGltf LoadReloadableGltf(const GlbView &glb, ThreadPool &pool)
+    {
+        return (LoadReloadableGltf(glb, &pool));
+    }
+
+    bool PartChanges::HasChanges() const
+    {
+        if (!changed.empty() || !removed.empty())
+            return (true);
+        for (size_t i = 0; i < previousIndex.size(); i++)
+        {
+            if (previousIndex[i] != static_cast<int>(i))
+                return (true);
+        }
+        return (false);
+    }
+
+    bool GltfChangeSet::HasChanges() const
+    {
+        return (rootSceneChanged || scenes.HasChanges() || nodes.HasChanges() || meshes.HasChanges() || skins.HasChanges()
+            || materials.HasChanges() || images.HasChanges() || textures.HasChanges() || animations.HasChanges());
+    }
+
+    // a part keeps the previous one at its index when the content is the same, or else any previous one
+    // with the same content, preferably one nothing kept yet
+    static void MatchByKey(const std::vector<ContentKey> &previous, const std::vector<ContentKey> &keys, PartChanges &changes)
+    {
+        std::unordered_map<ContentKey, std::vector<int>, ContentKeyHash> previousByKey;
+        for (size_t i = 0; i < previous.size(); i++)
+            previousByKey[previous[i]].push_back(i);
+
+        std::vector<bool> kept(previous.size(), false);
+        changes.previousIndex.assign(keys.size(), -1);
+        for (size_t i = 0; i < keys.size() && i < previous.size(); i++)
+        {
+            if (keys[i] == previous[i])
+            {
+                changes.previousIndex[i] = i;
+                kept[i] = true;
+            }
+        }
+
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            if (changes.previousIndex[i] != -1)
+                continue;
+
+            auto it = previousByKey.find(keys[i]);
+            if (it == previousByKey.end())
+            {
+                changes.changed.push_back(i);
+                continue;
+            }
+            int match = it->second[0];
+            for (int candidate: it->second)
+            {
+                if (!kept[candidate])
+                {
+                    match = candidate;
+                    break;
+                }
+            }
+            changes.previousIndex[i] = match;
+            kept[match] = true;
+        }
+
+        for (size_t i = 0; i < previous.size(); i++)
+        {
+            if (!kept[i])
+                changes.removed.push_back(i);
+        }
+    }
+
+    template <typename T, typename Equal>
+    static void MatchByIndex(const std::vector<T> &previous, const std::vector<T> &values, Equal equal, PartChanges &changes)
+    {
+        changes.previousIndex.assign(values.size(), -1);
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            if (i < previous.size() && equal(previous[i], values[i]))
+                changes.previousIndex[i] = i;
+            else
+                changes.changed.push_back(i);
+        }
+        for (size_t i = values.size(); i < previous.size(); i++)
+            changes.removed.push_back(i);
+    }
+
+    // moves the kept parts out of the previous data, a previous part kept twice is copied the second time
+    template <typename T>
+    static void KeepParts(std::vector<T> &previous, std::vector<T> &parts, const PartChanges &changes)
+    {
+        std::vector<int> keptBy(previous.size(), -1);
+        for (size_t i = 0; i < parts.size(); i++)
+        {
+            int index = changes.previousIndex[i];
+            if (index == -1)
+                continue;
+            if (keptBy[index] == -1)
+            {
+                parts[i] = std::move(previous[index]);
+                keptBy[index] = i;
+            }
+            else
+                parts[i] = parts[keptBy[index]];
+        }
+    }
+
+    static bool SameScene(const Scene &a, const Scene &b)
+    {
+        return (a.name == b.name && a.nodes == b.nodes);
+    }
+
+    static bool SameNode(const Node &a, const Node &b)
+    {
+        return (a.name == b.name && std::memcmp(&a.transform, &b.transform, sizeof(ml::mat4)) == 0
+            && a.children == b.children && a.mesh == b.mesh && a.skin == b.skin);
+    }
+
+    static bool SameMaterial(const Material &a, const Material &b)
+    {
+        const PbrMetallicRoughness &pbrA = a.pbr;
+        const PbrMetallicRoughness &pbrB = b.pbr;
+        return (a.name == b.name && std::memcmp(&pbrA.baseColorFactor, &pbrB.baseColorFactor, sizeof(ml::vec4)) == 0
+            && pbrA.baseColorTexture == pbrB.baseColorTexture && pbrA.metallicFactor == pbrB.metallicFactor
+            && pbrA.roughnessFactor == pbrB.roughnessFactor && pbrA.metallicRoughnessTexture == pbrB.metallicRoughnessTexture
+            && a.normalTexture == b.normalTexture && a.occlusionTexture == b.occlusionTexture && a.emissiveTexture == b.emissiveTexture
+            && std::memcmp(&a.emissiveFactor, &b.emissiveFactor, sizeof(ml::vec3)) == 0 && a.alphaMode == b.alphaMode
+            && a.alphaCutoff == b.alphaCutoff && a.doubleSided == b.doubleSided);
+    }
+
+    static bool SameTexture(const Texture &a, const Texture &b)
+    {
+        return (a.source == b.source);
+    }
+
+    static void CountBytes(const std::vector<ContentKey> &keys, const PartChanges &changes, GltfChangeSet &changeSet)
+    {
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            if (changes.previousIndex[i] == -1)
+                changeSet.decodedBytes += keys[i].sourceBytes;
+            else
+                changeSet.reusedBytes += keys[i].sourceBytes;
+        }
+    }
+
+    static GltfChangeSet ReloadGltf(ReloadableGltf &gltf, const GlbView &glb, ThreadPool *pool)
+    {
+        GltfData data;
+        GltfSources sources = LoadGltfSources(glb, data);
+        GltfFingerprint fingerprint = GetFingerprint(data, sources, pool);
+
+        GltfChangeSet changeSet;
+        GltfData &previous = gltf.data;
+        changeSet.rootSceneChanged = data.rootScene != previous.rootScene;
+        MatchByIndex(previous.scenes, data.scenes, SameScene, changeSet.scenes);
+        MatchByIndex(previous.nodes, data.nodes, SameNode, changeSet.nodes);
+        MatchByIndex(previous.materials, data.materials, SameMaterial, changeSet.materials);
+        MatchByIndex(previous.textures, data.textures, SameTexture, changeSet.textures);
+        MatchByKey(gltf.fingerprint.meshes, fingerprint.meshes, changeSet.meshes);
+        MatchByKey(gltf.fingerprint.skins, fingerprint.skins, changeSet.skins);
+        MatchByKey(gltf.fingerprint.animations, fingerprint.animations, changeSet.animations);
+        MatchByKey(gltf.fingerprint.images, fingerprint.images, changeSet.images);
+        CountBytes(fingerprint.meshes, changeSet.meshes, changeSet);
+        CountBytes(fingerprint.skins, changeSet.skins, changeSet);
+        CountBytes(fingerprint.animations, changeSet.animations, changeSet);
+
+        data.meshes.resize(sources.meshes.size());
+        data.skins.resize(sources.skins.size());
+        data.animations.resize(sources.animations.size());
+
+        const std::vector<size_t> &meshes = changeSet.meshes.changed;
+        const std::vector<size_t> &skins = changeSet.skins.changed;
+        const std::vector<size_t> &animations = changeSet.animations.changed;
+        RunJobs(meshes.size() + skins.size() + animations.size(), pool, [&](size_t job)
+        {
+            if (job < meshes.size())
+                data.meshes[meshes[job]] = DecodeMesh(sources.meshes[meshes[job]]);
+            else if ((job -= meshes.size()) < skins.size())
+                data.skins[skins[job]] = DecodeSkin(sources.skins[skins[job]]);
+            else
+            {
+                job -= skins.size();
+                data.animations[animations[job]] = DecodeAnimation(sources.animations[animations[job]]);
+            }
+        });
+
+        // only once the decoding succeeded, the previous data stays whole when it throws
+        KeepParts(previous.meshes, data.meshes, changeSet.meshes);
+        KeepParts(previous.skins, data.skins, changeSet.skins);
+        KeepParts(previous.animations, data.animations, changeSet.animations);
+
+        // the kept names point into the previous arena, the same strings are in the new one
+        for (size_t i = 0; i < data.meshes.size(); i++)
+            data.meshes[i].name = sources.meshes[i].name;
+        for (size_t i = 0; i < data.skins.size(); i++)
+            data.skins[i].name = sources.skins[i].name;
+        for (size_t i = 0; i < data.animations.size(); i++)
+            data.animations[i].name = sources.animations[i].name;
+
+        gltf.data = std::move(data);
+        gltf.fingerprint = std::move(fingerprint);
+        return (changeSet);
+    }
+
+    GltfChangeSet ReloadGltf(ReloadableGltf &gltf, const GlbView &glb)
+    {
+        return (ReloadGltf(gltf, glb, NULL));
+    }
+
+    GltfChangeSet ReloadGltf(ReloadableGltf &gltf, const GlbView &glb, ThreadPool &pool)
+    {
+        return (ReloadGltf(gltf, glb, &pool));
+    }
+}
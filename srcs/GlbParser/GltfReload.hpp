@@ -0,0 +1,66 @@
+#pragma once
+
+#include "GlbParser/ContentKey.hpp"
+
+namespace Glb
+{
+    // keys of the parts of a loaded file, compared with the ones of its next version
+    struct GltfFingerprint
+    {
+        std::vector<ContentKey> meshes;
+        std::vector<ContentKey> skins;
+        std::vector<ContentKey> animations;
+        std::vector<ContentKey> images;
+    };
+
+    struct ReloadableGltf
+    {
+        GltfData data;
+        GltfFingerprint fingerprint;
+    };
+
+    // meshes, skins, animations and images are matched by content, so a part that only moved keeps its
+    // previous one, and one only renamed is kept with its new name. Scenes, nodes, materials and textures
+    // are compared with the previous value at the same index
+    struct PartChanges
+    {
+        std::vector<int> previousIndex; // per part of the new version, the previous part it kept, -1 when it is new or changed
+        std::vector<size_t> changed; // parts of the new version that were decoded again (or are new values)
+        std::vector<size_t> removed; // previous parts nothing kept
+
+        bool HasChanges() const;
+    };
+
+    struct GltfChangeSet
+    {
+        PartChanges scenes;
+        PartChanges nodes;
+        PartChanges meshes;
+        PartChanges skins;
+        PartChanges materials;
+        PartChanges images;
+        PartChanges textures;
+        PartChanges animations;
+        bool rootSceneChanged;
+        size_t decodedBytes; // bytes read from the BIN chunk by the parts decoded again
+        size_t reusedBytes; // and by the parts kept
+
+        GltfChangeSet()
+        {
+            rootSceneChanged = false;
+            decodedBytes = 0;
+            reusedBytes = 0;
+        }
+
+        bool HasChanges() const;
+    };
+
+    ReloadableGltf LoadReloadableGltf(const GlbView &glb);
+    ReloadableGltf LoadReloadableGltf(const GlbView &glb, ThreadPool &pool);
+
+    // loads the new version of a file, only decoding the meshes, skins and animations whose content changed,
+    // the other ones are moved from the previous data. Like after LoadGltf, the images of the new data point
+    // into the new glb, the previous file can be unmapped
+    GltfChangeSet ReloadGltf(ReloadableGltf &gltf, const GlbView &glb);
+    GltfChangeSet ReloadGltf(ReloadableGltf &gltf, const GlbView &glb, ThreadPool &pool);
+}
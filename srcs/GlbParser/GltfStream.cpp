@@ -0,0 +1,682 @@
+#include "GlbParser/GlbParser.hpp"
+#include "GlbParser/JsonReader.hpp"
+#include "GlbParser/LoadStats.hpp"
+#include <stdexcept>
+
+// single pass over the JSON chunk with JsonReader, filling GltfData without building a Json::Node tree.
+// accessors can be declared after the meshes using them, so meshes, skins, animations and images
+// are first stored with their indices and resolved once the whole chunk has been read
+namespace Glb
+{
+    struct PrimitiveRefs
+    {
+        std::map<std::string, int> attributes;
+        int indices = -1;
+        int material = -1;
+    };
+
+    struct MeshRefs
+    {
+        std::string_view name;
+        std::vector<PrimitiveRefs> primitives;
+    };
+
+    struct SkinRefs
+    {
+        std::string_view name;
+        std::vector<int> joints;
+        int inverseBindMatrices = -1;
+    };
+
+    struct SamplerRefs
+    {
+        int input = -1;
+        int output = -1;
+        Interpolation interpolation = Interpolation::LINEAR;
+    };
+
+    struct AnimationRefs
+    {
+        std::string_view name;
+        std::vector<Channel> channels;
+        std::vector<SamplerRefs> samplers;
+    };
+
+    struct ImageRefs
+    {
+        std::string_view name;
+        int bufferView = -1;
+    };
+
+    struct GltfRefs
+    {
+        std::vector<MeshRefs> meshes;
+        std::vector<SkinRefs> skins;
+        std::vector<AnimationRefs> animations;
+        std::vector<ImageRefs> images;
+    };
+
+    template <typename Vector>
+    static void ReadIntArray(JsonReader &reader, Vector &values)
+    {
+        values.clear();
+        reader.BeginArray();
+        while (reader.NextElement())
+            values.push_back(reader.ReadInt());
+    }
+
+    // names without escape sequences go from the JSON chunk to the arena without a temporary string
+    static std::string_view ReadName(JsonReader &reader, GltfArena &arena)
+    {
+        std::string buffer;
+        return (arena.Intern(reader.ReadString(buffer)));
+    }
+
+    static void ReadFloatArray(JsonReader &reader, float *values, size_t nbValue)
+    {
+        size_t i = 0;
+        reader.BeginArray();
+        while (reader.NextElement())
+        {
+            float value = reader.ReadNumber();
+            if (i < nbValue)
+                values[i++] = value;
+        }
+    }
+
+    static int ReadTextureIndex(JsonReader &reader)
+    {
+        int index = -1;
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "index")
+                index = reader.ReadInt();
+            else
+                reader.Skip();
+        }
+        return (index);
+    }
+
+    static Scene ReadScene(JsonReader &reader, GltfArena &arena)
+    {
+        Scene scene(arena.GetResource());
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "name")
+                scene.name = ReadName(reader, arena);
+            else if (key == "nodes")
+                ReadIntArray(reader, scene.nodes);
+            else
+                reader.Skip();
+        }
+        return (scene);
+    }
+
+    static Node ReadNode(JsonReader &reader, GltfArena &arena)
+    {
+        Node node(arena.GetResource());
+
+        float translate[3] = {0, 0, 0};
+        float quat[4] = {0, 0, 0, 1};
+        float scale[3] = {1, 1, 1};
+
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "name")
+                node.name = ReadName(reader, arena);
+            else if (key == "children")
+                ReadIntArray(reader, node.children);
+            else if (key == "mesh")
+                node.mesh = reader.ReadInt();
+            else if (key == "skin")
+                node.skin = reader.ReadInt();
+            else if (key == "translation")
+                ReadFloatArray(reader, translate, 3);
+            else if (key == "rotation")
+                ReadFloatArray(reader, quat, 4);
+            else if (key == "scale")
+                ReadFloatArray(reader, scale, 3);
+            else
+                reader.Skip();
+        }
+
+        node.transform = CalculateTransform(ml::vec3(translate[0], translate[1], translate[2]),
+                                            ml::vec4(quat[0], quat[1], quat[2], quat[3]),
+                                            ml::vec3(scale[0], scale[1], scale[2]));
+        return (node);
+    }
+
+    static PrimitiveRefs ReadPrimitive(JsonReader &reader)
+    {
+        PrimitiveRefs primitive;
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "attributes")
+            {
+                std::string_view attribute;
+                reader.BeginObject();
+                while (reader.NextKey(attribute))
+                    primitive.attributes[std::string(attribute)] = reader.ReadInt();
+            }
+            else if (key == "indices")
+                primitive.indices = reader.ReadInt();
+            else if (key == "material")
+                primitive.material = reader.ReadInt();
+            else
+                reader.Skip();
+        }
+        return (primitive);
+    }
+
+    static MeshRefs ReadMesh(JsonReader &reader, GltfArena &arena)
+    {
+        MeshRefs mesh;
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "name")
+                mesh.name = ReadName(reader, arena);
+            else if (key == "primitives")
+            {
+                reader.BeginArray();
+                while (reader.NextElement())
+                    mesh.primitives.push_back(ReadPrimitive(reader));
+            }
+            else
+                reader.Skip();
+        }
+        return (mesh);
+    }
+
+    static SkinRefs ReadSkin(JsonReader &reader, GltfArena &arena)
+    {
+        SkinRefs skin;
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "name")
+                skin.name = ReadName(reader, arena);
+            else if (key == "joints")
+                ReadIntArray(reader, skin.joints);
+            else if (key == "inverseBindMatrices")
+                skin.inverseBindMatrices = reader.ReadInt();
+            else
+                reader.Skip();
+        }
+        return (skin);
+    }
+
+    static PbrMetallicRoughness ReadPBR(JsonReader &reader)
+    {
+        PbrMetallicRoughness pbr;
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "baseColorFactor")
+            {
+                float factor[4] = {1, 1, 1, 1};
+                ReadFloatArray(reader, factor, 4);
+                pbr.baseColorFactor = ml::vec4(factor[0], factor[1], factor[2], factor[3]);
+            }
+            else if (key == "baseColorTexture")
+                pbr.baseColorTexture = ReadTextureIndex(reader);
+            else if (key == "metallicFactor")
+                pbr.metallicFactor = reader.ReadNumber();
+            else if (key == "roughnessFactor")
+                pbr.roughnessFactor = reader.ReadNumber();
+            else if (key == "metallicRoughnessTexture")
+                pbr.metallicRoughnessTexture = ReadTextureIndex(reader);
+            else
+                reader.Skip();
+        }
+        return (pbr);
+    }
+
+    static Material ReadMaterial(JsonReader &reader, GltfArena &arena)
+    {
+        Material material;
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "name")
+                material.name = ReadName(reader, arena);
+            else if (key == "pbrMetallicRoughness")
+                material.pbr = ReadPBR(reader);
+            else if (key == "normalTexture")
+                material.normalTexture = ReadTextureIndex(reader);
+            else if (key == "occlusionTexture")
+                material.occlusionTexture = ReadTextureIndex(reader);
+            else if (key == "emissiveTexture")
+                material.emissiveTexture = ReadTextureIndex(reader);
+            else if (key == "emissiveFactor")
+            {
+                float factor[3] = {0, 0, 0};
+                ReadFloatArray(reader, factor, 3);
+                material.emissiveFactor = ml::vec3(factor[0], factor[1], factor[2]);
+            }
+            else if (key == "alphaMode")
+            {
+                std::string buffer;
+                material.alphaMode = ParseAlphaMode(reader.ReadString(buffer));
+            }
+            else if (key == "alphaCutoff")
+                material.alphaCutoff = reader.ReadNumber();
+            else if (key == "doubleSided")
+                material.doubleSided = reader.ReadBool();
+            else
+                reader.Skip();
+        }
+        return (material);
+    }
+
+    static ImageRefs ReadImage(JsonReader &reader, GltfArena &arena)
+    {
+        ImageRefs image;
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "name")
+                image.name = ReadName(reader, arena);
+            else if (key == "bufferView")
+                image.bufferView = reader.ReadInt();
+            else
+                reader.Skip();
+        }
+        return (image);
+    }
+
+    static Texture ReadTexture(JsonReader &reader)
+    {
+        Texture texture;
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "source")
+                texture.source = reader.ReadInt();
+            else
+                reader.Skip();
+        }
+        return (texture);
+    }
+
+    static Channel ReadChannel(JsonReader &reader)
+    {
+        Channel channel;
+        channel.sampler = -1;
+        channel.node = -1;
+        channel.path = AnimationPath::TRANSLATION;
+
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "sampler")
+                channel.sampler = reader.ReadInt();
+            else if (key == "target")
+            {
+                std::string_view targetKey;
+                reader.BeginObject();
+                while (reader.NextKey(targetKey))
+                {
+                    if (targetKey == "node")
+                        channel.node = reader.ReadInt();
+                    else if (targetKey == "path")
+                    {
+                        std::string buffer;
+                        channel.path = ParseAnimationPath(reader.ReadString(buffer));
+                    }
+                    else
+                        reader.Skip();
+                }
+            }
+            else
+                reader.Skip();
+        }
+        return (channel);
+    }
+
+    static SamplerRefs ReadSampler(JsonReader &reader)
+    {
+        SamplerRefs sampler;
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "input")
+                sampler.input = reader.ReadInt();
+            else if (key == "output")
+                sampler.output = reader.ReadInt();
+            else if (key == "interpolation")
+            {
+                std::string buffer;
+                sampler.interpolation = ParseInterpolation(reader.ReadString(buffer));
+            }
+            else
+                reader.Skip();
+        }
+        return (sampler);
+    }
+
+    static AnimationRefs ReadAnimation(JsonReader &reader, GltfArena &arena)
+    {
+        AnimationRefs animation;
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "name")
+                animation.name = ReadName(reader, arena);
+            else if (key == "channels")
+            {
+                reader.BeginArray();
+                while (reader.NextElement())
+                    animation.channels.push_back(ReadChannel(reader));
+            }
+            else if (key == "samplers")
+            {
+                reader.BeginArray();
+                while (reader.NextElement())
+                    animation.samplers.push_back(ReadSampler(reader));
+            }
+            else
+                reader.Skip();
+        }
+        return (animation);
+    }
+
+    static AccessorInfo ReadAccessorInfo(JsonReader &reader)
+    {
+        AccessorInfo accessor;
+        accessor.bufferView = -1;
+        accessor.byteOffset = 0;
+        accessor.count = 0;
+        accessor.componentType = ComponentType::FLOAT;
+        accessor.type = AccessorType::SCALAR;
+        accessor.normalized = false;
+        float min[4] = {0, 0, 0, 0};
+        float max[4] = {0, 0, 0, 0};
+        bool hasMin = false;
+        bool hasMax = false;
+
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "bufferView")
+                accessor.bufferView = reader.ReadInt();
+            else if (key == "byteOffset")
+                accessor.byteOffset = reader.ReadSize();
+            else if (key == "count")
+                accessor.count = reader.ReadSize();
+            else if (key == "componentType")
+                accessor.componentType = static_cast<ComponentType>(reader.ReadInt());
+            else if (key == "type")
+                accessor.type = ParseAccessorType(reader.ReadString());
+            else if (key == "normalized")
+                accessor.normalized = reader.ReadBool();
+            else if (key == "min")
+            {
+                ReadFloatArray(reader, min, 4);
+                hasMin = true;
+            }
+            else if (key == "max")
+            {
+                ReadFloatArray(reader, max, 4);
+                hasMax = true;
+            }
+            else
+                reader.Skip();
+        }
+        accessor.hasBounds = hasMin && hasMax;
+        std::copy(min, min + 4, accessor.min);
+        std::copy(max, max + 4, accessor.max);
+        return (accessor);
+    }
+
+    static MeshoptCompression ReadMeshoptCompression(JsonReader &reader)
+    {
+        MeshoptCompression compression;
+
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "buffer")
+                compression.buffer = reader.ReadInt();
+            else if (key == "byteOffset")
+                compression.byteOffset = reader.ReadSize();
+            else if (key == "byteLength")
+                compression.byteLength = reader.ReadSize();
+            else if (key == "byteStride")
+                compression.byteStride = reader.ReadSize();
+            else if (key == "count")
+                compression.count = reader.ReadSize();
+            else if (key == "mode")
+                compression.mode = ParseMeshoptMode(reader.ReadString());
+            else if (key == "filter")
+                compression.filter = ParseMeshoptFilter(reader.ReadString());
+            else
+                reader.Skip();
+        }
+        return (compression);
+    }
+
+    static BufferViewInfo ReadBufferViewInfo(JsonReader &reader)
+    {
+        BufferViewInfo bufferView;
+        bufferView.buffer = 0;
+        bufferView.byteOffset = 0;
+        bufferView.byteLength = 0;
+        bufferView.byteStride = 0;
+        bufferView.compressed = false;
+
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "buffer")
+                bufferView.buffer = reader.ReadInt();
+            else if (key == "byteOffset")
+                bufferView.byteOffset = reader.ReadSize();
+            else if (key == "byteLength")
+                bufferView.byteLength = reader.ReadSize();
+            else if (key == "byteStride")
+                bufferView.byteStride = reader.ReadSize();
+            else if (key == "extensions")
+            {
+                std::string_view extension;
+                reader.BeginObject();
+                while (reader.NextKey(extension))
+                {
+                    if (extension == "EXT_meshopt_compression")
+                    {
+                        bufferView.compression = ReadMeshoptCompression(reader);
+                        bufferView.compressed = true;
+                    }
+                    else
+                        reader.Skip();
+                }
+            }
+            else
+                reader.Skip();
+        }
+        return (bufferView);
+    }
+
+    static BufferInfo ReadBufferInfo(JsonReader &reader)
+    {
+        BufferInfo buffer;
+        buffer.byteLength = 0;
+
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "byteLength")
+                buffer.byteLength = reader.ReadSize();
+            else
+                reader.Skip();
+        }
+        return (buffer);
+    }
+
+    template <typename T>
+    static void ReadArray(JsonReader &reader, std::vector<T> &values, T (*readElement)(JsonReader &))
+    {
+        reader.BeginArray();
+        while (reader.NextElement())
+            values.push_back(readElement(reader));
+    }
+
+    template <typename T>
+    static void ReadArray(JsonReader &reader, std::vector<T> &values, GltfArena &arena, T (*readElement)(JsonReader &, GltfArena &))
+    {
+        reader.BeginArray();
+        while (reader.NextElement())
+            values.push_back(readElement(reader, arena));
+    }
+
+    static void ReadGltf(JsonReader &reader, GltfData &data, GltfIndex &gltfIndex, GltfRefs &refs)
+    {
+        data.rootScene = 0;
+
+        std::string_view key;
+        reader.BeginObject();
+        while (reader.NextKey(key))
+        {
+            if (key == "scene")
+                data.rootScene = reader.ReadInt();
+            else if (key == "scenes")
+                ReadArray(reader, data.scenes, *data.arena, ReadScene);
+            else if (key == "nodes")
+                ReadArray(reader, data.nodes, *data.arena, ReadNode);
+            else if (key == "meshes")
+                ReadArray(reader, refs.meshes, *data.arena, ReadMesh);
+            else if (key == "skins")
+                ReadArray(reader, refs.skins, *data.arena, ReadSkin);
+            else if (key == "materials")
+                ReadArray(reader, data.materials, *data.arena, ReadMaterial);
+            else if (key == "images")
+                ReadArray(reader, refs.images, *data.arena, ReadImage);
+            else if (key == "textures")
+                ReadArray(reader, data.textures, ReadTexture);
+            else if (key == "animations")
+                ReadArray(reader, refs.animations, *data.arena, ReadAnimation);
+            else if (key == "accessors")
+                ReadArray(reader, gltfIndex.accessors, ReadAccessorInfo);
+            else if (key == "bufferViews")
+                ReadArray(reader, gltfIndex.bufferViews, ReadBufferViewInfo);
+            else if (key == "buffers")
+                ReadArray(reader, gltfIndex.buffers, ReadBufferInfo);
+            else
+                reader.Skip();
+        }
+    }
+
+    static GltfSources ResolveRefs(GltfData &data, const GltfRefs &refs, const GltfIndex &gltfIndex, const GlbView &glb)
+    {
+        GltfSources sources;
+        sources.decodedViews = gltfIndex.decodedViews;
+        sources.meshes.reserve(refs.meshes.size());
+        sources.skins.reserve(refs.skins.size());
+        sources.animations.reserve(refs.animations.size());
+        data.images.reserve(refs.images.size());
+
+        for (const MeshRefs &meshRefs: refs.meshes)
+        {
+            MeshSource mesh;
+            mesh.name = meshRefs.name;
+            mesh.primitives.reserve(meshRefs.primitives.size());
+            for (const PrimitiveRefs &primitiveRefs: meshRefs.primitives)
+            {
+                PrimitiveSource primitive;
+                for (const auto &attribute: primitiveRefs.attributes)
+                    primitive.attributes[attribute.first] = ResolveAccessor(gltfIndex, glb, attribute.second);
+                primitive.hasIndices = primitiveRefs.indices >= 0;
+                if (primitive.hasIndices)
+                    primitive.indices = ResolveAccessor(gltfIndex, glb, primitiveRefs.indices);
+                primitive.material = primitiveRefs.material;
+                mesh.primitives.push_back(primitive);
+            }
+            sources.meshes.push_back(mesh);
+        }
+
+        for (const SkinRefs &skinRefs: refs.skins)
+        {
+            SkinSource skin;
+            skin.name = skinRefs.name;
+            skin.joints = skinRefs.joints;
+            skin.inverseBindMatrices = ResolveAccessor(gltfIndex, glb, skinRefs.inverseBindMatrices);
+            sources.skins.push_back(skin);
+        }
+
+        for (const AnimationRefs &animationRefs: refs.animations)
+        {
+            AnimationSource animation;
+            animation.name = animationRefs.name;
+            animation.channels = animationRefs.channels;
+            animation.samplers.reserve(animationRefs.samplers.size());
+            for (const SamplerRefs &samplerRefs: animationRefs.samplers)
+            {
+                SamplerSource sampler;
+                sampler.interpolation = samplerRefs.interpolation;
+                sampler.input = ResolveAccessor(gltfIndex, glb, samplerRefs.input);
+                sampler.output = ResolveAccessor(gltfIndex, glb, samplerRefs.output);
+                animation.samplers.push_back(sampler);
+            }
+            sources.animations.push_back(animation);
+        }
+
+        for (const ImageRefs &imageRefs: refs.images)
+        {
+            std::string_view bufferView = ResolveImageBufferView(gltfIndex, glb, imageRefs.bufferView);
+
+            Image image;
+            image.name = imageRefs.name;
+            image.buffer = (unsigned char*)bufferView.data();
+            image.bufferLength = bufferView.size();
+            data.images.push_back(image);
+        }
+
+        return (sources);
+    }
+
+    GltfSources LoadGltfSources(const GlbView &glb, GltfData &data)
+    {
+        StageTimer timer(LoadStage::JSON_PARSE, glb.json.size());
+        GltfIndex gltfIndex;
+        GltfRefs refs;
+
+        JsonReader reader(glb.json);
+        ReadGltf(reader, data, gltfIndex, refs);
+        return (ResolveRefs(data, refs, gltfIndex, glb));
+    }
+
+    GltfData LoadGltf(const GlbView &glb)
+    {
+        GltfData data;
+        DecodeSources(data, LoadGltfSources(glb, data));
+        return (data);
+    }
+
+    GltfData LoadGltf(const GlbView &glb, ThreadPool &pool)
+    {
+        GltfData data;
+        DecodeSources(data, LoadGltfSources(glb, data), pool);
+        return (data);
+    }
+}
@@ -0,0 +1,24 @@
+#include "GlbParser/Hash.hpp"
+#include <cstring>
+
+namespace Glb
+{
+    uint64_t HashBytes(std::string_view bytes)
+    {
+        const uint64_t prime = 0x100000001B3ULL;
+        uint64_t hash = 0xCBF29CE484222325ULL ^ bytes.size();
+
+        size_t i = 0;
+        for (; i + 8 <= bytes.size(); i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, bytes.data() + i, sizeof(word));
+            hash = (hash ^ word) * prime;
+            hash ^= hash >> 29;
+        }
+        for (; i < bytes.size(); i++)
+            hash = (hash ^ static_cast<unsigned char>(bytes[i])) * prime;
+
+        return (hash);
+    }
+}
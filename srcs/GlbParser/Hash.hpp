@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace Glb
+{
+    // FNV-1a on 8-byte words, fast but not collision resistant: equal hashes only mean the bytes are likely equal
+    uint64_t HashBytes(std::string_view bytes);
+}
@@ -0,0 +1,601 @@
+#include "GlbParser/ImageDecoder.hpp"
+#include <stdexcept>
+#include <cstring>
+#include <cstdlib>
+
+namespace Glb
+{
+    // Inflate (RFC 1950 and 1951)
+
+    class BitReader
+    {
+        private:
+            const unsigned char *data;
+            const unsigned char *end;
+            uint64_t buffer;
+            size_t nbBit;
+            size_t nbPadding; // zero bits added past the end, reading them means the stream is truncated
+
+            void Refill()
+            {
+                while (nbBit <= 56)
+                {
+                    if (data < end)
+                        buffer |= static_cast<uint64_t>(*data++) << nbBit;
+                    else
+                        nbPadding += 8;
+                    nbBit += 8;
+                }
+            }
+
+        public:
+            BitReader(const unsigned char *data, size_t length)
+            {
+                this->data = data;
+                this->end = data + length;
+                buffer = 0;
+                nbBit = 0;
+                nbPadding = 0;
+            }
+
+            uint32_t Peek(size_t count)
+            {
+                if (nbBit < count)
+                    Refill();
+                return (static_cast<uint32_t>(buffer & ((1ull << count) - 1)));
+            }
+
+            void Consume(size_t count)
+            {
+                buffer >>= count;
+                nbBit -= count;
+                if (nbBit < nbPadding)
+                    throw(std::runtime_error("deflate stream is truncated"));
+            }
+
+            uint32_t Read(size_t count)
+            {
+                uint32_t value = Peek(count);
+                Consume(count);
+                return (value);
+            }
+
+            void AlignToByte()
+            {
+                Consume(nbBit % 8);
+            }
+    };
+
+    static const size_t fastBits = 10;
+
+    struct Huffman
+    {
+        uint16_t counts[16];
+        uint16_t symbols[288];
+        uint16_t fast[1 << fastBits]; // (length << 9) | symbol for the codes up to fastBits long, 0 for the others
+    };
+
+    static void BuildHuffman(Huffman &huffman, const uint8_t *lengths, size_t nbSymbol)
+    {
+        std::memset(huffman.counts, 0, sizeof(huffman.counts));
+        for (size_t i = 0; i < nbSymbol; i++)
+            huffman.counts[lengths[i]]++;
+        huffman.counts[0] = 0;
+
+        int left = 1;
+        for (size_t length = 1; length < 16; length++)
+        {
+            left = left * 2 - huffman.counts[length];
+            if (left < 0)
+                throw(std::runtime_error("deflate stream has an over-subscribed huffman code"));
+        }
+
+        uint16_t offsets[16];
+        uint16_t nextCode[16];
+        offsets[1] = 0;
+        nextCode[1] = 0;
+        for (size_t length = 1; length < 15; length++)
+        {
+            offsets[length + 1] = offsets[length] + huffman.counts[length];
+            nextCode[length + 1] = (nextCode[length] + huffman.counts[length]) << 1;
+        }
+
+        std::memset(huffman.fast, 0, sizeof(huffman.fast));
+        for (size_t symbol = 0; symbol < nbSymbol; symbol++)
+        {
+            size_t length = lengths[symbol];
+            if (length == 0)
+                continue;
+            huffman.symbols[offsets[length]++] = static_cast<uint16_t>(symbol);
+
+            // codes are stored most significant bit first, the table is indexed by the next bits of the stream
+            uint32_t code = nextCode[length]++;
+            if (length > fastBits)
+                continue;
+            uint32_t reversed = 0;
+            for (size_t i = 0; i < length; i++)
+                reversed |= ((code >> i) & 1) << (length - 1 - i);
+            for (uint32_t i = reversed; i < (1u << fastBits); i += 1u << length)
+                huffman.fast[i] = static_cast<uint16_t>((length << 9) | symbol);
+        }
+    }
+
+    static uint32_t DecodeSymbol(BitReader &reader, const Huffman &huffman)
+    {
+        uint16_t entry = huffman.fast[reader.Peek(fastBits)];
+        if (entry != 0)
+        {
+            reader.Consume(entry >> 9);
+            return (entry & 511);
+        }
+
+        // canonical decoding one bit at a time for the long codes
+        int code = 0;
+        int first = 0;
+        int index = 0;
+        for (size_t length = 1; length < 16; length++)
+        {
+            code |= reader.Read(1);
+            int count = huffman.counts[length];
+            if (code - count < first)
+                return (huffman.symbols[index + (code - first)]);
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+        throw(std::runtime_error("deflate stream has an invalid huffman code"));
+    }
+
+    static const uint16_t lengthBases[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const uint8_t lengthExtras[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const uint16_t distanceBases[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static const uint8_t distanceExtras[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    static void ReadDynamicTables(BitReader &reader, Huffman &literals, Huffman &distances)
+    {
+        static const uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+        size_t nbLiteral = reader.Read(5) + 257;
+        size_t nbDistance = reader.Read(5) + 1;
+        size_t nbCodeLength = reader.Read(4) + 4;
+        if (nbLiteral > 286 || nbDistance > 30)
+            throw(std::runtime_error("deflate stream has too many codes"));
+
+        uint8_t lengths[286 + 30] = {};
+        for (size_t i = 0; i < nbCodeLength; i++)
+            lengths[order[i]] = static_cast<uint8_t>(reader.Read(3));
+        Huffman codeLengths;
+        BuildHuffman(codeLengths, lengths, 19);
+
+        std::memset(lengths, 0, sizeof(lengths));
+        size_t i = 0;
+        while (i < nbLiteral + nbDistance)
+        {
+            uint32_t symbol = DecodeSymbol(reader, codeLengths);
+            if (symbol < 16)
+            {
+                lengths[i++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+
+            uint8_t value = 0;
+            size_t repeat;
+            if (symbol == 16)
+            {
+                if (i == 0)
+                    throw(std::runtime_error("deflate stream repeats a code length before the first one"));
+                value = lengths[i - 1];
+                repeat = 3 + reader.Read(2);
+            }
+            else if (symbol == 17)
+                repeat = 3 + reader.Read(3);
+            else
+                repeat = 11 + reader.Read(7);
+
+            if (i + repeat > nbLiteral + nbDistance)
+                throw(std::runtime_error("deflate stream has too many code lengths"));
+            std::memset(lengths + i, value, repeat);
+            i += repeat;
+        }
+
+        BuildHuffman(literals, lengths, nbLiteral);
+        BuildHuffman(distances, lengths + nbLiteral, nbDistance);
+    }
+
+    static void BuildFixedTables(Huffman &literals, Huffman &distances)
+    {
+        uint8_t lengths[288];
+        std::memset(lengths, 8, 144);
+        std::memset(lengths + 144, 9, 112);
+        std::memset(lengths + 256, 7, 24);
+        std::memset(lengths + 280, 8, 8);
+        BuildHuffman(literals, lengths, 288);
+        std::memset(lengths, 5, 30);
+        BuildHuffman(distances, lengths, 30);
+    }
+
+    // zlib stream into out, which already has the expected size
+    static void Inflate(const unsigned char *data, size_t length, std::vector<uint8_t> &out)
+    {
+        if (length < 2 || (data[0] & 0x0f) != 8 || ((data[0] << 8) | data[1]) % 31 != 0 || (data[1] & 0x20))
+            throw(std::runtime_error("zlib stream has an unsupported header"));
+
+        BitReader reader(data + 2, length - 2);
+        size_t size = 0;
+        bool last = false;
+        while (!last)
+        {
+            last = reader.Read(1);
+            uint32_t type = reader.Read(2);
+            if (type == 0)
+            {
+                reader.AlignToByte();
+                uint32_t blockLength = reader.Read(16);
+                if ((reader.Read(16) ^ 0xffff) != blockLength)
+                    throw(std::runtime_error("deflate stored block has a wrong length"));
+                if (size + blockLength > out.size())
+                    throw(std::runtime_error("deflate stream is bigger than expected"));
+                for (uint32_t i = 0; i < blockLength; i++)
+                    out[size++] = static_cast<uint8_t>(reader.Read(8));
+                continue;
+            }
+            if (type == 3)
+                throw(std::runtime_error("deflate stream has an invalid block type"));
+
+            Huffman literals;
+            Huffman distances;
+            if (type == 1)
+                BuildFixedTables(literals, distances);
+            else
+                ReadDynamicTables(reader, literals, distances);
+
+            while (true)
+            {
+                uint32_t symbol = DecodeSymbol(reader, literals);
+                if (symbol < 256)
+                {
+                    if (size == out.size())
+                        throw(std::runtime_error("deflate stream is bigger than expected"));
+                    out[size++] = static_cast<uint8_t>(symbol);
+                    continue;
+                }
+                if (symbol == 256)
+                    break;
+
+                symbol -= 257;
+                if (symbol >= 29)
+                    throw(std::runtime_error("deflate stream has an invalid length"));
+                size_t copyLength = lengthBases[symbol] + reader.Read(lengthExtras[symbol]);
+                uint32_t distanceSymbol = DecodeSymbol(reader, distances);
+                if (distanceSymbol >= 30)
+                    throw(std::runtime_error("deflate stream has an invalid distance"));
+                size_t distance = distanceBases[distanceSymbol] + reader.Read(distanceExtras[distanceSymbol]);
+                if (distance > size)
+                    throw(std::runtime_error("deflate stream points before its start"));
+                if (size + copyLength > out.size())
+                    throw(std::runtime_error("deflate stream is bigger than expected"));
+
+                // the source can overlap the destination
+                uint8_t *dst = out.data() + size;
+                const uint8_t *src = dst - distance;
+                for (size_t i = 0; i < copyLength; i++)
+                    dst[i] = src[i];
+                size += copyLength;
+            }
+        }
+
+        if (size != out.size())
+            throw(std::runtime_error("deflate stream is smaller than expected"));
+    }
+
+    // PNG
+
+    static const unsigned char pngSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+    bool IsPng(const unsigned char *data, size_t length)
+    {
+        return (length >= 8 && std::memcmp(data, pngSignature, 8) == 0);
+    }
+
+    bool IsJpeg(const unsigned char *data, size_t length)
+    {
+        return (length >= 3 && data[0] == 0xff && data[1] == 0xd8 && data[2] == 0xff);
+    }
+
+    static uint32_t ReadBigEndian32(const unsigned char *data)
+    {
+        return ((static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) | (static_cast<uint32_t>(data[2]) << 8) | data[3]);
+    }
+
+    struct PngInfo
+    {
+        uint32_t width;
+        uint32_t height;
+        uint32_t bitDepth;
+        uint32_t colorType;
+        size_t nbChannel;
+        uint8_t palette[256][4];
+        bool hasColorKey; // tRNS of a gray or RGB image
+        uint32_t colorKey[3];
+    };
+
+    static size_t RowSize(const PngInfo &info, size_t width)
+    {
+        return ((width * info.nbChannel * info.bitDepth + 7) / 8);
+    }
+
+    static uint8_t Paeth(int a, int b, int c)
+    {
+        int p = a + b - c;
+        int pa = std::abs(p - a);
+        int pb = std::abs(p - b);
+        int pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc)
+            return (static_cast<uint8_t>(a));
+        return (static_cast<uint8_t>(pb <= pc ? b : c));
+    }
+
+    static void Unfilter(uint8_t *rows, size_t rowSize, size_t nbRow, size_t pixelSize)
+    {
+        std::vector<uint8_t> zeros(rowSize, 0);
+        const uint8_t *previous = zeros.data();
+        for (size_t y = 0; y < nbRow; y++)
+        {
+            uint8_t filter = rows[y * (rowSize + 1)];
+            uint8_t *row = rows + y * (rowSize + 1) + 1;
+            switch (filter)
+            {
+                case 0:
+                    break;
+                case 1:
+                    for (size_t i = pixelSize; i < rowSize; i++)
+                        row[i] += row[i - pixelSize];
+                    break;
+                case 2:
+                    for (size_t i = 0; i < rowSize; i++)
+                        row[i] += previous[i];
+                    break;
+                case 3:
+                    for (size_t i = 0; i < rowSize; i++)
+                        row[i] += static_cast<uint8_t>(((i >= pixelSize ? row[i - pixelSize] : 0) + previous[i]) / 2);
+                    break;
+                case 4:
+                    for (size_t i = 0; i < rowSize; i++)
+                    {
+                        if (i < pixelSize)
+                            row[i] += previous[i];
+                        else
+                            row[i] += Paeth(row[i - pixelSize], previous[i], previous[i - pixelSize]);
+                    }
+                    break;
+                default:
+                    throw(std::runtime_error("png has an unknown filter: " + std::to_string(filter)));
+            }
+            previous = row;
+        }
+    }
+
+    static uint32_t ReadSample(const uint8_t *row, size_t index, uint32_t bitDepth)
+    {
+        if (bitDepth == 8)
+            return (row[index]);
+        else if (bitDepth == 16)
+            return ((static_cast<uint32_t>(row[index * 2]) << 8) | row[index * 2 + 1]);
+        size_t bit = index * bitDepth;
+        return ((row[bit / 8] >> (8 - bitDepth - bit % 8)) & ((1u << bitDepth) - 1));
+    }
+
+    static uint8_t ScaleSample(uint32_t sample, uint32_t bitDepth)
+    {
+        if (bitDepth == 16)
+            return (static_cast<uint8_t>(sample >> 8));
+        return (static_cast<uint8_t>(sample * 255 / ((1u << bitDepth) - 1)));
+    }
+
+    static void WritePixels(const PngInfo &info, const uint8_t *rows, size_t passWidth, size_t passHeight, size_t x0, size_t y0, size_t dx, size_t dy, std::vector<uint8_t> &rgba)
+    {
+        size_t rowSize = RowSize(info, passWidth);
+        for (size_t y = 0; y < passHeight; y++)
+        {
+            const uint8_t *row = rows + y * (rowSize + 1) + 1;
+            if (info.colorType == 6 && info.bitDepth == 8 && dx == 1)
+            {
+                std::memcpy(rgba.data() + (y0 + y * dy) * info.width * 4, row, rowSize);
+                continue;
+            }
+
+            for (size_t x = 0; x < passWidth; x++)
+            {
+                uint8_t *pixel = rgba.data() + ((y0 + y * dy) * info.width + x0 + x * dx) * 4;
+                uint32_t samples[4];
+                for (size_t c = 0; c < info.nbChannel; c++)
+                    samples[c] = ReadSample(row, x * info.nbChannel + c, info.bitDepth);
+
+                switch (info.colorType)
+                {
+                    case 3:
+                        if (samples[0] >= 256)
+                            throw(std::runtime_error("png palette index is out of the palette"));
+                        std::memcpy(pixel, info.palette[samples[0]], 4);
+                        break;
+                    case 0:
+                    case 4:
+                        pixel[0] = pixel[1] = pixel[2] = ScaleSample(samples[0], info.bitDepth);
+                        pixel[3] = info.colorType == 4 ? ScaleSample(samples[1], info.bitDepth) : 255;
+                        if (info.hasColorKey && samples[0] == info.colorKey[0])
+                            pixel[3] = 0;
+                        break;
+                    default:
+                        for (size_t c = 0; c < 3; c++)
+                            pixel[c] = ScaleSample(samples[c], info.bitDepth);
+                        pixel[3] = info.colorType == 6 ? ScaleSample(samples[3], info.bitDepth) : 255;
+                        if (info.hasColorKey && samples[0] == info.colorKey[0] && samples[1] == info.colorKey[1] && samples[2] == info.colorKey[2])
+                            pixel[3] = 0;
+                        break;
+                }
+            }
+        }
+    }
+
+    void DecodePng(const unsigned char *data, size_t length, uint32_t &width, uint32_t &height, std::vector<uint8_t> &rgba)
+    {
+        if (!IsPng(data, length))
+            throw(std::runtime_error("png signature is missing"));
+
+        PngInfo info = PngInfo();
+        for (size_t i = 0; i < 256; i++)
+        {
+            info.palette[i][0] = info.palette[i][1] = info.palette[i][2] = 0;
+            info.palette[i][3] = 255;
+        }
+        uint32_t interlace = 0;
+        bool hasHeader = false;
+        std::vector<uint8_t> compressed;
+
+        size_t offset = 8;
+        while (true)
+        {
+            if (offset + 12 > length)
+                throw(std::runtime_error("png is truncated"));
+            size_t chunkLength = ReadBigEndian32(data + offset);
+            const unsigned char *type = data + offset + 4;
+            const unsigned char *chunk = data + offset + 8;
+            if (chunkLength > length - offset - 12)
+                throw(std::runtime_error("png chunk is out of the file"));
+            offset += chunkLength + 12; // the CRC isn't checked
+
+            if (std::memcmp(type, "IHDR", 4) == 0)
+            {
+                if (chunkLength != 13)
+                    throw(std::runtime_error("png IHDR has a wrong size"));
+                info.width = ReadBigEndian32(chunk);
+                info.height = ReadBigEndian32(chunk + 4);
+                info.bitDepth = chunk[8];
+                info.colorType = chunk[9];
+                interlace = chunk[12];
+                static const size_t nbChannels[7] = {1, 0, 3, 1, 2, 0, 4};
+                if (info.colorType > 6 || nbChannels[info.colorType] == 0)
+                    throw(std::runtime_error("png color type unknown: " + std::to_string(info.colorType)));
+                info.nbChannel = nbChannels[info.colorType];
+                bool validDepth = info.bitDepth == 8 || (info.bitDepth == 16 && info.colorType != 3)
+                               || ((info.bitDepth == 1 || info.bitDepth == 2 || info.bitDepth == 4) && (info.colorType == 0 || info.colorType == 3));
+                if (!validDepth || chunk[10] != 0 || chunk[11] != 0 || interlace > 1)
+                    throw(std::runtime_error("png IHDR is invalid"));
+                if (info.width == 0 || info.height == 0 || static_cast<uint64_t>(info.width) * info.height > (1ull << 30))
+                    throw(std::runtime_error("png size is invalid"));
+                hasHeader = true;
+            }
+            else if (!hasHeader)
+                throw(std::runtime_error("png doesn't start with IHDR"));
+            else if (std::memcmp(type, "PLTE", 4) == 0)
+            {
+                for (size_t i = 0; i < chunkLength / 3 && i < 256; i++)
+                    std::memcpy(info.palette[i], chunk + i * 3, 3);
+            }
+            else if (std::memcmp(type, "tRNS", 4) == 0)
+            {
+                if (info.colorType == 3)
+                {
+                    for (size_t i = 0; i < chunkLength && i < 256; i++)
+                        info.palette[i][3] = chunk[i];
+                }
+                else if (info.colorType == 0 && chunkLength >= 2)
+                {
+                    info.hasColorKey = true;
+                    info.colorKey[0] = (chunk[0] << 8) | chunk[1];
+                }
+                else if (info.colorType == 2 && chunkLength >= 6)
+                {
+                    info.hasColorKey = true;
+                    for (size_t c = 0; c < 3; c++)
+                        info.colorKey[c] = (chunk[c * 2] << 8) | chunk[c * 2 + 1];
+                }
+            }
+            else if (std::memcmp(type, "IDAT", 4) == 0)
+                compressed.insert(compressed.end(), chunk, chunk + chunkLength);
+            else if (std::memcmp(type, "IEND", 4) == 0)
+                break;
+            else if (!(type[0] & 0x20))
+                throw(std::runtime_error("png has an unknown critical chunk: " + std::string(reinterpret_cast<const char*>(type), 4)));
+        }
+
+        // Adam7 passes, a non interlaced image is a single pass
+        static const size_t adam7[7][4] = {{0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8}, {2, 0, 4, 4}, {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2}};
+        static const size_t single[1][4] = {{0, 0, 1, 1}};
+        const size_t (*passes)[4] = interlace ? adam7 : single;
+        size_t nbPass = interlace ? 7 : 1;
+
+        size_t passWidths[7];
+        size_t passHeights[7];
+        size_t inflatedSize = 0;
+        for (size_t pass = 0; pass < nbPass; pass++)
+        {
+            passWidths[pass] = info.width > passes[pass][0] ? (info.width - passes[pass][0] + passes[pass][2] - 1) / passes[pass][2] : 0;
+            passHeights[pass] = info.height > passes[pass][1] ? (info.height - passes[pass][1] + passes[pass][3] - 1) / passes[pass][3] : 0;
+            if (passWidths[pass] != 0)
+                inflatedSize += passHeights[pass] * (RowSize(info, passWidths[pass]) + 1);
+        }
+
+        // deflate expands at most 1032 times (258 bytes per 2 bits), a tiny file claiming a huge size fails before allocating it
+        if (inflatedSize / 1032 > compressed.size())
+            throw(std::runtime_error("png data is too small for its size"));
+        std::vector<uint8_t> inflated(inflatedSize);
+        Inflate(compressed.data(), compressed.size(), inflated);
+
+        width = info.width;
+        height = info.height;
+        rgba.assign(static_cast<size_t>(width) * height * 4, 0);
+
+        size_t pixelSize = (info.nbChannel * info.bitDepth + 7) / 8;
+        uint8_t *rows = inflated.data();
+        for (size_t pass = 0; pass < nbPass; pass++)
+        {
+            if (passWidths[pass] == 0 || passHeights[pass] == 0)
+                continue;
+            size_t rowSize = RowSize(info, passWidths[pass]);
+            Unfilter(rows, rowSize, passHeights[pass], pixelSize);
+            WritePixels(info, rows, passWidths[pass], passHeights[pass], passes[pass][0], passes[pass][1], passes[pass][2], passes[pass][3], rgba);
+            rows += passHeights[pass] * (rowSize + 1);
+        }
+    }
+
+    // Mips
+
+    void GenerateMipChain(DecodedImage &image)
+    {
+        if (image.levels.empty())
+            return;
+        image.levels.resize(1);
+
+        size_t width = image.width;
+        size_t height = image.height;
+        while (width > 1 || height > 1)
+        {
+            size_t mipWidth = width > 1 ? width / 2 : 1;
+            size_t mipHeight = height > 1 ? height / 2 : 1;
+            const std::vector<uint8_t> &src = image.levels.back();
+            std::vector<uint8_t> dst(mipWidth * mipHeight * 4);
+
+            // odd sizes drop their last row or column, 1 pixel wide sizes average the same pixel twice
+            for (size_t y = 0; y < mipHeight; y++)
+            {
+                size_t y0 = y * 2;
+                size_t y1 = height > 1 ? y0 + 1 : y0;
+                for (size_t x = 0; x < mipWidth; x++)
+                {
+                    size_t x0 = x * 2;
+                    size_t x1 = width > 1 ? x0 + 1 : x0;
+                    for (size_t c = 0; c < 4; c++)
+                    {
+                        uint32_t sum = src[(y0 * width + x0) * 4 + c] + src[(y0 * width + x1) * 4 + c] + src[(y1 * width + x0) * 4 + c] + src[(y1 * width + x1) * 4 + c];
+                        dst[(y * mipWidth + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                    }
+                }
+            }
+
+            image.levels.push_back(std::move(dst));
+            width = mipWidth;
+            height = mipHeight;
+        }
+    }
+}
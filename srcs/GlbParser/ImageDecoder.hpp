@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Glb
+{
+    struct DecodedImage
+    {
+        std::string name;
+        uint32_t width;
+        uint32_t height;
+        std::vector<std::vector<uint8_t>> levels; // RGBA8, levels[0] is the image, then each mip halves the size down to 1x1
+    };
+
+    bool IsPng(const unsigned char *data, size_t length);
+    bool IsJpeg(const unsigned char *data, size_t length);
+
+    // every color type, bit depth and Adam7 interlacing, 16 bits channels keep their high byte, throws on malformed files
+    void DecodePng(const unsigned char *data, size_t length, uint32_t &width, uint32_t &height, std::vector<uint8_t> &rgba);
+
+    // box filtered mips appended to levels[0], the color values are averaged as they are (no sRGB conversion)
+    void GenerateMipChain(DecodedImage &image);
+}
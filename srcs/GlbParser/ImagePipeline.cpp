@@ -0,0 +1,160 @@
+#include "GlbParser/ImagePipeline.hpp"
+#include "GlbParser/Hash.hpp"
+#include "GlbParser/LoadStats.hpp"
+#include <stdexcept>
+#include <cstring>
+
+namespace Glb
+{
+    DecodedImage DecodeImage(const std::string &name, const unsigned char *data, size_t length, const ImageDecodeOptions &options)
+    {
+        StageTimer timer(LoadStage::IMAGE, length);
+        DecodedImage image;
+        image.name = name;
+        image.levels.resize(1);
+        if (IsPng(data, length))
+            DecodePng(data, length, image.width, image.height, image.levels[0]);
+        else if (!options.decoder || !options.decoder(data, length, image.width, image.height, image.levels[0]))
+            throw(std::runtime_error("image " + name + " has a format without decoder" + (IsJpeg(data, length) ? " (JPEG)" : "")));
+
+        if (image.levels[0].size() != static_cast<size_t>(image.width) * image.height * 4)
+            throw(std::runtime_error("image " + name + " decoder returned a wrong number of pixels"));
+        if (options.generateMips)
+            GenerateMipChain(image);
+        return (image);
+    }
+
+    ImagePipeline::ImagePipeline(ThreadPool &pool, const ImageDecodeOptions &options) : pool(pool)
+    {
+        this->options = options;
+        nbPending = 0;
+    }
+
+    ImagePipeline::~ImagePipeline()
+    {
+        WaitPending();
+    }
+
+    void ImagePipeline::Run(std::shared_ptr<Job> job, std::shared_ptr<std::promise<std::shared_ptr<const DecodedImage>>> promise, const std::string &name)
+    {
+        try
+        {
+            promise->set_value(std::make_shared<const DecodedImage>(DecodeImage(name, job->bytes->data(), job->bytes->size(), options)));
+        }
+        catch (...)
+        {
+            promise->set_exception(std::current_exception());
+        }
+
+        // callbacks added from now on are called by Submit
+        std::vector<Callback> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job->done = true;
+            callbacks.swap(job->callbacks);
+        }
+        // an exception leaving the task would end the worker thread and nbPending would never reach 0
+        std::exception_ptr error;
+        for (const Callback &callback: callbacks)
+        {
+            try
+            {
+                callback(job->future);
+            }
+            catch (...)
+            {
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error && !callbackError)
+            callbackError = error;
+        nbPending--;
+        finished.notify_all();
+    }
+
+    ImageFuture ImagePipeline::Submit(const Image &image, const Callback &callback)
+    {
+        std::string_view bytes(reinterpret_cast<const char*>(image.buffer), image.bufferLength);
+        std::pair<uint64_t, size_t> key(HashBytes(bytes), bytes.size());
+
+        std::unique_lock<std::mutex> lock(mutex);
+        auto range = jobs.equal_range(key);
+        auto it = range.first;
+        while (it != range.second && !bytes.empty() && std::memcmp(it->second->bytes->data(), bytes.data(), bytes.size()) != 0)
+            it++;
+        if (it != range.second)
+        {
+            std::shared_ptr<Job> job = it->second;
+            if (!job->done)
+            {
+                if (callback)
+                    job->callbacks.push_back(callback);
+                return (job->future);
+            }
+            lock.unlock();
+            if (callback)
+                callback(job->future);
+            return (job->future);
+        }
+
+        std::shared_ptr<std::promise<std::shared_ptr<const DecodedImage>>> promise = std::make_shared<std::promise<std::shared_ptr<const DecodedImage>>>();
+        std::shared_ptr<Job> job = std::make_shared<Job>();
+        job->bytes = std::make_shared<const std::vector<uint8_t>>(image.buffer, image.buffer + image.bufferLength);
+        job->future = promise->get_future().share();
+        job->done = false;
+        if (callback)
+            job->callbacks.push_back(callback);
+        jobs.emplace(key, job);
+        nbPending++;
+        lock.unlock();
+
+        std::string name(image.name);
+        pool.Submit([this, job, promise, name]()
+        {
+            Run(job, promise, name);
+        });
+        return (job->future);
+    }
+
+    std::vector<ImageFuture> ImagePipeline::Submit(const std::vector<Image> &images, const Callback &callback)
+    {
+        std::vector<ImageFuture> futures;
+        futures.reserve(images.size());
+        for (const Image &image: images)
+            futures.push_back(Submit(image, callback));
+        return (futures);
+    }
+
+    void ImagePipeline::WaitPending()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this]() { return (nbPending == 0); });
+    }
+
+    void ImagePipeline::Wait()
+    {
+        WaitPending();
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            error.swap(callbackError);
+        }
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    void ImagePipeline::Clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = jobs.begin(); it != jobs.end();)
+        {
+            if (it->second->done)
+                it = jobs.erase(it);
+            else
+                it++;
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <map>
+#include <future>
+#include "GlbParser/GlbParser.hpp"
+#include "GlbParser/ImageDecoder.hpp"
+
+namespace Glb
+{
+    typedef std::shared_future<std::shared_ptr<const DecodedImage>> ImageFuture;
+
+    // decoder for the formats that aren't built in (JPEG...), fills width, height and RGBA8 pixels,
+    // returns false when it doesn't handle the data
+    typedef std::function<bool(const unsigned char *data, size_t length, uint32_t &width, uint32_t &height, std::vector<uint8_t> &rgba)> ImageDecoderFunction;
+
+    struct ImageDecodeOptions
+    {
+        bool generateMips;
+        ImageDecoderFunction decoder; // tried after the built-in PNG decoder
+
+        ImageDecodeOptions()
+        {
+            generateMips = false;
+        }
+    };
+
+    // decodes images on a ThreadPool. The compressed bytes are copied when an image is submitted,
+    // so the Image and the file it points into can be dropped right after.
+    // Images with the same bytes (e.g. sharing a bufferView) are decoded once and share their result, which
+    // has the name of the first one. They are looked up by hash and length, then compared byte for byte, so
+    // the compressed bytes stay with the results until Clear() or the destruction.
+    class ImagePipeline
+    {
+        public:
+            // called once the future is ready, on the worker thread or right away in Submit when the bytes
+            // were already decoded, get() rethrows the decoding error if any. What a callback throws on a
+            // worker thread is rethrown by Wait()
+            typedef std::function<void(const ImageFuture &future)> Callback;
+
+        private:
+            struct Job
+            {
+                std::shared_ptr<const std::vector<uint8_t>> bytes;
+                ImageFuture future;
+                std::vector<Callback> callbacks;
+                bool done;
+            };
+
+            ThreadPool &pool;
+            ImageDecodeOptions options;
+            std::mutex mutex;
+            std::condition_variable finished;
+            std::multimap<std::pair<uint64_t, size_t>, std::shared_ptr<Job>> jobs; // several when different bytes collide
+            size_t nbPending;
+            std::exception_ptr callbackError; // the first one thrown on a worker thread since the last Wait()
+
+            void Run(std::shared_ptr<Job> job, std::shared_ptr<std::promise<std::shared_ptr<const DecodedImage>>> promise, const std::string &name);
+            void WaitPending();
+
+        public:
+            ImagePipeline(ThreadPool &pool, const ImageDecodeOptions &options = ImageDecodeOptions());
+            ImagePipeline(const ImagePipeline &) = delete;
+            ~ImagePipeline(); // waits for the submitted images
+
+            ImagePipeline &operator=(const ImagePipeline &) = delete;
+
+            ImageFuture Submit(const Image &image, const Callback &callback = Callback());
+            std::vector<ImageFuture> Submit(const std::vector<Image> &images, const Callback &callback = Callback());
+            void Wait(); // not from a task of the same pool, rethrows the first exception of a callback
+            void Clear(); // forgets the finished images, the futures already returned stay valid
+    };
+
+    DecodedImage DecodeImage(const std::string &name, const unsigned char *data, size_t length, const ImageDecodeOptions &options = ImageDecodeOptions()); // on the calling thread
+}
@@ -0,0 +1,132 @@
+#include "GlbParser/IndexBuffer.hpp"
+#include "GlbParser/GltfIndex.hpp"
+#include "GlbParser/VertexKernels.hpp"
+#include "GlbParser/LoadStats.hpp"
+#include <stdexcept>
+
+namespace Glb
+{
+    IndexBuffer::IndexBuffer(ComponentType componentType)
+    {
+        this->componentType = componentType;
+    }
+
+    uint32_t IndexBuffer::Get(size_t index) const
+    {
+        switch (componentType)
+        {
+            case ComponentType::UNSIGNED_BYTE:
+                return (data[index]);
+            case ComponentType::UNSIGNED_SHORT:
+                return (ConvertRawComponent<uint32_t, uint16_t>(data.data() + index * 2, false, 1.0f));
+            default:
+                return (ConvertRawComponent<uint32_t, uint32_t>(data.data() + index * 4, false, 1.0f));
+        }
+    }
+
+    void IndexBuffer::Set(size_t index, uint32_t value)
+    {
+        switch (componentType)
+        {
+            case ComponentType::UNSIGNED_BYTE:
+                data[index] = static_cast<uint8_t>(value);
+                break;
+            case ComponentType::UNSIGNED_SHORT:
+            {
+                uint16_t narrow = static_cast<uint16_t>(value);
+                std::memcpy(data.data() + index * 2, &narrow, sizeof(narrow));
+                break;
+            }
+            default:
+                std::memcpy(data.data() + index * 4, &value, sizeof(value));
+                break;
+        }
+    }
+
+    std::vector<uint32_t> IndexBuffer::ToUint32() const
+    {
+        std::vector<uint32_t> indices(Size());
+        if (indices.empty())
+            return (indices);
+
+        if (componentType == ComponentType::UNSIGNED_SHORT)
+            Kernels::WidenU16ToU32(reinterpret_cast<const uint16_t*>(data.data()), indices.data(), indices.size());
+        else if (componentType == ComponentType::UNSIGNED_INT)
+            std::memcpy(indices.data(), data.data(), data.size());
+        else
+        {
+            for (size_t i = 0; i < indices.size(); i++)
+                indices[i] = data[i];
+        }
+        return (indices);
+    }
+
+    void IndexBuffer::Assign(const std::vector<uint32_t> &indices, size_t nbVertex)
+    {
+        componentType = SmallestIndexType(nbVertex);
+        Resize(indices.size());
+        if (indices.empty())
+            return;
+
+        if (componentType == ComponentType::UNSIGNED_SHORT)
+            Kernels::NarrowU32ToU16(indices.data(), reinterpret_cast<uint16_t*>(data.data()), indices.size());
+        else if (componentType == ComponentType::UNSIGNED_INT)
+            std::memcpy(data.data(), indices.data(), data.size());
+        else
+        {
+            for (size_t i = 0; i < indices.size(); i++)
+                data[i] = static_cast<uint8_t>(indices[i]);
+        }
+    }
+
+    ComponentType SmallestIndexType(size_t nbVertex)
+    {
+        if (nbVertex <= 256)
+            return (ComponentType::UNSIGNED_BYTE);
+        else if (nbVertex <= 65536)
+            return (ComponentType::UNSIGNED_SHORT);
+        return (ComponentType::UNSIGNED_INT);
+    }
+
+    template <typename T>
+    static void CopyIndices(IndexBuffer &indices, const Accessor &accessor)
+    {
+        T *dst = reinterpret_cast<T*>(indices.data.data());
+        if (accessor.data && accessor.byteStride == sizeof(T))
+            std::memcpy(dst, accessor.data, accessor.count * sizeof(T));
+        else
+            AccessorView<T>(accessor).CopyTo(dst);
+    }
+
+    void DecodeIndices(IndexBuffer &indices, const Accessor &resolvedAccessor)
+    {
+        LoadedBufferViews views;
+        Accessor accessor = views.Load(resolvedAccessor);
+        if (accessor.nbComponent != 1)
+            throw(std::runtime_error("indices must be SCALAR"));
+
+        indices.componentType = accessor.componentType;
+        switch (accessor.componentType)
+        {
+            case ComponentType::UNSIGNED_BYTE:
+            case ComponentType::UNSIGNED_SHORT:
+            case ComponentType::UNSIGNED_INT:
+                break;
+            default:
+                throw(std::runtime_error("indices component type must be unsigned: " + std::to_string(static_cast<int>(accessor.componentType))));
+        }
+
+        StageTimer timer(LoadStage::ACCESSOR_DECODE);
+        indices.Resize(accessor.count);
+        timer.SetBytes(indices.data.size());
+        if (accessor.count == 0)
+            return;
+
+        if (accessor.componentType == ComponentType::UNSIGNED_BYTE)
+            CopyIndices<uint8_t>(indices, accessor);
+        else if (accessor.componentType == ComponentType::UNSIGNED_SHORT)
+            CopyIndices<uint16_t>(indices, accessor);
+        else
+            CopyIndices<uint32_t>(indices, accessor);
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include "GlbParser/Accessor.hpp"
+
+namespace Glb
+{
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-mesh-primitive
+    // indices keep the type of the file: UNSIGNED_BYTE, UNSIGNED_SHORT or UNSIGNED_INT
+    struct IndexBuffer
+    {
+        ComponentType componentType;
+        std::vector<unsigned char> data; // Size() indices of ComponentSize(componentType) bytes
+
+        IndexBuffer(ComponentType componentType = ComponentType::UNSIGNED_SHORT);
+
+        size_t Size() const { return (data.size() / ComponentSize(componentType)); }
+        bool Empty() const { return (data.empty()); }
+        void Resize(size_t count) { data.resize(count * ComponentSize(componentType)); }
+        uint32_t Get(size_t index) const;
+        void Set(size_t index, uint32_t value);
+
+        template <typename T>
+        const T *Data() const
+        {
+            if (componentType != ComponentTypeOf<T>::value)
+                return (NULL);
+            return (reinterpret_cast<const T*>(data.data()));
+        }
+
+        std::vector<uint32_t> ToUint32() const;
+        void Assign(const std::vector<uint32_t> &indices, size_t nbVertex); // uses the smallest type able to index nbVertex vertices
+    };
+
+    ComponentType SmallestIndexType(size_t nbVertex);
+    void DecodeIndices(IndexBuffer &indices, const Accessor &accessor);
+}
@@ -0,0 +1,273 @@
+#include "GlbParser/JsonReader.hpp"
+#include <stdexcept>
+#include <cstdlib>
+#include <cctype>
+#include <cmath>
+#include <climits>
+#include <limits>
+
+namespace Glb
+{
+    JsonReader::JsonReader(std::string_view json)
+    {
+        this->json = json;
+        pos = 0;
+        first = false;
+    }
+
+    void JsonReader::Fail(const std::string &message) const
+    {
+        throw(std::runtime_error("JSON error at byte " + std::to_string(pos) + ": " + message));
+    }
+
+    void JsonReader::SkipWhitespace()
+    {
+        while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\n' || json[pos] == '\r' || json[pos] == '\t'))
+            pos++;
+    }
+
+    char JsonReader::Peek()
+    {
+        SkipWhitespace();
+        if (pos >= json.size())
+            Fail("unexpected end of input");
+        return (json[pos]);
+    }
+
+    void JsonReader::Expect(char c)
+    {
+        if (Peek() != c)
+            Fail(std::string("expected '") + c + "'");
+        pos++;
+    }
+
+    void JsonReader::BeginObject()
+    {
+        Expect('{');
+        first = true;
+    }
+
+    // a closed container is a value of its parent, which then needs a comma before its next member
+    bool JsonReader::NextMember(char close)
+    {
+        char c = Peek();
+        if (c == close)
+        {
+            pos++;
+            first = false;
+            return (false);
+        }
+        if (!first)
+        {
+            if (c != ',')
+                Fail(std::string("expected ',' or '") + close + "'");
+            pos++;
+            if (Peek() == close)
+                Fail("trailing comma");
+        }
+        first = false;
+        return (true);
+    }
+
+    bool JsonReader::NextKey(std::string_view &key)
+    {
+        if (!NextMember('}'))
+            return (false);
+        key = ReadRawString();
+        Expect(':');
+        return (true);
+    }
+
+    void JsonReader::BeginArray()
+    {
+        Expect('[');
+        first = true;
+    }
+
+    bool JsonReader::NextElement()
+    {
+        return (NextMember(']'));
+    }
+
+    std::string_view JsonReader::ReadRawString()
+    {
+        Expect('"');
+        size_t start = pos;
+        while (pos < json.size() && json[pos] != '"')
+        {
+            if (json[pos] == '\\')
+                pos++;
+            pos++;
+        }
+        if (pos >= json.size())
+            Fail("unterminated string");
+        return (json.substr(start, pos++ - start));
+    }
+
+    std::string_view JsonReader::ReadRawNumber()
+    {
+        Peek();
+        size_t start = pos;
+        while (pos < json.size() && (std::isdigit(static_cast<unsigned char>(json[pos]))
+            || json[pos] == '-' || json[pos] == '+' || json[pos] == '.' || json[pos] == 'e' || json[pos] == 'E'))
+            pos++;
+        if (start == pos)
+            Fail("expected a number");
+        return (json.substr(start, pos - start));
+    }
+
+    bool JsonReader::IsNull()
+    {
+        if (Peek() != 'n')
+            return (false);
+        if (json.substr(pos, 4) != "null")
+            Fail("invalid literal");
+        pos += 4;
+        return (true);
+    }
+
+    double JsonReader::ReadNumber()
+    {
+        // the chunk isn't null-terminated, strtod needs a bounded copy
+        std::string_view raw = ReadRawNumber();
+        char buffer[64];
+        if (raw.size() >= sizeof(buffer))
+            Fail("number too long");
+        raw.copy(buffer, raw.size());
+        buffer[raw.size()] = '\0';
+        return (std::strtod(buffer, NULL));
+    }
+
+    // the casts are undefined out of range, NaN fails the comparisons
+    int JsonReader::ReadInt()
+    {
+        double value = ReadNumber();
+        if (!(value >= INT_MIN && value <= INT_MAX) || value != std::floor(value))
+            Fail("expected an integer");
+        return (static_cast<int>(value));
+    }
+
+    size_t JsonReader::ReadSize()
+    {
+        double value = ReadNumber();
+        if (!(value >= 0 && value < static_cast<double>(std::numeric_limits<size_t>::max())) || value != std::floor(value))
+            Fail("expected a positive integer");
+        return (static_cast<size_t>(value));
+    }
+
+    bool JsonReader::ReadBool()
+    {
+        Peek();
+        if (json.substr(pos, 4) == "true")
+        {
+            pos += 4;
+            return (true);
+        }
+        if (json.substr(pos, 5) == "false")
+        {
+            pos += 5;
+            return (false);
+        }
+        Fail("expected a boolean");
+        return (false);
+    }
+
+    static std::string Unescape(std::string_view raw)
+    {
+        std::string str;
+        str.reserve(raw.size());
+        for (size_t i = 0; i < raw.size(); i++)
+        {
+            if (raw[i] != '\\' || i + 1 >= raw.size())
+            {
+                str += raw[i];
+                continue;
+            }
+
+            i++;
+            switch (raw[i])
+            {
+                case 'n': str += '\n'; break;
+                case 't': str += '\t'; break;
+                case 'r': str += '\r'; break;
+                case 'b': str += '\b'; break;
+                case 'f': str += '\f'; break;
+                case 'u':
+                {
+                    // encode the code point in UTF-8, surrogate pairs are kept as two code points
+                    unsigned long codePoint = std::strtoul(std::string(raw.substr(i + 1, 4)).c_str(), NULL, 16);
+                    i += 4;
+                    if (codePoint < 0x80)
+                        str += static_cast<char>(codePoint);
+                    else if (codePoint < 0x800)
+                    {
+                        str += static_cast<char>(0xC0 | (codePoint >> 6));
+                        str += static_cast<char>(0x80 | (codePoint & 0x3F));
+                    }
+                    else
+                    {
+                        str += static_cast<char>(0xE0 | (codePoint >> 12));
+                        str += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                        str += static_cast<char>(0x80 | (codePoint & 0x3F));
+                    }
+                    break;
+                }
+                default: str += raw[i]; break;
+            }
+        }
+        return (str);
+    }
+
+    std::string JsonReader::ReadString()
+    {
+        return (Unescape(ReadRawString()));
+    }
+
+    std::string_view JsonReader::ReadString(std::string &buffer)
+    {
+        std::string_view raw = ReadRawString();
+        if (raw.find('\\') == std::string_view::npos)
+            return (raw);
+        buffer = Unescape(raw);
+        return (buffer);
+    }
+
+    // iterative, a deeply nested value can't overflow the stack
+    void JsonReader::Skip()
+    {
+        std::string closes; // of the containers being skipped, innermost last
+        bool hasValue = true;
+        while (true)
+        {
+            if (hasValue)
+            {
+                char c = Peek();
+                if (c == '{')
+                {
+                    BeginObject();
+                    closes += '}';
+                }
+                else if (c == '[')
+                {
+                    BeginArray();
+                    closes += ']';
+                }
+                else if (c == '"')
+                    ReadRawString();
+                else if (c == 't' || c == 'f')
+                    ReadBool();
+                else if (c == 'n')
+                    IsNull();
+                else
+                    ReadRawNumber();
+            }
+            if (closes.empty())
+                return;
+
+            std::string_view key;
+            hasValue = closes.back() == '}' ? NextKey(key) : NextElement();
+            if (!hasValue)
+                closes.pop_back();
+        }
+    }
+}
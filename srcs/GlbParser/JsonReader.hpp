@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace Glb
+{
+    // pull-based JSON reader working directly on the JSON chunk, no DOM is built.
+    // objects are read with BeginObject() then NextKey() until it returns false,
+    // arrays with BeginArray() then NextElement() until it returns false,
+    // every value not read must be skipped with Skip(). Members must be separated by exactly one comma
+    class JsonReader
+    {
+        private:
+            std::string_view json;
+            size_t pos;
+            bool first; // no member of the innermost container was read yet
+
+            void SkipWhitespace();
+            char Peek();
+            void Expect(char c);
+            void Fail(const std::string &message) const;
+            std::string_view ReadRawString();
+            std::string_view ReadRawNumber();
+            bool NextMember(char close);
+
+        public:
+            JsonReader(std::string_view json);
+
+            void BeginObject();
+            bool NextKey(std::string_view &key); // key is raw, escape sequences aren't decoded
+            void BeginArray();
+            bool NextElement();
+
+            bool IsNull();
+            double ReadNumber();
+            int ReadInt();
+            size_t ReadSize();
+            bool ReadBool();
+            std::string ReadString();
+            std::string_view ReadString(std::string &buffer); // points into the JSON, or into buffer when it had escape sequences
+            void Skip();
+
+            size_t GetPosition() const { return (pos); }
+    };
+}
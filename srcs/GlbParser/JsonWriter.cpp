@@ -0,0 +1,134 @@
+#include "GlbParser/JsonWriter.hpp"
+#include <cmath>
+#include <charconv>
+#include <stdexcept>
+
+namespace Glb
+{
+    JsonWriter::JsonWriter()
+    {
+        afterKey = false;
+        json.reserve(4096);
+    }
+
+    void JsonWriter::Separate()
+    {
+        if (afterKey)
+        {
+            afterKey = false;
+            return;
+        }
+        if (!firsts.empty())
+        {
+            if (!firsts.back())
+                json += ',';
+            firsts.back() = false;
+        }
+    }
+
+    void JsonWriter::Open(char c)
+    {
+        Separate();
+        json += c;
+        firsts.push_back(true);
+    }
+
+    void JsonWriter::Close(char c)
+    {
+        if (firsts.empty())
+            throw(std::runtime_error("JSON writer closing more than it opened"));
+        firsts.pop_back();
+        json += c;
+    }
+
+    void JsonWriter::Key(std::string_view key)
+    {
+        String(key);
+        json += ':';
+        afterKey = true;
+    }
+
+    void JsonWriter::String(std::string_view value)
+    {
+        static const char hex[] = "0123456789abcdef";
+
+        Separate();
+        json += '"';
+        for (char c: value)
+        {
+            unsigned char u = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\')
+            {
+                json += '\\';
+                json += c;
+            }
+            else if (c == '\n')
+                json += "\\n";
+            else if (c == '\t')
+                json += "\\t";
+            else if (c == '\r')
+                json += "\\r";
+            else if (u < 0x20)
+            {
+                json += "\\u00";
+                json += hex[u >> 4];
+                json += hex[u & 15];
+            }
+            else
+                json += c;
+        }
+        json += '"';
+    }
+
+    void JsonWriter::Int(long long value)
+    {
+        Separate();
+        char buffer[24];
+        char *end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+        json.append(buffer, end);
+    }
+
+    void JsonWriter::Size(size_t value)
+    {
+        Separate();
+        char buffer[24];
+        char *end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+        json.append(buffer, end);
+    }
+
+    void JsonWriter::Float(float value)
+    {
+        if (!std::isfinite(value))
+            throw(std::runtime_error("JSON can't hold NaN or infinite numbers"));
+
+        Separate();
+        char buffer[32];
+        char *end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+        json.append(buffer, end);
+    }
+
+    void JsonWriter::Double(double value)
+    {
+        if (!std::isfinite(value))
+            throw(std::runtime_error("JSON can't hold NaN or infinite numbers"));
+
+        Separate();
+        char buffer[32];
+        char *end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+        json.append(buffer, end);
+    }
+
+    void JsonWriter::Bool(bool value)
+    {
+        Separate();
+        json += value ? "true" : "false";
+    }
+
+    void JsonWriter::Floats(const float *values, size_t count)
+    {
+        BeginArray();
+        for (size_t i = 0; i < count; i++)
+            Float(values[i]);
+        EndArray();
+    }
+}
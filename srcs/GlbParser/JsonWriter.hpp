@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <string_view>
+
+namespace Glb
+{
+    // push-based JSON emitter appending compact JSON to one string, the commas are placed by the writer.
+    // inside an object every value is preceded by Key()
+    class JsonWriter
+    {
+        private:
+            std::string json;
+            std::vector<bool> firsts; // per open object or array, nothing written in it yet
+            bool afterKey;
+
+            void Separate();
+            void Open(char c);
+            void Close(char c);
+
+        public:
+            JsonWriter();
+
+            void BeginObject() { Open('{'); }
+            void EndObject() { Close('}'); }
+            void BeginArray() { Open('['); }
+            void EndArray() { Close(']'); }
+            void Key(std::string_view key);
+
+            void String(std::string_view value); // escapes what JSON requires
+            void Int(long long value);
+            void Size(size_t value);
+            void Float(float value); // shortest form reading back to the same float, throws on NaN and infinities
+            void Double(double value);
+            void Bool(bool value);
+            void Floats(const float *values, size_t count); // array of numbers
+
+            const std::string &GetJson() const { return (json); }
+            std::string &GetJson() { return (json); }
+    };
+}
@@ -0,0 +1,187 @@
+#include "GlbParser/LoadStats.hpp"
+#include "GlbParser/JsonWriter.hpp"
+#include <fstream>
+#include <stdexcept>
+
+namespace Glb
+{
+    static std::atomic<LoadStats*> installedStats(NULL);
+    static std::atomic<uint32_t> nbThreadSeen(0);
+
+    static uint32_t GetThreadId()
+    {
+        thread_local uint32_t id = nbThreadSeen++;
+        return (id);
+    }
+
+    const char *ToString(LoadStage stage)
+    {
+        switch (stage)
+        {
+            case LoadStage::FILE_READ:
+                return ("FILE_READ");
+            case LoadStage::JSON_PARSE:
+                return ("JSON_PARSE");
+            case LoadStage::MESHOPT_DECODE:
+                return ("MESHOPT_DECODE");
+            case LoadStage::ACCESSOR_DECODE:
+                return ("ACCESSOR_DECODE");
+            case LoadStage::VERTEX_INTERLEAVE:
+                return ("VERTEX_INTERLEAVE");
+            case LoadStage::SKIN:
+                return ("SKIN");
+            case LoadStage::ANIMATION:
+                return ("ANIMATION");
+            case LoadStage::IMAGE:
+                return ("IMAGE");
+        }
+        return ("UNKNOWN");
+    }
+
+    LoadStats::LoadStats(bool trace)
+    {
+        this->trace = trace;
+        Reset();
+    }
+
+    void LoadStats::SetCallback(const std::function<void(const LoadEvent &event)> &callback)
+    {
+        this->callback = callback;
+    }
+
+    void LoadStats::Record(LoadStage stage, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end, size_t bytes)
+    {
+        uint64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+        Counter &counter = counters[static_cast<size_t>(stage)];
+        counter.count.fetch_add(1, std::memory_order_relaxed);
+        counter.bytes.fetch_add(bytes, std::memory_order_relaxed);
+        counter.nanoseconds.fetch_add(duration, std::memory_order_relaxed);
+
+        if (!trace && !callback)
+            return;
+
+        LoadEvent event;
+        event.stage = stage;
+        event.thread = GetThreadId();
+        event.start = std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin).count();
+        event.duration = duration;
+        event.bytes = bytes;
+
+        if (trace)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            events.push_back(event);
+        }
+        if (callback)
+            callback(event);
+    }
+
+    void LoadStats::Reset()
+    {
+        for (Counter &counter: counters)
+        {
+            counter.count = 0;
+            counter.bytes = 0;
+            counter.nanoseconds = 0;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        events.clear();
+        origin = std::chrono::steady_clock::now();
+    }
+
+    StageStats LoadStats::Get(LoadStage stage) const
+    {
+        const Counter &counter = counters[static_cast<size_t>(stage)];
+
+        StageStats stats;
+        stats.count = counter.count.load(std::memory_order_relaxed);
+        stats.bytes = counter.bytes.load(std::memory_order_relaxed);
+        stats.seconds = counter.nanoseconds.load(std::memory_order_relaxed) / 1e9;
+        return (stats);
+    }
+
+    std::vector<LoadEvent> LoadStats::GetEvents() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (events);
+    }
+
+    std::string LoadStats::ToChromeTrace() const
+    {
+        std::vector<LoadEvent> events = GetEvents();
+
+        // complete events ("ph": "X"), timestamps in microseconds
+        JsonWriter json;
+        json.BeginObject();
+        json.Key("traceEvents");
+        json.BeginArray();
+        for (const LoadEvent &event: events)
+        {
+            json.BeginObject();
+            json.Key("name");
+            json.String(ToString(event.stage));
+            json.Key("cat");
+            json.String("glb");
+            json.Key("ph");
+            json.String("X");
+            json.Key("ts");
+            json.Double(event.start / 1e3);
+            json.Key("dur");
+            json.Double(event.duration / 1e3);
+            json.Key("pid");
+            json.Int(1);
+            json.Key("tid");
+            json.Size(event.thread);
+            json.Key("args");
+            json.BeginObject();
+            json.Key("bytes");
+            json.Size(event.bytes);
+            json.EndObject();
+            json.EndObject();
+        }
+        json.EndArray();
+        json.Key("displayTimeUnit");
+        json.String("ms");
+        json.EndObject();
+
+        return (std::move(json.GetJson()));
+    }
+
+    void LoadStats::WriteChromeTrace(const std::string &path) const
+    {
+        std::ofstream file(path, std::ios::binary);
+        if (!file)
+            throw(std::runtime_error("failed to open " + path));
+        std::string trace = ToChromeTrace();
+        file.write(trace.data(), trace.size());
+        if (!file)
+            throw(std::runtime_error("failed to write " + path));
+    }
+
+    void SetLoadStats(LoadStats *stats)
+    {
+        installedStats.store(stats, std::memory_order_release);
+    }
+
+    LoadStats *GetLoadStats()
+    {
+        return (installedStats.load(std::memory_order_acquire));
+    }
+
+    StageTimer::StageTimer(LoadStage stage, size_t bytes)
+    {
+        stats = GetLoadStats();
+        this->stage = stage;
+        this->bytes = bytes;
+        if (stats)
+            start = std::chrono::steady_clock::now();
+    }
+
+    StageTimer::~StageTimer()
+    {
+        if (stats)
+            stats->Record(stage, start, std::chrono::steady_clock::now(), bytes);
+    }
+}
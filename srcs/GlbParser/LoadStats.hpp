@@ -0,0 +1,112 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace Glb
+{
+    enum class LoadStage
+    {
+        FILE_READ, // mapping the file, and reading it when populated
+        JSON_PARSE, // LoadJson, or the streaming reader with the accessor resolution
+        MESHOPT_DECODE, // EXT_meshopt_compression bufferViews, on their first read by a decode function
+        ACCESSOR_DECODE, // indices
+        VERTEX_INTERLEAVE, // attributes into Vertex or a VertexLayout
+        SKIN,
+        ANIMATION,
+        IMAGE // ImagePipeline decoding to RGBA8
+    };
+    constexpr size_t nbLoadStage = 8;
+
+    const char *ToString(LoadStage stage);
+
+    struct StageStats
+    {
+        size_t count; // times the stage ran
+        size_t bytes; // output bytes, or input bytes for FILE_READ, JSON_PARSE and IMAGE
+        double seconds; // summed over the threads
+
+        StageStats()
+        {
+            count = 0;
+            bytes = 0;
+            seconds = 0;
+        }
+
+        double MegabytesPerSecond() const { return (seconds > 0 ? bytes / seconds / 1e6 : 0); }
+    };
+
+    struct LoadEvent
+    {
+        LoadStage stage;
+        uint32_t thread; // small ids given in order of first event
+        uint64_t start; // nanoseconds since the LoadStats was created or reset
+        uint64_t duration;
+        size_t bytes;
+    };
+
+    // per stage timers and byte counters, filled by every load of the process while installed with SetLoadStats.
+    // with trace set, each stage run is also kept as an event for ToChromeTrace
+    class LoadStats
+    {
+        private:
+            struct Counter
+            {
+                std::atomic<size_t> count;
+                std::atomic<size_t> bytes;
+                std::atomic<uint64_t> nanoseconds;
+            };
+
+            Counter counters[nbLoadStage];
+            std::chrono::steady_clock::time_point origin;
+            bool trace;
+            std::function<void(const LoadEvent &event)> callback;
+
+            mutable std::mutex mutex;
+            std::vector<LoadEvent> events;
+
+        public:
+            LoadStats(bool trace = false);
+            LoadStats(const LoadStats &) = delete;
+
+            LoadStats &operator=(const LoadStats &) = delete;
+
+            // called from the loading threads after each stage run, set it before installing the stats
+            void SetCallback(const std::function<void(const LoadEvent &event)> &callback);
+            void Record(LoadStage stage, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end, size_t bytes);
+            void Reset(); // not while loading
+
+            StageStats Get(LoadStage stage) const;
+            std::vector<LoadEvent> GetEvents() const;
+            // Trace Event Format JSON, opens in chrome://tracing or ui.perfetto.dev
+            std::string ToChromeTrace() const;
+            void WriteChromeTrace(const std::string &path) const;
+    };
+
+    // NULL, the default, turns the instrumentation off. The stats must outlive the loads started while installed
+    void SetLoadStats(LoadStats *stats);
+    LoadStats *GetLoadStats();
+
+    // times its scope into the installed LoadStats, only reads a pointer when there is none
+    class StageTimer
+    {
+        private:
+            LoadStats *stats;
+            LoadStage stage;
+            size_t bytes;
+            std::chrono::steady_clock::time_point start;
+
+        public:
+            StageTimer(LoadStage stage, size_t bytes = 0);
+            StageTimer(const StageTimer &) = delete;
+            ~StageTimer();
+
+            StageTimer &operator=(const StageTimer &) = delete;
+
+            void SetBytes(size_t bytes) { this->bytes = bytes; }
+    };
+}
@@ -0,0 +1,85 @@
+#include "GlbParser/MappedFile.hpp"
+#include "GlbParser/LoadStats.hpp"
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace Glb
+{
+    MappedFile::MappedFile()
+    {
+        data = NULL;
+        size = 0;
+    }
+
+    MappedFile::MappedFile(const std::string &path, bool populate)
+    {
+        StageTimer timer(LoadStage::FILE_READ);
+        data = NULL;
+        size = 0;
+
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+            throw(std::runtime_error("failed to open " + path));
+
+        struct stat st;
+        if (fstat(fd, &st) == -1)
+        {
+            close(fd);
+            throw(std::runtime_error("failed to stat " + path));
+        }
+
+        if (st.st_size > 0)
+        {
+            int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+            if (populate)
+                flags |= MAP_POPULATE;
+#endif
+            void *mapping = mmap(NULL, st.st_size, PROT_READ, flags, fd, 0);
+            if (mapping == MAP_FAILED)
+            {
+                close(fd);
+                throw(std::runtime_error("failed to map " + path));
+            }
+#ifndef MAP_POPULATE
+            if (populate)
+                madvise(mapping, st.st_size, MADV_WILLNEED);
+#endif
+            data = static_cast<const char*>(mapping);
+            size = st.st_size;
+            timer.SetBytes(size);
+        }
+        close(fd);
+    }
+
+    MappedFile::MappedFile(MappedFile &&other)
+    {
+        data = other.data;
+        size = other.size;
+        other.data = NULL;
+        other.size = 0;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (data)
+            munmap(const_cast<char*>(data), size);
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other)
+    {
+        if (this != &other)
+        {
+            if (data)
+                munmap(const_cast<char*>(data), size);
+            data = other.data;
+            size = other.size;
+            other.data = NULL;
+            other.size = 0;
+        }
+        return (*this);
+    }
+}
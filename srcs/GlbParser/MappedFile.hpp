@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace Glb
+{
+    // read-only memory mapping of a whole file, unmapped on destruction
+    class MappedFile
+    {
+        private:
+            const char *data;
+            size_t size;
+
+        public:
+            MappedFile();
+            MappedFile(const std::string &path, bool populate = false); // populate reads the whole file now instead of on page faults
+            MappedFile(const MappedFile &) = delete;
+            MappedFile(MappedFile &&other);
+            ~MappedFile();
+
+            MappedFile &operator=(const MappedFile &) = delete;
+            MappedFile &operator=(MappedFile &&other);
+
+            const char *GetData() const { return (data); }
+            size_t GetSize() const { return (size); }
+            std::string_view GetBytes() const { return (std::string_view(data, size)); }
+    };
+}
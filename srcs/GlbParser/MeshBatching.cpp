@@ -0,0 +1,235 @@
+#include "GlbParser/MeshBatching.hpp"
+#include "GlbParser/VertexKernels.hpp"
+#include <map>
+#include <numeric>
+#include <cstring>
+#include <stdexcept>
+
+namespace Glb
+{
+    static size_t AlignUp(size_t value, size_t alignment)
+    {
+        return ((value + alignment - 1) / alignment * alignment);
+    }
+
+    // meshes used by a node with a skin
+    static std::vector<bool> FindSkinnedMeshes(const GltfData &data)
+    {
+        std::vector<bool> skinned(data.meshes.size(), false);
+        for (const Node &node: data.nodes)
+        {
+            if (node.skin >= 0 && node.mesh >= 0 && static_cast<size_t>(node.mesh) < data.meshes.size())
+                skinned[node.mesh] = true;
+        }
+        return (skinned);
+    }
+
+    static void CollectInstances(const GltfData &data, BatchedMeshes &batched, std::vector<size_t> &firstInstances, std::vector<size_t> &nbInstances)
+    {
+        firstInstances.assign(data.meshes.size(), 0);
+        nbInstances.assign(data.meshes.size(), 0);
+        for (const Node &node: data.nodes)
+        {
+            if (node.mesh >= 0 && static_cast<size_t>(node.mesh) < data.meshes.size())
+                nbInstances[node.mesh]++;
+        }
+        size_t offset = 0;
+        for (size_t i = 0; i < data.meshes.size(); i++)
+        {
+            firstInstances[i] = offset;
+            offset += nbInstances[i];
+        }
+
+        batched.instances.resize(offset);
+        std::vector<size_t> fill = firstInstances;
+        for (size_t i = 0; i < data.nodes.size(); i++)
+        {
+            int mesh = data.nodes[i].mesh;
+            if (mesh >= 0 && static_cast<size_t>(mesh) < data.meshes.size())
+                batched.instances[fill[mesh]++] = static_cast<uint32_t>(i);
+        }
+    }
+
+    // sets every range and command, the arenas are sized but not filled
+    static void LayoutBatches(const GltfData &data, const MeshBatchOptions &options, BatchedMeshes &batched)
+    {
+        if (options.alignment == 0 || (options.alignment & (options.alignment - 1)) != 0)
+            throw(std::runtime_error("batch alignment must be a power of two"));
+
+        std::vector<bool> skinned = FindSkinnedMeshes(data);
+        std::vector<size_t> firstInstances;
+        std::vector<size_t> nbInstances;
+        CollectInstances(data, batched, firstInstances, nbInstances);
+
+        // primitives of each batch in mesh then primitive order, non skinned batches first
+        std::map<std::pair<bool, int>, std::vector<std::pair<int, int>>> groups;
+        size_t maxNbVertex = 0;
+        batched.meshDraws.resize(data.meshes.size());
+        size_t nbPrimitive = 0;
+        for (size_t m = 0; m < data.meshes.size(); m++)
+        {
+            batched.meshDraws[m] = nbPrimitive;
+            const std::vector<Primitive> &primitives = data.meshes[m].primitives;
+            nbPrimitive += primitives.size();
+            for (size_t p = 0; p < primitives.size(); p++)
+            {
+                if (primitives[p].vertices.empty())
+                    continue;
+
+                bool isSkinned = options.separateSkinned && skinned[m];
+                int material = options.groupByMaterial ? primitives[p].material : -1;
+                groups[{isSkinned, material}].push_back({static_cast<int>(m), static_cast<int>(p)});
+                maxNbVertex = std::max(maxNbVertex, primitives[p].vertices.size());
+            }
+        }
+        batched.primitiveDraws.assign(nbPrimitive, BatchedMeshes::noDraw);
+
+        // 8 bit indices aren't drawable everywhere
+        batched.indices.componentType = maxNbVertex <= 65536 ? ComponentType::UNSIGNED_SHORT : ComponentType::UNSIGNED_INT;
+        size_t indexSize = ComponentSize(batched.indices.componentType);
+        // vertices of a batch start on a multiple of both the alignment and the vertex size
+        size_t vertexStep = options.alignment / std::gcd(options.alignment, sizeof(Vertex));
+
+        size_t nbVertex = 0;
+        size_t nbIndex = 0;
+        for (const auto &group: groups)
+        {
+            MeshBatch batch;
+            batch.skinned = group.first.first;
+            batch.material = group.first.second;
+            batch.firstDraw = batched.draws.size();
+            batch.nbDraw = group.second.size();
+            batch.firstVertex = AlignUp(nbVertex, vertexStep);
+            batch.firstIndex = AlignUp(nbIndex * indexSize, options.alignment) / indexSize;
+            nbVertex = batch.firstVertex;
+            nbIndex = batch.firstIndex;
+
+            for (const std::pair<int, int> &key: group.second)
+            {
+                const Primitive &primitive = data.meshes[key.first].primitives[key.second];
+                size_t primitiveNbIndex = primitive.indices.Empty() ? primitive.vertices.size() : primitive.indices.Size();
+                if (nbVertex > INT32_MAX || nbIndex + primitiveNbIndex > UINT32_MAX)
+                    throw(std::runtime_error("too many vertices or indices to batch"));
+
+                DrawIndirectCommand command;
+                command.indexCount = static_cast<uint32_t>(primitiveNbIndex);
+                command.instanceCount = static_cast<uint32_t>(nbInstances[key.first]);
+                command.firstIndex = static_cast<uint32_t>(nbIndex);
+                command.baseVertex = static_cast<int32_t>(nbVertex);
+                command.firstInstance = static_cast<uint32_t>(firstInstances[key.first]);
+
+                BatchedDraw draw;
+                draw.mesh = key.first;
+                draw.primitive = key.second;
+                draw.batch = batched.batches.size();
+                draw.vertexCount = static_cast<uint32_t>(primitive.vertices.size());
+                draw.bounds = primitive.bounds;
+
+                batched.primitiveDraws[batched.meshDraws[key.first] + key.second] = static_cast<uint32_t>(batched.draws.size());
+                batched.commands.push_back(command);
+                batched.draws.push_back(draw);
+                nbVertex += primitive.vertices.size();
+                nbIndex += primitiveNbIndex;
+            }
+
+            batch.nbVertex = nbVertex - batch.firstVertex;
+            batch.nbIndex = nbIndex - batch.firstIndex;
+            batched.batches.push_back(batch);
+        }
+
+        // the padding between batches stays zeroed
+        batched.vertices.resize(nbVertex);
+        batched.indices.Resize(nbIndex);
+    }
+
+    template <typename T>
+    static void CopyIndices(const IndexBuffer &src, T *dst)
+    {
+        size_t count = src.Size();
+        if (src.componentType == ComponentTypeOf<T>::value)
+            std::memcpy(dst, src.data.data(), count * sizeof(T));
+        else if (src.componentType == ComponentType::UNSIGNED_BYTE && sizeof(T) == 2)
+            Kernels::WidenU8ToU16(src.data.data(), reinterpret_cast<uint16_t*>(dst), count);
+        else if (src.componentType == ComponentType::UNSIGNED_SHORT && sizeof(T) == 4)
+            Kernels::WidenU16ToU32(src.Data<uint16_t>(), reinterpret_cast<uint32_t*>(dst), count);
+        else if (src.componentType == ComponentType::UNSIGNED_INT && sizeof(T) == 2)
+            Kernels::NarrowU32ToU16(src.Data<uint32_t>(), reinterpret_cast<uint16_t*>(dst), count); // the primitive has at most 65536 vertices
+        else
+        {
+            for (size_t i = 0; i < count; i++)
+                dst[i] = static_cast<T>(src.Get(i));
+        }
+    }
+
+    static void CopyDraw(const GltfData &data, BatchedMeshes &batched, size_t drawIndex)
+    {
+        const BatchedDraw &draw = batched.draws[drawIndex];
+        const DrawIndirectCommand &command = batched.commands[drawIndex];
+        const Primitive &primitive = data.meshes[draw.mesh].primitives[draw.primitive];
+
+        std::memcpy(&batched.vertices[command.baseVertex], primitive.vertices.data(), primitive.vertices.size() * sizeof(Vertex));
+
+        unsigned char *dst = batched.indices.data.data() + command.firstIndex * ComponentSize(batched.indices.componentType);
+        bool wide = batched.indices.componentType == ComponentType::UNSIGNED_INT;
+        if (primitive.indices.Empty())
+        {
+            if (wide)
+                std::iota(reinterpret_cast<uint32_t*>(dst), reinterpret_cast<uint32_t*>(dst) + command.indexCount, 0u);
+            else
+                std::iota(reinterpret_cast<uint16_t*>(dst), reinterpret_cast<uint16_t*>(dst) + command.indexCount, static_cast<uint16_t>(0));
+        }
+        else if (wide)
+            CopyIndices(primitive.indices, reinterpret_cast<uint32_t*>(dst));
+        else
+            CopyIndices(primitive.indices, reinterpret_cast<uint16_t*>(dst));
+    }
+
+    BatchedMeshes BatchMeshes(const GltfData &data, const MeshBatchOptions &options)
+    {
+        BatchedMeshes batched;
+        LayoutBatches(data, options, batched);
+        for (size_t i = 0; i < batched.draws.size(); i++)
+            CopyDraw(data, batched, i);
+        return (batched);
+    }
+
+    BatchedMeshes BatchMeshes(const GltfData &data, ThreadPool &pool, const MeshBatchOptions &options)
+    {
+        BatchedMeshes batched;
+        LayoutBatches(data, options, batched);
+
+        // draws are cut in tasks of about the same number of vertices, each task writes its own ranges
+        const size_t nbVertexPerTask = 65536;
+        std::vector<size_t> taskBegins;
+        size_t nbVertex = nbVertexPerTask;
+        for (size_t i = 0; i < batched.draws.size(); i++)
+        {
+            if (nbVertex >= nbVertexPerTask)
+            {
+                taskBegins.push_back(i);
+                nbVertex = 0;
+            }
+            nbVertex += batched.draws[i].vertexCount;
+        }
+        taskBegins.push_back(batched.draws.size());
+
+        pool.ParallelFor(taskBegins.size() - 1, [&](size_t task)
+        {
+            for (size_t i = taskBegins[task]; i < taskBegins[task + 1]; i++)
+                CopyDraw(data, batched, i);
+        });
+        return (batched);
+    }
+
+    void ReleaseMeshData(GltfData &data)
+    {
+        for (Mesh &mesh: data.meshes)
+        {
+            for (Primitive &primitive: mesh.primitives)
+            {
+                std::vector<Vertex>().swap(primitive.vertices);
+                std::vector<unsigned char>().swap(primitive.indices.data);
+            }
+        }
+    }
+}
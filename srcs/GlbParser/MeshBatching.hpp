@@ -0,0 +1,75 @@
+#pragma once
+
+#include "GlbParser/GlbParser.hpp"
+#include "GlbParser/ThreadPool.hpp"
+
+namespace Glb
+{
+    struct MeshBatchOptions
+    {
+        bool groupByMaterial; // one batch per material, otherwise the materials are mixed and only draws tell them apart
+        bool separateSkinned; // meshes used by a skinned node go in their own batches
+        size_t alignment; // bytes, the vertices and indices of every batch start on a multiple of it
+
+        MeshBatchOptions()
+        {
+            groupByMaterial = true;
+            separateSkinned = true;
+            alignment = 256;
+        }
+    };
+
+    // same layout as the commands of glMultiDrawElementsIndirect and vkCmdDrawIndexedIndirect
+    struct DrawIndirectCommand
+    {
+        uint32_t indexCount;
+        uint32_t instanceCount;
+        uint32_t firstIndex; // in BatchedMeshes::indices
+        int32_t baseVertex; // in BatchedMeshes::vertices, the indices are the ones of the primitive
+        uint32_t firstInstance; // in BatchedMeshes::instances
+    };
+
+    // draw i of BatchedMeshes is commands[i]
+    struct BatchedDraw
+    {
+        int mesh;
+        int primitive;
+        size_t batch;
+        uint32_t vertexCount;
+        Bounds bounds; // Primitive::bounds
+    };
+
+    // contiguous ranges of the arenas and of the draws
+    struct MeshBatch
+    {
+        int material; // -1 when the materials are mixed or the primitives have none
+        bool skinned;
+        size_t firstDraw, nbDraw;
+        size_t firstVertex, nbVertex;
+        size_t firstIndex, nbIndex;
+    };
+
+    struct BatchedMeshes
+    {
+        std::vector<Vertex> vertices;
+        IndexBuffer indices; // UNSIGNED_SHORT, or UNSIGNED_INT when a primitive has more than 65536 vertices
+        std::vector<MeshBatch> batches;
+        std::vector<DrawIndirectCommand> commands;
+        std::vector<BatchedDraw> draws;
+        std::vector<uint32_t> instances; // glTF nodes using each mesh, the primitives of a mesh share its range
+        std::vector<size_t> meshDraws; // first entry of each mesh in primitiveDraws
+        std::vector<uint32_t> primitiveDraws; // draw of every primitive, noDraw for empty ones
+
+        static constexpr uint32_t noDraw = 0xFFFFFFFF;
+
+        uint32_t GetDraw(size_t mesh, size_t primitive) const { return (primitiveDraws[meshDraws[mesh] + primitive]); }
+    };
+
+    // packs the primitives of every mesh into one vertex and one index arena, grouped in batches by
+    // (skinned, material) so each batch is one multi draw; non indexed primitives get indices
+    BatchedMeshes BatchMeshes(const GltfData &data, const MeshBatchOptions &options = MeshBatchOptions());
+    BatchedMeshes BatchMeshes(const GltfData &data, ThreadPool &pool, const MeshBatchOptions &options = MeshBatchOptions()); // copies split on the pool
+
+    // frees the vertices and indices of every primitive once they are batched, materials and bounds stay
+    void ReleaseMeshData(GltfData &data);
+}
@@ -0,0 +1,421 @@
+#include "GlbParser/MeshOptimizer.hpp"
+#include "GlbParser/Hash.hpp"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace Glb
+{
+    constexpr uint32_t noIndex = 0xFFFFFFFF;
+
+    static size_t CountMisses(const std::vector<uint32_t> &indices, size_t cacheSize)
+    {
+        uint32_t nbVertex = 0;
+        for (uint32_t index: indices)
+            nbVertex = std::max(nbVertex, index + 1);
+
+        // a vertex is in the FIFO cache while less than cacheSize misses happened since it was added
+        std::vector<uint32_t> addedAt(nbVertex, noIndex);
+        size_t nbMiss = 0;
+        for (uint32_t index: indices)
+        {
+            if (addedAt[index] == noIndex || nbMiss - addedAt[index] > cacheSize)
+            {
+                addedAt[index] = nbMiss;
+                nbMiss++;
+            }
+        }
+        return (nbMiss);
+    }
+
+    float ComputeAcmr(const std::vector<uint32_t> &indices, size_t cacheSize)
+    {
+        if (indices.size() < 3)
+            return (0);
+        return (static_cast<float>(CountMisses(indices, cacheSize)) / (indices.size() / 3));
+    }
+
+    float ComputeAtvr(const std::vector<uint32_t> &indices, size_t nbVertex, size_t cacheSize)
+    {
+        if (nbVertex == 0)
+            return (0);
+        return (static_cast<float>(CountMisses(indices, cacheSize)) / nbVertex);
+    }
+
+    float ComputeOverdraw(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices)
+    {
+        const int gridSize = 256;
+        Bounds bounds = ComputeBounds(vertices);
+        float extent = 0;
+        for (int i = 0; i < 3; i++)
+            extent = std::max(extent, bounds.max[i] - bounds.min[i]);
+        if (indices.size() < 3 || !(extent > 0))
+            return (0);
+        float scale = (gridSize - 1) / extent;
+
+        std::vector<float> depths(gridSize * gridSize);
+        size_t nbCovered = 0;
+        size_t nbShaded = 0;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            for (int side = 0; side < 2; side++)
+            {
+                // looking along -axis then +axis, the image is mirrored for the second one so the front faces keep
+                // a positive area; a pixel is shaded when it passes the depth test at the time its triangle is drawn
+                std::fill(depths.begin(), depths.end(), std::numeric_limits<float>::max());
+                for (size_t i = 0; i + 2 < indices.size(); i += 3)
+                {
+                    float u[3], v[3], z[3];
+                    for (int k = 0; k < 3; k++)
+                    {
+                        const float *position = &vertices[indices[i + k]].x;
+                        u[k] = (position[(axis + 1) % 3] - bounds.min[(axis + 1) % 3]) * scale;
+                        v[k] = (position[(axis + 2) % 3] - bounds.min[(axis + 2) % 3]) * scale;
+                        z[k] = side == 0 ? bounds.max[axis] - position[axis] : position[axis] - bounds.min[axis];
+                        if (side == 1)
+                            u[k] = gridSize - 1 - u[k];
+                    }
+                    float area = (u[1] - u[0]) * (v[2] - v[0]) - (u[2] - u[0]) * (v[1] - v[0]);
+                    if (!(area > 0))
+                        continue;
+
+                    int minX = std::max(0, static_cast<int>(std::floor(std::min({u[0], u[1], u[2]}))));
+                    int maxX = std::min(gridSize - 1, static_cast<int>(std::ceil(std::max({u[0], u[1], u[2]}))));
+                    int minY = std::max(0, static_cast<int>(std::floor(std::min({v[0], v[1], v[2]}))));
+                    int maxY = std::min(gridSize - 1, static_cast<int>(std::ceil(std::max({v[0], v[1], v[2]}))));
+                    for (int y = minY; y <= maxY; y++)
+                    {
+                        for (int x = minX; x <= maxX; x++)
+                        {
+                            float px = x + 0.5f;
+                            float py = y + 0.5f;
+                            float w0 = (u[2] - u[1]) * (py - v[1]) - (v[2] - v[1]) * (px - u[1]);
+                            float w1 = (u[0] - u[2]) * (py - v[2]) - (v[0] - v[2]) * (px - u[2]);
+                            float w2 = area - w0 - w1;
+                            if (w0 < 0 || w1 < 0 || w2 < 0)
+                                continue;
+                            float depth = (w0 * z[0] + w1 * z[1] + w2 * z[2]) / area;
+                            float &stored = depths[y * gridSize + x];
+                            if (depth < stored)
+                            {
+                                stored = depth;
+                                nbShaded++;
+                            }
+                        }
+                    }
+                }
+                for (float depth: depths)
+                    nbCovered += depth != std::numeric_limits<float>::max();
+            }
+        }
+        return (nbCovered ? static_cast<float>(nbShaded) / nbCovered : 0);
+    }
+
+    // remap[i] is the new index of vertex i, unique its first occurrence in the old order
+    static std::vector<uint32_t> DeduplicateVertices(const std::vector<Vertex> &vertices, std::vector<uint32_t> &unique)
+    {
+        // open addressing on the hash of the vertex bytes, equal bytes only
+        size_t tableSize = 1;
+        while (tableSize < vertices.size() * 2)
+            tableSize *= 2;
+        std::vector<uint32_t> table(tableSize, noIndex);
+
+        std::vector<uint32_t> remap(vertices.size());
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            const Vertex &vertex = vertices[i];
+            size_t slot = HashBytes(std::string_view(reinterpret_cast<const char*>(&vertex), sizeof(Vertex))) & (tableSize - 1);
+            while (table[slot] != noIndex && std::memcmp(&vertices[unique[table[slot]]], &vertex, sizeof(Vertex)) != 0)
+                slot = (slot + 1) & (tableSize - 1);
+
+            if (table[slot] == noIndex)
+            {
+                table[slot] = unique.size();
+                unique.push_back(i);
+            }
+            remap[i] = table[slot];
+        }
+        return (remap);
+    }
+
+    // https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+    static float VertexScore(int cachePosition, uint32_t nbRemaining, size_t cacheSize)
+    {
+        if (nbRemaining == 0)
+            return (-1.0f);
+
+        float score = 0.0f;
+        if (cachePosition >= 0)
+        {
+            if (cachePosition < 3) // vertices of the last triangle
+                score = 0.75f;
+            else
+                score = std::pow(1.0f - static_cast<float>(cachePosition - 3) / (cacheSize - 3), 1.5f);
+        }
+        return (score + 2.0f / std::sqrt(static_cast<float>(nbRemaining)));
+    }
+
+    static std::vector<uint32_t> OptimizeVertexCache(const std::vector<uint32_t> &indices, size_t nbVertex, size_t cacheSize)
+    {
+        cacheSize = std::max(cacheSize, static_cast<size_t>(4));
+        size_t nbTriangle = indices.size() / 3;
+
+        // triangles using each vertex, the emitted ones are swapped out of the first nbRemaining
+        std::vector<uint32_t> nbRemaining(nbVertex, 0);
+        for (uint32_t index: indices)
+            nbRemaining[index]++;
+        std::vector<uint32_t> offsets(nbVertex + 1, 0);
+        for (size_t v = 0; v < nbVertex; v++)
+            offsets[v + 1] = offsets[v] + nbRemaining[v];
+        std::vector<uint32_t> adjacency(indices.size());
+        std::vector<uint32_t> filled(offsets.begin(), offsets.end() - 1);
+        for (size_t t = 0; t < nbTriangle; t++)
+        {
+            for (size_t k = 0; k < 3; k++)
+                adjacency[filled[indices[t * 3 + k]]++] = t;
+        }
+
+        std::vector<int> cachePositions(nbVertex, -1);
+        std::vector<float> vertexScores(nbVertex);
+        for (size_t v = 0; v < nbVertex; v++)
+            vertexScores[v] = VertexScore(-1, nbRemaining[v], cacheSize);
+
+        std::vector<float> triangleScores(nbTriangle);
+        std::vector<bool> emitted(nbTriangle, false);
+        uint32_t best = noIndex;
+        for (size_t t = 0; t < nbTriangle; t++)
+        {
+            triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+            if (best == noIndex || triangleScores[t] > triangleScores[best])
+                best = t;
+        }
+
+        std::vector<uint32_t> output;
+        output.reserve(indices.size());
+        std::vector<uint32_t> cache;
+        std::vector<uint32_t> newCache;
+        size_t nextUnemitted = 0;
+        while (output.size() < indices.size())
+        {
+            if (best == noIndex) // nothing left around the cache, start again from the first triangle left
+            {
+                while (emitted[nextUnemitted])
+                    nextUnemitted++;
+                best = nextUnemitted;
+            }
+
+            emitted[best] = true;
+            newCache.clear();
+            for (size_t k = 0; k < 3; k++)
+            {
+                uint32_t v = indices[best * 3 + k];
+                output.push_back(v);
+                newCache.push_back(v);
+
+                uint32_t *begin = adjacency.data() + offsets[v];
+                uint32_t *end = begin + nbRemaining[v];
+                *std::find(begin, end, best) = *(end - 1);
+                nbRemaining[v]--;
+            }
+            for (uint32_t v: cache)
+            {
+                if (v != newCache[0] && v != newCache[1] && v != newCache[2])
+                    newCache.push_back(v);
+            }
+
+            // vertices pushed out of the cache only lose their cache bonus
+            for (size_t i = cacheSize; i < newCache.size(); i++)
+            {
+                cachePositions[newCache[i]] = -1;
+                vertexScores[newCache[i]] = VertexScore(-1, nbRemaining[newCache[i]], cacheSize);
+            }
+            if (newCache.size() > cacheSize)
+                newCache.resize(cacheSize);
+            for (size_t i = 0; i < newCache.size(); i++)
+            {
+                cachePositions[newCache[i]] = i;
+                vertexScores[newCache[i]] = VertexScore(i, nbRemaining[newCache[i]], cacheSize);
+            }
+            std::swap(cache, newCache);
+
+            best = noIndex;
+            for (uint32_t v: cache)
+            {
+                for (uint32_t i = 0; i < nbRemaining[v]; i++)
+                {
+                    uint32_t t = adjacency[offsets[v] + i];
+                    triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+                    if (best == noIndex || triangleScores[t] > triangleScores[best])
+                        best = t;
+                }
+            }
+        }
+
+        return (output);
+    }
+
+    struct TriangleCluster
+    {
+        size_t begin; // first index
+        size_t end;
+        float sortKey;
+    };
+
+    // Sander et al., Fast Triangle Reordering for Vertex Locality and Reduced Overdraw:
+    // the cache order is cut where the cache restarts and the clusters facing away from
+    // the mesh center are drawn first, they are the most likely to hide the others
+    static std::vector<uint32_t> OptimizeOverdraw(const std::vector<uint32_t> &indices, const std::vector<Vertex> &vertices, size_t cacheSize)
+    {
+        std::vector<TriangleCluster> clusters;
+        std::vector<uint32_t> addedAt(vertices.size(), noIndex);
+        size_t nbMiss = 0;
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            size_t nbTriangleMiss = 0;
+            for (size_t k = 0; k < 3; k++)
+            {
+                uint32_t v = indices[i + k];
+                if (addedAt[v] == noIndex || nbMiss - addedAt[v] > cacheSize)
+                {
+                    addedAt[v] = nbMiss;
+                    nbMiss++;
+                    nbTriangleMiss++;
+                }
+            }
+            if (clusters.empty() || nbTriangleMiss == 3)
+                clusters.push_back({i, i + 3, 0.0f});
+            else
+                clusters.back().end = i + 3;
+        }
+
+        float meshCenter[3] = {0, 0, 0};
+        for (uint32_t index: indices)
+        {
+            meshCenter[0] += vertices[index].x;
+            meshCenter[1] += vertices[index].y;
+            meshCenter[2] += vertices[index].z;
+        }
+        for (size_t c = 0; c < 3; c++)
+            meshCenter[c] /= indices.size();
+
+        for (TriangleCluster &cluster: clusters)
+        {
+            float center[3] = {0, 0, 0};
+            float normal[3] = {0, 0, 0};
+            float area = 0;
+            for (size_t i = cluster.begin; i < cluster.end; i += 3)
+            {
+                const Vertex &a = vertices[indices[i]];
+                const Vertex &b = vertices[indices[i + 1]];
+                const Vertex &c = vertices[indices[i + 2]];
+                float ab[3] = {b.x - a.x, b.y - a.y, b.z - a.z};
+                float ac[3] = {c.x - a.x, c.y - a.y, c.z - a.z};
+                float cross[3] = {ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0]};
+                float triangleArea = std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+
+                center[0] += (a.x + b.x + c.x) / 3 * triangleArea;
+                center[1] += (a.y + b.y + c.y) / 3 * triangleArea;
+                center[2] += (a.z + b.z + c.z) / 3 * triangleArea;
+                for (size_t k = 0; k < 3; k++)
+                    normal[k] += cross[k];
+                area += triangleArea;
+            }
+
+            float normalLength = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            if (area == 0 || normalLength == 0)
+                continue;
+            for (size_t k = 0; k < 3; k++)
+                cluster.sortKey += (center[k] / area - meshCenter[k]) * normal[k] / normalLength;
+        }
+
+        std::stable_sort(clusters.begin(), clusters.end(), [](const TriangleCluster &a, const TriangleCluster &b)
+        {
+            return (a.sortKey > b.sortKey);
+        });
+
+        std::vector<uint32_t> output;
+        output.reserve(indices.size());
+        for (const TriangleCluster &cluster: clusters)
+            output.insert(output.end(), indices.begin() + cluster.begin, indices.begin() + cluster.end);
+        return (output);
+    }
+
+    // vertices in the order of their first use, the unused ones are dropped
+    static void OptimizeVertexFetch(std::vector<uint32_t> &indices, std::vector<Vertex> &vertices)
+    {
+        std::vector<uint32_t> remap(vertices.size(), noIndex);
+        std::vector<Vertex> ordered;
+        ordered.reserve(vertices.size());
+        for (uint32_t &index: indices)
+        {
+            if (remap[index] == noIndex)
+            {
+                remap[index] = ordered.size();
+                ordered.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+        vertices = std::move(ordered);
+    }
+
+    MeshOptimizationStats OptimizePrimitive(Primitive &primitive, const MeshOptimizationOptions &options)
+    {
+        std::vector<Vertex> &vertices = primitive.vertices;
+        std::vector<uint32_t> indices;
+        if (primitive.indices.Empty())
+        {
+            indices.resize(vertices.size());
+            std::iota(indices.begin(), indices.end(), 0);
+        }
+        else
+            indices = primitive.indices.ToUint32();
+
+        if (indices.size() % 3 != 0)
+            throw(std::runtime_error("primitive isn't a triangle list: " + std::to_string(indices.size()) + " indices"));
+        for (uint32_t index: indices)
+        {
+            if (index >= vertices.size())
+                throw(std::runtime_error("index " + std::to_string(index) + " out of the " + std::to_string(vertices.size()) + " vertices"));
+        }
+
+        MeshOptimizationStats stats;
+        stats.nbVertexBefore = vertices.size();
+        stats.acmrBefore = ComputeAcmr(indices, options.cacheSize);
+        stats.atvrBefore = ComputeAtvr(indices, vertices.size(), options.cacheSize);
+
+        if (options.deduplicate)
+        {
+            std::vector<uint32_t> unique;
+            std::vector<uint32_t> remap = DeduplicateVertices(vertices, unique);
+            for (uint32_t &index: indices)
+                index = remap[index];
+
+            std::vector<Vertex> uniqueVertices(unique.size());
+            for (size_t i = 0; i < unique.size(); i++)
+                uniqueVertices[i] = vertices[unique[i]];
+            vertices = std::move(uniqueVertices);
+        }
+
+        if (options.optimizeVertexCache)
+            indices = OptimizeVertexCache(indices, vertices.size(), options.cacheSize);
+
+        if (options.optimizeOverdraw)
+        {
+            std::vector<uint32_t> reordered = OptimizeOverdraw(indices, vertices, options.cacheSize);
+            if (ComputeAcmr(reordered, options.cacheSize) <= ComputeAcmr(indices, options.cacheSize) * options.overdrawThreshold)
+                indices = std::move(reordered);
+        }
+
+        if (options.optimizeVertexFetch)
+            OptimizeVertexFetch(indices, vertices);
+
+        primitive.indices.Assign(indices, vertices.size());
+
+        stats.nbVertexAfter = vertices.size();
+        stats.acmrAfter = ComputeAcmr(indices, options.cacheSize);
+        stats.atvrAfter = ComputeAtvr(indices, vertices.size(), options.cacheSize);
+        return (stats);
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "GlbParser/GlbParser.hpp"
+
+namespace Glb
+{
+    struct MeshOptimizationOptions
+    {
+        bool deduplicate; // merges the vertices with exactly the same bytes
+        bool optimizeVertexCache; // Forsyth triangle order
+        bool optimizeOverdraw; // reorders clusters of triangles so the outer ones are drawn first
+        bool optimizeVertexFetch; // vertices in the order the indices first use them
+        size_t cacheSize; // simulated FIFO cache used by the cache optimization and the stats
+        float overdrawThreshold; // the overdraw pass is dropped if it makes the ACMR worse than this factor
+
+        MeshOptimizationOptions()
+        {
+            deduplicate = true;
+            optimizeVertexCache = true;
+            optimizeOverdraw = true;
+            optimizeVertexFetch = true;
+            cacheSize = 16;
+            overdrawThreshold = 1.05f;
+        }
+    };
+
+    struct MeshOptimizationStats
+    {
+        size_t nbVertexBefore;
+        size_t nbVertexAfter;
+        float acmrBefore; // average cache miss ratio: transformed vertices per triangle, 0.5 at best, 3 at worst
+        float acmrAfter;
+        float atvrBefore; // average transformed vertex ratio: transformed vertices per vertex, 1 at best
+        float atvrAfter;
+    };
+
+    // transformed vertices per triangle of a triangle list going through a FIFO cache
+    float ComputeAcmr(const std::vector<uint32_t> &indices, size_t cacheSize);
+    float ComputeAtvr(const std::vector<uint32_t> &indices, size_t nbVertex, size_t cacheSize);
+    // shaded pixels per covered pixel when the front faces are drawn in order with a depth test, over the 6 axis
+    // views of the mesh bounds on a 256x256 grid, 1 at best
+    float ComputeOverdraw(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices);
+
+    // the primitive must be a triangle list, non indexed ones get indices;
+    // the indices end up with the smallest type able to index the vertices
+    MeshOptimizationStats OptimizePrimitive(Primitive &primitive, const MeshOptimizationOptions &options = MeshOptimizationOptions());
+}
@@ -0,0 +1,462 @@
+#include "GlbParser/MeshoptDecoder.hpp"
+#include "GlbParser/VertexKernels.hpp"
+#include <stdexcept>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+
+namespace Glb
+{
+    MeshoptMode ParseMeshoptMode(const std::string &mode)
+    {
+        if (mode == "ATTRIBUTES")
+            return (MeshoptMode::ATTRIBUTES);
+        else if (mode == "TRIANGLES")
+            return (MeshoptMode::TRIANGLES);
+        else if (mode == "INDICES")
+            return (MeshoptMode::INDICES);
+        throw(std::runtime_error("EXT_meshopt_compression mode unknown: " + mode));
+    }
+
+    MeshoptFilter ParseMeshoptFilter(const std::string &filter)
+    {
+        if (filter == "NONE" || filter.empty()) // NONE is the default
+            return (MeshoptFilter::NONE);
+        else if (filter == "OCTAHEDRAL")
+            return (MeshoptFilter::OCTAHEDRAL);
+        else if (filter == "QUATERNION")
+            return (MeshoptFilter::QUATERNION);
+        else if (filter == "EXPONENTIAL")
+            return (MeshoptFilter::EXPONENTIAL);
+        throw(std::runtime_error("EXT_meshopt_compression filter unknown: " + filter));
+    }
+
+    // Vertex codec
+
+    static const unsigned char vertexHeader = 0xa0;
+    static const size_t vertexBlockSizeBytes = 8192;
+    static const size_t vertexBlockMaxSize = 256;
+    static const size_t byteGroupSize = 16;
+    static const size_t byteGroupMaxRead = 24; // 8 bytes of 4 bits values and 16 bytes that didn't fit
+    static const size_t tailMinSize = 32;
+
+    // 16 values of BITS bits, most significant first, the ones with all bits set are stored in full after the group
+    template <int BITS>
+    static const unsigned char *UnpackByteGroup(const unsigned char *data, unsigned char *buffer)
+    {
+        const unsigned char sentinel = (1 << BITS) - 1;
+        const unsigned char *extra = data + byteGroupSize * BITS / 8;
+        for (size_t i = 0; i < byteGroupSize; i++)
+        {
+            unsigned char value = (data[i * BITS / 8] >> (8 - BITS - (i * BITS) % 8)) & sentinel;
+            buffer[i] = value == sentinel ? *extra++ : value;
+        }
+        return (extra);
+    }
+
+    static const unsigned char *DecodeBytes(const unsigned char *data, const unsigned char *end, unsigned char *buffer, size_t size)
+    {
+        // 2 bits of header per group of 16 bytes
+        size_t nbGroup = size / byteGroupSize;
+        size_t headerSize = (nbGroup + 3) / 4;
+        if (static_cast<size_t>(end - data) < headerSize)
+            throw(std::runtime_error("EXT_meshopt_compression vertex data is truncated"));
+        const unsigned char *header = data;
+        data += headerSize;
+
+        for (size_t group = 0; group < nbGroup; group++)
+        {
+            // the tail after the blocks is always big enough for the largest group
+            if (static_cast<size_t>(end - data) < byteGroupMaxRead)
+                throw(std::runtime_error("EXT_meshopt_compression vertex data is truncated"));
+
+            unsigned char *values = buffer + group * byteGroupSize;
+            switch ((header[group / 4] >> ((group % 4) * 2)) & 3)
+            {
+                case 0:
+                    std::memset(values, 0, byteGroupSize);
+                    break;
+                case 1:
+                    data = UnpackByteGroup<2>(data, values);
+                    break;
+                case 2:
+                    data = UnpackByteGroup<4>(data, values);
+                    break;
+                default:
+                    std::memcpy(values, data, byteGroupSize);
+                    data += byteGroupSize;
+                    break;
+            }
+        }
+        return (data);
+    }
+
+    void DecodeMeshoptVertices(unsigned char *dst, size_t count, size_t byteStride, const unsigned char *src, size_t srcLength)
+    {
+        if (byteStride == 0 || byteStride > 256 || byteStride % 4 != 0)
+            throw(std::runtime_error("EXT_meshopt_compression ATTRIBUTES byteStride must be a multiple of 4 up to 256"));
+        size_t tailSize = byteStride < tailMinSize ? tailMinSize : byteStride;
+        if (srcLength < 1 + tailSize)
+            throw(std::runtime_error("EXT_meshopt_compression vertex data is truncated"));
+        if ((src[0] & 0xf0) != vertexHeader || (src[0] & 0x0f) != 0)
+            throw(std::runtime_error("EXT_meshopt_compression vertex data has an unsupported header"));
+
+        const unsigned char *data = src + 1;
+        const unsigned char *end = src + srcLength;
+
+        // deltas start from the first vertex, stored at the end of the tail
+        unsigned char last[256];
+        std::memcpy(last, end - byteStride, byteStride);
+
+        size_t blockSize = (vertexBlockSizeBytes / byteStride) & ~(byteGroupSize - 1);
+        if (blockSize > vertexBlockMaxSize)
+            blockSize = vertexBlockMaxSize;
+
+        // one row of deltas per byte of the vertex, decoded block by block then summed by the kernel
+        std::vector<unsigned char> deltas(byteStride * blockSize);
+        for (size_t offset = 0; offset < count; offset += blockSize)
+        {
+            size_t nbVertex = count - offset < blockSize ? count - offset : blockSize;
+            size_t nbVertexAligned = (nbVertex + byteGroupSize - 1) & ~(byteGroupSize - 1);
+            for (size_t k = 0; k < byteStride; k++)
+                data = DecodeBytes(data, end, deltas.data() + k * blockSize, nbVertexAligned);
+            Kernels::DecodeByteDeltas(deltas.data(), blockSize, dst + offset * byteStride, byteStride, nbVertex, last);
+        }
+
+        if (static_cast<size_t>(end - data) != tailSize)
+            throw(std::runtime_error("EXT_meshopt_compression vertex data has an unexpected size"));
+    }
+
+    // Index codecs
+
+    static const unsigned char triangleHeader = 0xe0;
+    static const unsigned char sequenceHeader = 0xd0;
+
+    static uint32_t DecodeVByte(const unsigned char *&data)
+    {
+        unsigned char lead = *data++;
+        if (lead < 128)
+            return (lead);
+
+        // 7 bits per byte, little endian, at most 5 bytes
+        uint32_t result = lead & 127;
+        uint32_t shift = 7;
+        for (size_t i = 0; i < 4; i++)
+        {
+            unsigned char group = *data++;
+            result |= static_cast<uint32_t>(group & 127) << shift;
+            shift += 7;
+            if (group < 128)
+                break;
+        }
+        return (result);
+    }
+
+    static uint32_t DecodeFreeIndex(const unsigned char *&data, uint32_t last)
+    {
+        uint32_t value = DecodeVByte(data);
+        return (last + ((value >> 1) ^ (0u - (value & 1))));
+    }
+
+    static void WriteIndex(unsigned char *dst, size_t byteStride, size_t i, uint32_t index)
+    {
+        if (byteStride == 2)
+        {
+            uint16_t narrow = static_cast<uint16_t>(index);
+            std::memcpy(dst + i * 2, &narrow, sizeof(narrow));
+        }
+        else
+            std::memcpy(dst + i * 4, &index, sizeof(index));
+    }
+
+    // the encoder and decoder keep the same 16 last edges and 16 last vertices, a triangle is mostly
+    // an edge of the FIFO plus a new, cached or delta encoded vertex
+    struct TriangleFifos
+    {
+        uint32_t edges[16][2];
+        uint32_t vertices[16];
+        size_t edgeOffset;
+        size_t vertexOffset;
+
+        TriangleFifos()
+        {
+            std::memset(edges, 0xff, sizeof(edges));
+            std::memset(vertices, 0xff, sizeof(vertices));
+            edgeOffset = 0;
+            vertexOffset = 0;
+        }
+
+        void PushEdge(uint32_t a, uint32_t b)
+        {
+            edges[edgeOffset][0] = a;
+            edges[edgeOffset][1] = b;
+            edgeOffset = (edgeOffset + 1) & 15;
+        }
+
+        void PushVertex(uint32_t v, bool push = true)
+        {
+            vertices[vertexOffset] = v;
+            vertexOffset = (vertexOffset + (push ? 1 : 0)) & 15;
+        }
+    };
+
+    void DecodeMeshoptTriangles(unsigned char *dst, size_t count, size_t byteStride, const unsigned char *src, size_t srcLength)
+    {
+        if (byteStride != 2 && byteStride != 4)
+            throw(std::runtime_error("EXT_meshopt_compression TRIANGLES byteStride must be 2 or 4"));
+        if (count % 3 != 0)
+            throw(std::runtime_error("EXT_meshopt_compression TRIANGLES count must be a multiple of 3"));
+        // header, 1 code per triangle and the 16 bytes table
+        if (srcLength < 1 + count / 3 + 16)
+            throw(std::runtime_error("EXT_meshopt_compression index data is truncated"));
+        int version = src[0] & 0x0f;
+        if ((src[0] & 0xf0) != triangleHeader || version > 1)
+            throw(std::runtime_error("EXT_meshopt_compression index data has an unsupported header"));
+
+        TriangleFifos fifos;
+        uint32_t next = 0;
+        uint32_t last = 0;
+        int fecMax = version >= 1 ? 13 : 15; // version 1 uses 13 and 14 for the free indices last - 1 and last + 1
+
+        const unsigned char *code = src + 1;
+        const unsigned char *data = code + count / 3;
+        const unsigned char *dataSafeEnd = src + srcLength - 16;
+        const unsigned char *codeAuxTable = dataSafeEnd;
+
+        for (size_t i = 0; i < count; i += 3)
+        {
+            // a triangle reads at most 16 bytes, the table behind dataSafeEnd keeps these reads in the buffer
+            if (data > dataSafeEnd)
+                throw(std::runtime_error("EXT_meshopt_compression index data is truncated"));
+
+            unsigned char codeTri = *code++;
+            uint32_t a, b, c;
+            if (codeTri < 0xf0)
+            {
+                // edge from the FIFO and a third vertex
+                int fe = codeTri >> 4;
+                a = fifos.edges[(fifos.edgeOffset - 1 - fe) & 15][0];
+                b = fifos.edges[(fifos.edgeOffset - 1 - fe) & 15][1];
+
+                int fec = codeTri & 15;
+                if (fec < fecMax)
+                {
+                    c = fec == 0 ? next++ : fifos.vertices[(fifos.vertexOffset - 1 - fec) & 15];
+                    fifos.PushVertex(c, fec == 0);
+                }
+                else
+                {
+                    last = c = fec != 15 ? last + (fec - (fec ^ 3)) : DecodeFreeIndex(data, last);
+                    fifos.PushVertex(c);
+                }
+
+                fifos.PushEdge(c, b);
+                fifos.PushEdge(a, c);
+            }
+            else
+            {
+                int feb, fec;
+                if (codeTri < 0xfe)
+                {
+                    // the 2 last vertices come from the table, the first one is new
+                    unsigned char codeAux = codeAuxTable[codeTri & 15];
+                    feb = codeAux >> 4;
+                    fec = codeAux & 15;
+
+                    a = next++;
+                    b = feb == 0 ? next++ : fifos.vertices[(fifos.vertexOffset - feb) & 15];
+                    c = fec == 0 ? next++ : fifos.vertices[(fifos.vertexOffset - fec) & 15];
+
+                    // 15 in the table is a FIFO distance like the others, only new vertices are pushed
+                    fifos.PushVertex(a);
+                    fifos.PushVertex(b, feb == 0);
+                    fifos.PushVertex(c, fec == 0);
+                }
+                else
+                {
+                    // full byte instead of the table, 0xff means the first vertex is a free index
+                    unsigned char codeAux = *data++;
+                    int fea = codeTri == 0xfe ? 0 : 15;
+                    feb = codeAux >> 4;
+                    fec = codeAux & 15;
+
+                    if (codeAux == 0)
+                        next = 0; // restart of the vertex numbering
+
+                    a = fea == 0 ? next++ : 0;
+                    b = feb == 0 ? next++ : fifos.vertices[(fifos.vertexOffset - feb) & 15];
+                    c = fec == 0 ? next++ : fifos.vertices[(fifos.vertexOffset - fec) & 15];
+
+                    if (fea == 15)
+                        last = a = DecodeFreeIndex(data, last);
+                    if (feb == 15)
+                        last = b = DecodeFreeIndex(data, last);
+                    if (fec == 15)
+                        last = c = DecodeFreeIndex(data, last);
+
+                    fifos.PushVertex(a);
+                    fifos.PushVertex(b, feb == 0 || feb == 15);
+                    fifos.PushVertex(c, fec == 0 || fec == 15);
+                }
+
+                fifos.PushEdge(b, a);
+                fifos.PushEdge(c, b);
+                fifos.PushEdge(a, c);
+            }
+
+            WriteIndex(dst, byteStride, i, a);
+            WriteIndex(dst, byteStride, i + 1, b);
+            WriteIndex(dst, byteStride, i + 2, c);
+        }
+
+        if (data != dataSafeEnd)
+            throw(std::runtime_error("EXT_meshopt_compression index data has an unexpected size"));
+    }
+
+    void DecodeMeshoptIndices(unsigned char *dst, size_t count, size_t byteStride, const unsigned char *src, size_t srcLength)
+    {
+        if (byteStride != 2 && byteStride != 4)
+            throw(std::runtime_error("EXT_meshopt_compression INDICES byteStride must be 2 or 4"));
+        // header, at least 1 byte per index and a 4 bytes tail
+        if (srcLength < 1 + count + 4)
+            throw(std::runtime_error("EXT_meshopt_compression index data is truncated"));
+        if ((src[0] & 0xf0) != sequenceHeader || (src[0] & 0x0f) > 1)
+            throw(std::runtime_error("EXT_meshopt_compression index data has an unsupported header"));
+
+        const unsigned char *data = src + 1;
+        const unsigned char *dataSafeEnd = src + srcLength - 4;
+
+        // each index is a delta against one of 2 baselines, the low bit says which one
+        uint32_t last[2] = {0, 0};
+        for (size_t i = 0; i < count; i++)
+        {
+            if (data >= dataSafeEnd)
+                throw(std::runtime_error("EXT_meshopt_compression index data is truncated"));
+
+            uint32_t value = DecodeVByte(data);
+            uint32_t baseline = value & 1;
+            value >>= 1;
+            last[baseline] += (value >> 1) ^ (0u - (value & 1));
+            WriteIndex(dst, byteStride, i, last[baseline]);
+        }
+
+        if (data != dataSafeEnd)
+            throw(std::runtime_error("EXT_meshopt_compression index data has an unexpected size"));
+    }
+
+    // Filters
+
+    static int RoundToInt(float value)
+    {
+        return (static_cast<int>(value + (value >= 0 ? 0.5f : -0.5f)));
+    }
+
+    // x and y are octahedral, z holds the value of 1 at the same precision, w is left as is
+    template <typename T>
+    static void DecodeOctahedralFilter(T *data, size_t count)
+    {
+        const float max = static_cast<float>((1 << (sizeof(T) * 8 - 1)) - 1);
+        for (size_t i = 0; i < count; i++)
+        {
+            T *element = data + i * 4;
+            float x = element[0];
+            float y = element[1];
+            float z = element[2] - std::fabs(x) - std::fabs(y);
+
+            // fold back the lower hemisphere
+            float t = z >= 0 ? 0 : z;
+            x += x >= 0 ? t : -t;
+            y += y >= 0 ? t : -t;
+
+            float scale = max / std::sqrt(x * x + y * y + z * z);
+            element[0] = static_cast<T>(RoundToInt(x * scale));
+            element[1] = static_cast<T>(RoundToInt(y * scale));
+            element[2] = static_cast<T>(RoundToInt(z * scale));
+        }
+    }
+
+    // 3 smallest components, the index of the largest one in the 2 low bits of w and the scale in its other bits
+    static void DecodeQuaternionFilter(int16_t *data, size_t count)
+    {
+        const float scale = 1.0f / std::sqrt(2.0f);
+        for (size_t i = 0; i < count; i++)
+        {
+            int16_t *element = data + i * 4;
+            float componentScale = scale / static_cast<float>(element[3] | 3);
+            float x = element[0] * componentScale;
+            float y = element[1] * componentScale;
+            float z = element[2] * componentScale;
+            float ww = 1.0f - x * x - y * y - z * z;
+            float w = std::sqrt(ww >= 0 ? ww : 0);
+
+            int largest = element[3] & 3;
+            element[(largest + 1) & 3] = static_cast<int16_t>(RoundToInt(x * 32767.0f));
+            element[(largest + 2) & 3] = static_cast<int16_t>(RoundToInt(y * 32767.0f));
+            element[(largest + 3) & 3] = static_cast<int16_t>(RoundToInt(z * 32767.0f));
+            element[largest] = static_cast<int16_t>(RoundToInt(w * 32767.0f));
+        }
+    }
+
+    // 24 bits signed mantissa and 8 bits signed exponent into a float
+    static void DecodeExponentialFilter(unsigned char *data, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            uint32_t value;
+            std::memcpy(&value, data + i * 4, sizeof(value));
+            int32_t mantissa = static_cast<int32_t>(value << 8) >> 8;
+            int32_t exponent = static_cast<int32_t>(value) >> 24;
+
+            uint32_t powerBits = static_cast<uint32_t>(exponent + 127) << 23;
+            float power;
+            std::memcpy(&power, &powerBits, sizeof(power));
+            float result = power * static_cast<float>(mantissa);
+            std::memcpy(data + i * 4, &result, sizeof(result));
+        }
+    }
+
+    void ApplyMeshoptFilter(unsigned char *data, size_t count, size_t byteStride, MeshoptFilter filter)
+    {
+        switch (filter)
+        {
+            case MeshoptFilter::NONE:
+                break;
+            case MeshoptFilter::OCTAHEDRAL:
+                if (byteStride == 4)
+                    DecodeOctahedralFilter(reinterpret_cast<int8_t*>(data), count);
+                else if (byteStride == 8)
+                    DecodeOctahedralFilter(reinterpret_cast<int16_t*>(data), count);
+                else
+                    throw(std::runtime_error("EXT_meshopt_compression OCTAHEDRAL byteStride must be 4 or 8"));
+                break;
+            case MeshoptFilter::QUATERNION:
+                if (byteStride != 8)
+                    throw(std::runtime_error("EXT_meshopt_compression QUATERNION byteStride must be 8"));
+                DecodeQuaternionFilter(reinterpret_cast<int16_t*>(data), count);
+                break;
+            case MeshoptFilter::EXPONENTIAL:
+                if (byteStride % 4 != 0)
+                    throw(std::runtime_error("EXT_meshopt_compression EXPONENTIAL byteStride must be a multiple of 4"));
+                DecodeExponentialFilter(data, count * byteStride / 4);
+                break;
+        }
+    }
+
+    void DecodeMeshopt(unsigned char *dst, const MeshoptCompression &compression, const unsigned char *src)
+    {
+        switch (compression.mode)
+        {
+            case MeshoptMode::ATTRIBUTES:
+                DecodeMeshoptVertices(dst, compression.count, compression.byteStride, src, compression.byteLength);
+                ApplyMeshoptFilter(dst, compression.count, compression.byteStride, compression.filter);
+                break;
+            case MeshoptMode::TRIANGLES:
+                DecodeMeshoptTriangles(dst, compression.count, compression.byteStride, src, compression.byteLength);
+                break;
+            case MeshoptMode::INDICES:
+                DecodeMeshoptIndices(dst, compression.count, compression.byteStride, src, compression.byteLength);
+                break;
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace Glb
+{
+    // https://github.com/KhronosGroup/glTF/tree/main/extensions/2.0/Vendor/EXT_meshopt_compression
+    enum class MeshoptMode
+    {
+        ATTRIBUTES, // vertex codec
+        TRIANGLES, // index codec, triangle lists only
+        INDICES // index sequence codec
+    };
+
+    enum class MeshoptFilter
+    {
+        NONE,
+        OCTAHEDRAL,
+        QUATERNION,
+        EXPONENTIAL
+    };
+
+    MeshoptMode ParseMeshoptMode(const std::string &mode);
+    MeshoptFilter ParseMeshoptFilter(const std::string &filter);
+
+    // EXT_meshopt_compression object of a bufferView
+    struct MeshoptCompression
+    {
+        int buffer;
+        size_t byteOffset;
+        size_t byteLength;
+        size_t byteStride; // size of a decoded element
+        size_t count;
+        MeshoptMode mode;
+        MeshoptFilter filter;
+
+        MeshoptCompression()
+        {
+            buffer = 0;
+            byteOffset = 0;
+            byteLength = 0;
+            byteStride = 0;
+            count = 0;
+            mode = MeshoptMode::ATTRIBUTES;
+            filter = MeshoptFilter::NONE;
+        }
+    };
+
+    // every decoder writes count * byteStride bytes into dst and throws on malformed data
+    void DecodeMeshoptVertices(unsigned char *dst, size_t count, size_t byteStride, const unsigned char *src, size_t srcLength);
+    void DecodeMeshoptTriangles(unsigned char *dst, size_t count, size_t byteStride, const unsigned char *src, size_t srcLength);
+    void DecodeMeshoptIndices(unsigned char *dst, size_t count, size_t byteStride, const unsigned char *src, size_t srcLength);
+    void ApplyMeshoptFilter(unsigned char *data, size_t count, size_t byteStride, MeshoptFilter filter); // in place
+    void DecodeMeshopt(unsigned char *dst, const MeshoptCompression &compression, const unsigned char *src);
+}
@@ -0,0 +1,403 @@
+#include "GlbParser/ProgressiveLoader.hpp"
+#include "GlbParser/SceneGraph.hpp"
+#include <array>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+
+namespace Glb
+{
+    // a part handed out keeps the arena its name points into, like the ones of GltfDocument
+    template <typename T>
+    struct LoadedPart
+    {
+        std::shared_ptr<GltfArena> arena;
+        T value;
+    };
+
+    template <typename T>
+    static std::shared_ptr<const T> MakePart(const std::shared_ptr<GltfArena> &arena, T &&value)
+    {
+        std::shared_ptr<LoadedPart<T>> part = std::make_shared<LoadedPart<T>>(LoadedPart<T>{arena, std::move(value)});
+        return (std::shared_ptr<const T>(part, &part->value));
+    }
+
+    ProgressiveLoader::ProgressiveLoader(const std::string &path, ThreadPool &pool, const ProgressiveLoadCallbacks &callbacks, const ProgressiveLoadOptions &options):
+        pool(pool), callbacks(callbacks), options(options)
+    {
+        // the structure task becomes the first worker
+        nbRunningWorker = 1;
+        structureLoaded = false;
+        done = false;
+        cancelled = false;
+        pool.Submit([this, path]()
+        {
+            LoadStructure(path);
+        });
+    }
+
+    ProgressiveLoader::~ProgressiveLoader()
+    {
+        Cancel();
+        Wait();
+    }
+
+    void ProgressiveLoader::LoadStructure(const std::string &path)
+    {
+        std::vector<float> priorities;
+        try
+        {
+            if (cancelled)
+                throw(std::runtime_error("cancelled"));
+            glb = std::make_unique<MappedGlb>(path);
+            sources = LoadGltfSources(glb->GetView(), data);
+            meshes.resize(sources.meshes.size());
+            skins.resize(sources.skins.size());
+            animations.resize(sources.animations.size());
+            images.resize(data.images.size());
+
+            {
+                std::lock_guard<std::mutex> lock(callbackMutex);
+                if (!cancelled && callbacks.onStructure)
+                    callbacks.onStructure(data);
+            }
+
+            if (options.meshPriority)
+            {
+                priorities = options.meshPriority(data, sources);
+                if (priorities.size() != sources.meshes.size())
+                    throw(std::runtime_error("the mesh priority function must give one priority per mesh"));
+            }
+        }
+        catch (...)
+        {
+            if (!cancelled)
+            {
+                std::lock_guard<std::mutex> lock(callbackMutex);
+                if (callbacks.onError)
+                    callbacks.onError(LoadItem::STRUCTURE, 0, std::current_exception());
+            }
+            Finish();
+            return;
+        }
+
+        size_t nbWorker = options.nbWorker > 0 ? options.nbWorker : std::max<size_t>(pool.GetNbThread(), 1);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            // SetMeshPriorities may have been called while the structure was loading
+            if (meshPriorities.size() != sources.meshes.size())
+            {
+                meshPriorities = priorities;
+                if (meshPriorities.empty())
+                {
+                    // file order
+                    for (size_t i = 0; i < sources.meshes.size(); i++)
+                        meshPriorities.push_back(-static_cast<float>(i));
+                }
+            }
+            pendingMeshes.resize(sources.meshes.size());
+            std::iota(pendingMeshes.begin(), pendingMeshes.end(), 0);
+            SortPendingMeshes();
+
+            // popped from the back: skins, animations then images
+            if (options.decodeImages)
+            {
+                for (size_t i = data.images.size(); i-- > 0;)
+                    pendingItems.push_back({LoadItem::IMAGE, i});
+            }
+            for (size_t i = sources.animations.size(); i-- > 0;)
+                pendingItems.push_back({LoadItem::ANIMATION, i});
+            for (size_t i = sources.skins.size(); i-- > 0;)
+                pendingItems.push_back({LoadItem::SKIN, i});
+
+            if (cancelled)
+            {
+                pendingMeshes.clear();
+                pendingItems.clear();
+            }
+            structureLoaded = true;
+            nbRunningWorker += nbWorker - 1;
+        }
+
+        for (size_t i = 1; i < nbWorker; i++)
+        {
+            pool.Submit([this]()
+            {
+                RunWorker();
+            });
+        }
+        RunWorker();
+    }
+
+    void ProgressiveLoader::SortPendingMeshes()
+    {
+        // the next mesh is at the back, equal priorities keep the file order
+        std::sort(pendingMeshes.begin(), pendingMeshes.end(), [&](size_t a, size_t b)
+        {
+            if (meshPriorities[a] != meshPriorities[b])
+                return (meshPriorities[a] < meshPriorities[b]);
+            return (a > b);
+        });
+    }
+
+    bool ProgressiveLoader::PopItem(WorkItem &item)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cancelled)
+            return (false);
+        if (!pendingMeshes.empty())
+        {
+            item = {LoadItem::MESH, pendingMeshes.back()};
+            pendingMeshes.pop_back();
+            return (true);
+        }
+        if (!pendingItems.empty())
+        {
+            item = pendingItems.back();
+            pendingItems.pop_back();
+            return (true);
+        }
+        return (false);
+    }
+
+    void ProgressiveLoader::RunWorker()
+    {
+        WorkItem item;
+        while (PopItem(item))
+            Decode(item);
+
+        bool last;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            last = --nbRunningWorker == 0;
+        }
+        if (last)
+            Finish();
+    }
+
+    void ProgressiveLoader::Decode(const WorkItem &item)
+    {
+        try
+        {
+            switch (item.type)
+            {
+                case LoadItem::MESH:
+                {
+                    std::shared_ptr<const Mesh> mesh = MakePart(data.arena, DecodeMesh(sources.meshes[item.index]));
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        meshes[item.index] = mesh;
+                    }
+                    std::lock_guard<std::mutex> lock(callbackMutex);
+                    if (!cancelled && callbacks.onMesh)
+                        callbacks.onMesh(item.index, mesh);
+                    break;
+                }
+                case LoadItem::SKIN:
+                {
+                    std::shared_ptr<const Skin> skin = MakePart(data.arena, DecodeSkin(sources.skins[item.index]));
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        skins[item.index] = skin;
+                    }
+                    std::lock_guard<std::mutex> lock(callbackMutex);
+                    if (!cancelled && callbacks.onSkin)
+                        callbacks.onSkin(item.index, skin);
+                    break;
+                }
+                case LoadItem::ANIMATION:
+                {
+                    std::shared_ptr<const Animation> animation = MakePart(data.arena, DecodeAnimation(sources.animations[item.index]));
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        animations[item.index] = animation;
+                    }
+                    std::lock_guard<std::mutex> lock(callbackMutex);
+                    if (!cancelled && callbacks.onAnimation)
+                        callbacks.onAnimation(item.index, animation);
+                    break;
+                }
+                case LoadItem::IMAGE:
+                {
+                    const Image &source = data.images[item.index];
+                    std::shared_ptr<const DecodedImage> image = std::make_shared<const DecodedImage>(DecodeImage(std::string(source.name), source.buffer, source.bufferLength, options.imageOptions));
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        images[item.index] = image;
+                    }
+                    std::lock_guard<std::mutex> lock(callbackMutex);
+                    if (!cancelled && callbacks.onImage)
+                        callbacks.onImage(item.index, image);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(callbackMutex);
+            if (!cancelled && callbacks.onError)
+                callbacks.onError(item.type, item.index, std::current_exception());
+        }
+    }
+
+    void ProgressiveLoader::Finish()
+    {
+        {
+            std::lock_guard<std::mutex> lock(callbackMutex);
+            if (callbacks.onFinished)
+                callbacks.onFinished(cancelled);
+        }
+
+        // nothing of this object is touched once done is set, the destructor may be running
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+        finished.notify_all();
+    }
+
+    void ProgressiveLoader::SetMeshPriorities(const std::vector<float> &priorities)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (structureLoaded && priorities.size() != meshPriorities.size())
+            throw(std::runtime_error("SetMeshPriorities needs one priority per mesh"));
+
+        meshPriorities = priorities;
+        if (structureLoaded)
+            SortPendingMeshes();
+    }
+
+    void ProgressiveLoader::Cancel()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        cancelled = true;
+        pendingMeshes.clear();
+        pendingItems.clear();
+    }
+
+    void ProgressiveLoader::Wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&]()
+        {
+            return (done);
+        });
+    }
+
+    bool ProgressiveLoader::IsFinished() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (done);
+    }
+
+    std::shared_ptr<const Mesh> ProgressiveLoader::GetMesh(size_t meshIndex) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (meshIndex < meshes.size() ? meshes[meshIndex] : NULL);
+    }
+
+    std::shared_ptr<const Skin> ProgressiveLoader::GetSkin(size_t skinIndex) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (skinIndex < skins.size() ? skins[skinIndex] : NULL);
+    }
+
+    std::shared_ptr<const Animation> ProgressiveLoader::GetAnimation(size_t animationIndex) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (animationIndex < animations.size() ? animations[animationIndex] : NULL);
+    }
+
+    std::shared_ptr<const DecodedImage> ProgressiveLoader::GetImage(size_t imageIndex) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (imageIndex < images.size() ? images[imageIndex] : NULL);
+    }
+
+    // union of the POSITION bounds of the primitives, false when one of them has none
+    static bool GetSourceBounds(const MeshSource &mesh, Bounds &bounds)
+    {
+        for (const PrimitiveSource &primitive: mesh.primitives)
+        {
+            auto it = primitive.attributes.find("POSITION");
+            if (it == primitive.attributes.end() || !it->second.hasBounds || it->second.nbComponent != 3)
+                return (false);
+            Bounds primitiveBounds;
+            primitiveBounds.Extend(it->second.min);
+            primitiveBounds.Extend(it->second.max);
+            bounds.Extend(primitiveBounds);
+        }
+        return (true);
+    }
+
+    // fraction of the screen covered by the projected box, 1 when it crosses the camera plane
+    static float GetScreenCoverage(const float *matrix, const Bounds &bounds)
+    {
+        float low[2] = {1, 1};
+        float high[2] = {-1, -1};
+        for (int corner = 0; corner < 8; corner++)
+        {
+            float p[3] = {
+                corner & 1 ? bounds.max[0] : bounds.min[0],
+                corner & 2 ? bounds.max[1] : bounds.min[1],
+                corner & 4 ? bounds.max[2] : bounds.min[2]
+            };
+            float clip[4];
+            for (int r = 0; r < 4; r++)
+                clip[r] = matrix[r] * p[0] + matrix[4 + r] * p[1] + matrix[8 + r] * p[2] + matrix[12 + r];
+            if (clip[3] <= 0)
+                return (1);
+            for (int i = 0; i < 2; i++)
+            {
+                low[i] = std::min(low[i], clip[i] / clip[3]);
+                high[i] = std::max(high[i], clip[i] / clip[3]);
+            }
+        }
+
+        float area = 1;
+        for (int i = 0; i < 2; i++)
+            area *= std::max(std::min(high[i], 1.0f) - std::max(low[i], -1.0f), 0.0f) * 0.5f;
+        return (area);
+    }
+
+    MeshPriorityFunction ScreenCoveragePriority(const float *viewProjection)
+    {
+        std::array<float, 16> camera;
+        std::copy(viewProjection, viewProjection + 16, camera.begin());
+
+        return ([camera](const GltfData &data, const GltfSources &sources)
+        {
+            std::vector<Bounds> bounds(sources.meshes.size());
+            std::vector<float> priorities(sources.meshes.size(), 0);
+            for (size_t i = 0; i < sources.meshes.size(); i++)
+            {
+                if (!GetSourceBounds(sources.meshes[i], bounds[i]))
+                    priorities[i] = std::numeric_limits<float>::max();
+            }
+
+            SceneGraph graph(data);
+            graph.UpdateWorldTransforms();
+            for (size_t flatIndex = 0; flatIndex < graph.GetNbNode(); flatIndex++)
+            {
+                int mesh = data.nodes[graph.GetNodeIndex(flatIndex)].mesh;
+                if (mesh < 0 || static_cast<size_t>(mesh) >= sources.meshes.size() || bounds[mesh].IsEmpty())
+                    continue;
+
+                // clip = viewProjection * world
+                const float *world = graph.GetWorldMatrix(flatIndex);
+                float matrix[16];
+                for (int c = 0; c < 4; c++)
+                {
+                    for (int r = 0; r < 4; r++)
+                    {
+                        matrix[c * 4 + r] = camera[r] * world[c * 4] + camera[4 + r] * world[c * 4 + 1]
+                                          + camera[8 + r] * world[c * 4 + 2] + camera[12 + r] * world[c * 4 + 3];
+                    }
+                }
+                priorities[mesh] = std::max(priorities[mesh], GetScreenCoverage(matrix, bounds[mesh]));
+            }
+            return (priorities);
+        });
+    }
+}
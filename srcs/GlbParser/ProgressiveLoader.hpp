@@ -0,0 +1,119 @@
+#pragma once
+
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <exception>
+#include <condition_variable>
+#include "GlbParser/GlbParser.hpp"
+#include "GlbParser/ImageDecoder.hpp"
+#include "GlbParser/ImagePipeline.hpp"
+
+namespace Glb
+{
+    enum class LoadItem
+    {
+        STRUCTURE,
+        MESH,
+        SKIN,
+        ANIMATION,
+        IMAGE
+    };
+
+    // one priority per mesh, the highest ones are decoded first
+    typedef std::function<std::vector<float>(const GltfData &data, const GltfSources &sources)> MeshPriorityFunction;
+
+    // called one at a time from the pool threads, never two at once, and not after onFinished
+    struct ProgressiveLoadCallbacks
+    {
+        std::function<void(const GltfData &data)> onStructure; // scenes, nodes, materials and image views, meshes, skins and animations are empty
+        std::function<void(size_t meshIndex, const std::shared_ptr<const Mesh> &mesh)> onMesh;
+        std::function<void(size_t skinIndex, const std::shared_ptr<const Skin> &skin)> onSkin;
+        std::function<void(size_t animationIndex, const std::shared_ptr<const Animation> &animation)> onAnimation;
+        std::function<void(size_t imageIndex, const std::shared_ptr<const DecodedImage> &image)> onImage;
+        std::function<void(LoadItem item, size_t index, std::exception_ptr error)> onError; // the other items keep loading, unless it's the STRUCTURE
+        std::function<void(bool cancelled)> onFinished; // always called, last
+    };
+
+    struct ProgressiveLoadOptions
+    {
+        MeshPriorityFunction meshPriority; // file order when not set
+        bool decodeImages; // to RGBA8 after the animations, the compressed images are in the structure either way
+        ImageDecodeOptions imageOptions;
+        size_t nbWorker; // pool tasks decoding at once, each one takes the best pending item when it finishes the last
+
+        ProgressiveLoadOptions()
+        {
+            decodeImages = true;
+            nbWorker = 0; // every thread of the pool
+        }
+    };
+
+    // loads a .glb in the background and hands out each part as soon as it is decoded: the structure first,
+    // then the meshes by priority, then the skins, the animations and the images.
+    // the file is read by the pool too, the constructor returns right away
+    class ProgressiveLoader
+    {
+        private:
+            struct WorkItem
+            {
+                LoadItem type;
+                size_t index;
+            };
+
+            ThreadPool &pool;
+            ProgressiveLoadCallbacks callbacks;
+            ProgressiveLoadOptions options;
+
+            std::unique_ptr<MappedGlb> glb;
+            GltfData data;
+            GltfSources sources;
+
+            mutable std::mutex mutex;
+            std::condition_variable finished;
+            std::vector<size_t> pendingMeshes; // sorted by increasing priority, the next one is at the back
+            std::vector<float> meshPriorities;
+            std::vector<WorkItem> pendingItems; // skins, animations then images, in reverse order
+            std::vector<std::shared_ptr<const Mesh>> meshes;
+            std::vector<std::shared_ptr<const Skin>> skins;
+            std::vector<std::shared_ptr<const Animation>> animations;
+            std::vector<std::shared_ptr<const DecodedImage>> images;
+            size_t nbRunningWorker;
+            bool structureLoaded;
+            bool done;
+            std::atomic<bool> cancelled;
+
+            std::mutex callbackMutex;
+
+            void LoadStructure(const std::string &path);
+            void SortPendingMeshes();
+            bool PopItem(WorkItem &item);
+            void RunWorker();
+            void Decode(const WorkItem &item);
+            void Finish();
+
+        public:
+            ProgressiveLoader(const std::string &path, ThreadPool &pool, const ProgressiveLoadCallbacks &callbacks, const ProgressiveLoadOptions &options = ProgressiveLoadOptions());
+            ProgressiveLoader(const ProgressiveLoader &) = delete;
+            ~ProgressiveLoader(); // cancels and waits, not from a task of the same pool
+
+            ProgressiveLoader &operator=(const ProgressiveLoader &) = delete;
+
+            // the meshes not started yet follow the new order, e.g. when the camera moved
+            void SetMeshPriorities(const std::vector<float> &priorities);
+            void Cancel(); // drops the pending items, the ones being decoded finish without callbacks
+            void Wait(); // until onFinished returned, not from a task of the same pool
+            bool IsFinished() const;
+
+            // the structure is set once onStructure was called, the parts once their callback was
+            const GltfData &GetData() const { return (data); }
+            std::shared_ptr<const Mesh> GetMesh(size_t meshIndex) const;
+            std::shared_ptr<const Skin> GetSkin(size_t skinIndex) const;
+            std::shared_ptr<const Animation> GetAnimation(size_t animationIndex) const;
+            std::shared_ptr<const DecodedImage> GetImage(size_t imageIndex) const;
+    };
+
+    // priority of each mesh from the screen area its POSITION bounds cover, the biggest instance counting.
+    // viewProjection is 16 floats column major in OpenGL clip space, meshes without bounds come first
+    MeshPriorityFunction ScreenCoveragePriority(const float *viewProjection);
+}
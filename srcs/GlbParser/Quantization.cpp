@@ -0,0 +1,358 @@
+#include "GlbParser/Quantization.hpp"
+#include "GlbParser/GltfIndex.hpp"
+#include "GlbParser/VertexLayout.hpp"
+#include "GlbParser/LoadStats.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace Glb
+{
+    uint16_t FloatToHalf(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        uint32_t sign = (bits >> 16) & 0x8000;
+        uint32_t exponent = (bits >> 23) & 0xff;
+        uint32_t mantissa = bits & 0x7fffff;
+
+        if (exponent == 0xff) // inf and nan
+            return (static_cast<uint16_t>(sign | 0x7c00 | (mantissa ? 0x200 : 0)));
+
+        int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+        if (halfExponent >= 0x1f)
+            return (static_cast<uint16_t>(sign | 0x7c00));
+
+        uint32_t half;
+        uint32_t rest;
+        uint32_t halfway;
+        if (halfExponent <= 0) // subnormal half
+        {
+            if (halfExponent < -10)
+                return (static_cast<uint16_t>(sign));
+            mantissa |= 0x800000;
+            uint32_t shift = 14 - halfExponent;
+            half = mantissa >> shift;
+            rest = mantissa & ((1u << shift) - 1);
+            halfway = 1u << (shift - 1);
+        }
+        else
+        {
+            half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+            rest = mantissa & 0x1fff;
+            halfway = 0x1000;
+        }
+
+        // a carry out of the mantissa correctly bumps the exponent, up to inf
+        if (rest > halfway || (rest == halfway && (half & 1)))
+            half++;
+        return (static_cast<uint16_t>(sign | half));
+    }
+
+    float HalfToFloat(uint16_t value)
+    {
+        uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+        uint32_t exponent = (value >> 10) & 0x1f;
+        uint32_t mantissa = value & 0x3ff;
+
+        if (exponent == 0)
+        {
+            float result = std::ldexp(static_cast<float>(mantissa), -24);
+            return (sign ? -result : result);
+        }
+
+        uint32_t bits;
+        if (exponent == 0x1f)
+            bits = sign | 0x7f800000 | (mantissa << 13);
+        else
+            bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return (result);
+    }
+
+    static float SignNotZero(float value)
+    {
+        return (value >= 0.0f ? 1.0f : -1.0f);
+    }
+
+    static int16_t FloatToSnorm16(float value)
+    {
+        return (static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f)));
+    }
+
+    // https://jcgt.org/published/0003/02/01/
+    void EncodeOctahedral(const float *direction, int16_t &x, int16_t &y)
+    {
+        float length = std::fabs(direction[0]) + std::fabs(direction[1]) + std::fabs(direction[2]);
+        if (length == 0.0f)
+        {
+            x = 0;
+            y = 0;
+            return;
+        }
+
+        float px = direction[0] / length;
+        float py = direction[1] / length;
+        if (direction[2] < 0.0f)
+        {
+            float wrappedX = (1.0f - std::fabs(py)) * SignNotZero(px);
+            float wrappedY = (1.0f - std::fabs(px)) * SignNotZero(py);
+            px = wrappedX;
+            py = wrappedY;
+        }
+        x = FloatToSnorm16(px);
+        y = FloatToSnorm16(py);
+    }
+
+    void DecodeOctahedral(int16_t x, int16_t y, float *direction)
+    {
+        float px = std::max(x / 32767.0f, -1.0f);
+        float py = std::max(y / 32767.0f, -1.0f);
+        float pz = 1.0f - std::fabs(px) - std::fabs(py);
+        if (pz < 0.0f)
+        {
+            float unwrappedX = (1.0f - std::fabs(py)) * SignNotZero(px);
+            float unwrappedY = (1.0f - std::fabs(px)) * SignNotZero(py);
+            px = unwrappedX;
+            py = unwrappedY;
+        }
+
+        float length = std::sqrt(px * px + py * py + pz * pz);
+        direction[0] = px / length;
+        direction[1] = py / length;
+        direction[2] = pz / length;
+    }
+
+    template <typename T>
+    static T *GetField(T *first, size_t index)
+    {
+        return (reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(first) + index * sizeof(QuantizedVertex)));
+    }
+
+    // NULL when the primitive doesn't have the attribute
+    static const Accessor *FindAttribute(const std::map<std::string, Accessor> &accessors, const std::string &name, size_t nbComponent, size_t count)
+    {
+        auto it = accessors.find(name);
+        if (it == accessors.end())
+            return (NULL);
+
+        const Accessor &accessor = it->second;
+        if (accessor.count != count)
+            throw(std::runtime_error(name + " has " + std::to_string(accessor.count) + " elements instead of " + std::to_string(count)));
+        if (accessor.nbComponent != nbComponent)
+            throw(std::runtime_error(name + " has " + std::to_string(accessor.nbComponent) + " components instead of " + std::to_string(nbComponent)));
+        return (&accessor);
+    }
+
+    // integers that fit in 16 bits once biased, signed normalized ones are left to the float path
+    // because -32768 and -128 are clamped to -1
+    static bool IsDirectInteger(const Accessor &accessor, int32_t &bias, float &scale)
+    {
+        switch (accessor.componentType)
+        {
+            case ComponentType::UNSIGNED_BYTE:
+                bias = 0;
+                scale = accessor.normalized ? 1.0f / 255.0f : 1.0f;
+                return (true);
+            case ComponentType::UNSIGNED_SHORT:
+                bias = 0;
+                scale = accessor.normalized ? 1.0f / 65535.0f : 1.0f;
+                return (true);
+            case ComponentType::BYTE:
+                bias = 128;
+                scale = 1.0f;
+                return (!accessor.normalized);
+            case ComponentType::SHORT:
+                bias = 32768;
+                scale = 1.0f;
+                return (!accessor.normalized);
+            default:
+                return (false);
+        }
+    }
+
+    // quantizes every component to unorm16, offset and scale receive the dequantization parameters
+    static void QuantizeBounded(const Accessor &accessor, uint16_t *dst, float *offset, float *scale)
+    {
+        size_t nbComponent = accessor.nbComponent;
+        for (size_t c = 0; c < nbComponent; c++)
+        {
+            offset[c] = 0.0f;
+            scale[c] = 1.0f;
+        }
+        if (!accessor.data) // zeros, already there
+            return;
+
+        int32_t bias;
+        float directScale;
+        if (IsDirectInteger(accessor, bias, directScale))
+        {
+            size_t componentSize = ComponentSize(accessor.componentType);
+            for (size_t i = 0; i < accessor.count; i++)
+            {
+                const unsigned char *src = accessor.data + i * accessor.byteStride;
+                uint16_t *element = GetField(dst, i);
+                for (size_t c = 0; c < nbComponent; c++)
+                    element[c] = static_cast<uint16_t>(ConvertComponent<int32_t>(src + c * componentSize, accessor.componentType, false) + bias);
+            }
+            for (size_t c = 0; c < nbComponent; c++)
+            {
+                offset[c] = -bias * directScale;
+                scale[c] = directScale;
+            }
+            return;
+        }
+
+        AccessorView<float> view(accessor);
+        float min[4];
+        float max[4];
+        if (accessor.hasBounds)
+        {
+            std::copy(accessor.min, accessor.min + nbComponent, min);
+            std::copy(accessor.max, accessor.max + nbComponent, max);
+        }
+        else
+        {
+            std::fill(min, min + nbComponent, INFINITY);
+            std::fill(max, max + nbComponent, -INFINITY);
+            for (size_t i = 0; i < accessor.count; i++)
+            {
+                for (size_t c = 0; c < nbComponent; c++)
+                {
+                    float value = view.Get(i, c);
+                    min[c] = std::min(min[c], value);
+                    max[c] = std::max(max[c], value);
+                }
+            }
+        }
+
+        float factor[4];
+        for (size_t c = 0; c < nbComponent; c++)
+        {
+            float range = max[c] - min[c];
+            factor[c] = range > 0.0f ? 65535.0f / range : 0.0f;
+            offset[c] = min[c];
+            scale[c] = range / 65535.0f;
+        }
+
+        float values[4];
+        for (size_t i = 0; i < accessor.count; i++)
+        {
+            view.Read(i, values);
+            uint16_t *element = GetField(dst, i);
+            for (size_t c = 0; c < nbComponent; c++)
+                element[c] = static_cast<uint16_t>(std::lround(std::clamp((values[c] - min[c]) * factor[c], 0.0f, 65535.0f)));
+        }
+    }
+
+    static void QuantizeHalf(const Accessor &accessor, uint16_t *dst)
+    {
+        AccessorView<float> view(accessor);
+        float values[4];
+        for (size_t i = 0; i < accessor.count; i++)
+        {
+            view.Read(i, values);
+            uint16_t *element = GetField(dst, i);
+            for (size_t c = 0; c < accessor.nbComponent; c++)
+                element[c] = FloatToHalf(values[c]);
+        }
+    }
+
+    static void QuantizeDirections(const Accessor &accessor, int16_t *dst, int16_t *sign)
+    {
+        AccessorView<float> view(accessor);
+        float values[4];
+        for (size_t i = 0; i < accessor.count; i++)
+        {
+            view.Read(i, values);
+            int16_t *element = GetField(dst, i);
+            EncodeOctahedral(values, element[0], element[1]);
+            if (sign)
+                *GetField(sign, i) = values[3] < 0.0f ? -1 : 1;
+        }
+    }
+
+    // rounds each weight then gives the rounding error to the biggest one so they still sum to 255
+    static void QuantizeWeights(const Accessor &accessor, uint8_t *dst)
+    {
+        if (accessor.data && accessor.componentType == ComponentType::UNSIGNED_BYTE)
+        {
+            for (size_t i = 0; i < accessor.count; i++)
+                std::memcpy(GetField(dst, i), accessor.data + i * accessor.byteStride, 4);
+            return;
+        }
+
+        AccessorView<float> view(accessor);
+        float weights[4];
+        for (size_t i = 0; i < accessor.count; i++)
+        {
+            view.Read(i, weights);
+            uint8_t *element = GetField(dst, i);
+
+            float total = weights[0] + weights[1] + weights[2] + weights[3];
+            if (total <= 0.0f)
+            {
+                std::memset(element, 0, 4);
+                continue;
+            }
+
+            int sum = 0;
+            size_t biggest = 0;
+            for (size_t c = 0; c < 4; c++)
+            {
+                element[c] = static_cast<uint8_t>(std::lround(std::clamp(weights[c] / total, 0.0f, 1.0f) * 255.0f));
+                sum += element[c];
+                if (weights[c] > weights[biggest])
+                    biggest = c;
+            }
+            element[biggest] = static_cast<uint8_t>(element[biggest] + 255 - sum);
+        }
+    }
+
+    void DecodeQuantizedVertices(std::vector<QuantizedVertex> &vertices, DequantizationParams &params, const std::map<std::string, Accessor> &resolvedAccessors, const QuantizationOptions &options)
+    {
+        LoadedBufferViews views;
+        const std::map<std::string, Accessor> &accessors = views.Load(resolvedAccessors);
+        auto positionIt = accessors.find("POSITION");
+        if (positionIt == accessors.end())
+            throw(std::runtime_error("primitive without POSITION attribute"));
+
+        size_t count = positionIt->second.count;
+        StageTimer timer(LoadStage::VERTEX_INTERLEAVE, count * sizeof(QuantizedVertex));
+        vertices.assign(count, QuantizedVertex());
+        params.positionFormat = options.positionFormat;
+        std::fill(params.positionOffset, params.positionOffset + 3, 0.0f);
+        std::fill(params.positionScale, params.positionScale + 3, 1.0f);
+        std::fill(params.uvOffset, params.uvOffset + 2, 0.0f);
+        std::fill(params.uvScale, params.uvScale + 2, 1.0f);
+        if (count == 0)
+            return;
+
+        QuantizedVertex &first = vertices[0];
+        for (QuantizedVertex &vertex: vertices)
+            vertex.tangentSign = 1;
+
+        const Accessor *position = FindAttribute(accessors, "POSITION", 3, count);
+        if (options.positionFormat == PositionFormat::HALF_FLOAT)
+            QuantizeHalf(*position, &first.x);
+        else
+            QuantizeBounded(*position, &first.x, params.positionOffset, params.positionScale);
+
+        if (const Accessor *texCoord = FindAttribute(accessors, "TEXCOORD_0", 2, count))
+            QuantizeBounded(*texCoord, &first.u, params.uvOffset, params.uvScale);
+
+        if (const Accessor *normal = FindAttribute(accessors, "NORMAL", 3, count))
+            QuantizeDirections(*normal, &first.nx, NULL);
+
+        if (const Accessor *tangent = FindAttribute(accessors, "TANGENT", 4, count))
+            QuantizeDirections(*tangent, &first.tx, &first.tangentSign);
+
+        if (const Accessor *joints = FindAttribute(accessors, "JOINTS_0", 4, count))
+            DecodeAttribute(*joints, &first.j1, sizeof(QuantizedVertex));
+
+        if (const Accessor *weights = FindAttribute(accessors, "WEIGHTS_0", 4, count))
+            QuantizeWeights(*weights, &first.w1);
+    }
+}
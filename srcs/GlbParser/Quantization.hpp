@@ -0,0 +1,65 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include "GlbParser/IndexBuffer.hpp"
+
+namespace Glb
+{
+    enum class PositionFormat
+    {
+        HALF_FLOAT,
+        UNORM16 // quantized against the primitive bounds
+    };
+
+    struct QuantizationOptions
+    {
+        PositionFormat positionFormat;
+
+        QuantizationOptions()
+        {
+            positionFormat = PositionFormat::UNORM16;
+        }
+    };
+
+    // 32 bytes instead of the 56 of Vertex
+    struct QuantizedVertex
+    {
+        uint16_t x, y, z; // see DequantizationParams
+        int16_t tangentSign; // TANGENT.w, 1 when the primitive has no tangent
+        uint16_t u, v; // unorm16 against the uv bounds
+        int16_t nx, ny; // octahedral snorm16
+        int16_t tx, ty; // octahedral snorm16
+        uint16_t j1, j2, j3, j4;
+        uint8_t w1, w2, w3, w4; // unorm8, their sum is 255
+    };
+    static_assert(sizeof(QuantizedVertex) == 32, "QuantizedVertex is documented as 32 bytes");
+
+    // per component: value = offset + quantized * scale
+    struct DequantizationParams
+    {
+        PositionFormat positionFormat;
+        float positionOffset[3]; // 0 for half floats
+        float positionScale[3]; // 1 for half floats
+        float uvOffset[2];
+        float uvScale[2];
+    };
+
+    struct QuantizedPrimitive
+    {
+        std::vector<QuantizedVertex> vertices;
+        IndexBuffer indices;
+        int material;
+        DequantizationParams dequantization;
+    };
+
+    uint16_t FloatToHalf(float value); // rounds to nearest even
+    float HalfToFloat(uint16_t value);
+    void EncodeOctahedral(const float *direction, int16_t &x, int16_t &y);
+    void DecodeOctahedral(int16_t x, int16_t y, float *direction);
+
+    // KHR_mesh_quantization integer attributes are read as integers, floats are only used
+    // for float accessors, normals, tangents and weights that have to be re-encoded
+    void DecodeQuantizedVertices(std::vector<QuantizedVertex> &vertices, DequantizationParams &params, const std::map<std::string, Accessor> &accessors, const QuantizationOptions &options);
+}
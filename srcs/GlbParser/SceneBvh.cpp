@@ -0,0 +1,363 @@
+#include "GlbParser/SceneBvh.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace Glb
+{
+    constexpr size_t raysPerTask = 256;
+
+    Frustum ExtractFrustum(const float *viewProjection)
+    {
+        // row i of the column major matrix
+        auto row = [&](int i, int c) { return (viewProjection[c * 4 + i]); };
+
+        Frustum frustum;
+        for (int c = 0; c < 4; c++)
+        {
+            frustum.planes[0][c] = row(3, c) + row(0, c);
+            frustum.planes[1][c] = row(3, c) - row(0, c);
+            frustum.planes[2][c] = row(3, c) + row(1, c);
+            frustum.planes[3][c] = row(3, c) - row(1, c);
+            frustum.planes[4][c] = row(3, c) + row(2, c);
+            frustum.planes[5][c] = row(3, c) - row(2, c);
+        }
+        return (frustum);
+    }
+
+    // inverse of an affine column major matrix, false when its 3x3 part is singular
+    static bool InvertAffine(const float *matrix, float *inverse)
+    {
+        const float *m = matrix;
+        float c00 = m[5] * m[10] - m[9] * m[6];
+        float c01 = m[9] * m[2] - m[1] * m[10];
+        float c02 = m[1] * m[6] - m[5] * m[2];
+        float det = m[0] * c00 + m[4] * c01 + m[8] * c02;
+        if (det == 0 || !std::isfinite(det))
+            return (false);
+
+        float inv = 1.0f / det;
+        float r[9] = {
+            c00 * inv, c01 * inv, c02 * inv,
+            (m[8] * m[6] - m[4] * m[10]) * inv, (m[0] * m[10] - m[8] * m[2]) * inv, (m[4] * m[2] - m[0] * m[6]) * inv,
+            (m[4] * m[9] - m[8] * m[5]) * inv, (m[8] * m[1] - m[0] * m[9]) * inv, (m[0] * m[5] - m[4] * m[1]) * inv
+        };
+        for (int c = 0; c < 3; c++)
+        {
+            for (int i = 0; i < 3; i++)
+                inverse[c * 4 + i] = r[c * 3 + i];
+            inverse[c * 4 + 3] = 0;
+        }
+        for (int i = 0; i < 3; i++)
+            inverse[12 + i] = -(r[i] * m[12] + r[3 + i] * m[13] + r[6 + i] * m[14]);
+        inverse[15] = 1;
+        return (true);
+    }
+
+    static void BuildTriangleMesh(const Primitive &primitive, std::vector<float> &positions, Bvh &bvh, const BvhOptions &options)
+    {
+        std::vector<uint32_t> indices;
+        if (!primitive.indices.Empty())
+            indices = primitive.indices.ToUint32();
+        size_t nbIndex = indices.empty() ? primitive.vertices.size() : indices.size();
+        size_t nbTriangle = nbIndex / 3;
+
+        positions.resize(nbTriangle * 9);
+        std::vector<Bounds> bounds(nbTriangle);
+        for (size_t i = 0; i < nbTriangle * 3; i++)
+        {
+            size_t index = indices.empty() ? i : indices[i];
+            if (index >= primitive.vertices.size())
+                throw(std::runtime_error("index " + std::to_string(index) + " out of the vertices"));
+
+            const Vertex &vertex = primitive.vertices[index];
+            float *position = &positions[i * 3];
+            position[0] = vertex.x;
+            position[1] = vertex.y;
+            position[2] = vertex.z;
+            bounds[i / 3].Extend(position);
+        }
+        bvh.Build(bounds, options);
+    }
+
+    SceneBvh::SceneBvh(const GltfData &data, const SceneGraph &graph, const SceneBvhOptions &options): options(options)
+    {
+        CollectItems(data, graph);
+
+        std::vector<const Primitive*> primitives = PrepareTriangleMeshes(data);
+        for (size_t i = 0; i < primitives.size(); i++)
+        {
+            if (primitives[i])
+                BuildTriangleMesh(*primitives[i], triangleMeshes[i].positions, triangleMeshes[i].bvh, options.bvh);
+        }
+
+        std::vector<Bounds> bounds;
+        UpdateWorldBounds(graph, bounds);
+        bvh.Build(bounds, options.bvh);
+    }
+
+    SceneBvh::SceneBvh(const GltfData &data, const SceneGraph &graph, ThreadPool &pool, const SceneBvhOptions &options): options(options)
+    {
+        CollectItems(data, graph);
+
+        std::vector<const Primitive*> primitives = PrepareTriangleMeshes(data);
+        pool.ParallelFor(primitives.size(), [&](size_t i)
+        {
+            if (primitives[i])
+                BuildTriangleMesh(*primitives[i], triangleMeshes[i].positions, triangleMeshes[i].bvh, options.bvh);
+        });
+
+        std::vector<Bounds> bounds;
+        UpdateWorldBounds(graph, bounds);
+        bvh.Build(bounds, options.bvh);
+    }
+
+    void SceneBvh::CollectItems(const GltfData &data, const SceneGraph &graph)
+    {
+        for (size_t flatIndex = 0; flatIndex < graph.GetNbNode(); flatIndex++)
+        {
+            int mesh = data.nodes[graph.GetNodeIndex(flatIndex)].mesh;
+            if (mesh < 0 || static_cast<size_t>(mesh) >= data.meshes.size())
+                continue;
+
+            const std::vector<Primitive> &primitives = data.meshes[mesh].primitives;
+            for (size_t i = 0; i < primitives.size(); i++)
+            {
+                if (primitives[i].bounds.IsEmpty())
+                    continue;
+
+                SceneItem item;
+                item.flatIndex = flatIndex;
+                item.mesh = mesh;
+                item.primitive = static_cast<int>(i);
+                item.localBounds = primitives[i].bounds;
+                items.push_back(item);
+            }
+        }
+        if (items.size() > INT32_MAX)
+            throw(std::runtime_error("too many primitives for a SceneBvh"));
+    }
+
+    std::vector<const Primitive*> SceneBvh::PrepareTriangleMeshes(const GltfData &data)
+    {
+        if (!options.triangles)
+            return (std::vector<const Primitive*>());
+
+        meshOffsets.resize(data.meshes.size() + 1);
+        meshOffsets[0] = 0;
+        for (size_t i = 0; i < data.meshes.size(); i++)
+            meshOffsets[i + 1] = meshOffsets[i] + data.meshes[i].primitives.size();
+        triangleMeshes.resize(meshOffsets.back());
+
+        // only the primitives of meshes in the scene
+        std::vector<const Primitive*> primitives(triangleMeshes.size(), NULL);
+        for (const SceneItem &item: items)
+            primitives[meshOffsets[item.mesh] + item.primitive] = &data.meshes[item.mesh].primitives[item.primitive];
+        return (primitives);
+    }
+
+    void SceneBvh::UpdateWorldBounds(const SceneGraph &graph, std::vector<Bounds> &bounds)
+    {
+        bounds.resize(items.size());
+        inverseWorlds.resize(items.size() * 16);
+        invertible.resize(items.size());
+        for (size_t i = 0; i < items.size(); i++)
+        {
+            const float *world = graph.GetWorldMatrix(items[i].flatIndex);
+            items[i].bounds = TransformBounds(items[i].localBounds, world);
+            bounds[i] = items[i].bounds;
+            invertible[i] = InvertAffine(world, &inverseWorlds[i * 16]);
+        }
+    }
+
+    void SceneBvh::Refit(const SceneGraph &graph)
+    {
+        std::vector<Bounds> bounds;
+        UpdateWorldBounds(graph, bounds);
+        bvh.Refit(bounds);
+    }
+
+    // -1 outside of a plane, 1 inside all of them, 0 crossing some; mask holds the planes still to test
+    // and loses the ones the box is fully inside of
+    static int ClassifyBounds(const Frustum &frustum, const Bounds &bounds, uint32_t &mask)
+    {
+        for (int p = 0; p < 6; p++)
+        {
+            if (!(mask & (1u << p)))
+                continue;
+
+            const float *plane = frustum.planes[p];
+            float farthest = plane[3];
+            float nearest = plane[3];
+            for (int i = 0; i < 3; i++)
+            {
+                bool positive = plane[i] >= 0;
+                farthest += plane[i] * (positive ? bounds.max[i] : bounds.min[i]);
+                nearest += plane[i] * (positive ? bounds.min[i] : bounds.max[i]);
+            }
+            if (farthest < 0)
+                return (-1);
+            if (nearest >= 0)
+                mask &= ~(1u << p);
+        }
+        return (mask == 0 ? 1 : 0);
+    }
+
+    void SceneBvh::CullFrustum(const Frustum &frustum, std::vector<uint32_t> &visible) const
+    {
+        visible.clear();
+        if (bvh.IsEmpty())
+            return;
+
+        const std::vector<BvhNode> &nodes = bvh.GetNodes();
+        const std::vector<uint32_t> &bvhItems = bvh.GetItems();
+
+        struct Entry
+        {
+            uint32_t node;
+            uint32_t mask;
+        };
+        Entry stack[Bvh::maxDepth + 1];
+        size_t size = 0;
+        stack[size++] = {0, 0x3F};
+        while (size > 0)
+        {
+            Entry entry = stack[--size];
+            const BvhNode &node = nodes[entry.node];
+            int classification = ClassifyBounds(frustum, node.bounds, entry.mask);
+            if (classification < 0)
+                continue;
+
+            if (classification > 0)
+            {
+                // the items of a subtree are contiguous, from its leftmost leaf to its rightmost one
+                uint32_t first = entry.node;
+                while (nodes[first].count == 0)
+                    first++;
+                uint32_t last = entry.node;
+                while (nodes[last].count == 0)
+                    last = nodes[last].offset;
+                visible.insert(visible.end(), bvhItems.begin() + nodes[first].offset, bvhItems.begin() + nodes[last].offset + nodes[last].count);
+                continue;
+            }
+
+            if (node.count > 0)
+            {
+                for (uint32_t i = 0; i < node.count; i++)
+                {
+                    uint32_t item = bvhItems[node.offset + i];
+                    uint32_t mask = entry.mask;
+                    if (ClassifyBounds(frustum, items[item].bounds, mask) >= 0)
+                        visible.push_back(item);
+                }
+                continue;
+            }
+
+            stack[size++] = {node.offset, entry.mask};
+            stack[size++] = {entry.node + 1, entry.mask};
+        }
+    }
+
+    void SceneBvh::CullFrustums(const std::vector<Frustum> &frustums, std::vector<std::vector<uint32_t>> &visibles, ThreadPool &pool) const
+    {
+        visibles.resize(frustums.size());
+        pool.ParallelFor(frustums.size(), [&](size_t i)
+        {
+            CullFrustum(frustums[i], visibles[i]);
+        });
+    }
+
+    // Moller-Trumbore, both faces
+    static bool IntersectTriangle(const float *origin, const float *direction, const float *triangle, float tMax, float &t, float &u, float &v)
+    {
+        const float *v0 = triangle;
+        float e1[3] = {triangle[3] - v0[0], triangle[4] - v0[1], triangle[5] - v0[2]};
+        float e2[3] = {triangle[6] - v0[0], triangle[7] - v0[1], triangle[8] - v0[2]};
+        float p[3] = {direction[1] * e2[2] - direction[2] * e2[1], direction[2] * e2[0] - direction[0] * e2[2], direction[0] * e2[1] - direction[1] * e2[0]};
+        float det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+        if (det == 0)
+            return (false);
+
+        float inv = 1.0f / det;
+        float s[3] = {origin[0] - v0[0], origin[1] - v0[1], origin[2] - v0[2]};
+        u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inv;
+        if (u < 0 || u > 1)
+            return (false);
+
+        float q[3] = {s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0]};
+        v = (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) * inv;
+        if (v < 0 || u + v > 1)
+            return (false);
+
+        t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inv;
+        return (t >= 0 && t < tMax);
+    }
+
+    void SceneBvh::IntersectItem(uint32_t item, const Ray &ray, const float *inverse, float &tMax, RayHit &hit) const
+    {
+        if (!options.triangles)
+        {
+            float tEntry;
+            if (IntersectBounds(items[item].bounds, ray.origin, inverse, tMax, tEntry) && tEntry < tMax)
+            {
+                tMax = tEntry;
+                hit.item = static_cast<int>(item);
+                hit.t = tEntry;
+            }
+            return;
+        }
+
+        if (!invertible[item])
+            return;
+
+        // the direction isn't normalized in mesh space, so t stays the same in both spaces
+        const float *m = &inverseWorlds[item * 16];
+        float origin[3];
+        float direction[3];
+        for (int i = 0; i < 3; i++)
+        {
+            origin[i] = m[i] * ray.origin[0] + m[4 + i] * ray.origin[1] + m[8 + i] * ray.origin[2] + m[12 + i];
+            direction[i] = m[i] * ray.direction[0] + m[4 + i] * ray.direction[1] + m[8 + i] * ray.direction[2];
+        }
+
+        const SceneItem &sceneItem = items[item];
+        const TriangleMesh &mesh = triangleMeshes[meshOffsets[sceneItem.mesh] + sceneItem.primitive];
+        mesh.bvh.Raycast(origin, direction, tMax, [&](uint32_t triangle, float &nearest)
+        {
+            float t, u, v;
+            if (!IntersectTriangle(origin, direction, &mesh.positions[triangle * 9], nearest, t, u, v))
+                return;
+            nearest = t;
+            hit.item = static_cast<int>(item);
+            hit.t = t;
+            hit.triangle = static_cast<int>(triangle);
+            hit.u = u;
+            hit.v = v;
+        });
+    }
+
+    RayHit SceneBvh::CastRay(const Ray &ray) const
+    {
+        RayHit hit;
+        float tMax = ray.tMax;
+        float inverse[3];
+        for (int i = 0; i < 3; i++)
+            inverse[i] = 1.0f / ray.direction[i];
+
+        bvh.Raycast(ray.origin, ray.direction, tMax, [&](uint32_t item, float &nearest)
+        {
+            IntersectItem(item, ray, inverse, nearest, hit);
+        });
+        return (hit);
+    }
+
+    void SceneBvh::CastRays(const std::vector<Ray> &rays, std::vector<RayHit> &hits, ThreadPool &pool) const
+    {
+        hits.resize(rays.size());
+        pool.ParallelFor((rays.size() + raysPerTask - 1) / raysPerTask, [&](size_t task)
+        {
+            size_t end = std::min(rays.size(), (task + 1) * raysPerTask);
+            for (size_t i = task * raysPerTask; i < end; i++)
+                hits[i] = CastRay(rays[i]);
+        });
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "GlbParser/Bvh.hpp"
+#include "GlbParser/SceneGraph.hpp"
+
+namespace Glb
+{
+    // a point is inside when a * x + b * y + c * z + d >= 0 for every plane
+    struct Frustum
+    {
+        float planes[6][4]; // left, right, bottom, top, near, far
+    };
+
+    // planes of a 16 floats column major view projection matrix, OpenGL clip space (z in [-w, w])
+    Frustum ExtractFrustum(const float *viewProjection);
+
+    struct Ray
+    {
+        float origin[3];
+        float direction[3]; // doesn't have to be normalized, t is then in units of direction
+        float tMax;
+
+        Ray()
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                origin[i] = 0;
+                direction[i] = 0;
+            }
+            direction[2] = -1;
+            tMax = std::numeric_limits<float>::max();
+        }
+    };
+
+    struct RayHit
+    {
+        int item; // in SceneBvh::GetItems(), -1 when nothing was hit
+        float t;
+        int triangle; // in the primitive, -1 when only the item bounds were tested
+        float u, v; // barycentric coordinates of the hit on the triangle
+
+        RayHit()
+        {
+            item = -1;
+            t = std::numeric_limits<float>::max();
+            triangle = -1;
+            u = 0;
+            v = 0;
+        }
+    };
+
+    // one primitive of a node of the scene
+    struct SceneItem
+    {
+        size_t flatIndex; // in the SceneGraph
+        int mesh;
+        int primitive;
+        Bounds localBounds; // Primitive::bounds
+        Bounds bounds; // world space
+    };
+
+    struct SceneBvhOptions
+    {
+        BvhOptions bvh;
+        bool triangles; // also builds a Bvh over the triangles of every primitive, rays then hit triangles instead of bounds
+
+        SceneBvhOptions()
+        {
+            triangles = false;
+        }
+    };
+
+    // spatial index over the world space bounds of the primitives of a scene, the world transforms of
+    // the SceneGraph must be up to date (UpdateWorldTransforms). The GltfData is only read while building,
+    // the triangles are copied. Skinned primitives use their bind pose bounds.
+    // queries are const and can run on several threads at once
+    class SceneBvh
+    {
+        private:
+            // triangles of one primitive in the space of its mesh, shared by every node using the mesh
+            struct TriangleMesh
+            {
+                std::vector<float> positions; // 9 floats per triangle
+                Bvh bvh;
+            };
+
+            SceneBvhOptions options;
+            std::vector<SceneItem> items;
+            std::vector<float> inverseWorlds; // 16 floats per item, world to mesh space
+            std::vector<unsigned char> invertible; // a node scaled to 0 can't be hit by a ray at the triangle level
+            std::vector<size_t> meshOffsets; // first TriangleMesh of each mesh
+            std::vector<TriangleMesh> triangleMeshes;
+            Bvh bvh;
+
+            void CollectItems(const GltfData &data, const SceneGraph &graph);
+            std::vector<const Primitive*> PrepareTriangleMeshes(const GltfData &data); // primitive of each TriangleMesh to build, NULL for unused ones
+            void UpdateWorldBounds(const SceneGraph &graph, std::vector<Bounds> &bounds);
+            void IntersectItem(uint32_t item, const Ray &ray, const float *inverse, float &tMax, RayHit &hit) const;
+
+        public:
+            SceneBvh(const GltfData &data, const SceneGraph &graph, const SceneBvhOptions &options = SceneBvhOptions());
+            SceneBvh(const GltfData &data, const SceneGraph &graph, ThreadPool &pool, const SceneBvhOptions &options = SceneBvhOptions()); // triangle Bvhs built in parallel
+
+            void Refit(const SceneGraph &graph); // the world transforms changed, keeps the tree and only updates its boxes
+
+            size_t GetNbItem() const { return (items.size()); }
+            const std::vector<SceneItem> &GetItems() const { return (items); }
+            const Bvh &GetBvh() const { return (bvh); }
+
+            // indices of the items intersecting the frustum, in no particular order
+            void CullFrustum(const Frustum &frustum, std::vector<uint32_t> &visible) const;
+            void CullFrustums(const std::vector<Frustum> &frustums, std::vector<std::vector<uint32_t>> &visibles, ThreadPool &pool) const;
+
+            RayHit CastRay(const Ray &ray) const; // nearest hit
+            void CastRays(const std::vector<Ray> &rays, std::vector<RayHit> &hits, ThreadPool &pool) const;
+    };
+}
@@ -0,0 +1,177 @@
+#include "GlbParser/SceneGraph.hpp"
+#include "GlbParser/VertexKernels.hpp"
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+
+namespace Glb
+{
+    SceneGraph::SceneGraph(const std::vector<Node> &nodes, const std::vector<int> &roots)
+    {
+        Flatten(nodes, roots);
+    }
+
+    SceneGraph::SceneGraph(const GltfData &data)
+    {
+        if (data.rootScene >= 0 && static_cast<size_t>(data.rootScene) < data.scenes.size())
+        {
+            const std::pmr::vector<int> &sceneNodes = data.scenes[data.rootScene].nodes;
+            Flatten(data.nodes, std::vector<int>(sceneNodes.begin(), sceneNodes.end()));
+            return;
+        }
+
+        std::vector<bool> isChild(data.nodes.size(), false);
+        for (const Node &node: data.nodes)
+        {
+            for (int child: node.children)
+            {
+                if (child >= 0 && static_cast<size_t>(child) < isChild.size())
+                    isChild[child] = true;
+            }
+        }
+
+        std::vector<int> roots;
+        for (size_t i = 0; i < data.nodes.size(); i++)
+        {
+            if (!isChild[i])
+                roots.push_back(i);
+        }
+        Flatten(data.nodes, roots);
+    }
+
+    void SceneGraph::Flatten(const std::vector<Node> &nodes, const std::vector<int> &roots)
+    {
+        flatIndices.assign(nodes.size(), -1);
+
+        // iterative depth first walk, hierarchies can be deep enough to overflow a recursive one
+        std::vector<std::pair<int, int>> stack; // node, flat index of its parent
+        for (auto it = roots.rbegin(); it != roots.rend(); it++)
+            stack.push_back({*it, -1});
+
+        while (!stack.empty())
+        {
+            auto [nodeIndex, parent] = stack.back();
+            stack.pop_back();
+
+            if (nodeIndex < 0 || static_cast<size_t>(nodeIndex) >= nodes.size())
+                throw(std::runtime_error("node " + std::to_string(nodeIndex) + " doesn't exist"));
+            if (flatIndices[nodeIndex] != -1)
+                throw(std::runtime_error("node " + std::to_string(nodeIndex) + " has several parents or is in a cycle"));
+
+            flatIndices[nodeIndex] = parents.size();
+            parents.push_back(parent);
+            nodeIndices.push_back(nodeIndex);
+            locals.push_back(DecomposeTransform(nodes[nodeIndex].transform));
+
+            const std::pmr::vector<int> &children = nodes[nodeIndex].children;
+            for (auto it = children.rbegin(); it != children.rend(); it++)
+                stack.push_back({*it, flatIndices[nodeIndex]});
+        }
+
+        // children are after their parent, so walking backwards closes every subtree before its parent's
+        size_t nbNode = parents.size();
+        subtreeEnds.resize(nbNode);
+        for (size_t i = 0; i < nbNode; i++)
+            subtreeEnds[i] = i + 1;
+        for (size_t i = nbNode; i-- > 0;)
+        {
+            if (parents[i] >= 0)
+                subtreeEnds[parents[i]] = std::max(subtreeEnds[parents[i]], subtreeEnds[i]);
+        }
+
+        localMatrices.resize(nbNode * 16);
+        worlds.resize(nbNode * 16);
+        dirty.assign(nbNode, 1);
+        hasDirty = nbNode != 0;
+    }
+
+    void SceneGraph::SetLocalTransform(size_t index, const LocalTransform &transform)
+    {
+        locals[index] = transform;
+        dirty[index] = 1;
+        hasDirty = true;
+    }
+
+    void SceneGraph::SetLocalTransforms(const std::vector<LocalTransform> &pose)
+    {
+        for (size_t i = 0; i < locals.size(); i++)
+        {
+            size_t nodeIndex = nodeIndices[i];
+            if (nodeIndex >= pose.size())
+                continue;
+            if (std::memcmp(&locals[i], &pose[nodeIndex], sizeof(LocalTransform)) != 0)
+                SetLocalTransform(i, pose[nodeIndex]);
+        }
+    }
+
+    // column major T * R * S
+    static void ComposeMatrix(const LocalTransform &transform, float *matrix)
+    {
+        const float *q = transform.rotation;
+        const float *s = transform.scale;
+        float xx = q[0] * q[0], yy = q[1] * q[1], zz = q[2] * q[2];
+        float xy = q[0] * q[1], xz = q[0] * q[2], yz = q[1] * q[2];
+        float wx = q[3] * q[0], wy = q[3] * q[1], wz = q[3] * q[2];
+
+        matrix[0] = (1 - 2 * (yy + zz)) * s[0];
+        matrix[1] = 2 * (xy + wz) * s[0];
+        matrix[2] = 2 * (xz - wy) * s[0];
+        matrix[3] = 0;
+        matrix[4] = 2 * (xy - wz) * s[1];
+        matrix[5] = (1 - 2 * (xx + zz)) * s[1];
+        matrix[6] = 2 * (yz + wx) * s[1];
+        matrix[7] = 0;
+        matrix[8] = 2 * (xz + wy) * s[2];
+        matrix[9] = 2 * (yz - wx) * s[2];
+        matrix[10] = (1 - 2 * (xx + yy)) * s[2];
+        matrix[11] = 0;
+        matrix[12] = transform.translation[0];
+        matrix[13] = transform.translation[1];
+        matrix[14] = transform.translation[2];
+        matrix[15] = 1;
+    }
+
+    size_t SceneGraph::UpdateWorldTransforms()
+    {
+        if (!hasDirty)
+            return (0);
+
+        size_t nbComputed = 0;
+        size_t i = 0;
+        while (i < parents.size())
+        {
+            if (!dirty[i])
+            {
+                i++;
+                continue;
+            }
+
+            // the whole subtree moves, only the dirty nodes inside need a new local matrix
+            size_t end = subtreeEnds[i];
+            for (size_t j = i; j < end; j++)
+            {
+                if (dirty[j])
+                {
+                    ComposeMatrix(locals[j], localMatrices.data() + j * 16);
+                    dirty[j] = 0;
+                }
+            }
+            Kernels::MultiplyHierarchy(localMatrices.data(), parents.data(), worlds.data(), i, end);
+            nbComputed += end - i;
+            i = end;
+        }
+
+        hasDirty = false;
+        return (nbComputed);
+    }
+
+    ml::mat4 SceneGraph::GetWorldTransform(size_t index) const
+    {
+        const float *world = GetWorldMatrix(index);
+
+        ml::mat4 transform;
+        for (size_t j = 0; j < 16; j++)
+            transform[j % 4][j / 4] = world[j];
+        return (transform);
+    }
+}
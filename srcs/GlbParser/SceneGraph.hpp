@@ -0,0 +1,44 @@
+#pragma once
+
+#include "GlbParser/AnimationRuntime.hpp"
+
+namespace Glb
+{
+    // nodes of a scene flattened depth first: a parent is always before its children and the
+    // subtree of a node is the contiguous range [index, GetSubtreeEnd(index)).
+    // indices of the methods are flat indices, see GetFlatIndex to go from a glTF node to it
+    class SceneGraph
+    {
+        private:
+            std::vector<int> parents; // -1 for the roots
+            std::vector<int> nodeIndices;
+            std::vector<int> flatIndices; // -1 for the nodes outside of the scene
+            std::vector<size_t> subtreeEnds;
+            std::vector<LocalTransform> locals;
+            std::vector<float> localMatrices; // 16 floats per node, column major like glTF
+            std::vector<float> worlds;
+            std::vector<unsigned char> dirty; // local transform changed since the last update
+            bool hasDirty;
+
+            void Flatten(const std::vector<Node> &nodes, const std::vector<int> &roots);
+
+        public:
+            SceneGraph(const std::vector<Node> &nodes, const std::vector<int> &roots);
+            SceneGraph(const GltfData &data); // root scene, or every node without parent when there is none
+
+            size_t GetNbNode() const { return (parents.size()); }
+            int GetParent(size_t index) const { return (parents[index]); }
+            int GetNodeIndex(size_t index) const { return (nodeIndices[index]); }
+            int GetFlatIndex(size_t nodeIndex) const { return (nodeIndex < flatIndices.size() ? flatIndices[nodeIndex] : -1); }
+            size_t GetSubtreeEnd(size_t index) const { return (subtreeEnds[index]); }
+
+            const LocalTransform &GetLocalTransform(size_t index) const { return (locals[index]); }
+            void SetLocalTransform(size_t index, const LocalTransform &transform);
+            void SetLocalTransforms(const std::vector<LocalTransform> &pose); // indexed by glTF node, only changed ones are marked dirty
+
+            // recomputes the world matrices of the dirty subtrees, returns the number of matrices computed
+            size_t UpdateWorldTransforms();
+            const float *GetWorldMatrix(size_t index) const { return (worlds.data() + index * 16); }
+            ml::mat4 GetWorldTransform(size_t index) const;
+    };
+}
@@ -0,0 +1,83 @@
+#include "GlbParser/Skinning.hpp"
+#include "GlbParser/VertexKernels.hpp"
+#include <stdexcept>
+
+namespace Glb
+{
+    std::vector<float> BuildJointPalette(const Skin &skin, const SceneGraph &graph)
+    {
+        std::vector<float> palette(skin.joints.size() * 16);
+        BuildJointPalette(skin, graph, palette.data());
+        return (palette);
+    }
+
+    void BuildJointPalette(const Skin &skin, const SceneGraph &graph, float *palette)
+    {
+        for (size_t i = 0; i < skin.joints.size(); i++)
+        {
+            const Joint &joint = skin.joints[i];
+            int flatIndex = graph.GetFlatIndex(joint.nodeIndex);
+            if (flatIndex < 0)
+                throw(std::runtime_error("joint node " + std::to_string(joint.nodeIndex) + " isn't in the scene graph"));
+
+            const float *world = graph.GetWorldMatrix(flatIndex);
+            float *matrix = palette + i * 16;
+            for (size_t c = 0; c < 4; c++)
+            {
+                for (size_t r = 0; r < 4; r++)
+                {
+                    matrix[c * 4 + r] = world[r] * joint.inverseBindMatrix[0][c]
+                                      + world[4 + r] * joint.inverseBindMatrix[1][c]
+                                      + world[8 + r] * joint.inverseBindMatrix[2][c]
+                                      + world[12 + r] * joint.inverseBindMatrix[3][c];
+                }
+            }
+        }
+    }
+
+    static Kernels::SkinningInput GetSkinningInput(const Primitive &primitive, size_t nbJoint, bool withNormals)
+    {
+        // the kernels index the palette without checking
+        for (const Vertex &vertex: primitive.vertices)
+        {
+            if (vertex.j1 >= nbJoint || vertex.j2 >= nbJoint || vertex.j3 >= nbJoint || vertex.j4 >= nbJoint)
+                throw(std::runtime_error("vertex joint out of the palette of " + std::to_string(nbJoint) + " joints"));
+        }
+
+        Kernels::SkinningInput input;
+        const Vertex *vertices = primitive.vertices.data();
+        input.positions = &vertices->x;
+        input.normals = withNormals ? &vertices->nx : NULL;
+        input.joints = &vertices->j1;
+        input.weights = &vertices->w1;
+        input.stride = sizeof(Vertex);
+        return (input);
+    }
+
+    void SkinPrimitive(const Primitive &primitive, const float *palette, size_t nbJoint, float *positions, float *normals)
+    {
+        if (primitive.vertices.empty())
+            return;
+
+        Kernels::SkinningInput input = GetSkinningInput(primitive, nbJoint, normals != NULL);
+        Kernels::SkinVertices(palette, input, positions, normals, 0, primitive.vertices.size());
+    }
+
+    void SkinPrimitive(const Primitive &primitive, const float *palette, size_t nbJoint, float *positions, float *normals, ThreadPool &pool)
+    {
+        if (primitive.vertices.empty())
+            return;
+
+        Kernels::SkinningInput input = GetSkinningInput(primitive, nbJoint, normals != NULL);
+
+        // ranges big enough for the task overhead to stay small, each range writes its own outputs
+        const size_t nbVertexPerTask = 4096;
+        size_t nbVertex = primitive.vertices.size();
+        size_t nbTask = (nbVertex + nbVertexPerTask - 1) / nbVertexPerTask;
+        pool.ParallelFor(nbTask, [&](size_t task)
+        {
+            size_t begin = task * nbVertexPerTask;
+            Kernels::SkinVertices(palette, input, positions, normals, begin, std::min(begin + nbVertexPerTask, nbVertex));
+        });
+    }
+}
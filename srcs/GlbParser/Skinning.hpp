@@ -0,0 +1,18 @@
+#pragma once
+
+#include "GlbParser/SceneGraph.hpp"
+
+namespace Glb
+{
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#skins-overview
+    // jointMatrix = world transform of the joint node * inverse bind matrix, 16 floats column major per joint
+    std::vector<float> BuildJointPalette(const Skin &skin, const SceneGraph &graph);
+    void BuildJointPalette(const Skin &skin, const SceneGraph &graph, float *palette); // palette holds 16 floats per joint
+
+    // writes the skinned positions, and normals when not NULL, of every vertex of the primitive as packed float3,
+    // the outputs must hold 3 * vertices.size() floats, normals go through the inverse transpose of the blended matrix
+    // so they stay perpendicular under non uniform scale
+    void SkinPrimitive(const Primitive &primitive, const float *palette, size_t nbJoint, float *positions, float *normals);
+    // same, split by vertex ranges on the pool
+    void SkinPrimitive(const Primitive &primitive, const float *palette, size_t nbJoint, float *positions, float *normals, ThreadPool &pool);
+}
@@ -0,0 +1,148 @@
+#include "GlbParser/ThreadPool.hpp"
+#include <exception>
+
+namespace Glb
+{
+    // pool and queue owned by the current thread, NULL outside of the workers
+    static thread_local const ThreadPool *currentPool = NULL;
+    static thread_local size_t currentQueue = 0;
+
+    ThreadPool::ThreadPool(size_t nbThread)
+    {
+        if (nbThread == 0)
+            nbThread = 1;
+
+        nbPendingTask = 0;
+        nextQueue = 0;
+        stop = false;
+        for (size_t i = 0; i < nbThread; i++)
+            queues.push_back(std::make_unique<WorkerQueue>());
+        for (size_t i = 0; i < nbThread; i++)
+            threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stop = true;
+        }
+        wakeUp.notify_all();
+        for (std::thread &thread: threads)
+            thread.join();
+    }
+
+    void ThreadPool::Submit(std::function<void()> task)
+    {
+        size_t queueIndex;
+        if (currentPool == this)
+            queueIndex = currentQueue;
+        else
+            queueIndex = nextQueue++ % queues.size();
+
+        // counted before being published, a worker popping it right away can't take the counter below zero
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            nbPendingTask++;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues[queueIndex]->mutex);
+            queues[queueIndex]->tasks.push_back(std::move(task));
+        }
+        wakeUp.notify_one();
+    }
+
+    bool ThreadPool::PopTask(size_t queueIndex, std::function<void()> &task)
+    {
+        // own queue first, newest task for cache locality
+        {
+            WorkerQueue &queue = *queues[queueIndex];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty())
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                nbPendingTask--;
+                return (true);
+            }
+        }
+
+        // then steal the oldest task of another queue
+        for (size_t i = 1; i < queues.size(); i++)
+        {
+            WorkerQueue &queue = *queues[(queueIndex + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty())
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                nbPendingTask--;
+                return (true);
+            }
+        }
+
+        return (false);
+    }
+
+    void ThreadPool::WorkerLoop(size_t queueIndex)
+    {
+        currentPool = this;
+        currentQueue = queueIndex;
+        while (true)
+        {
+            std::function<void()> task;
+            if (PopTask(queueIndex, task))
+            {
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wakeUp.wait(lock, [this]() { return (stop || nbPendingTask > 0); });
+            if (stop && nbPendingTask == 0)
+                return;
+        }
+    }
+
+    void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)> &function)
+    {
+        if (count == 0)
+            return;
+
+        std::atomic<size_t> nbRemaining(count);
+        std::mutex errorMutex;
+        std::exception_ptr error;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            Submit([&, i]()
+            {
+                try
+                {
+                    function(i);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error)
+                        error = std::current_exception();
+                }
+                nbRemaining--;
+            });
+        }
+
+        // help instead of blocking, a worker waiting here must keep the pool going
+        size_t queueIndex = currentPool == this ? currentQueue : 0;
+        while (nbRemaining > 0)
+        {
+            std::function<void()> task;
+            if (PopTask(queueIndex, task))
+                task();
+            else
+                std::this_thread::yield();
+        }
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
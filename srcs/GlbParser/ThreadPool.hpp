@@ -0,0 +1,48 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+namespace Glb
+{
+    // work-stealing pool: every worker owns a queue and steals from the others when it is empty
+    class ThreadPool
+    {
+        private:
+            struct WorkerQueue
+            {
+                std::mutex mutex;
+                std::deque<std::function<void()>> tasks;
+            };
+
+            std::vector<std::unique_ptr<WorkerQueue>> queues;
+            std::vector<std::thread> threads;
+            std::mutex sleepMutex;
+            std::condition_variable wakeUp;
+            std::atomic<size_t> nbPendingTask;
+            std::atomic<size_t> nextQueue;
+            bool stop;
+
+            bool PopTask(size_t queueIndex, std::function<void()> &task);
+            void WorkerLoop(size_t queueIndex);
+
+        public:
+            explicit ThreadPool(size_t nbThread = std::thread::hardware_concurrency());
+            ThreadPool(const ThreadPool &) = delete;
+            ~ThreadPool();
+
+            ThreadPool &operator=(const ThreadPool &) = delete;
+
+            size_t GetNbThread() const { return (threads.size()); }
+            void Submit(std::function<void()> task);
+            // runs function(0) .. function(count - 1) and returns once all of them are done,
+            // the calling thread runs tasks too so it can be called from inside a task
+            void ParallelFor(size_t count, const std::function<void(size_t)> &function);
+    };
+}
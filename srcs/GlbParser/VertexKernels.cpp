@@ -0,0 +1,947 @@
+#include "GlbParser/VertexKernels.hpp"
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define GLB_KERNELS_X86
+    #include <immintrin.h>
+#elif defined(__ARM_NEON)
+    #define GLB_KERNELS_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace Glb
+{
+    namespace Kernels
+    {
+        struct KernelTable
+        {
+            const char *name;
+            void (*widenU8ToU16)(const uint8_t *src, uint16_t *dst, size_t count);
+            void (*widenU16ToU32)(const uint16_t *src, uint32_t *dst, size_t count);
+            void (*narrowU32ToU16)(const uint32_t *src, uint16_t *dst, size_t count);
+            void (*interleaveFloats)(const unsigned char *src, size_t srcStride, size_t nbFloat, float *dst, size_t dstStride, size_t count);
+            void (*interleaveJointsU8)(const unsigned char *src, size_t srcStride, uint16_t *dst, size_t dstStride, size_t count);
+            void (*blendVec4)(const float *keys, const float *weights, float *dst, size_t count);
+            void (*multiplyHierarchy)(const float *locals, const int *parents, float *worlds, size_t begin, size_t end);
+            void (*skinVertices)(const float *palette, const SkinningInput &input, float *positions, float *normals, size_t begin, size_t end);
+            void (*decodeByteDeltas)(const uint8_t *deltas, size_t deltaStride, uint8_t *vertices, size_t vertexSize, size_t count, uint8_t *last);
+            void (*positionBounds)(const float *positions, size_t stride, size_t count, float *min, float *max);
+        };
+
+        template <typename T>
+        static const T *GetVertex(const T *stream, size_t stride, size_t index)
+        {
+            return (reinterpret_cast<const T*>(reinterpret_cast<const unsigned char*>(stream) + index * stride));
+        }
+
+        static void Normalize3(float *vector)
+        {
+            float length = std::sqrt(vector[0] * vector[0] + vector[1] * vector[1] + vector[2] * vector[2]);
+            if (length > 0)
+            {
+                vector[0] /= length;
+                vector[1] /= length;
+                vector[2] /= length;
+            }
+        }
+
+        // normals go through the inverse transpose of the 3x3 part, x y z being its columns: the cofactor matrix
+        // (y^z, z^x, x^y) is the inverse transpose times the determinant, the normalization removes the scale and
+        // the sign of the determinant keeps the normals of mirrored joints outward
+        static void TransformNormal(const float *x, const float *y, const float *z, const float *normal, float *out)
+        {
+            float yz[3] = {y[1] * z[2] - y[2] * z[1], y[2] * z[0] - y[0] * z[2], y[0] * z[1] - y[1] * z[0]};
+            float zx[3] = {z[1] * x[2] - z[2] * x[1], z[2] * x[0] - z[0] * x[2], z[0] * x[1] - z[1] * x[0]};
+            float xy[3] = {x[1] * y[2] - x[2] * y[1], x[2] * y[0] - x[0] * y[2], x[0] * y[1] - x[1] * y[0]};
+            float sign = x[0] * yz[0] + x[1] * yz[1] + x[2] * yz[2] < 0 ? -1.0f : 1.0f;
+            for (size_t r = 0; r < 3; r++)
+                out[r] = sign * (yz[r] * normal[0] + zx[r] * normal[1] + xy[r] * normal[2]);
+            Normalize3(out);
+        }
+
+        // Scalar
+
+        static void ScalarSkinVertices(const float *palette, const SkinningInput &input, float *positions, float *normals, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                const uint16_t *joints = GetVertex(input.joints, input.stride, i);
+                const float *weights = GetVertex(input.weights, input.stride, i);
+
+                float matrix[12] = {}; // 3 rows of the 4 columns, the last row of a palette matrix is 0 0 0 1
+                for (size_t k = 0; k < 4; k++)
+                {
+                    const float *joint = palette + joints[k] * 16;
+                    for (size_t c = 0; c < 4; c++)
+                    {
+                        for (size_t r = 0; r < 3; r++)
+                            matrix[c * 3 + r] += weights[k] * joint[c * 4 + r];
+                    }
+                }
+
+                const float *position = GetVertex(input.positions, input.stride, i);
+                for (size_t r = 0; r < 3; r++)
+                    positions[i * 3 + r] = matrix[r] * position[0] + matrix[3 + r] * position[1] + matrix[6 + r] * position[2] + matrix[9 + r];
+
+                if (input.normals)
+                    TransformNormal(matrix, matrix + 3, matrix + 6, GetVertex(input.normals, input.stride, i), normals + i * 3);
+            }
+        }
+
+        static void ScalarWidenU8ToU16(const uint8_t *src, uint16_t *dst, size_t count)
+        {
+            for (size_t i = 0; i < count; i++)
+                dst[i] = src[i];
+        }
+
+        static void ScalarWidenU16ToU32(const uint16_t *src, uint32_t *dst, size_t count)
+        {
+            for (size_t i = 0; i < count; i++)
+                dst[i] = src[i];
+        }
+
+        static void ScalarNarrowU32ToU16(const uint32_t *src, uint16_t *dst, size_t count)
+        {
+            for (size_t i = 0; i < count; i++)
+                dst[i] = static_cast<uint16_t>(src[i]);
+        }
+
+        template <size_t N>
+        static void ScalarInterleaveFloatsN(const unsigned char *src, size_t srcStride, float *dst, size_t dstStride, size_t count)
+        {
+            unsigned char *dstBytes = reinterpret_cast<unsigned char*>(dst);
+            for (size_t i = 0; i < count; i++)
+                std::memcpy(dstBytes + i * dstStride, src + i * srcStride, N * sizeof(float));
+        }
+
+        static void ScalarInterleaveFloats(const unsigned char *src, size_t srcStride, size_t nbFloat, float *dst, size_t dstStride, size_t count)
+        {
+            switch (nbFloat)
+            {
+                case 1: ScalarInterleaveFloatsN<1>(src, srcStride, dst, dstStride, count); break;
+                case 2: ScalarInterleaveFloatsN<2>(src, srcStride, dst, dstStride, count); break;
+                case 3: ScalarInterleaveFloatsN<3>(src, srcStride, dst, dstStride, count); break;
+                case 4: ScalarInterleaveFloatsN<4>(src, srcStride, dst, dstStride, count); break;
+                default: break;
+            }
+        }
+
+        static void ScalarInterleaveJointsU8(const unsigned char *src, size_t srcStride, uint16_t *dst, size_t dstStride, size_t count)
+        {
+            unsigned char *dstBytes = reinterpret_cast<unsigned char*>(dst);
+            for (size_t i = 0; i < count; i++)
+            {
+                uint16_t joints[4] = {src[i * srcStride + 0], src[i * srcStride + 1], src[i * srcStride + 2], src[i * srcStride + 3]};
+                std::memcpy(dstBytes + i * dstStride, joints, sizeof(joints));
+            }
+        }
+
+        static void ScalarPositionBounds(const float *positions, size_t stride, size_t count, float *min, float *max)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                const float *position = GetVertex(positions, stride, i);
+                for (size_t c = 0; c < 3; c++)
+                {
+                    min[c] = std::min(min[c], position[c]);
+                    max[c] = std::max(max[c], position[c]);
+                }
+            }
+        }
+
+#if defined(GLB_KERNELS_X86)
+        // SSE2, always available on x86_64
+
+        static void Sse2WidenU8ToU16(const uint8_t *src, uint16_t *dst, size_t count)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16)
+            {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(bytes, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(bytes, zero));
+            }
+            ScalarWidenU8ToU16(src + i, dst + i, count - i);
+        }
+
+        static void Sse2WidenU16ToU32(const uint16_t *src, uint32_t *dst, size_t count)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m128i shorts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(shorts, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(shorts, zero));
+            }
+            ScalarWidenU16ToU32(src + i, dst + i, count - i);
+        }
+
+        static void Sse2NarrowU32ToU16(const uint32_t *src, uint16_t *dst, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                // sign extend the low 16 bits so the saturating pack keeps them unchanged
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4));
+                a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+                b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(a, b));
+            }
+            ScalarNarrowU32ToU16(src + i, dst + i, count - i);
+        }
+
+        static void Sse2InterleaveFloats(const unsigned char *src, size_t srcStride, size_t nbFloat, float *dst, size_t dstStride, size_t count)
+        {
+            unsigned char *dstBytes = reinterpret_cast<unsigned char*>(dst);
+            if (nbFloat == 4)
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    __m128 value = _mm_loadu_ps(reinterpret_cast<const float*>(src + i * srcStride));
+                    _mm_storeu_ps(reinterpret_cast<float*>(dstBytes + i * dstStride), value);
+                }
+            }
+            else if (nbFloat == 3)
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    const unsigned char *s = src + i * srcStride;
+                    unsigned char *d = dstBytes + i * dstStride;
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(d), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(s)));
+                    _mm_store_ss(reinterpret_cast<float*>(d + 8), _mm_load_ss(reinterpret_cast<const float*>(s + 8)));
+                }
+            }
+            else if (nbFloat == 2)
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    __m128i value = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i * srcStride));
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(dstBytes + i * dstStride), value);
+                }
+            }
+            else
+                ScalarInterleaveFloats(src, srcStride, nbFloat, dst, dstStride, count);
+        }
+
+        static void Sse2InterleaveJointsU8(const unsigned char *src, size_t srcStride, uint16_t *dst, size_t dstStride, size_t count)
+        {
+            if (srcStride != 4)
+            {
+                ScalarInterleaveJointsU8(src, srcStride, dst, dstStride, count);
+                return;
+            }
+
+            // 16 bytes = joints of 4 vertices, widened to 2 registers of 2 vertices each
+            const __m128i zero = _mm_setzero_si128();
+            unsigned char *dstBytes = reinterpret_cast<unsigned char*>(dst);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+                __m128i low = _mm_unpacklo_epi8(bytes, zero);
+                __m128i high = _mm_unpackhi_epi8(bytes, zero);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dstBytes + (i + 0) * dstStride), low);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dstBytes + (i + 1) * dstStride), _mm_srli_si128(low, 8));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dstBytes + (i + 2) * dstStride), high);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dstBytes + (i + 3) * dstStride), _mm_srli_si128(high, 8));
+            }
+            ScalarInterleaveJointsU8(src + i * 4, srcStride, reinterpret_cast<uint16_t*>(dstBytes + i * dstStride), dstStride, count - i);
+        }
+
+        static void Sse2BlendVec4(const float *keys, const float *weights, float *dst, size_t count)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                const float *key = keys + i * 16;
+                const float *weight = weights + i * 4;
+                __m128 sum = _mm_mul_ps(_mm_loadu_ps(key), _mm_set1_ps(weight[0]));
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(key + 4), _mm_set1_ps(weight[1])));
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(key + 8), _mm_set1_ps(weight[2])));
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(key + 12), _mm_set1_ps(weight[3])));
+                _mm_storeu_ps(dst + i * 4, sum);
+            }
+        }
+
+        static void Sse2MultiplyHierarchy(const float *locals, const int *parents, float *worlds, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                const float *local = locals + i * 16;
+                float *world = worlds + i * 16;
+                if (parents[i] < 0)
+                {
+                    std::memcpy(world, local, 16 * sizeof(float));
+                    continue;
+                }
+
+                const float *parent = worlds + parents[i] * 16;
+                __m128 column0 = _mm_loadu_ps(parent);
+                __m128 column1 = _mm_loadu_ps(parent + 4);
+                __m128 column2 = _mm_loadu_ps(parent + 8);
+                __m128 column3 = _mm_loadu_ps(parent + 12);
+                for (size_t c = 0; c < 4; c++)
+                {
+                    const float *l = local + c * 4;
+                    __m128 sum = _mm_mul_ps(column0, _mm_set1_ps(l[0]));
+                    sum = _mm_add_ps(sum, _mm_mul_ps(column1, _mm_set1_ps(l[1])));
+                    sum = _mm_add_ps(sum, _mm_mul_ps(column2, _mm_set1_ps(l[2])));
+                    sum = _mm_add_ps(sum, _mm_mul_ps(column3, _mm_set1_ps(l[3])));
+                    _mm_storeu_ps(world + c * 4, sum);
+                }
+            }
+        }
+
+        // a ^ b in the 3 first lanes, the 4th one is 0
+        static __m128 Sse2Cross(__m128 a, __m128 b)
+        {
+            __m128 aYzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+            __m128 bYzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+            __m128 cross = _mm_sub_ps(_mm_mul_ps(a, bYzx), _mm_mul_ps(aYzx, b));
+            return (_mm_shuffle_ps(cross, cross, _MM_SHUFFLE(3, 0, 2, 1)));
+        }
+
+        // same as TransformNormal
+        static void Sse2TransformNormal(__m128 x, __m128 y, __m128 z, const float *normal, float *out)
+        {
+            __m128 yz = Sse2Cross(y, z);
+            float lanes[4];
+            _mm_storeu_ps(lanes, _mm_mul_ps(x, yz));
+            float sign = lanes[0] + lanes[1] + lanes[2] < 0 ? -1.0f : 1.0f;
+            __m128 transformed = _mm_add_ps(_mm_add_ps(_mm_mul_ps(yz, _mm_set1_ps(normal[0])), _mm_mul_ps(Sse2Cross(z, x), _mm_set1_ps(normal[1]))),
+                                            _mm_mul_ps(Sse2Cross(x, y), _mm_set1_ps(normal[2])));
+            _mm_storeu_ps(lanes, _mm_mul_ps(transformed, _mm_set1_ps(sign)));
+            std::memcpy(out, lanes, 3 * sizeof(float));
+            Normalize3(out);
+        }
+
+        static void Sse2SkinVertices(const float *palette, const SkinningInput &input, float *positions, float *normals, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                const uint16_t *joints = GetVertex(input.joints, input.stride, i);
+                const float *weights = GetVertex(input.weights, input.stride, i);
+
+                __m128 column[4];
+                for (size_t c = 0; c < 4; c++)
+                    column[c] = _mm_setzero_ps();
+                for (size_t k = 0; k < 4; k++)
+                {
+                    const float *joint = palette + joints[k] * 16;
+                    __m128 weight = _mm_set1_ps(weights[k]);
+                    for (size_t c = 0; c < 4; c++)
+                        column[c] = _mm_add_ps(column[c], _mm_mul_ps(_mm_loadu_ps(joint + c * 4), weight));
+                }
+
+                // the 4th lane is dropped, outputs are float3
+                float result[4];
+                const float *position = GetVertex(input.positions, input.stride, i);
+                __m128 skinned = _mm_add_ps(_mm_add_ps(_mm_mul_ps(column[0], _mm_set1_ps(position[0])), _mm_mul_ps(column[1], _mm_set1_ps(position[1]))),
+                                            _mm_add_ps(_mm_mul_ps(column[2], _mm_set1_ps(position[2])), column[3]));
+                _mm_storeu_ps(result, skinned);
+                std::memcpy(positions + i * 3, result, 3 * sizeof(float));
+
+                if (input.normals)
+                    Sse2TransformNormal(column[0], column[1], column[2], GetVertex(input.normals, input.stride, i), normals + i * 3);
+            }
+        }
+
+        // 16 rows of 16 bytes, 4 rounds of interleaving row i with row i + 8 end up transposed
+        static void Sse2Transpose16x16(__m128i *rows)
+        {
+            for (size_t round = 0; round < 4; round++)
+            {
+                __m128i interleaved[16];
+                for (size_t i = 0; i < 8; i++)
+                {
+                    interleaved[i * 2] = _mm_unpacklo_epi8(rows[i], rows[i + 8]);
+                    interleaved[i * 2 + 1] = _mm_unpackhi_epi8(rows[i], rows[i + 8]);
+                }
+                for (size_t i = 0; i < 16; i++)
+                    rows[i] = interleaved[i];
+            }
+        }
+
+        static void Sse2DecodeByteDeltas(const uint8_t *deltas, size_t deltaStride, uint8_t *vertices, size_t vertexSize, size_t count, uint8_t *last)
+        {
+            const __m128i one = _mm_set1_epi8(1);
+            const __m128i low7 = _mm_set1_epi8(0x7f);
+            for (size_t k = 0; k < vertexSize; k += 16)
+            {
+                size_t nbLane = vertexSize - k < 16 ? vertexSize - k : 16;
+                uint8_t lanes[16] = {};
+                std::memcpy(lanes, last + k, nbLane);
+                __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes));
+
+                for (size_t i = 0; i < count; i += 16)
+                {
+                    __m128i rows[16];
+                    for (size_t j = 0; j < 16; j++)
+                        rows[j] = j < nbLane ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(deltas + (k + j) * deltaStride + i)) : _mm_setzero_si128();
+                    Sse2Transpose16x16(rows); // rows[j] now holds the bytes k to k + 15 of vertex i + j
+
+                    size_t nbVertex = count - i < 16 ? count - i : 16;
+                    for (size_t j = 0; j < nbVertex; j++)
+                    {
+                        __m128i sign = _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(rows[j], one));
+                        previous = _mm_add_epi8(previous, _mm_xor_si128(_mm_and_si128(_mm_srli_epi16(rows[j], 1), low7), sign));
+                        uint8_t *vertex = vertices + (i + j) * vertexSize + k;
+                        if (nbLane == 16)
+                            _mm_storeu_si128(reinterpret_cast<__m128i*>(vertex), previous);
+                        else
+                        {
+                            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), previous);
+                            std::memcpy(vertex, lanes, nbLane);
+                        }
+                    }
+                }
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), previous);
+                std::memcpy(last + k, lanes, nbLane);
+            }
+        }
+
+        // reads 4 floats per position, the 4th one belongs to the next position so the last one is done in scalar
+        static void Sse2PositionBounds(const float *positions, size_t stride, size_t count, float *min, float *max)
+        {
+            if (count == 0)
+                return;
+
+            float lanes[4] = {min[0], min[1], min[2], 0};
+            __m128 low = _mm_loadu_ps(lanes);
+            lanes[0] = max[0]; lanes[1] = max[1]; lanes[2] = max[2];
+            __m128 high = _mm_loadu_ps(lanes);
+            for (size_t i = 0; i + 1 < count; i++)
+            {
+                __m128 position = _mm_loadu_ps(GetVertex(positions, stride, i));
+                low = _mm_min_ps(low, position);
+                high = _mm_max_ps(high, position);
+            }
+
+            _mm_storeu_ps(lanes, low);
+            std::memcpy(min, lanes, 3 * sizeof(float));
+            _mm_storeu_ps(lanes, high);
+            std::memcpy(max, lanes, 3 * sizeof(float));
+            ScalarPositionBounds(GetVertex(positions, stride, count - 1), stride, 1, min, max);
+        }
+
+        static const KernelTable sse2Table = {
+            "sse2",
+            Sse2WidenU8ToU16,
+            Sse2WidenU16ToU32,
+            Sse2NarrowU32ToU16,
+            Sse2InterleaveFloats,
+            Sse2InterleaveJointsU8,
+            Sse2BlendVec4,
+            Sse2MultiplyHierarchy,
+            Sse2SkinVertices,
+            Sse2DecodeByteDeltas,
+            Sse2PositionBounds
+        };
+
+        // AVX2, only used when the cpu supports it
+
+        __attribute__((target("avx2")))
+        static void Avx2WidenU8ToU16(const uint8_t *src, uint16_t *dst, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16)
+            {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_cvtepu8_epi16(bytes));
+            }
+            ScalarWidenU8ToU16(src + i, dst + i, count - i);
+        }
+
+        __attribute__((target("avx2")))
+        static void Avx2WidenU16ToU32(const uint16_t *src, uint32_t *dst, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m128i shorts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_cvtepu16_epi32(shorts));
+            }
+            ScalarWidenU16ToU32(src + i, dst + i, count - i);
+        }
+
+        __attribute__((target("avx2")))
+        static void Avx2NarrowU32ToU16(const uint32_t *src, uint16_t *dst, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16)
+            {
+                __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 8));
+                a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+                b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+                // the pack works per 128-bit lane, reorder the 64-bit blocks afterwards
+                __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+            }
+            Sse2NarrowU32ToU16(src + i, dst + i, count - i);
+        }
+
+        __attribute__((target("avx2")))
+        static void Avx2BlendVec4(const float *keys, const float *weights, float *dst, size_t count)
+        {
+            // two blends per iteration, one in each 128-bit lane
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                const float *key = keys + i * 16;
+                const float *weight = weights + i * 4;
+                __m256 sum = _mm256_mul_ps(_mm256_setr_m128(_mm_loadu_ps(key), _mm_loadu_ps(key + 16)),
+                                           _mm256_setr_m128(_mm_set1_ps(weight[0]), _mm_set1_ps(weight[4])));
+                for (size_t k = 1; k < 4; k++)
+                {
+                    __m256 value = _mm256_setr_m128(_mm_loadu_ps(key + k * 4), _mm_loadu_ps(key + 16 + k * 4));
+                    __m256 factor = _mm256_setr_m128(_mm_set1_ps(weight[k]), _mm_set1_ps(weight[4 + k]));
+                    sum = _mm256_add_ps(sum, _mm256_mul_ps(value, factor));
+                }
+                _mm256_storeu_ps(dst + i * 4, sum);
+            }
+            Sse2BlendVec4(keys + i * 16, weights + i * 4, dst + i * 4, count - i);
+        }
+
+        __attribute__((target("avx2")))
+        static void Avx2SkinVertices(const float *palette, const SkinningInput &input, float *positions, float *normals, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                const uint16_t *joints = GetVertex(input.joints, input.stride, i);
+                const float *weights = GetVertex(input.weights, input.stride, i);
+
+                // columns 0 and 1 in one register, 2 and 3 in the other
+                __m256 columns01 = _mm256_setzero_ps();
+                __m256 columns23 = _mm256_setzero_ps();
+                for (size_t k = 0; k < 4; k++)
+                {
+                    const float *joint = palette + joints[k] * 16;
+                    __m256 weight = _mm256_set1_ps(weights[k]);
+                    columns01 = _mm256_add_ps(columns01, _mm256_mul_ps(_mm256_loadu_ps(joint), weight));
+                    columns23 = _mm256_add_ps(columns23, _mm256_mul_ps(_mm256_loadu_ps(joint + 8), weight));
+                }
+
+                float result[4];
+                const float *position = GetVertex(input.positions, input.stride, i);
+                __m256 sum = _mm256_add_ps(_mm256_mul_ps(columns01, _mm256_setr_ps(position[0], position[0], position[0], position[0], position[1], position[1], position[1], position[1])),
+                                           _mm256_mul_ps(columns23, _mm256_setr_ps(position[2], position[2], position[2], position[2], 1, 1, 1, 1)));
+                _mm_storeu_ps(result, _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1)));
+                std::memcpy(positions + i * 3, result, 3 * sizeof(float));
+
+                if (input.normals)
+                {
+                    Sse2TransformNormal(_mm256_castps256_ps128(columns01), _mm256_extractf128_ps(columns01, 1), _mm256_castps256_ps128(columns23),
+                                        GetVertex(input.normals, input.stride, i), normals + i * 3);
+                }
+            }
+        }
+
+        static const KernelTable avx2Table = {
+            "avx2",
+            Avx2WidenU8ToU16,
+            Avx2WidenU16ToU32,
+            Avx2NarrowU32ToU16,
+            Sse2InterleaveFloats,
+            Sse2InterleaveJointsU8,
+            Avx2BlendVec4,
+            Sse2MultiplyHierarchy,
+            Avx2SkinVertices,
+            Sse2DecodeByteDeltas,
+            Sse2PositionBounds
+        };
+#elif defined(GLB_KERNELS_NEON)
+        // NEON, always available on aarch64
+
+        static void NeonWidenU8ToU16(const uint8_t *src, uint16_t *dst, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16)
+            {
+                uint8x16_t bytes = vld1q_u8(src + i);
+                vst1q_u16(dst + i, vmovl_u8(vget_low_u8(bytes)));
+                vst1q_u16(dst + i + 8, vmovl_u8(vget_high_u8(bytes)));
+            }
+            ScalarWidenU8ToU16(src + i, dst + i, count - i);
+        }
+
+        static void NeonWidenU16ToU32(const uint16_t *src, uint32_t *dst, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                uint16x8_t shorts = vld1q_u16(src + i);
+                vst1q_u32(dst + i, vmovl_u16(vget_low_u16(shorts)));
+                vst1q_u32(dst + i + 4, vmovl_u16(vget_high_u16(shorts)));
+            }
+            ScalarWidenU16ToU32(src + i, dst + i, count - i);
+        }
+
+        static void NeonNarrowU32ToU16(const uint32_t *src, uint16_t *dst, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                uint16x4_t low = vmovn_u32(vld1q_u32(src + i));
+                uint16x4_t high = vmovn_u32(vld1q_u32(src + i + 4));
+                vst1q_u16(dst + i, vcombine_u16(low, high));
+            }
+            ScalarNarrowU32ToU16(src + i, dst + i, count - i);
+        }
+
+        static void NeonInterleaveFloats(const unsigned char *src, size_t srcStride, size_t nbFloat, float *dst, size_t dstStride, size_t count)
+        {
+            unsigned char *dstBytes = reinterpret_cast<unsigned char*>(dst);
+            if (nbFloat == 4)
+            {
+                for (size_t i = 0; i < count; i++)
+                    vst1q_f32(reinterpret_cast<float*>(dstBytes + i * dstStride), vld1q_f32(reinterpret_cast<const float*>(src + i * srcStride)));
+            }
+            else if (nbFloat == 2)
+            {
+                for (size_t i = 0; i < count; i++)
+                    vst1_f32(reinterpret_cast<float*>(dstBytes + i * dstStride), vld1_f32(reinterpret_cast<const float*>(src + i * srcStride)));
+            }
+            else
+                ScalarInterleaveFloats(src, srcStride, nbFloat, dst, dstStride, count);
+        }
+
+        static void NeonInterleaveJointsU8(const unsigned char *src, size_t srcStride, uint16_t *dst, size_t dstStride, size_t count)
+        {
+            if (srcStride != 4)
+            {
+                ScalarInterleaveJointsU8(src, srcStride, dst, dstStride, count);
+                return;
+            }
+
+            unsigned char *dstBytes = reinterpret_cast<unsigned char*>(dst);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                uint8x16_t bytes = vld1q_u8(src + i * 4);
+                uint16x8_t low = vmovl_u8(vget_low_u8(bytes));
+                uint16x8_t high = vmovl_u8(vget_high_u8(bytes));
+                vst1_u16(reinterpret_cast<uint16_t*>(dstBytes + (i + 0) * dstStride), vget_low_u16(low));
+                vst1_u16(reinterpret_cast<uint16_t*>(dstBytes + (i + 1) * dstStride), vget_high_u16(low));
+                vst1_u16(reinterpret_cast<uint16_t*>(dstBytes + (i + 2) * dstStride), vget_low_u16(high));
+                vst1_u16(reinterpret_cast<uint16_t*>(dstBytes + (i + 3) * dstStride), vget_high_u16(high));
+            }
+            ScalarInterleaveJointsU8(src + i * 4, srcStride, reinterpret_cast<uint16_t*>(dstBytes + i * dstStride), dstStride, count - i);
+        }
+
+        static void NeonBlendVec4(const float *keys, const float *weights, float *dst, size_t count)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                const float *key = keys + i * 16;
+                const float *weight = weights + i * 4;
+                float32x4_t sum = vmulq_n_f32(vld1q_f32(key), weight[0]);
+                sum = vmlaq_n_f32(sum, vld1q_f32(key + 4), weight[1]);
+                sum = vmlaq_n_f32(sum, vld1q_f32(key + 8), weight[2]);
+                sum = vmlaq_n_f32(sum, vld1q_f32(key + 12), weight[3]);
+                vst1q_f32(dst + i * 4, sum);
+            }
+        }
+
+        static void NeonMultiplyHierarchy(const float *locals, const int *parents, float *worlds, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                const float *local = locals + i * 16;
+                float *world = worlds + i * 16;
+                if (parents[i] < 0)
+                {
+                    std::memcpy(world, local, 16 * sizeof(float));
+                    continue;
+                }
+
+                const float *parent = worlds + parents[i] * 16;
+                float32x4_t column0 = vld1q_f32(parent);
+                float32x4_t column1 = vld1q_f32(parent + 4);
+                float32x4_t column2 = vld1q_f32(parent + 8);
+                float32x4_t column3 = vld1q_f32(parent + 12);
+                for (size_t c = 0; c < 4; c++)
+                {
+                    const float *l = local + c * 4;
+                    float32x4_t sum = vmulq_n_f32(column0, l[0]);
+                    sum = vmlaq_n_f32(sum, column1, l[1]);
+                    sum = vmlaq_n_f32(sum, column2, l[2]);
+                    sum = vmlaq_n_f32(sum, column3, l[3]);
+                    vst1q_f32(world + c * 4, sum);
+                }
+            }
+        }
+
+        static void NeonSkinVertices(const float *palette, const SkinningInput &input, float *positions, float *normals, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                const uint16_t *joints = GetVertex(input.joints, input.stride, i);
+                const float *weights = GetVertex(input.weights, input.stride, i);
+
+                float32x4_t column[4];
+                for (size_t c = 0; c < 4; c++)
+                    column[c] = vdupq_n_f32(0);
+                for (size_t k = 0; k < 4; k++)
+                {
+                    const float *joint = palette + joints[k] * 16;
+                    for (size_t c = 0; c < 4; c++)
+                        column[c] = vmlaq_n_f32(column[c], vld1q_f32(joint + c * 4), weights[k]);
+                }
+
+                float result[4];
+                const float *position = GetVertex(input.positions, input.stride, i);
+                float32x4_t skinned = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(column[3], column[0], position[0]), column[1], position[1]), column[2], position[2]);
+                vst1q_f32(result, skinned);
+                std::memcpy(positions + i * 3, result, 3 * sizeof(float));
+
+                if (input.normals)
+                {
+                    float matrix[12];
+                    for (size_t c = 0; c < 3; c++)
+                        vst1q_f32(matrix + c * 4, column[c]);
+                    TransformNormal(matrix, matrix + 4, matrix + 8, GetVertex(input.normals, input.stride, i), normals + i * 3);
+                }
+            }
+        }
+
+        static void NeonTranspose16x16(uint8x16_t *rows)
+        {
+            for (size_t round = 0; round < 4; round++)
+            {
+                uint8x16_t interleaved[16];
+                for (size_t i = 0; i < 8; i++)
+                {
+                    uint8x16x2_t zipped = vzipq_u8(rows[i], rows[i + 8]);
+                    interleaved[i * 2] = zipped.val[0];
+                    interleaved[i * 2 + 1] = zipped.val[1];
+                }
+                for (size_t i = 0; i < 16; i++)
+                    rows[i] = interleaved[i];
+            }
+        }
+
+        static void NeonDecodeByteDeltas(const uint8_t *deltas, size_t deltaStride, uint8_t *vertices, size_t vertexSize, size_t count, uint8_t *last)
+        {
+            const uint8x16_t one = vdupq_n_u8(1);
+            for (size_t k = 0; k < vertexSize; k += 16)
+            {
+                size_t nbLane = vertexSize - k < 16 ? vertexSize - k : 16;
+                uint8_t lanes[16] = {};
+                std::memcpy(lanes, last + k, nbLane);
+                uint8x16_t previous = vld1q_u8(lanes);
+
+                for (size_t i = 0; i < count; i += 16)
+                {
+                    uint8x16_t rows[16];
+                    for (size_t j = 0; j < 16; j++)
+                        rows[j] = j < nbLane ? vld1q_u8(deltas + (k + j) * deltaStride + i) : vdupq_n_u8(0);
+                    NeonTranspose16x16(rows);
+
+                    size_t nbVertex = count - i < 16 ? count - i : 16;
+                    for (size_t j = 0; j < nbVertex; j++)
+                    {
+                        uint8x16_t sign = vsubq_u8(vdupq_n_u8(0), vandq_u8(rows[j], one));
+                        previous = vaddq_u8(previous, veorq_u8(vshrq_n_u8(rows[j], 1), sign));
+                        uint8_t *vertex = vertices + (i + j) * vertexSize + k;
+                        if (nbLane == 16)
+                            vst1q_u8(vertex, previous);
+                        else
+                        {
+                            vst1q_u8(lanes, previous);
+                            std::memcpy(vertex, lanes, nbLane);
+                        }
+                    }
+                }
+
+                vst1q_u8(lanes, previous);
+                std::memcpy(last + k, lanes, nbLane);
+            }
+        }
+
+        // reads 4 floats per position, the 4th one belongs to the next position so the last one is done in scalar
+        static void NeonPositionBounds(const float *positions, size_t stride, size_t count, float *min, float *max)
+        {
+            if (count == 0)
+                return;
+
+            float lanes[4] = {min[0], min[1], min[2], 0};
+            float32x4_t low = vld1q_f32(lanes);
+            lanes[0] = max[0]; lanes[1] = max[1]; lanes[2] = max[2];
+            float32x4_t high = vld1q_f32(lanes);
+            for (size_t i = 0; i + 1 < count; i++)
+            {
+                float32x4_t position = vld1q_f32(GetVertex(positions, stride, i));
+                low = vminq_f32(low, position);
+                high = vmaxq_f32(high, position);
+            }
+
+            vst1q_f32(lanes, low);
+            std::memcpy(min, lanes, 3 * sizeof(float));
+            vst1q_f32(lanes, high);
+            std::memcpy(max, lanes, 3 * sizeof(float));
+            ScalarPositionBounds(GetVertex(positions, stride, count - 1), stride, 1, min, max);
+        }
+
+        static const KernelTable neonTable = {
+            "neon",
+            NeonWidenU8ToU16,
+            NeonWidenU16ToU32,
+            NeonNarrowU32ToU16,
+            NeonInterleaveFloats,
+            NeonInterleaveJointsU8,
+            NeonBlendVec4,
+            NeonMultiplyHierarchy,
+            NeonSkinVertices,
+            NeonDecodeByteDeltas,
+            NeonPositionBounds
+        };
+#else
+        static void ScalarBlendVec4(const float *keys, const float *weights, float *dst, size_t count)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                const float *key = keys + i * 16;
+                const float *weight = weights + i * 4;
+                for (size_t c = 0; c < 4; c++)
+                    dst[i * 4 + c] = weight[0] * key[c] + weight[1] * key[4 + c] + weight[2] * key[8 + c] + weight[3] * key[12 + c];
+            }
+        }
+
+        static void ScalarMultiplyHierarchy(const float *locals, const int *parents, float *worlds, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                const float *local = locals + i * 16;
+                float *world = worlds + i * 16;
+                if (parents[i] < 0)
+                {
+                    std::memcpy(world, local, 16 * sizeof(float));
+                    continue;
+                }
+
+                const float *parent = worlds + parents[i] * 16;
+                for (size_t c = 0; c < 4; c++)
+                {
+                    for (size_t r = 0; r < 4; r++)
+                        world[c * 4 + r] = parent[r] * local[c * 4] + parent[4 + r] * local[c * 4 + 1] + parent[8 + r] * local[c * 4 + 2] + parent[12 + r] * local[c * 4 + 3];
+                }
+            }
+        }
+
+        static void ScalarDecodeByteDeltas(const uint8_t *deltas, size_t deltaStride, uint8_t *vertices, size_t vertexSize, size_t count, uint8_t *last)
+        {
+            for (size_t k = 0; k < vertexSize; k++)
+            {
+                uint8_t previous = last[k];
+                for (size_t i = 0; i < count; i++)
+                {
+                    uint8_t delta = deltas[k * deltaStride + i];
+                    previous += (delta >> 1) ^ static_cast<uint8_t>(-(delta & 1));
+                    vertices[i * vertexSize + k] = previous;
+                }
+                last[k] = previous;
+            }
+        }
+
+        static const KernelTable scalarTable = {
+            "scalar",
+            ScalarWidenU8ToU16,
+            ScalarWidenU16ToU32,
+            ScalarNarrowU32ToU16,
+            ScalarInterleaveFloats,
+            ScalarInterleaveJointsU8,
+            ScalarBlendVec4,
+            ScalarMultiplyHierarchy,
+            ScalarSkinVertices,
+            ScalarDecodeByteDeltas,
+            ScalarPositionBounds
+        };
+#endif
+
+        static const KernelTable &SelectTable()
+        {
+#if defined(GLB_KERNELS_X86)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2"))
+                return (avx2Table);
+            return (sse2Table);
+#elif defined(GLB_KERNELS_NEON)
+            return (neonTable);
+#else
+            return (scalarTable);
+#endif
+        }
+
+        static const KernelTable &GetTable()
+        {
+            static const KernelTable &table = SelectTable();
+            return (table);
+        }
+
+        const char *GetName()
+        {
+            return (GetTable().name);
+        }
+
+        void WidenU8ToU16(const uint8_t *src, uint16_t *dst, size_t count)
+        {
+            GetTable().widenU8ToU16(src, dst, count);
+        }
+
+        void WidenU16ToU32(const uint16_t *src, uint32_t *dst, size_t count)
+        {
+            GetTable().widenU16ToU32(src, dst, count);
+        }
+
+        void NarrowU32ToU16(const uint32_t *src, uint16_t *dst, size_t count)
+        {
+            GetTable().narrowU32ToU16(src, dst, count);
+        }
+
+        void InterleaveFloats(const unsigned char *src, size_t srcStride, size_t nbFloat, float *dst, size_t dstStride, size_t count)
+        {
+            GetTable().interleaveFloats(src, srcStride, nbFloat, dst, dstStride, count);
+        }
+
+        void InterleaveJointsU8(const unsigned char *src, size_t srcStride, uint16_t *dst, size_t dstStride, size_t count)
+        {
+            GetTable().interleaveJointsU8(src, srcStride, dst, dstStride, count);
+        }
+
+        void BlendVec4(const float *keys, const float *weights, float *dst, size_t count)
+        {
+            GetTable().blendVec4(keys, weights, dst, count);
+        }
+
+        void MultiplyHierarchy(const float *locals, const int *parents, float *worlds, size_t begin, size_t end)
+        {
+            GetTable().multiplyHierarchy(locals, parents, worlds, begin, end);
+        }
+
+        void SkinVertices(const float *palette, const SkinningInput &input, float *positions, float *normals, size_t begin, size_t end)
+        {
+            GetTable().skinVertices(palette, input, positions, normals, begin, end);
+        }
+
+        void DecodeByteDeltas(const uint8_t *deltas, size_t deltaStride, uint8_t *vertices, size_t vertexSize, size_t count, uint8_t *last)
+        {
+            GetTable().decodeByteDeltas(deltas, deltaStride, vertices, vertexSize, count, last);
+        }
+
+        void SkinVerticesScalar(const float *palette, const SkinningInput &input, float *positions, float *normals, size_t begin, size_t end)
+        {
+            ScalarSkinVertices(palette, input, positions, normals, begin, end);
+        }
+
+        void PositionBounds(const float *positions, size_t stride, size_t count, float *min, float *max)
+        {
+            GetTable().positionBounds(positions, stride, count, min, max);
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Glb
+{
+    // bulk conversion kernels used by the decoders, each one has a scalar fallback
+    // and SSE2/AVX2/NEON versions, the best one is picked at runtime on first call
+    namespace Kernels
+    {
+        const char *GetName();
+
+        void WidenU8ToU16(const uint8_t *src, uint16_t *dst, size_t count);
+        void WidenU16ToU32(const uint16_t *src, uint32_t *dst, size_t count);
+        void NarrowU32ToU16(const uint32_t *src, uint16_t *dst, size_t count); // keeps the low 16 bits
+
+        // copies count elements of nbFloat floats (1 to 4) from a strided source into a strided destination,
+        // used to scatter float attributes straight into the Vertex array
+        void InterleaveFloats(const unsigned char *src, size_t srcStride, size_t nbFloat, float *dst, size_t dstStride, size_t count);
+        // same for 4 uint8_t joints widened into 4 uint16_t
+        void InterleaveJointsU8(const unsigned char *src, size_t srcStride, uint16_t *dst, size_t dstStride, size_t count);
+
+        // dst[i] = sum of weights[4i + k] * keys[4i + k] for k in 0..3, keys and dst being float4,
+        // every lerp, slerp and cubic spline of the animation sampling ends up as this weighted sum
+        void BlendVec4(const float *keys, const float *weights, float *dst, size_t count);
+
+        // worlds[i] = worlds[parents[i]] * locals[i] for i in [begin, end), or locals[i] when parents[i] < 0,
+        // matrices are 16 floats column major and every parent comes before its children
+        void MultiplyHierarchy(const float *locals, const int *parents, float *worlds, size_t begin, size_t end);
+
+        // strided vertex streams, stride being the bytes between two vertices of every stream
+        struct SkinningInput
+        {
+            const float *positions; // float3
+            const float *normals; // float3, NULL to only skin the positions
+            const uint16_t *joints; // 4 indices into the palette, already checked
+            const float *weights; // float4
+            size_t stride;
+        };
+
+        // linear blend skinning of vertices [begin, end) with a palette of 16 floats column major matrices,
+        // outputs are tightly packed float3, normals go through the inverse transpose of the blended matrix and are renormalized
+        void SkinVertices(const float *palette, const SkinningInput &input, float *positions, float *normals, size_t begin, size_t end);
+        void SkinVerticesScalar(const float *palette, const SkinningInput &input, float *positions, float *normals, size_t begin, size_t end); // reference for the SIMD versions
+
+        // meshopt vertex codec: deltas[k * deltaStride + i] is the zigzag delta of byte k of vertex i, rows are readable
+        // up to count rounded to 16, vertices[i * vertexSize + k] = last[k] += unzigzag(delta), last ends up as the last vertex
+        void DecodeByteDeltas(const uint8_t *deltas, size_t deltaStride, uint8_t *vertices, size_t vertexSize, size_t count, uint8_t *last);
+
+        // extends min and max (float3) with count float3 positions, stride being the bytes between two positions (at least 12)
+        void PositionBounds(const float *positions, size_t stride, size_t count, float *min, float *max);
+    }
+}
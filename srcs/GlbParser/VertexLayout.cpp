@@ -0,0 +1,215 @@
+#include "GlbParser/VertexLayout.hpp"
+#include "GlbParser/GltfIndex.hpp"
+#include "GlbParser/VertexKernels.hpp"
+#include "GlbParser/LoadStats.hpp"
+#include <stdexcept>
+
+namespace Glb
+{
+    const char *GetAttributeName(VertexAttribute attribute)
+    {
+        switch (attribute)
+        {
+            case VertexAttribute::POSITION:
+                return ("POSITION");
+            case VertexAttribute::NORMAL:
+                return ("NORMAL");
+            case VertexAttribute::TANGENT:
+                return ("TANGENT");
+            case VertexAttribute::TEXCOORD_0:
+                return ("TEXCOORD_0");
+            case VertexAttribute::TEXCOORD_1:
+                return ("TEXCOORD_1");
+            case VertexAttribute::COLOR_0:
+                return ("COLOR_0");
+            case VertexAttribute::JOINTS_0:
+                return ("JOINTS_0");
+            case VertexAttribute::WEIGHTS_0:
+                return ("WEIGHTS_0");
+        }
+        throw(std::runtime_error("vertex attribute unknown: " + std::to_string(static_cast<int>(attribute))));
+    }
+
+    size_t AttributeNbComponent(VertexAttribute attribute)
+    {
+        switch (attribute)
+        {
+            case VertexAttribute::TEXCOORD_0:
+            case VertexAttribute::TEXCOORD_1:
+                return (2);
+            case VertexAttribute::POSITION:
+            case VertexAttribute::NORMAL:
+                return (3);
+            case VertexAttribute::TANGENT:
+            case VertexAttribute::COLOR_0:
+            case VertexAttribute::JOINTS_0:
+            case VertexAttribute::WEIGHTS_0:
+                return (4);
+        }
+        throw(std::runtime_error("vertex attribute unknown: " + std::to_string(static_cast<int>(attribute))));
+    }
+
+    size_t AttributeSize(VertexAttribute attribute)
+    {
+        if (attribute == VertexAttribute::JOINTS_0)
+            return (AttributeNbComponent(attribute) * sizeof(uint16_t));
+        return (AttributeNbComponent(attribute) * sizeof(float));
+    }
+
+    VertexLayout::VertexLayout()
+    {
+        attributes = {VertexAttribute::POSITION, VertexAttribute::TEXCOORD_0, VertexAttribute::NORMAL};
+        interleaved = true;
+    }
+
+    VertexLayout::VertexLayout(std::initializer_list<VertexAttribute> attributes, bool interleaved)
+    {
+        this->attributes = attributes;
+        this->interleaved = interleaved;
+    }
+
+    size_t VertexLayout::GetStride() const
+    {
+        size_t stride = 0;
+        for (VertexAttribute attribute: attributes)
+            stride += AttributeSize(attribute);
+        return (stride);
+    }
+
+    size_t VertexLayout::GetOffset(VertexAttribute attribute) const
+    {
+        size_t offset = 0;
+        for (VertexAttribute current: attributes)
+        {
+            if (current == attribute)
+                return (offset);
+            offset += AttributeSize(current);
+        }
+        throw(std::runtime_error(std::string("vertex layout has no ") + GetAttributeName(attribute)));
+    }
+
+    bool VertexLayout::Contains(VertexAttribute attribute) const
+    {
+        for (VertexAttribute current: attributes)
+        {
+            if (current == attribute)
+                return (true);
+        }
+        return (false);
+    }
+
+    unsigned char *VertexBuffer::GetAttribute(VertexAttribute attribute, size_t &stride)
+    {
+        return (const_cast<unsigned char*>(static_cast<const VertexBuffer*>(this)->GetAttribute(attribute, stride)));
+    }
+
+    const unsigned char *VertexBuffer::GetAttribute(VertexAttribute attribute, size_t &stride) const
+    {
+        if (!layout.Contains(attribute) || count == 0)
+            return (NULL);
+
+        if (layout.interleaved)
+        {
+            stride = layout.GetStride();
+            return (streams[0].data() + layout.GetOffset(attribute));
+        }
+
+        for (size_t i = 0; i < layout.attributes.size(); i++)
+        {
+            if (layout.attributes[i] == attribute)
+            {
+                stride = AttributeSize(attribute);
+                return (streams[i].data());
+            }
+        }
+        return (NULL);
+    }
+
+    void DecodeAttribute(const Accessor &accessor, float *dst, size_t dstStride)
+    {
+        if (accessor.data && accessor.componentType == ComponentType::FLOAT && accessor.nbComponent <= 4)
+            Kernels::InterleaveFloats(accessor.data, accessor.byteStride, accessor.nbComponent, dst, dstStride, accessor.count);
+        else
+            AccessorView<float>(accessor).CopyTo(dst, dstStride);
+    }
+
+    void DecodeAttribute(const Accessor &accessor, uint16_t *dst, size_t dstStride)
+    {
+        if (accessor.data && accessor.componentType == ComponentType::UNSIGNED_BYTE && accessor.nbComponent == 4)
+            Kernels::InterleaveJointsU8(accessor.data, accessor.byteStride, dst, dstStride, accessor.count);
+        else
+            AccessorView<uint16_t>(accessor).CopyTo(dst, dstStride);
+    }
+
+    static void FillAttribute(unsigned char *dst, size_t stride, size_t count, size_t nbComponent, size_t firstComponent, float value)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            float *element = reinterpret_cast<float*>(dst + i * stride);
+            for (size_t c = firstComponent; c < nbComponent; c++)
+                element[c] = value;
+        }
+    }
+
+    static void LoadAttribute(VertexBuffer &buffer, const std::map<std::string, Accessor> &accessors, VertexAttribute attribute)
+    {
+        size_t stride;
+        unsigned char *dst = buffer.GetAttribute(attribute, stride);
+        size_t nbComponent = AttributeNbComponent(attribute);
+        std::string name = GetAttributeName(attribute);
+
+        auto it = accessors.find(name);
+        if (it == accessors.end())
+        {
+            // streams start zeroed
+            if (attribute == VertexAttribute::COLOR_0)
+                FillAttribute(dst, stride, buffer.count, nbComponent, 0, 1.0f);
+            return;
+        }
+
+        const Accessor &accessor = it->second;
+        if (accessor.count != buffer.count)
+            throw(std::runtime_error(name + " has " + std::to_string(accessor.count) + " elements instead of " + std::to_string(buffer.count)));
+
+        // COLOR_0 can be VEC3, alpha is then 1
+        bool rgbColor = attribute == VertexAttribute::COLOR_0 && accessor.nbComponent == 3;
+        if (accessor.nbComponent != nbComponent && !rgbColor)
+            throw(std::runtime_error(name + " has " + std::to_string(accessor.nbComponent) + " components instead of " + std::to_string(nbComponent)));
+
+        if (attribute == VertexAttribute::JOINTS_0)
+            DecodeAttribute(accessor, reinterpret_cast<uint16_t*>(dst), stride);
+        else
+            DecodeAttribute(accessor, reinterpret_cast<float*>(dst), stride);
+
+        if (rgbColor)
+            FillAttribute(dst, stride, buffer.count, nbComponent, 3, 1.0f);
+    }
+
+    VertexBuffer DecodeVertexBuffer(const std::map<std::string, Accessor> &resolvedAccessors, const VertexLayout &layout)
+    {
+        LoadedBufferViews views;
+        const std::map<std::string, Accessor> &accessors = views.Load(resolvedAccessors);
+        auto position = accessors.find("POSITION");
+        if (position == accessors.end())
+            throw(std::runtime_error("primitive without POSITION attribute"));
+
+        VertexBuffer buffer;
+        buffer.layout = layout;
+        buffer.count = position->second.count;
+        StageTimer timer(LoadStage::VERTEX_INTERLEAVE, buffer.count * layout.GetStride());
+        if (layout.interleaved)
+            buffer.streams.emplace_back(buffer.count * layout.GetStride());
+        else
+        {
+            for (VertexAttribute attribute: layout.attributes)
+                buffer.streams.emplace_back(buffer.count * AttributeSize(attribute));
+        }
+        if (buffer.count == 0)
+            return (buffer);
+
+        for (VertexAttribute attribute: layout.attributes)
+            LoadAttribute(buffer, accessors, attribute);
+
+        return (buffer);
+    }
+}
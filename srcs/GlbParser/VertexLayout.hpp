@@ -0,0 +1,61 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <initializer_list>
+#include "GlbParser/Accessor.hpp"
+
+namespace Glb
+{
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#meshes-overview
+    // output formats: POSITION, NORMAL float3, TANGENT, COLOR_0, WEIGHTS_0 float4, TEXCOORD_n float2, JOINTS_0 uint16x4
+    enum class VertexAttribute
+    {
+        POSITION,
+        NORMAL,
+        TANGENT,
+        TEXCOORD_0,
+        TEXCOORD_1,
+        COLOR_0,
+        JOINTS_0,
+        WEIGHTS_0
+    };
+
+    const char *GetAttributeName(VertexAttribute attribute);
+    size_t AttributeNbComponent(VertexAttribute attribute);
+    size_t AttributeSize(VertexAttribute attribute); // bytes of one element in the output
+
+    // which attributes to emit and how: interleaved gives one packed stream in the attributes order,
+    // otherwise each attribute gets its own tightly packed stream (structure of arrays)
+    struct VertexLayout
+    {
+        std::vector<VertexAttribute> attributes;
+        bool interleaved;
+
+        VertexLayout();
+        VertexLayout(std::initializer_list<VertexAttribute> attributes, bool interleaved = true);
+
+        size_t GetStride() const; // bytes between two vertices of the interleaved stream
+        size_t GetOffset(VertexAttribute attribute) const; // offset inside an interleaved vertex
+        bool Contains(VertexAttribute attribute) const;
+    };
+
+    struct VertexBuffer
+    {
+        VertexLayout layout;
+        size_t count;
+        std::vector<std::vector<unsigned char>> streams; // one when interleaved, else one per layout attribute
+
+        // first element of the attribute and bytes between two elements, NULL if the layout doesn't have it
+        unsigned char *GetAttribute(VertexAttribute attribute, size_t &stride);
+        const unsigned char *GetAttribute(VertexAttribute attribute, size_t &stride) const;
+    };
+
+    // decode one accessor into a strided destination, with the SIMD kernels when the formats allow it
+    void DecodeAttribute(const Accessor &accessor, float *dst, size_t dstStride);
+    void DecodeAttribute(const Accessor &accessor, uint16_t *dst, size_t dstStride);
+
+    // attributes missing from the primitive are filled with zeros, except COLOR_0 which is white
+    VertexBuffer DecodeVertexBuffer(const std::map<std::string, Accessor> &accessors, const VertexLayout &layout);
+}
@@ -0,0 +1,123 @@
+#include "Test.hpp"
+#include "GlbParser/GltfIndex.hpp"
+
+// one bufferView over the whole BIN chunk and one accessor in it
+static Glb::GltfIndex MakeIndex(size_t binSize, Glb::AccessorType type, Glb::ComponentType componentType, size_t count, size_t byteOffset = 0)
+{
+    Glb::GltfIndex index;
+    Glb::BufferViewInfo bufferView = Glb::BufferViewInfo();
+    bufferView.byteLength = binSize;
+    index.bufferViews.push_back(bufferView);
+
+    Glb::AccessorInfo accessor = Glb::AccessorInfo();
+    accessor.byteOffset = byteOffset;
+    accessor.count = count;
+    accessor.componentType = componentType;
+    accessor.type = type;
+    index.accessors.push_back(accessor);
+    return (index);
+}
+
+static std::vector<float> ReadAccessor(const std::string &bin, Glb::AccessorType type, Glb::ComponentType componentType, size_t count)
+{
+    Glb::GltfIndex index = MakeIndex(bin.size(), type, componentType, count);
+    Glb::GlbView glb;
+    glb.bin = bin;
+    return (Glb::AccessorView<float>(Glb::ResolveAccessor(index, glb, 0)).ToVector());
+}
+
+TEST(AccessorMat3BytesColumnsArePadded)
+{
+    // each column of 3 bytes starts on a 4 bytes boundary, 0xee is the padding
+    std::string bin;
+    for (int element = 0; element < 2; element++)
+    {
+        for (int column = 0; column < 3; column++)
+        {
+            for (int row = 0; row < 3; row++)
+                bin.push_back(static_cast<char>(element * 10 + column * 3 + row + 1));
+            bin.push_back('\xee');
+        }
+    }
+    std::vector<float> expected;
+    for (int element = 0; element < 2; element++)
+    {
+        for (int i = 1; i <= 9; i++)
+            expected.push_back(element * 10 + i);
+    }
+    CHECK(ReadAccessor(bin, Glb::AccessorType::MAT3, Glb::ComponentType::UNSIGNED_BYTE, 2) == expected);
+
+    // the 24 bytes aren't enough for 3 elements
+    CHECK_THROWS(ReadAccessor(bin, Glb::AccessorType::MAT3, Glb::ComponentType::UNSIGNED_BYTE, 3));
+}
+
+TEST(AccessorPaddedMatrixLayouts)
+{
+    // MAT3 of shorts: 6 bytes columns padded to 8
+    std::string bin;
+    for (int column = 0; column < 3; column++)
+    {
+        for (int16_t row = 0; row < 3; row++)
+        {
+            int16_t value = -(column * 3 + row);
+            bin.append(reinterpret_cast<const char*>(&value), 2);
+        }
+        bin.append(2, '\x7f');
+    }
+    CHECK(ReadAccessor(bin, Glb::AccessorType::MAT3, Glb::ComponentType::SHORT, 1) == std::vector<float>({0, -1, -2, -3, -4, -5, -6, -7, -8}));
+
+    // MAT2 of bytes: 2 bytes columns padded to 4, MAT2 of shorts and MAT4 of bytes aren't padded
+    CHECK(ReadAccessor(std::string("\x01\x02\xee\xee\x03\x04\xee\xee", 8), Glb::AccessorType::MAT2, Glb::ComponentType::BYTE, 1) == std::vector<float>({1, 2, 3, 4}));
+    CHECK(ReadAccessor(std::string("\x01\x00\x02\x00\x03\x00\x04\x00", 8), Glb::AccessorType::MAT2, Glb::ComponentType::UNSIGNED_SHORT, 1) == std::vector<float>({1, 2, 3, 4}));
+    CHECK(Glb::ColumnStride(Glb::AccessorType::MAT4, Glb::ComponentType::UNSIGNED_BYTE) == 4);
+    CHECK(Glb::ColumnStride(Glb::AccessorType::VEC3, Glb::ComponentType::UNSIGNED_BYTE) == 3);
+}
+
+TEST(AccessorRangeOverflow)
+{
+    // values whose products wrap around would pass an unchecked range test
+    std::string bin(64, '\0');
+    Glb::GlbView glb;
+    glb.bin = bin;
+    size_t huge = std::numeric_limits<size_t>::max();
+    CHECK_THROWS(Glb::ResolveAccessor(MakeIndex(bin.size(), Glb::AccessorType::VEC4, Glb::ComponentType::FLOAT, huge / 8 + 2), glb, 0));
+    CHECK_THROWS(Glb::ResolveAccessor(MakeIndex(bin.size(), Glb::AccessorType::SCALAR, Glb::ComponentType::FLOAT, 1, huge - 2), glb, 0));
+    CHECK_THROWS(Glb::ResolveAccessor(MakeIndex(bin.size(), Glb::AccessorType::SCALAR, Glb::ComponentType::FLOAT, 2, 60), glb, 0));
+    Glb::ResolveAccessor(MakeIndex(bin.size(), Glb::AccessorType::SCALAR, Glb::ComponentType::FLOAT, 1, 60), glb, 0);
+
+    Glb::GltfIndex index = MakeIndex(bin.size(), Glb::AccessorType::SCALAR, Glb::ComponentType::FLOAT, 1);
+    index.bufferViews[0].byteOffset = 8;
+    index.bufferViews[0].byteLength = huge - 4;
+    CHECK_THROWS(Glb::ResolveAccessor(index, glb, 0));
+}
+
+TEST(AccessorCompressedRangeOverflow)
+{
+    std::string bin(64, '\0');
+    Glb::GlbView glb;
+    glb.bin = bin;
+    size_t huge = std::numeric_limits<size_t>::max();
+    Glb::GltfIndex index = MakeIndex(16, Glb::AccessorType::SCALAR, Glb::ComponentType::FLOAT, 4);
+    index.bufferViews[0].buffer = 1;
+    index.bufferViews[0].compressed = true;
+    index.bufferViews[0].compression.byteStride = 4;
+    index.bufferViews[0].compression.count = 4;
+
+    // offset plus length wraps around
+    index.bufferViews[0].compression.byteOffset = huge - 2;
+    index.bufferViews[0].compression.byteLength = 16;
+    CHECK_THROWS(Glb::ResolveAccessor(index, glb, 0));
+
+    // count * byteStride wraps around to the byteLength
+    index.bufferViews[0].compression.byteOffset = 0;
+    index.bufferViews[0].compression.count = huge / 4 + 5;
+    CHECK_THROWS(Glb::ResolveAccessor(index, glb, 0));
+
+    // checked but not decoded, the bytes aren't valid meshopt data
+    index.bufferViews[0].compression.count = 4;
+    Glb::Accessor accessor = Glb::ResolveAccessor(index, glb, 0);
+    CHECK(accessor.compressed && !accessor.data);
+    CHECK_THROWS(Glb::AccessorView<float>(accessor).ToVector());
+    Glb::LoadedBufferViews views;
+    CHECK_THROWS(views.Load(accessor));
+}
@@ -0,0 +1,54 @@
+#include "Test.hpp"
+#include "TestGlb.hpp"
+#include "GlbParser/AssetCache.hpp"
+#include <memory>
+
+TEST(AssetCacheSharesRenamedParts)
+{
+    Bench::SyntheticGlbOptions options;
+    options.nbMesh = 2;
+    options.nbVertex = 100;
+    options.nbNode = 4;
+    options.nbJoint = 2;
+    options.nbAnimation = 1;
+    options.nbKeyframe = 4;
+    std::string first = Bench::GenerateSyntheticGlb(options);
+    std::string renamed = Test::ReplaceInJson(Test::ReplaceInJson(first, "\"mesh0\"", "\"rock\""), "\"skin0\"", "\"rig\"");
+
+    Glb::AssetCache cache;
+    std::unique_ptr<Glb::SharedGltf> a = std::make_unique<Glb::SharedGltf>(Glb::LoadSharedGltf(Glb::ParseGlbView(first), cache));
+    Glb::SharedGltf b = Glb::LoadSharedGltf(Glb::ParseGlbView(renamed), cache);
+
+    // the names aren't part of the content, the second asset only hits
+    CHECK(cache.GetStats().nbHit == options.nbMesh + 1 + options.nbAnimation);
+    CHECK(a->meshes[0] == b.meshes[0] && a->skins[0] == b.skins[0]);
+    CHECK(b.meshes[0]->name.empty() && b.skins[0]->name.empty());
+
+    // each asset keeps its own names, valid once the other one is gone
+    CHECK(a->meshNames[0] == "mesh0" && a->skinNames[0] == "skin0");
+    a.reset();
+    CHECK(b.meshNames.size() == options.nbMesh && b.meshNames[0] == "rock" && b.meshNames[1] == "mesh1");
+    CHECK(b.skinNames[0] == "rig" && b.animationNames[0] == "animation0");
+}
+
+TEST(ContentKeyComparesLengthAndKind)
+{
+    Glb::ContentKey key = Glb::ContentKeyBuilder(Glb::ContentKind::MESH).Finish();
+    Glb::ContentKey other = key;
+    CHECK(other == key);
+    other.sourceBytes++;
+    CHECK(other != key);
+    other = key;
+    other.kind = Glb::ContentKind::SKIN;
+    CHECK(other != key);
+
+    // the same bytes seen as an image or a mesh are different parts
+    const unsigned char bytes[] = {1, 2, 3, 4};
+    Glb::ContentKeyBuilder image(Glb::ContentKind::IMAGE);
+    Glb::ContentKeyBuilder mesh(Glb::ContentKind::MESH);
+    image.AddSpan(bytes, sizeof(bytes));
+    mesh.AddSpan(bytes, sizeof(bytes));
+    Glb::ContentKey imageKey = image.Finish();
+    CHECK(imageKey.sourceBytes == sizeof(bytes));
+    CHECK(imageKey != mesh.Finish());
+}
@@ -0,0 +1,43 @@
+#include "Test.hpp"
+#include "TestGlb.hpp"
+#include "GlbParser/BatchLoader.hpp"
+#include <mutex>
+
+TEST(LoadManyMalformedFileCarriesItsError)
+{
+    Bench::SyntheticGlbOptions options;
+    options.nbMesh = 2;
+    options.nbVertex = 100;
+    options.nbNode = 8;
+    std::string bytes = Bench::GenerateSyntheticGlb(options);
+
+    // the scenes and nodes are parsed before the mesh accessors fail to resolve
+    std::vector<std::string> paths;
+    paths.push_back(Test::WriteTemporaryFile("batch0.glb", bytes));
+    paths.push_back(Test::WriteTemporaryFile("batch1.glb", Test::ReplaceInJson(bytes, "\"POSITION\":0", "\"POSITION\":99999")));
+    paths.push_back(Test::WriteTemporaryFile("batch2.glb", bytes));
+    paths.push_back(Test::WriteTemporaryFile("batch3.glb", "not a glb"));
+
+    std::mutex mutex;
+    std::vector<Glb::LoadedAsset> assets(paths.size());
+    Glb::LoadManyOptions loadOptions;
+    loadOptions.nbDecodeThread = 2;
+    Glb::LoadManyStats stats = Glb::LoadMany(paths, [&](Glb::LoadedAsset &asset)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        assets[asset.index] = std::move(asset);
+    }, loadOptions);
+
+    CHECK(stats.nbFile == 4);
+    CHECK(stats.nbFailed == 2);
+    CHECK(!assets[0].error);
+    CHECK(!assets[2].error);
+    CHECK(assets[1].error);
+    CHECK(assets[3].error);
+    CHECK(assets[1].data.nodes.empty());
+    CHECK_THROWS(std::rethrow_exception(assets[1].error));
+
+    Glb::GltfData expected = Test::LoadGltfBytes(bytes);
+    Test::CheckSameData(assets[0].data, expected);
+    Test::CheckSameData(assets[2].data, expected);
+}
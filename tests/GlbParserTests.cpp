@@ -0,0 +1,32 @@
+#include "Test.hpp"
+#include "TestGlb.hpp"
+
+static std::string MakeSkinnedAsset()
+{
+    Bench::SyntheticGlbOptions options;
+    options.nbVertex = 100;
+    options.nbNode = 4;
+    options.nbJoint = 4;
+    return (Bench::GenerateSyntheticGlb(options));
+}
+
+TEST(DecodeSkinReadsMat4)
+{
+    Glb::GltfData data = Test::LoadGltfBytes(MakeSkinnedAsset());
+    CHECK(data.skins.size() == 1);
+    CHECK(data.skins[0].joints.size() == 4);
+    for (const Glb::Joint &joint: data.skins[0].joints)
+    {
+        CHECK(joint.inverseBindMatrix[0][0] == 1 && joint.inverseBindMatrix[3][3] == 1);
+        CHECK(joint.inverseBindMatrix[3][0] == 0 && joint.inverseBindMatrix[0][3] != 0);
+    }
+}
+
+TEST(DecodeSkinRejectsOtherTypes)
+{
+    // same count and bytes, only the type of the accessor changes
+    std::string bytes = MakeSkinnedAsset();
+    CHECK_THROWS(Test::LoadGltfBytes(Test::ReplaceInJson(bytes, "\"MAT4\"", "\"VEC4\"")));
+    CHECK_THROWS(Test::LoadGltfBytes(Test::ReplaceInJson(bytes, "\"MAT4\"", "\"SCALAR\"")));
+    CHECK_THROWS(Test::LoadGltfBytes(Test::ReplaceInJson(bytes, "\"MAT4\"", "\"MAT3\"")));
+}
@@ -0,0 +1,131 @@
+#include "Test.hpp"
+#include "TestGlb.hpp"
+#include "GlbParser/GlbWriter.hpp"
+#include <cmath>
+#include <fstream>
+#include <iterator>
+
+static Bench::SyntheticGlbOptions RoundTripOptions(bool interleaved)
+{
+    Bench::SyntheticGlbOptions options;
+    options.nbMesh = 3;
+    options.nbVertex = 70000; // 32 bits indices for the big meshes
+    options.nbNode = 40;
+    options.nbJoint = 16;
+    options.nbAnimation = 2;
+    options.nbKeyframe = 12;
+    options.interleaved = interleaved;
+    return (options);
+}
+
+TEST(GlbWriterRoundTrip)
+{
+    for (bool interleaved: {true, false})
+    {
+        Bench::SyntheticGlbOptions options = RoundTripOptions(interleaved);
+        Glb::GltfData data = Test::LoadGltfBytes(Bench::GenerateSyntheticGlb(options));
+        CHECK(data.meshes.size() == 3 && data.skins.size() == 1 && data.animations.size() == 2);
+
+        std::vector<unsigned char> serialized = Glb::SerializeGlb(data);
+        std::string bytes(serialized.begin(), serialized.end());
+        Test::CheckSameData(Test::LoadGltfBytes(bytes), data);
+
+        // written again, the same bytes
+        std::vector<unsigned char> again = Glb::SerializeGlb(Test::LoadGltfBytes(bytes));
+        CHECK(again == serialized);
+    }
+}
+
+TEST(GlbWriterFileMatchesSerialize)
+{
+    Glb::GltfData data = Test::LoadGltfBytes(Bench::GenerateSyntheticGlb(RoundTripOptions(true)));
+    std::string path = Test::WriteTemporaryFile("written.glb", "");
+    size_t size = Glb::WriteGlb(data, path);
+
+    std::ifstream file(path, std::ios::binary);
+    std::vector<unsigned char> written((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    CHECK(written.size() == size);
+    CHECK(written == Glb::SerializeGlb(data));
+}
+
+TEST(GlbWriterNodeTrs)
+{
+    Bench::SyntheticGlbOptions options;
+    options.nbVertex = 16;
+    options.nbNode = 2;
+    std::string bytes = Bench::GenerateSyntheticGlb(options);
+    bytes = Test::ReplaceInJson(bytes, "\"name\":\"node1\",", "\"name\":\"node1\",\"rotation\":[0.2,-0.4,0.1,0.8888194417],\"scale\":[2,0.5,3],");
+    Glb::GltfData data = Test::LoadGltfBytes(bytes);
+    CHECK(data.nodes[1].transform[0][1] != 0); // rotated
+
+    std::vector<unsigned char> serialized = Glb::SerializeGlb(data);
+    Glb::GltfData loaded = Test::LoadGltfBytes(std::string(serialized.begin(), serialized.end()));
+    CHECK(loaded.nodes.size() == data.nodes.size());
+    for (size_t i = 0; i < data.nodes.size(); i++)
+    {
+        const float *expected = &data.nodes[i].transform[0][0];
+        const float *transform = &loaded.nodes[i].transform[0][0];
+        for (size_t j = 0; j < 16; j++)
+            CHECK(std::fabs(expected[j] - transform[j]) < 1e-5f);
+    }
+}
+
+TEST(GlbWriterTextures)
+{
+    Bench::SyntheticGlbOptions options;
+    options.nbVertex = 16;
+    options.nbNode = 2;
+    Glb::GltfData data = Test::LoadGltfBytes(Bench::GenerateSyntheticGlb(options));
+
+    // only the signatures matter to the writer
+    std::string png("\x89PNG\r\n\x1A\n\0\0\0\0", 12);
+    std::string jpeg("\xFF\xD8\xFF\xE0\0\0\0\0", 8);
+    Glb::Image image;
+    image.name = "png";
+    image.buffer = reinterpret_cast<unsigned char*>(png.data());
+    image.bufferLength = png.size();
+    data.images.push_back(image);
+    image.name = "jpeg";
+    image.buffer = reinterpret_cast<unsigned char*>(jpeg.data());
+    image.bufferLength = jpeg.size();
+    data.images.push_back(image);
+
+    // textures don't follow the images: two use the jpeg, one has no source
+    data.textures.resize(4);
+    data.textures[0].source = 1;
+    data.textures[1].source = 0;
+    data.textures[2].source = 1;
+    data.materials[0].pbr.baseColorTexture = 2;
+    data.materials[0].normalTexture = 1;
+    data.materials[0].emissiveTexture = 3;
+
+    std::vector<unsigned char> serialized = Glb::SerializeGlb(data);
+    Glb::GltfData loaded = Test::LoadGltfBytes(std::string(serialized.begin(), serialized.end()));
+    CHECK(loaded.images.size() == 2 && loaded.images[1].name == "jpeg");
+    CHECK(loaded.textures.size() == 4);
+    for (size_t i = 0; i < data.textures.size(); i++)
+        CHECK(loaded.textures[i].source == data.textures[i].source);
+    CHECK(loaded.materials[0].pbr.baseColorTexture == 2 && loaded.materials[0].normalTexture == 1);
+    CHECK(loaded.materials[0].emissiveTexture == 3 && loaded.materials[0].occlusionTexture == -1);
+
+    // out of range indices would write an invalid file
+    data.materials[0].occlusionTexture = 4;
+    CHECK_THROWS(Glb::SerializeGlb(data));
+    data.materials[0].occlusionTexture = -1;
+    data.textures[3].source = 2;
+    CHECK_THROWS(Glb::SerializeGlb(data));
+}
+
+TEST(GlbWriterWithoutRootScene)
+{
+    Bench::SyntheticGlbOptions options;
+    options.nbVertex = 16;
+    options.nbNode = 2;
+    Glb::GltfData data = Test::LoadGltfBytes(Bench::GenerateSyntheticGlb(options));
+    data.rootScene = -1;
+
+    std::vector<unsigned char> serialized = Glb::SerializeGlb(data);
+    Glb::GlbView view = Glb::ParseGlbView(std::string_view(reinterpret_cast<const char*>(serialized.data()), serialized.size()));
+    CHECK(view.json.find("\"scene\"") == std::string_view::npos);
+    CHECK(view.json.find("\"scenes\"") != std::string_view::npos);
+}
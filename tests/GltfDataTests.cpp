@@ -0,0 +1,57 @@
+#include "Test.hpp"
+#include "TestGlb.hpp"
+
+static std::string MakeAsset(uint32_t seed)
+{
+    Bench::SyntheticGlbOptions options;
+    options.nbMesh = 3;
+    options.nbVertex = 200;
+    options.nbNode = 24;
+    options.nbJoint = 8;
+    options.nbAnimation = 1;
+    options.nbKeyframe = 10;
+    options.seed = seed;
+    return (Bench::GenerateSyntheticGlb(options));
+}
+
+TEST(GltfDataMoveAssignOverLoaded)
+{
+    std::string first = MakeAsset(1);
+    std::string second = MakeAsset(2);
+
+    Glb::GltfData data = Test::LoadGltfBytes(first);
+    data = Test::LoadGltfBytes(second);
+    Test::CheckSameData(data, Test::LoadGltfBytes(second));
+}
+
+TEST(GltfDataCopyAssignBetweenLoaded)
+{
+    std::string first = MakeAsset(1);
+    std::string second = MakeAsset(2);
+
+    Glb::GltfData a = Test::LoadGltfBytes(first);
+    Glb::GltfData expected = Test::LoadGltfBytes(second);
+    {
+        Glb::GltfData b = Test::LoadGltfBytes(second);
+        a = b;
+        Test::CheckSameData(a, b);
+    }
+    // b and its last owner gone, the names live on in the shared arena
+    Test::CheckSameData(a, expected);
+
+    const Glb::GltfData &self = a;
+    a = self;
+    Test::CheckSameData(a, expected);
+}
+
+TEST(GltfDataResetLoaded)
+{
+    std::string bytes = MakeAsset(1);
+    Glb::GltfData data = Test::LoadGltfBytes(bytes);
+    CHECK(!data.nodes.empty());
+
+    data = Glb::GltfData();
+    CHECK(data.scenes.empty());
+    CHECK(data.nodes.empty());
+    CHECK(data.meshes.empty());
+}
@@ -0,0 +1,37 @@
+#include "Test.hpp"
+#include "TestGlb.hpp"
+#include "GlbParser/GltfReload.hpp"
+
+TEST(ReloadGltfKeepsUnchangedParts)
+{
+    Bench::SyntheticGlbOptions options;
+    options.nbMesh = 4;
+    options.nbVertex = 200;
+    options.nbNode = 16;
+    options.nbJoint = 4;
+    options.nbAnimation = 1;
+    options.nbKeyframe = 8;
+    std::string first = Bench::GenerateSyntheticGlb(options);
+    std::string renamed = Test::ReplaceInJson(first, "\"node3\"", "\"edited\"");
+
+    Glb::ReloadableGltf asset = Glb::LoadReloadableGltf(Glb::ParseGlbView(first));
+    Glb::GltfChangeSet changes = Glb::ReloadGltf(asset, Glb::ParseGlbView(renamed));
+    CHECK(changes.meshes.changed.empty());
+    CHECK(changes.nodes.changed.size() == 1 && changes.nodes.changed[0] == 3);
+    CHECK(changes.decodedBytes == 0);
+    Test::CheckSameData(asset.data, Test::LoadGltfBytes(renamed));
+
+    // a renamed mesh is kept, only its name changes
+    std::string meshRenamed = Test::ReplaceInJson(renamed, "\"mesh1\"", "\"rock\"");
+    changes = Glb::ReloadGltf(asset, Glb::ParseGlbView(meshRenamed));
+    CHECK(changes.meshes.changed.empty() && changes.decodedBytes == 0);
+    CHECK(asset.data.meshes[1].name == "rock");
+    Test::CheckSameData(asset.data, Test::LoadGltfBytes(meshRenamed));
+
+    // every part changes with another seed
+    options.seed = 2;
+    std::string second = Bench::GenerateSyntheticGlb(options);
+    changes = Glb::ReloadGltf(asset, Glb::ParseGlbView(second));
+    CHECK(changes.meshes.changed.size() == options.nbMesh);
+    Test::CheckSameData(asset.data, Test::LoadGltfBytes(second));
+}
@@ -0,0 +1,272 @@
+#include "Test.hpp"
+#include "TestPng.hpp"
+#include "GlbParser/ImageDecoder.hpp"
+
+static std::vector<uint8_t> Decode(const std::string &png, uint32_t &width, uint32_t &height)
+{
+    std::vector<uint8_t> rgba;
+    Glb::DecodePng(reinterpret_cast<const unsigned char*>(png.data()), png.size(), width, height, rgba);
+    return (rgba);
+}
+
+static void DecodePng(const std::string &png)
+{
+    uint32_t width;
+    uint32_t height;
+    Decode(png, width, height);
+}
+
+// a mix of gradients, which gives long matches, and noise, which gives literals
+static std::vector<uint32_t> MakeSamples(uint32_t width, uint32_t height, size_t nbChannel, uint32_t maxValue)
+{
+    std::vector<uint32_t> samples;
+    uint32_t seed = 12345;
+    for (size_t y = 0; y < height; y++)
+    {
+        for (size_t x = 0; x < width; x++)
+        {
+            for (size_t c = 0; c < nbChannel; c++)
+            {
+                seed = seed * 1103515245 + 12345;
+                uint32_t value = y % 3 == 0 ? (seed >> 8) : static_cast<uint32_t>(x + c * 7);
+                samples.push_back(value % (maxValue + 1));
+            }
+        }
+    }
+    return (samples);
+}
+
+static std::vector<uint8_t> MakePalette()
+{
+    std::vector<uint8_t> palette;
+    for (size_t i = 0; i < 256 * 3; i++)
+        palette.push_back(i * 37 + 11);
+    return (palette);
+}
+
+static bool DecodesAsExpected(uint32_t width, uint32_t height, const Test::PngOptions &options)
+{
+    std::vector<uint32_t> samples = MakeSamples(width, height, Test::GetNbChannel(options.colorType), (1u << options.bitDepth) - 1);
+    uint32_t decodedWidth = 0;
+    uint32_t decodedHeight = 0;
+    std::vector<uint8_t> rgba = Decode(Test::EncodePng(width, height, samples, options), decodedWidth, decodedHeight);
+    return (decodedWidth == width && decodedHeight == height && rgba == Test::ExpectedRgba(width, height, samples, options));
+}
+
+TEST(PngColorTypesAndBitDepths)
+{
+    static const uint8_t colorTypes[5] = {0, 2, 3, 4, 6};
+    static const std::vector<uint8_t> bitDepths[7] = {{1, 2, 4, 8, 16}, {}, {8, 16}, {1, 2, 4, 8}, {8, 16}, {}, {8, 16}};
+    static const Test::DeflateBlock blocks[3] = {Test::DeflateBlock::STORED, Test::DeflateBlock::FIXED, Test::DeflateBlock::DYNAMIC};
+
+    // 13x11 leaves partial Adam7 blocks on both sides, 1x1 and 3x2 have empty passes
+    static const uint32_t sizes[3][2] = {{13, 11}, {1, 1}, {3, 2}};
+    for (uint8_t colorType: colorTypes)
+    {
+        for (uint8_t bitDepth: bitDepths[colorType])
+        {
+            for (bool interlaced: {false, true})
+            {
+                for (Test::DeflateBlock block: blocks)
+                {
+                    Test::PngOptions options;
+                    options.colorType = colorType;
+                    options.bitDepth = bitDepth;
+                    options.interlaced = interlaced;
+                    options.block = block;
+                    if (colorType == 3)
+                        options.palette = MakePalette();
+                    for (const uint32_t *size: sizes)
+                        CHECK(DecodesAsExpected(size[0], size[1], options));
+                }
+            }
+        }
+    }
+}
+
+TEST(PngSeveralBlocks)
+{
+    // one block of each type in turn, with the rows spanning the block boundaries
+    Test::PngOptions options;
+    options.block = Test::DeflateBlock::MIXED;
+    options.maxBlockSize = 333;
+    CHECK(DecodesAsExpected(64, 48, options));
+    options.interlaced = true;
+    CHECK(DecodesAsExpected(64, 48, options));
+
+    // stored blocks are at most 65535 bytes
+    options.block = Test::DeflateBlock::STORED;
+    options.maxBlockSize = 65535;
+    CHECK(DecodesAsExpected(160, 200, options));
+}
+
+TEST(PngTransparency)
+{
+    Test::PngOptions options;
+    options.colorType = 3;
+    options.bitDepth = 4;
+    options.palette = MakePalette();
+    options.palette.resize(16 * 3);
+    options.transparency = {0, 64, 128, 255, 7}; // the entries after it stay opaque
+    CHECK(DecodesAsExpected(13, 11, options));
+
+    // palette entries after PLTE are opaque black
+    options.palette.resize(5 * 3);
+    CHECK(DecodesAsExpected(13, 11, options));
+
+    // the color key is compared before scaling
+    options = Test::PngOptions();
+    options.colorType = 0;
+    options.bitDepth = 2;
+    options.transparency = {0, 1};
+    CHECK(DecodesAsExpected(13, 11, options));
+    options.bitDepth = 16;
+    options.transparency = {0x12, 0x34};
+    CHECK(DecodesAsExpected(13, 11, options));
+
+    options.colorType = 2;
+    options.bitDepth = 8;
+    options.transparency = {0, 3, 0, 10, 0, 17};
+    CHECK(DecodesAsExpected(13, 11, options));
+}
+
+static std::string ReplaceIdat(const Test::PngOptions &options, uint32_t width, uint32_t height, const std::string &zlib)
+{
+    return (Test::PngHeader(width, height, options) + Test::PngChunk("IDAT", zlib) + Test::PngChunk("IEND", ""));
+}
+
+TEST(PngTruncated)
+{
+    Test::PngOptions options;
+    std::vector<uint32_t> samples = MakeSamples(16, 16, 4, 255);
+    for (Test::DeflateBlock block: {Test::DeflateBlock::STORED, Test::DeflateBlock::FIXED, Test::DeflateBlock::DYNAMIC})
+    {
+        options.block = block;
+        std::string png = Test::EncodePng(16, 16, samples, options);
+        for (size_t length = 0; length < png.size() - 12; length++)
+            CHECK_THROWS(DecodePng(png.substr(0, length)));
+
+        // a whole file with a stream that stops early
+        std::string zlib = Test::ZlibCompress(Test::FilterScanlines(16, 16, samples, options), block, 1000);
+        for (size_t length = 0; length + 4 < zlib.size(); length++)
+            CHECK_THROWS(DecodePng(ReplaceIdat(options, 16, 16, zlib.substr(0, length))));
+    }
+}
+
+TEST(PngCorruptDeflate)
+{
+    Test::PngOptions options;
+    std::vector<uint8_t> scanlines = Test::FilterScanlines(4, 4, MakeSamples(4, 4, 4, 255), options);
+    std::string stored = Test::ZlibCompress(scanlines, Test::DeflateBlock::STORED, 1000);
+    DecodePng(ReplaceIdat(options, 4, 4, stored));
+
+    std::string zlib = stored;
+    zlib[0] = 0x79; // not deflate
+    CHECK_THROWS(DecodePng(ReplaceIdat(options, 4, 4, zlib)));
+    zlib = stored;
+    zlib[1] = 0x02; // wrong check bits
+    CHECK_THROWS(DecodePng(ReplaceIdat(options, 4, 4, zlib)));
+    zlib = stored;
+    zlib[1] = 0x20; // preset dictionary, with valid check bits
+    CHECK_THROWS(DecodePng(ReplaceIdat(options, 4, 4, zlib)));
+
+    zlib = stored;
+    zlib[5] ^= 1; // NLEN isn't the complement of LEN
+    CHECK_THROWS(DecodePng(ReplaceIdat(options, 4, 4, zlib)));
+
+    zlib = stored;
+    zlib[2] = 0x07; // block type 3
+    CHECK_THROWS(DecodePng(ReplaceIdat(options, 4, 4, zlib)));
+
+    // a stream holding one byte less or more than the scanlines
+    std::vector<uint8_t> shorter(scanlines.begin(), scanlines.end() - 1);
+    CHECK_THROWS(DecodePng(ReplaceIdat(options, 4, 4, Test::ZlibCompress(shorter, Test::DeflateBlock::FIXED, 1000))));
+    std::vector<uint8_t> longer = scanlines;
+    longer.push_back(0);
+    CHECK_THROWS(DecodePng(ReplaceIdat(options, 4, 4, Test::ZlibCompress(longer, Test::DeflateBlock::DYNAMIC, 1000))));
+
+    // fixed block: literal 0 (00110000), then length 3 (0000001) at distance 2 (00001), before the start
+    std::string before = "\x78\x01";
+    before += std::string("\x63\x00\x42\x00", 4);
+    CHECK_THROWS(DecodePng(ReplaceIdat(options, 4, 4, before)));
+
+    // dynamic block whose code length code has five 1 bit codes
+    std::string oversubscribed = "\x78\x01";
+    oversubscribed += std::string("\x05\x20\x92\x24\x00\x00\x00\x00", 8);
+    CHECK_THROWS(DecodePng(ReplaceIdat(options, 4, 4, oversubscribed)));
+}
+
+TEST(PngCorruptFile)
+{
+    Test::PngOptions options;
+    std::vector<uint32_t> samples = MakeSamples(4, 4, 4, 255);
+    std::vector<uint8_t> scanlines = Test::FilterScanlines(4, 4, samples, options);
+    std::string png = Test::EncodePng(4, 4, samples, options);
+
+    std::string corrupt = png;
+    corrupt[1] = 'Q'; // signature
+    CHECK_THROWS(DecodePng(corrupt));
+
+    // IHDR: width, height, bit depth, color type, then compression, filter and interlace methods
+    for (size_t offset: {16, 20, 24, 25, 26, 27, 28})
+    {
+        corrupt = png;
+        corrupt[offset] = offset < 24 ? 0 : 9;
+        if (offset < 24)
+            corrupt[offset + 3] = 0;
+        CHECK_THROWS(DecodePng(corrupt));
+    }
+    corrupt = png;
+    corrupt[24] = 4; // valid depth, but not for RGBA
+    CHECK_THROWS(DecodePng(corrupt));
+    corrupt = png;
+    corrupt[11] = 12; // IHDR length
+    CHECK_THROWS(DecodePng(corrupt));
+
+    // no IHDR first, an unknown critical chunk, and no IEND
+    std::string signature = png.substr(0, 8);
+    CHECK_THROWS(DecodePng(signature + Test::PngChunk("IDAT", "") + png.substr(8)));
+    std::string ancillary = png.substr(0, 33) + Test::PngChunk("abCD", "xyz") + png.substr(33);
+    DecodePng(ancillary);
+    CHECK_THROWS(DecodePng(png.substr(0, 33) + Test::PngChunk("ABCD", "xyz") + png.substr(33)));
+    CHECK_THROWS(DecodePng(png.substr(0, png.size() - 12)));
+
+    // no IDAT at all
+    CHECK_THROWS(DecodePng(Test::PngHeader(4, 4, options) + Test::PngChunk("IEND", "")));
+
+    // filter type 5
+    std::vector<uint8_t> filtered = scanlines;
+    filtered[0] = 5;
+    CHECK_THROWS(DecodePng(ReplaceIdat(options, 4, 4, Test::ZlibCompress(filtered, Test::DeflateBlock::FIXED, 1000))));
+
+    // a 30000x30000 image of 20 bytes of data fails before allocating its 3.6 GB
+    CHECK_THROWS(DecodePng(ReplaceIdat(options, 30000, 30000, Test::ZlibCompress(scanlines, Test::DeflateBlock::FIXED, 1000))));
+}
+
+TEST(PngBitFlips)
+{
+    // any corruption throws or decodes something, it never reads out of the buffers
+    Test::PngOptions options;
+    options.block = Test::DeflateBlock::MIXED;
+    options.maxBlockSize = 200;
+    options.interlaced = true;
+    std::string png = Test::EncodePng(20, 20, MakeSamples(20, 20, 4, 255), options);
+    uint32_t seed = 777;
+    for (size_t i = 0; i < 2000; i++)
+    {
+        std::string corrupt = png;
+        for (size_t j = 0; j < 1 + i % 3; j++)
+        {
+            seed = seed * 1103515245 + 12345;
+            size_t bit = (seed >> 4) % ((png.size() - 41) * 8);
+            corrupt[41 + bit / 8] ^= 1 << (bit % 8); // past the signature and IHDR
+        }
+        try
+        {
+            DecodePng(corrupt);
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+    }
+}
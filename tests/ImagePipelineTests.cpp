@@ -0,0 +1,71 @@
+#include "Test.hpp"
+#include "TestPng.hpp"
+#include "GlbParser/ImagePipeline.hpp"
+
+static std::string MakePng(uint32_t color)
+{
+    std::vector<uint32_t> samples;
+    for (size_t i = 0; i < 4 * 4; i++)
+        samples.insert(samples.end(), {color & 0xff, (color >> 8) & 0xff, (color >> 16) & 0xff, 255});
+    Test::PngOptions options;
+    options.block = Test::DeflateBlock::STORED; // every color gives a file of the same size
+    return (Test::EncodePng(4, 4, samples, options));
+}
+
+static Glb::Image MakeImage(const char *name, const std::string &png)
+{
+    Glb::Image image;
+    image.name = name;
+    image.buffer = reinterpret_cast<unsigned char*>(const_cast<char*>(png.data()));
+    image.bufferLength = png.size();
+    return (image);
+}
+
+TEST(ImagePipelineSharesSameBytes)
+{
+    std::string red = MakePng(0x0000ff);
+    std::string redCopy = red;
+    std::string green = MakePng(0x00ff00);
+    CHECK(red.size() == green.size());
+
+    Glb::ThreadPool pool(2);
+    Glb::ImagePipeline pipeline(pool);
+    Glb::ImageFuture first = pipeline.Submit(MakeImage("red", red));
+    Glb::ImageFuture second = pipeline.Submit(MakeImage("red copy", redCopy));
+    Glb::ImageFuture third = pipeline.Submit(MakeImage("green", green));
+    pipeline.Wait();
+    CHECK(first.get() == second.get());
+    CHECK(first.get()->name == "red");
+    CHECK(third.get() != first.get());
+    CHECK(third.get()->levels[0][1] == 255 && first.get()->levels[0][0] == 255);
+
+    // after the decoding too
+    CHECK(pipeline.Submit(MakeImage("red again", red)).get() == first.get());
+}
+
+TEST(ImagePipelineCallbackThrows)
+{
+    Glb::ThreadPool pool(2);
+    Glb::ImagePipeline pipeline(pool);
+    std::atomic<size_t> nbCalled(0);
+    std::vector<std::string> pngs;
+    for (uint32_t i = 0; i < 8; i++)
+        pngs.push_back(MakePng(i));
+    for (const std::string &png: pngs)
+    {
+        pipeline.Submit(MakeImage("image", png), [&](const Glb::ImageFuture &)
+        {
+            nbCalled++;
+            throw(std::runtime_error("callback failed"));
+        });
+    }
+
+    // the worker threads survive, every callback ran and Wait() reports the error once
+    CHECK_THROWS(pipeline.Wait());
+    CHECK(nbCalled == pngs.size());
+    pipeline.Wait();
+
+    // a callback of an image already decoded runs in Submit and throws there
+    CHECK_THROWS(pipeline.Submit(MakeImage("image", pngs[0]), [](const Glb::ImageFuture &) { throw(std::runtime_error("callback failed")); }));
+    pipeline.Wait();
+}
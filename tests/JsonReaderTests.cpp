@@ -0,0 +1,93 @@
+#include "Test.hpp"
+#include "GlbParser/JsonReader.hpp"
+
+// reads every value of json, arrays and objects included
+static void SkipAll(const std::string &json)
+{
+    Glb::JsonReader reader(json);
+    reader.Skip();
+}
+
+TEST(JsonReaderMembers)
+{
+    std::string json = "{\"a\": [1, 2, {\"b\": []}, [], 3], \"c\": {}, \"d\": \"x\"}";
+    Glb::JsonReader reader(json);
+    std::string_view key;
+    std::vector<std::string> keys;
+    reader.BeginObject();
+    while (reader.NextKey(key))
+    {
+        keys.push_back(std::string(key));
+        if (key == "a")
+        {
+            std::vector<int> values;
+            reader.BeginArray();
+            while (reader.NextElement())
+            {
+                if (values.size() == 2 || values.size() == 3)
+                {
+                    reader.Skip();
+                    values.push_back(0);
+                }
+                else
+                    values.push_back(reader.ReadInt());
+            }
+            CHECK((values == std::vector<int>{1, 2, 0, 0, 3}));
+        }
+        else
+            reader.Skip();
+    }
+    CHECK((keys == std::vector<std::string>{"a", "c", "d"}));
+}
+
+TEST(JsonReaderCommas)
+{
+    SkipAll("[1, [2, 3], {\"a\": {}, \"b\": []}, []]");
+    CHECK_THROWS(SkipAll("[1 2]"));
+    CHECK_THROWS(SkipAll("[[] []]"));
+    CHECK_THROWS(SkipAll("{\"a\": 1 \"b\": 2}"));
+    CHECK_THROWS(SkipAll("{\"a\": {} \"b\": 2}"));
+    CHECK_THROWS(SkipAll("[1, 2,]"));
+    CHECK_THROWS(SkipAll("{\"a\": 1,}"));
+    CHECK_THROWS(SkipAll("[, 1]"));
+    CHECK_THROWS(SkipAll("[1,, 2]"));
+}
+
+TEST(JsonReaderDeepNesting)
+{
+    // deep enough to overflow the stack of a recursive Skip
+    size_t depth = 1000000;
+    SkipAll(std::string(depth, '[') + std::string(depth, ']'));
+    std::string objects;
+    for (size_t i = 0; i < depth; i++)
+        objects += "{\"a\":";
+    objects += "1" + std::string(depth, '}');
+    SkipAll(objects);
+    CHECK_THROWS(SkipAll(std::string(depth, '[') + std::string(depth - 1, ']')));
+}
+
+static int ReadInt(const std::string &json)
+{
+    Glb::JsonReader reader(json);
+    return (reader.ReadInt());
+}
+
+static size_t ReadSize(const std::string &json)
+{
+    Glb::JsonReader reader(json);
+    return (reader.ReadSize());
+}
+
+TEST(JsonReaderIntegers)
+{
+    CHECK(ReadInt("-2147483648") == -2147483647 - 1);
+    CHECK(ReadInt("2147483647") == 2147483647);
+    CHECK(ReadInt("1e3") == 1000);
+    CHECK_THROWS(ReadInt("2147483648"));
+    CHECK_THROWS(ReadInt("-1e300"));
+    CHECK_THROWS(ReadInt("1.5"));
+    CHECK(ReadSize("4294967296") == 4294967296ull);
+    CHECK_THROWS(ReadSize("-1"));
+    CHECK_THROWS(ReadSize("1e30"));
+    CHECK_THROWS(ReadSize("0.5"));
+}
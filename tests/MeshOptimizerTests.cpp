@@ -0,0 +1,136 @@
+#include "Test.hpp"
+#include "GlbParser/MeshOptimizer.hpp"
+#include <array>
+#include <algorithm>
+
+static Glb::Vertex MakeVertex(float x, float y, float z)
+{
+    Glb::Vertex vertex = Glb::Vertex();
+    vertex.x = x;
+    vertex.y = y;
+    vertex.z = z;
+    vertex.ny = 1;
+    vertex.w1 = 1;
+    return (vertex);
+}
+
+// size x size vertices, 2 triangles per cell, the triangles in a random order when shuffled
+static Glb::Primitive MakeGrid(uint32_t size, bool shuffled)
+{
+    Glb::Primitive primitive;
+    for (uint32_t y = 0; y < size; y++)
+    {
+        for (uint32_t x = 0; x < size; x++)
+            primitive.vertices.push_back(MakeVertex(x, 0, y));
+    }
+
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (uint32_t y = 0; y + 1 < size; y++)
+    {
+        for (uint32_t x = 0; x + 1 < size; x++)
+        {
+            uint32_t i = y * size + x;
+            triangles.push_back({i, i + size, i + 1});
+            triangles.push_back({i + 1, i + size, i + size + 1});
+        }
+    }
+    uint32_t seed = 42;
+    for (size_t i = triangles.size() - 1; shuffled && i > 0; i--)
+    {
+        seed = seed * 1664525 + 1013904223;
+        std::swap(triangles[i], triangles[(seed >> 8) % (i + 1)]);
+    }
+
+    std::vector<uint32_t> indices;
+    for (const std::array<uint32_t, 3> &triangle: triangles)
+        indices.insert(indices.end(), triangle.begin(), triangle.end());
+    primitive.indices.Assign(indices, primitive.vertices.size());
+    return (primitive);
+}
+
+// every triangle as its positions, rotated to start with the smallest one so the winding is kept, then sorted
+static std::vector<std::array<float, 9>> GetTriangles(const Glb::Primitive &primitive)
+{
+    std::vector<uint32_t> indices = primitive.indices.ToUint32();
+    std::vector<std::array<float, 9>> triangles;
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        std::array<std::array<float, 3>, 3> corners;
+        for (size_t k = 0; k < 3; k++)
+        {
+            const Glb::Vertex &vertex = primitive.vertices[indices[i + k]];
+            corners[k] = {vertex.x, vertex.y, vertex.z};
+        }
+        size_t first = std::min_element(corners.begin(), corners.end()) - corners.begin();
+        std::array<float, 9> triangle;
+        for (size_t k = 0; k < 3; k++)
+            std::copy(corners[(first + k) % 3].begin(), corners[(first + k) % 3].end(), triangle.begin() + k * 3);
+        triangles.push_back(triangle);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return (triangles);
+}
+
+TEST(MeshOptimizerKeepsTriangles)
+{
+    for (bool shuffled: {false, true})
+    {
+        Glb::Primitive primitive = MakeGrid(48, shuffled);
+        std::vector<std::array<float, 9>> before = GetTriangles(primitive);
+        Glb::MeshOptimizationStats stats = Glb::OptimizePrimitive(primitive);
+
+        CHECK(GetTriangles(primitive) == before);
+        CHECK(stats.nbVertexBefore == 48 * 48 && stats.nbVertexAfter == 48 * 48);
+        CHECK(stats.acmrAfter <= stats.acmrBefore);
+        CHECK(stats.acmrAfter == Glb::ComputeAcmr(primitive.indices.ToUint32(), 16));
+        // a grid can go down to about 0.5, the shuffled order is close to the 3 of no reuse
+        CHECK(stats.acmrAfter < 0.8f);
+        if (shuffled)
+            CHECK(stats.acmrBefore > 2.0f);
+    }
+}
+
+TEST(MeshOptimizerDeduplicates)
+{
+    // every triangle gets its own 3 vertices, only the grid ones remain
+    Glb::Primitive grid = MakeGrid(16, true);
+    std::vector<std::array<float, 9>> before = GetTriangles(grid);
+    Glb::Primitive primitive;
+    for (uint32_t index: grid.indices.ToUint32())
+        primitive.vertices.push_back(grid.vertices[index]);
+
+    Glb::MeshOptimizationStats stats = Glb::OptimizePrimitive(primitive);
+    CHECK(stats.nbVertexBefore == before.size() * 3);
+    CHECK(stats.nbVertexAfter == 16 * 16);
+    CHECK(GetTriangles(primitive) == before);
+    CHECK(primitive.indices.componentType == Glb::ComponentType::UNSIGNED_BYTE); // 256 vertices now
+}
+
+TEST(MeshOptimizerAcmr)
+{
+    CHECK(Glb::ComputeAcmr({0, 1, 2}, 16) == 3);
+    CHECK(Glb::ComputeAcmr({0, 1, 2, 2, 1, 3}, 16) == 2);
+    // 0 is out of a FIFO of 3 when it comes back
+    CHECK(Glb::ComputeAcmr({0, 1, 2, 3, 4, 0}, 3) == 3);
+    CHECK(Glb::ComputeAcmr({0, 1, 2, 3, 4, 0}, 16) == 2.5f);
+    CHECK(Glb::ComputeAtvr({0, 1, 2, 2, 1, 3}, 4, 16) == 1);
+}
+
+TEST(MeshOptimizerOverdraw)
+{
+    // two quads facing +z, the near one drawn first hides the far one, drawn last it shades every pixel again
+    std::vector<Glb::Vertex> vertices;
+    for (float z: {1.0f, 0.0f})
+    {
+        vertices.push_back(MakeVertex(0, 0, z));
+        vertices.push_back(MakeVertex(1, 0, z));
+        vertices.push_back(MakeVertex(0, 1, z));
+        vertices.push_back(MakeVertex(1, 1, z));
+    }
+    std::vector<uint32_t> nearFirst = {0, 1, 2, 2, 1, 3, 4, 5, 6, 6, 5, 7};
+    std::vector<uint32_t> farFirst = {4, 5, 6, 6, 5, 7, 0, 1, 2, 2, 1, 3};
+    float single = Glb::ComputeOverdraw(vertices, std::vector<uint32_t>(nearFirst.begin(), nearFirst.begin() + 6));
+    CHECK(single == 1);
+    CHECK(Glb::ComputeOverdraw(vertices, nearFirst) == 1);
+    CHECK(Glb::ComputeOverdraw(vertices, farFirst) > 1.9f);
+}
@@ -0,0 +1,125 @@
+#include "Test.hpp"
+#include "TestGlb.hpp"
+#include "GlbParser/MeshoptDecoder.hpp"
+#include "GlbParser/GltfDocument.hpp"
+#include "GlbParser/LoadStats.hpp"
+
+// version 1 stream: header, one code per triangle, the explicit aux bytes, then the 16 bytes aux table
+static std::vector<uint32_t> DecodeTriangles(const std::vector<unsigned char> &codes, const std::vector<unsigned char> &data, const std::vector<unsigned char> &table, size_t nbIndex)
+{
+    std::vector<unsigned char> src(1, 0xe1);
+    src.insert(src.end(), codes.begin(), codes.end());
+    src.insert(src.end(), data.begin(), data.end());
+    src.insert(src.end(), table.begin(), table.end());
+    src.resize(1 + codes.size() + data.size() + 16, 0);
+
+    std::vector<uint32_t> indices(nbIndex);
+    Glb::DecodeMeshoptTriangles(reinterpret_cast<unsigned char*>(indices.data()), nbIndex, 4, src.data(), src.size());
+    return (indices);
+}
+
+TEST(MeshoptTrianglesAuxTable)
+{
+    // 0xfe with an aux byte of 0 restarts the numbering with 3 new vertices, table entry 0 gives 3 new
+    // vertices too, so the vertex FIFO ends up full. Entry 1 reuses the last vertex and the one 15 before,
+    // which must not be pushed again: entry 2 then finds the FIFO as if it was never read
+    std::vector<unsigned char> codes = {0xfe, 0xf0, 0xf0, 0xf0, 0xf0, 0xf0, 0xf1, 0xf2};
+    std::vector<unsigned char> table = {0x00, 0x1f, 0x12};
+    std::vector<uint32_t> indices = DecodeTriangles(codes, {0x00}, table, codes.size() * 3);
+
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i < 18; i++)
+        expected.push_back(i);
+    expected.insert(expected.end(), {18, 17, 3, 19, 18, 17});
+    CHECK(indices == expected);
+}
+
+TEST(MeshoptTrianglesExplicitFreeIndices)
+{
+    // 0xff: the first vertex is a free index, and an aux nibble of 15 makes the second one a free index too,
+    // both pushed into the FIFO; the next triangle reuses them through the default-like table entry 0x12
+    std::vector<unsigned char> codes = {0xfe, 0xff, 0xf0};
+    std::vector<unsigned char> data = {0x00, 0xf1, 20, 2};
+    std::vector<unsigned char> table = {0x12};
+    std::vector<uint32_t> indices = DecodeTriangles(codes, data, table, codes.size() * 3);
+
+    // zigzag: 20 is +10, then 2 is +1 from the previous free index; c is the last vertex of the FIFO before them
+    std::vector<uint32_t> expected = {0, 1, 2, 10, 11, 2, 3, 11, 10};
+    CHECK(indices == expected);
+}
+
+TEST(MeshoptTrianglesTruncated)
+{
+    std::vector<unsigned char> src = {0xe1, 0xfe};
+    std::vector<uint32_t> indices(3);
+    CHECK_THROWS(Glb::DecodeMeshoptTriangles(reinterpret_cast<unsigned char*>(indices.data()), 3, 4, src.data(), src.size()));
+}
+
+static Bench::SyntheticGlbOptions CompressedOptions(bool interleaved)
+{
+    Bench::SyntheticGlbOptions options;
+    options.nbMesh = 2;
+    options.nbVertex = 700; // 3 blocks of the vertex codec in the interleaved case
+    options.nbNode = 3;
+    options.nbJoint = 2;
+    options.interleaved = interleaved;
+    options.meshopt = true;
+    return (options);
+}
+
+TEST(MeshoptFileMatchesUncompressed)
+{
+    for (bool interleaved: {true, false})
+    {
+        Bench::SyntheticGlbOptions options = CompressedOptions(interleaved);
+        std::string compressed = Bench::GenerateSyntheticGlb(options);
+        options.meshopt = false;
+        std::string plain = Bench::GenerateSyntheticGlb(options);
+        CHECK(compressed.size() < plain.size());
+        Test::CheckSameData(Test::LoadGltfBytes(compressed), Test::LoadGltfBytes(plain));
+
+        // the workers decode the bufferViews of their primitives concurrently
+        Glb::ThreadPool pool(4);
+        Test::CheckSameData(Glb::LoadGltf(Glb::ParseGlbView(compressed), pool), Test::LoadGltfBytes(plain));
+    }
+}
+
+TEST(MeshoptDecodedOnFirstRead)
+{
+    std::string bytes = Bench::GenerateSyntheticGlb(CompressedOptions(false));
+    Glb::LoadStats stats;
+    Glb::SetLoadStats(&stats);
+    Glb::GltfData data;
+    Glb::GltfSources sources = Glb::LoadGltfSources(Glb::ParseGlbView(bytes), data);
+    size_t nbDecodeAfterParse = stats.Get(Glb::LoadStage::MESHOPT_DECODE).count;
+    Glb::Mesh mesh = Glb::DecodeMesh(sources.meshes[0]);
+    size_t nbDecodeAfterMesh = stats.Get(Glb::LoadStage::MESHOPT_DECODE).count;
+    Glb::DecodeMesh(sources.meshes[0]);
+    Glb::SetLoadStats(NULL);
+
+    // 5 attributes and the indices, decoded once and then read from the cache
+    CHECK(nbDecodeAfterParse == 0);
+    CHECK(nbDecodeAfterMesh == 6);
+    CHECK(stats.Get(Glb::LoadStage::MESHOPT_DECODE).count == 6);
+    CHECK(sources.decodedViews->GetResidentBytes() == mesh.primitives[0].vertices.size() * (12 + 12 + 8 + 8 + 16) + mesh.primitives[0].indices.data.size());
+}
+
+TEST(MeshoptDocumentEvictsDecodedViews)
+{
+    Glb::GltfDocument document(Test::WriteTemporaryFile("meshopt.glb", Bench::GenerateSyntheticGlb(CompressedOptions(true))));
+    CHECK(document.GetResidentBytes() == 0);
+
+    std::shared_ptr<const Glb::Mesh> mesh = document.GetMesh(0);
+    const Glb::Primitive &primitive = mesh->primitives[0];
+    size_t oneMesh = document.GetResidentBytes();
+    CHECK(oneMesh > primitive.vertices.size() * sizeof(Glb::Vertex) + primitive.indices.data.size());
+
+    // both meshes have the same sizes, evicting one drops its copy and its decoded views
+    document.GetMesh(1);
+    CHECK(document.GetResidentBytes() == 2 * oneMesh);
+    document.Evict(0);
+    CHECK(document.GetResidentBytes() == oneMesh);
+    CHECK(document.GetMesh(0)->primitives[0].vertices.size() == primitive.vertices.size());
+    document.EvictAll();
+    CHECK(document.GetResidentBytes() == 0);
+}
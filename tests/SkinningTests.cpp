@@ -0,0 +1,116 @@
+#include "Test.hpp"
+#include "GlbParser/Skinning.hpp"
+#include "GlbParser/VertexKernels.hpp"
+#include <cmath>
+
+// one vertex at (1, 1, 0) on the plane x = y, weighted 1 on joint 0
+static Glb::Primitive MakeVertexOnDiagonal()
+{
+    Glb::Vertex vertex = Glb::Vertex();
+    vertex.x = 1;
+    vertex.y = 1;
+    vertex.nx = 1 / std::sqrt(2.0f);
+    vertex.ny = -1 / std::sqrt(2.0f);
+    vertex.w1 = 1;
+
+    Glb::Primitive primitive;
+    primitive.vertices.push_back(vertex);
+    return (primitive);
+}
+
+static std::vector<float> MakeScale(float x, float y, float z)
+{
+    std::vector<float> palette(16, 0.0f);
+    palette[0] = x;
+    palette[5] = y;
+    palette[10] = z;
+    palette[15] = 1;
+    return (palette);
+}
+
+static bool IsNear(const float *value, float x, float y, float z)
+{
+    return (std::fabs(value[0] - x) < 1e-5f && std::fabs(value[1] - y) < 1e-5f && std::fabs(value[2] - z) < 1e-5f);
+}
+
+TEST(SkinNormalNonUniformScale)
+{
+    // scaling x by 2 turns the plane x = y into x = 2 y, whose normal is (1, -2, 0) and not the scaled (2, -1, 0)
+    Glb::Primitive primitive = MakeVertexOnDiagonal();
+    std::vector<float> palette = MakeScale(2, 1, 1);
+    float position[3];
+    float normal[3];
+    Glb::SkinPrimitive(primitive, palette.data(), 1, position, normal);
+
+    CHECK(IsNear(position, 2, 1, 0));
+    CHECK(IsNear(normal, 1 / std::sqrt(5.0f), -2 / std::sqrt(5.0f), 0));
+    CHECK(std::fabs(normal[0] * 2 + normal[1] * 1) < 1e-5f); // perpendicular to the skinned plane direction (2, 1, 0)
+}
+
+TEST(SkinNormalMirroredJoint)
+{
+    // a negative scale flips the plane to x = -y, the normal follows it instead of being flipped inward
+    Glb::Primitive primitive = MakeVertexOnDiagonal();
+    std::vector<float> palette = MakeScale(-1, 1, 1);
+    float position[3];
+    float normal[3];
+    Glb::SkinPrimitive(primitive, palette.data(), 1, position, normal);
+
+    CHECK(IsNear(position, -1, 1, 0));
+    CHECK(IsNear(normal, -1 / std::sqrt(2.0f), -1 / std::sqrt(2.0f), 0));
+}
+
+TEST(SkinNormalBlendedJoints)
+{
+    // the kernels of the machine and the scalar reference agree on blends of sheared and scaled joints
+    std::vector<float> palette(3 * 16, 0.0f);
+    for (size_t j = 0; j < 3; j++)
+    {
+        float *matrix = palette.data() + j * 16;
+        matrix[0] = 1 + j;
+        matrix[5] = 2 - 0.5f * j;
+        matrix[10] = 0.5f + j;
+        matrix[4] = 0.25f * j; // shear of x by y
+        matrix[12] = static_cast<float>(j);
+        matrix[15] = 1;
+    }
+
+    Glb::Primitive primitive;
+    for (size_t i = 0; i < 37; i++)
+    {
+        Glb::Vertex vertex = Glb::Vertex();
+        vertex.x = std::sin(i * 0.7f);
+        vertex.y = std::cos(i * 1.3f);
+        vertex.z = i * 0.1f;
+        vertex.nx = std::cos(i * 0.7f);
+        vertex.ny = std::sin(i * 1.3f);
+        vertex.nz = 0.5f;
+        vertex.j1 = i % 3;
+        vertex.j2 = (i + 1) % 3;
+        vertex.w1 = 0.75f;
+        vertex.w2 = 0.25f;
+        primitive.vertices.push_back(vertex);
+    }
+
+    size_t nbVertex = primitive.vertices.size();
+    std::vector<float> positions(nbVertex * 3);
+    std::vector<float> normals(nbVertex * 3);
+    Glb::SkinPrimitive(primitive, palette.data(), 3, positions.data(), normals.data());
+
+    Glb::Kernels::SkinningInput input;
+    input.positions = &primitive.vertices[0].x;
+    input.normals = &primitive.vertices[0].nx;
+    input.joints = &primitive.vertices[0].j1;
+    input.weights = &primitive.vertices[0].w1;
+    input.stride = sizeof(Glb::Vertex);
+    std::vector<float> referencePositions(nbVertex * 3);
+    std::vector<float> referenceNormals(nbVertex * 3);
+    Glb::Kernels::SkinVerticesScalar(palette.data(), input, referencePositions.data(), referenceNormals.data(), 0, nbVertex);
+
+    for (size_t i = 0; i < nbVertex; i++)
+    {
+        const float *reference = referenceNormals.data() + i * 3;
+        CHECK(IsNear(positions.data() + i * 3, referencePositions[i * 3], referencePositions[i * 3 + 1], referencePositions[i * 3 + 2]));
+        CHECK(IsNear(normals.data() + i * 3, reference[0], reference[1], reference[2]));
+    }
+}
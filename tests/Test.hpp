@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+namespace Test
+{
+    struct TestCase
+    {
+        const char *name;
+        void (*function)();
+    };
+
+    std::vector<TestCase> &GetTests(); // in registration order, which is the link order of the files
+
+    struct Registration
+    {
+        Registration(const char *name, void (*function)()) { GetTests().push_back({name, function}); }
+    };
+
+    struct Failure: public std::runtime_error
+    {
+        Failure(const char *file, int line, const std::string &message): std::runtime_error(std::string(file) + ":" + std::to_string(line) + ": " + message) {}
+    };
+}
+
+#define TEST(name) \
+    static void name(); \
+    static Test::Registration name##Registration(#name, name); \
+    static void name()
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+            throw(Test::Failure(__FILE__, __LINE__, "CHECK(" #condition ")")); \
+    } while (0)
+
+// the expression must throw a std::exception, anything else or nothing fails the test
+#define CHECK_THROWS(expression) \
+    do \
+    { \
+        bool thrown = false; \
+        try \
+        { \
+            expression; \
+        } \
+        catch (const std::exception &) \
+        { \
+            thrown = true; \
+        } \
+        if (!thrown) \
+            throw(Test::Failure(__FILE__, __LINE__, "CHECK_THROWS(" #expression ") did not throw")); \
+    } while (0)
@@ -0,0 +1,139 @@
+#include "TestGlb.hpp"
+#include "Test.hpp"
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+
+namespace Test
+{
+    std::string PackGlb(const std::string &json, const std::string &bin)
+    {
+        std::string jsonChunk = json;
+        std::string binChunk = bin;
+        jsonChunk.resize((jsonChunk.size() + 3) & ~size_t(3), ' ');
+        binChunk.resize((binChunk.size() + 3) & ~size_t(3), '\0');
+
+        uint32_t header[5] = {Glb::glbMagic, Glb::glbVersion, uint32_t(12 + 8 + jsonChunk.size() + 8 + binChunk.size()), uint32_t(jsonChunk.size()), Glb::chunkTypeJson};
+        uint32_t binHeader[2] = {uint32_t(binChunk.size()), Glb::chunkTypeBin};
+
+        std::string glb(reinterpret_cast<const char*>(header), sizeof(header));
+        glb += jsonChunk;
+        glb.append(reinterpret_cast<const char*>(binHeader), sizeof(binHeader));
+        glb += binChunk;
+        return (glb);
+    }
+
+    std::string ReplaceInJson(const std::string &glb, const std::string &from, const std::string &to)
+    {
+        Glb::GlbView view = Glb::ParseGlbView(glb);
+        std::string json(view.json);
+        size_t position = json.find(from);
+        if (position == std::string::npos)
+            throw(std::runtime_error("no " + from + " in the JSON chunk"));
+        json.replace(position, from.size(), to);
+        return (PackGlb(json, std::string(view.bin)));
+    }
+
+    std::string WriteTemporaryFile(const std::string &name, const std::string &bytes)
+    {
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "GlbTests";
+        std::filesystem::create_directories(directory);
+        std::string path = (directory / name).string();
+
+        std::ofstream file(path, std::ios::binary);
+        file.write(bytes.data(), bytes.size());
+        if (!file)
+            throw(std::runtime_error("failed to write " + path));
+        return (path);
+    }
+
+    Glb::GltfData LoadGltfBytes(const std::string &glb)
+    {
+        return (Glb::LoadGltf(Glb::ParseGlbView(glb)));
+    }
+
+    static bool SameMatrix(const ml::mat4 &a, const ml::mat4 &b)
+    {
+        return (std::memcmp(&a, &b, sizeof(ml::mat4)) == 0);
+    }
+
+    void CheckSameData(const Glb::GltfData &a, const Glb::GltfData &b)
+    {
+        CHECK(a.rootScene == b.rootScene);
+        CHECK(a.scenes.size() == b.scenes.size());
+        for (size_t i = 0; i < a.scenes.size(); i++)
+        {
+            CHECK(a.scenes[i].name == b.scenes[i].name);
+            CHECK(std::equal(a.scenes[i].nodes.begin(), a.scenes[i].nodes.end(), b.scenes[i].nodes.begin(), b.scenes[i].nodes.end()));
+        }
+
+        CHECK(a.nodes.size() == b.nodes.size());
+        for (size_t i = 0; i < a.nodes.size(); i++)
+        {
+            const Glb::Node &nodeA = a.nodes[i];
+            const Glb::Node &nodeB = b.nodes[i];
+            CHECK(nodeA.name == nodeB.name);
+            CHECK(SameMatrix(nodeA.transform, nodeB.transform));
+            CHECK(std::equal(nodeA.children.begin(), nodeA.children.end(), nodeB.children.begin(), nodeB.children.end()));
+            CHECK(nodeA.mesh == nodeB.mesh);
+            CHECK(nodeA.skin == nodeB.skin);
+        }
+
+        CHECK(a.meshes.size() == b.meshes.size());
+        for (size_t i = 0; i < a.meshes.size(); i++)
+        {
+            CHECK(a.meshes[i].name == b.meshes[i].name);
+            CHECK(a.meshes[i].primitives.size() == b.meshes[i].primitives.size());
+            for (size_t p = 0; p < a.meshes[i].primitives.size(); p++)
+            {
+                const Glb::Primitive &primitiveA = a.meshes[i].primitives[p];
+                const Glb::Primitive &primitiveB = b.meshes[i].primitives[p];
+                CHECK(primitiveA.vertices.size() == primitiveB.vertices.size());
+                CHECK(std::memcmp(primitiveA.vertices.data(), primitiveB.vertices.data(), primitiveA.vertices.size() * sizeof(Glb::Vertex)) == 0);
+                CHECK(primitiveA.indices.componentType == primitiveB.indices.componentType);
+                CHECK(primitiveA.indices.data == primitiveB.indices.data);
+                CHECK(primitiveA.material == primitiveB.material);
+            }
+        }
+
+        CHECK(a.skins.size() == b.skins.size());
+        for (size_t i = 0; i < a.skins.size(); i++)
+        {
+            CHECK(a.skins[i].name == b.skins[i].name);
+            CHECK(a.skins[i].joints.size() == b.skins[i].joints.size());
+            for (size_t j = 0; j < a.skins[i].joints.size(); j++)
+            {
+                CHECK(a.skins[i].joints[j].nodeIndex == b.skins[i].joints[j].nodeIndex);
+                CHECK(SameMatrix(a.skins[i].joints[j].inverseBindMatrix, b.skins[i].joints[j].inverseBindMatrix));
+            }
+        }
+
+        CHECK(a.images.size() == b.images.size());
+        CHECK(a.textures.size() == b.textures.size());
+        for (size_t i = 0; i < a.textures.size(); i++)
+            CHECK(a.textures[i].source == b.textures[i].source);
+
+        CHECK(a.animations.size() == b.animations.size());
+        for (size_t i = 0; i < a.animations.size(); i++)
+        {
+            const Glb::Animation &animationA = a.animations[i];
+            const Glb::Animation &animationB = b.animations[i];
+            CHECK(animationA.name == animationB.name);
+            CHECK(animationA.channels.size() == animationB.channels.size());
+            for (size_t c = 0; c < animationA.channels.size(); c++)
+            {
+                CHECK(animationA.channels[c].sampler == animationB.channels[c].sampler);
+                CHECK(animationA.channels[c].node == animationB.channels[c].node);
+                CHECK(animationA.channels[c].path == animationB.channels[c].path);
+            }
+            CHECK(animationA.samplers.size() == animationB.samplers.size());
+            for (size_t s = 0; s < animationA.samplers.size(); s++)
+            {
+                CHECK(animationA.samplers[s].timecodes == animationB.samplers[s].timecodes);
+                CHECK(animationA.samplers[s].data == animationB.samplers[s].data);
+                CHECK(animationA.samplers[s].nbElement == animationB.samplers[s].nbElement);
+                CHECK(animationA.samplers[s].interpolation == animationB.samplers[s].interpolation);
+            }
+        }
+    }
+}
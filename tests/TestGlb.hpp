@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+#include "SyntheticGlb.hpp"
+#include "GlbParser/GlbParser.hpp"
+
+namespace Test
+{
+    std::string PackGlb(const std::string &json, const std::string &bin); // pads both chunks
+    // the same file with the first occurrence of from replaced in the JSON chunk, throws when there is none
+    std::string ReplaceInJson(const std::string &glb, const std::string &from, const std::string &to);
+    std::string WriteTemporaryFile(const std::string &name, const std::string &bytes); // returns its path
+
+    Glb::GltfData LoadGltfBytes(const std::string &glb); // the images point into glb
+    void CheckSameData(const Glb::GltfData &a, const Glb::GltfData &b); // names, hierarchy, vertices, indices, skins, textures and animations
+}
@@ -0,0 +1,553 @@
+#include "TestPng.hpp"
+#include <queue>
+#include <cstring>
+#include <stdexcept>
+#include <functional>
+
+namespace Test
+{
+    class BitWriter
+    {
+        private:
+            std::string &out;
+            uint32_t buffer;
+            size_t nbBit;
+
+        public:
+            BitWriter(std::string &out): out(out)
+            {
+                buffer = 0;
+                nbBit = 0;
+            }
+
+            void Write(uint32_t value, size_t count) // least significant bit first
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    buffer |= ((value >> i) & 1) << nbBit;
+                    if (++nbBit == 8)
+                        Flush();
+                }
+            }
+
+            void WriteCode(uint32_t code, size_t length) // huffman codes go most significant bit first
+            {
+                for (size_t i = 0; i < length; i++)
+                    Write((code >> (length - 1 - i)) & 1, 1);
+            }
+
+            void Flush()
+            {
+                if (nbBit == 0)
+                    return;
+                out.push_back(static_cast<char>(buffer));
+                buffer = 0;
+                nbBit = 0;
+            }
+    };
+
+    static const uint16_t lengthBases[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const uint8_t lengthExtras[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const uint16_t distanceBases[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static const uint8_t distanceExtras[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    // a literal when length is 0
+    struct Token
+    {
+        uint8_t literal;
+        uint16_t length;
+        uint16_t distance;
+    };
+
+    // greedy matches against the last position of each 3 bytes prefix
+    static std::vector<Token> FindMatches(const uint8_t *data, size_t size)
+    {
+        std::vector<Token> tokens;
+        std::vector<int64_t> lastPositions(1 << 16, -1);
+        size_t i = 0;
+        while (i < size)
+        {
+            size_t bestLength = 0;
+            size_t bestDistance = 0;
+            if (i + 3 <= size)
+            {
+                uint32_t hash = (data[i] * 251u * 251u + data[i + 1] * 251u + data[i + 2]) & 0xffff;
+                int64_t candidate = lastPositions[hash];
+                lastPositions[hash] = i;
+                if (candidate >= 0 && i - candidate <= 32768)
+                {
+                    size_t length = 0;
+                    while (length < 258 && i + length < size && data[candidate + length] == data[i + length])
+                        length++;
+                    if (length >= 3)
+                    {
+                        bestLength = length;
+                        bestDistance = i - candidate;
+                    }
+                }
+            }
+
+            if (bestLength == 0)
+            {
+                tokens.push_back({data[i], 0, 0});
+                i++;
+            }
+            else
+            {
+                tokens.push_back({0, static_cast<uint16_t>(bestLength), static_cast<uint16_t>(bestDistance)});
+                i += bestLength;
+            }
+        }
+        return (tokens);
+    }
+
+    static size_t LengthSymbol(size_t length)
+    {
+        size_t symbol = 28;
+        while (lengthBases[symbol] > length)
+            symbol--;
+        return (symbol);
+    }
+
+    static size_t DistanceSymbol(size_t distance)
+    {
+        size_t symbol = 29;
+        while (distanceBases[symbol] > distance)
+            symbol--;
+        return (symbol);
+    }
+
+    // huffman code lengths up to 15 bits, the frequencies are halved until the tree is shallow enough
+    static std::vector<uint8_t> BuildLengths(std::vector<uint32_t> frequencies)
+    {
+        while (true)
+        {
+            std::vector<uint8_t> lengths(frequencies.size(), 0);
+            typedef std::pair<uint64_t, int> Item; // weight, node
+            std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+            std::vector<int> parents;
+            for (size_t i = 0; i < frequencies.size(); i++)
+            {
+                if (frequencies[i] > 0)
+                {
+                    queue.push({frequencies[i], static_cast<int>(parents.size())});
+                    parents.push_back(-1);
+                }
+            }
+            // a code needs 2 symbols to be complete
+            for (size_t i = 0; queue.size() < 2; i++)
+            {
+                if (frequencies[i] == 0)
+                {
+                    frequencies[i] = 1;
+                    queue.push({1, static_cast<int>(parents.size())});
+                    parents.push_back(-1);
+                }
+            }
+            size_t nbLeaf = parents.size();
+
+            while (queue.size() > 1)
+            {
+                Item a = queue.top();
+                queue.pop();
+                Item b = queue.top();
+                queue.pop();
+                int node = parents.size();
+                parents.push_back(-1);
+                parents[a.second] = node;
+                parents[b.second] = node;
+                queue.push({a.first + b.first, node});
+            }
+
+            bool tooLong = false;
+            size_t leaf = 0;
+            for (size_t i = 0; i < frequencies.size(); i++)
+            {
+                if (frequencies[i] == 0)
+                    continue;
+                size_t depth = 0;
+                for (int node = leaf++; parents[node] >= 0; node = parents[node])
+                    depth++;
+                lengths[i] = depth;
+                tooLong |= depth > 15;
+            }
+            if (!tooLong && leaf == nbLeaf)
+                return (lengths);
+            for (uint32_t &frequency: frequencies)
+                frequency = frequency ? (frequency + 1) / 2 : 0;
+        }
+    }
+
+    static std::vector<uint32_t> CanonicalCodes(const std::vector<uint8_t> &lengths)
+    {
+        uint32_t counts[16] = {};
+        for (uint8_t length: lengths)
+            counts[length]++;
+        counts[0] = 0;
+        uint32_t nextCode[16] = {};
+        uint32_t code = 0;
+        for (size_t length = 1; length < 16; length++)
+        {
+            code = (code + counts[length - 1]) << 1;
+            nextCode[length] = code;
+        }
+        std::vector<uint32_t> codes(lengths.size(), 0);
+        for (size_t i = 0; i < lengths.size(); i++)
+        {
+            if (lengths[i])
+                codes[i] = nextCode[lengths[i]]++;
+        }
+        return (codes);
+    }
+
+    static void WriteTokens(BitWriter &writer, const std::vector<Token> &tokens, const std::vector<uint8_t> &literalLengths, const std::vector<uint8_t> &distanceLengths)
+    {
+        std::vector<uint32_t> literalCodes = CanonicalCodes(literalLengths);
+        std::vector<uint32_t> distanceCodes = CanonicalCodes(distanceLengths);
+        for (const Token &token: tokens)
+        {
+            if (token.length == 0)
+            {
+                writer.WriteCode(literalCodes[token.literal], literalLengths[token.literal]);
+                continue;
+            }
+            size_t length = LengthSymbol(token.length);
+            writer.WriteCode(literalCodes[257 + length], literalLengths[257 + length]);
+            writer.Write(token.length - lengthBases[length], lengthExtras[length]);
+            size_t distance = DistanceSymbol(token.distance);
+            writer.WriteCode(distanceCodes[distance], distanceLengths[distance]);
+            writer.Write(token.distance - distanceBases[distance], distanceExtras[distance]);
+        }
+        writer.WriteCode(literalCodes[256], literalLengths[256]);
+    }
+
+    static void WriteFixedBlock(BitWriter &writer, const std::vector<Token> &tokens)
+    {
+        std::vector<uint8_t> literalLengths(288, 8);
+        std::fill(literalLengths.begin() + 144, literalLengths.begin() + 256, 9);
+        std::fill(literalLengths.begin() + 256, literalLengths.begin() + 280, 7);
+        std::vector<uint8_t> distanceLengths(30, 5);
+        writer.Write(1, 2);
+        WriteTokens(writer, tokens, literalLengths, distanceLengths);
+    }
+
+    static void WriteDynamicBlock(BitWriter &writer, const std::vector<Token> &tokens)
+    {
+        std::vector<uint32_t> literalFrequencies(286, 0);
+        std::vector<uint32_t> distanceFrequencies(30, 0);
+        literalFrequencies[256] = 1;
+        for (const Token &token: tokens)
+        {
+            if (token.length == 0)
+                literalFrequencies[token.literal]++;
+            else
+            {
+                literalFrequencies[257 + LengthSymbol(token.length)]++;
+                distanceFrequencies[DistanceSymbol(token.distance)]++;
+            }
+        }
+        std::vector<uint8_t> literalLengths = BuildLengths(literalFrequencies);
+        std::vector<uint8_t> distanceLengths = BuildLengths(distanceFrequencies);
+
+        size_t nbLiteral = 286;
+        while (nbLiteral > 257 && literalLengths[nbLiteral - 1] == 0)
+            nbLiteral--;
+        size_t nbDistance = 30;
+        while (nbDistance > 1 && distanceLengths[nbDistance - 1] == 0)
+            nbDistance--;
+
+        // code lengths with the 16, 17 and 18 repeats
+        std::vector<uint8_t> all(literalLengths.begin(), literalLengths.begin() + nbLiteral);
+        all.insert(all.end(), distanceLengths.begin(), distanceLengths.begin() + nbDistance);
+        std::vector<std::pair<uint8_t, uint8_t>> symbols; // symbol, extra bits value
+        for (size_t i = 0; i < all.size();)
+        {
+            size_t run = 1;
+            while (i + run < all.size() && all[i + run] == all[i])
+                run++;
+            if (all[i] == 0 && run >= 11)
+            {
+                run = std::min<size_t>(run, 138);
+                symbols.push_back({18, static_cast<uint8_t>(run - 11)});
+            }
+            else if (all[i] == 0 && run >= 3)
+                symbols.push_back({17, static_cast<uint8_t>(run - 3)});
+            else if (i > 0 && all[i] == all[i - 1] && run >= 3)
+            {
+                run = std::min<size_t>(run, 6);
+                symbols.push_back({16, static_cast<uint8_t>(run - 3)});
+            }
+            else
+            {
+                run = 1;
+                symbols.push_back({all[i], 0});
+            }
+            i += run;
+        }
+
+        std::vector<uint32_t> codeLengthFrequencies(19, 0);
+        for (const std::pair<uint8_t, uint8_t> &symbol: symbols)
+            codeLengthFrequencies[symbol.first]++;
+        std::vector<uint8_t> codeLengthLengths = BuildLengths(codeLengthFrequencies);
+        while (true)
+        {
+            bool tooLong = false;
+            for (uint8_t length: codeLengthLengths)
+                tooLong |= length > 7;
+            if (!tooLong)
+                break;
+            for (uint32_t &frequency: codeLengthFrequencies)
+                frequency = frequency ? (frequency + 1) / 2 : 0;
+            codeLengthLengths = BuildLengths(codeLengthFrequencies);
+        }
+        std::vector<uint32_t> codeLengthCodes = CanonicalCodes(codeLengthLengths);
+
+        static const uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+        size_t nbCodeLength = 19;
+        while (nbCodeLength > 4 && codeLengthLengths[order[nbCodeLength - 1]] == 0)
+            nbCodeLength--;
+
+        writer.Write(2, 2);
+        writer.Write(nbLiteral - 257, 5);
+        writer.Write(nbDistance - 1, 5);
+        writer.Write(nbCodeLength - 4, 4);
+        for (size_t i = 0; i < nbCodeLength; i++)
+            writer.Write(codeLengthLengths[order[i]], 3);
+        static const uint8_t repeatBits[3] = {2, 3, 7};
+        for (const std::pair<uint8_t, uint8_t> &symbol: symbols)
+        {
+            writer.WriteCode(codeLengthCodes[symbol.first], codeLengthLengths[symbol.first]);
+            if (symbol.first >= 16)
+                writer.Write(symbol.second, repeatBits[symbol.first - 16]);
+        }
+        WriteTokens(writer, tokens, literalLengths, distanceLengths);
+    }
+
+    std::string ZlibCompress(const std::vector<uint8_t> &data, DeflateBlock block, size_t maxBlockSize)
+    {
+        std::string out = "\x78\x01";
+        BitWriter writer(out);
+        size_t nbBlock = std::max<size_t>(1, (data.size() + maxBlockSize - 1) / maxBlockSize);
+        for (size_t b = 0; b < nbBlock; b++)
+        {
+            size_t begin = b * maxBlockSize;
+            size_t end = std::min(data.size(), begin + maxBlockSize);
+            bool last = b + 1 == nbBlock;
+            DeflateBlock type = block == DeflateBlock::MIXED ? static_cast<DeflateBlock>(b % 3) : block;
+
+            writer.Write(last, 1);
+            if (type == DeflateBlock::STORED)
+            {
+                writer.Write(0, 2);
+                writer.Flush();
+                uint16_t length = end - begin;
+                uint16_t lengths[2] = {length, static_cast<uint16_t>(~length)};
+                out.append(reinterpret_cast<const char*>(lengths), sizeof(lengths));
+                out.append(reinterpret_cast<const char*>(data.data() + begin), end - begin);
+                continue;
+            }
+
+            // the matches stay inside the block, so each block decodes the same whatever the others are
+            std::vector<Token> tokens = FindMatches(data.data() + begin, end - begin);
+            if (type == DeflateBlock::FIXED)
+                WriteFixedBlock(writer, tokens);
+            else
+                WriteDynamicBlock(writer, tokens);
+        }
+        writer.Flush();
+
+        uint32_t a = 1;
+        uint32_t b = 0;
+        for (uint8_t byte: data)
+        {
+            a = (a + byte) % 65521;
+            b = (b + a) % 65521;
+        }
+        uint32_t adler = (b << 16) | a;
+        for (int shift = 24; shift >= 0; shift -= 8)
+            out.push_back(static_cast<char>(adler >> shift));
+        return (out);
+    }
+
+    size_t GetNbChannel(uint8_t colorType)
+    {
+        static const size_t nbChannels[7] = {1, 0, 3, 1, 2, 0, 4};
+        return (nbChannels[colorType]);
+    }
+
+    static uint8_t Paeth(int a, int b, int c)
+    {
+        int p = a + b - c;
+        int pa = std::abs(p - a);
+        int pb = std::abs(p - b);
+        int pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc)
+            return (a);
+        return (pb <= pc ? b : c);
+    }
+
+    std::vector<uint8_t> FilterScanlines(uint32_t width, uint32_t height, const std::vector<uint32_t> &samples, const PngOptions &options)
+    {
+        static const size_t adam7[7][4] = {{0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8}, {2, 0, 4, 4}, {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2}};
+        static const size_t single[1][4] = {{0, 0, 1, 1}};
+        const size_t (*passes)[4] = options.interlaced ? adam7 : single;
+        size_t nbPass = options.interlaced ? 7 : 1;
+        size_t nbChannel = GetNbChannel(options.colorType);
+        size_t pixelSize = std::max<size_t>(1, nbChannel * options.bitDepth / 8);
+
+        std::vector<uint8_t> out;
+        for (size_t pass = 0; pass < nbPass; pass++)
+        {
+            size_t passWidth = width > passes[pass][0] ? (width - passes[pass][0] + passes[pass][2] - 1) / passes[pass][2] : 0;
+            size_t passHeight = height > passes[pass][1] ? (height - passes[pass][1] + passes[pass][3] - 1) / passes[pass][3] : 0;
+            if (passWidth == 0 || passHeight == 0)
+                continue;
+
+            size_t rowSize = (passWidth * nbChannel * options.bitDepth + 7) / 8;
+            std::vector<uint8_t> previous(rowSize, 0);
+            for (size_t y = 0; y < passHeight; y++)
+            {
+                // packed samples, most significant bits first
+                std::vector<uint8_t> row(rowSize, 0);
+                size_t sourceY = passes[pass][1] + y * passes[pass][3];
+                for (size_t x = 0; x < passWidth; x++)
+                {
+                    size_t sourceX = passes[pass][0] + x * passes[pass][2];
+                    for (size_t c = 0; c < nbChannel; c++)
+                    {
+                        uint32_t sample = samples[(sourceY * width + sourceX) * nbChannel + c];
+                        size_t index = x * nbChannel + c;
+                        if (options.bitDepth == 16)
+                        {
+                            row[index * 2] = sample >> 8;
+                            row[index * 2 + 1] = sample & 0xff;
+                        }
+                        else if (options.bitDepth == 8)
+                            row[index] = sample;
+                        else
+                        {
+                            size_t bit = index * options.bitDepth;
+                            row[bit / 8] |= sample << (8 - options.bitDepth - bit % 8);
+                        }
+                    }
+                }
+
+                uint8_t filter = y % 5;
+                out.push_back(filter);
+                for (size_t i = 0; i < rowSize; i++)
+                {
+                    int left = i >= pixelSize ? row[i - pixelSize] : 0;
+                    int upLeft = i >= pixelSize ? previous[i - pixelSize] : 0;
+                    int predictor = 0;
+                    if (filter == 1)
+                        predictor = left;
+                    else if (filter == 2)
+                        predictor = previous[i];
+                    else if (filter == 3)
+                        predictor = (left + previous[i]) / 2;
+                    else if (filter == 4)
+                        predictor = Paeth(left, previous[i], upLeft);
+                    out.push_back(static_cast<uint8_t>(row[i] - predictor));
+                }
+                previous = row;
+            }
+        }
+        return (out);
+    }
+
+    std::string PngChunk(const char *type, const std::string &content)
+    {
+        std::string chunk;
+        for (int shift = 24; shift >= 0; shift -= 8)
+            chunk.push_back(static_cast<char>(content.size() >> shift));
+        chunk.append(type, 4);
+        chunk += content;
+        chunk.append(4, '\0'); // the decoder doesn't check the CRC
+        return (chunk);
+    }
+
+    std::string PngHeader(uint32_t width, uint32_t height, const PngOptions &options)
+    {
+        std::string header("\x89PNG\r\n\x1a\n", 8);
+        std::string ihdr;
+        for (uint32_t value: {width, height})
+        {
+            for (int shift = 24; shift >= 0; shift -= 8)
+                ihdr.push_back(static_cast<char>(value >> shift));
+        }
+        ihdr.push_back(options.bitDepth);
+        ihdr.push_back(options.colorType);
+        ihdr.push_back(0);
+        ihdr.push_back(0);
+        ihdr.push_back(options.interlaced);
+        header += PngChunk("IHDR", ihdr);
+        if (!options.palette.empty())
+            header += PngChunk("PLTE", std::string(options.palette.begin(), options.palette.end()));
+        if (!options.transparency.empty())
+            header += PngChunk("tRNS", std::string(options.transparency.begin(), options.transparency.end()));
+        return (header);
+    }
+
+    std::string EncodePng(uint32_t width, uint32_t height, const std::vector<uint32_t> &samples, const PngOptions &options)
+    {
+        std::string zlib = ZlibCompress(FilterScanlines(width, height, samples, options), options.block, options.maxBlockSize);
+
+        // split over 2 IDAT chunks, which the decoder has to join
+        std::string png = PngHeader(width, height, options);
+        png += PngChunk("IDAT", zlib.substr(0, zlib.size() / 2));
+        png += PngChunk("IDAT", zlib.substr(zlib.size() / 2));
+        png += PngChunk("IEND", "");
+        return (png);
+    }
+
+    std::vector<uint8_t> ExpectedRgba(uint32_t width, uint32_t height, const std::vector<uint32_t> &samples, const PngOptions &options)
+    {
+        size_t nbChannel = GetNbChannel(options.colorType);
+        uint32_t maxValue = (1u << options.bitDepth) - 1;
+        auto scale = [&](uint32_t sample)
+        {
+            return (static_cast<uint8_t>(options.bitDepth == 16 ? sample >> 8 : sample * 255 / maxValue));
+        };
+        auto key = [&](size_t c)
+        {
+            return ((static_cast<uint32_t>(options.transparency[c * 2]) << 8) | options.transparency[c * 2 + 1]);
+        };
+
+        std::vector<uint8_t> rgba;
+        for (size_t i = 0; i < static_cast<size_t>(width) * height; i++)
+        {
+            const uint32_t *pixel = &samples[i * nbChannel];
+            uint8_t out[4] = {0, 0, 0, 255};
+            switch (options.colorType)
+            {
+                case 0:
+                    out[0] = out[1] = out[2] = scale(pixel[0]);
+                    if (!options.transparency.empty() && pixel[0] == key(0))
+                        out[3] = 0;
+                    break;
+                case 2:
+                    for (size_t c = 0; c < 3; c++)
+                        out[c] = scale(pixel[c]);
+                    if (!options.transparency.empty() && pixel[0] == key(0) && pixel[1] == key(1) && pixel[2] == key(2))
+                        out[3] = 0;
+                    break;
+                case 3:
+                    if (pixel[0] * 3 + 2 < options.palette.size())
+                        std::memcpy(out, &options.palette[pixel[0] * 3], 3);
+                    if (pixel[0] < options.transparency.size())
+                        out[3] = options.transparency[pixel[0]];
+                    break;
+                case 4:
+                    out[0] = out[1] = out[2] = scale(pixel[0]);
+                    out[3] = scale(pixel[1]);
+                    break;
+                default:
+                    for (size_t c = 0; c < 4; c++)
+                        out[c] = scale(pixel[c]);
+                    break;
+            }
+            rgba.insert(rgba.end(), out, out + 4);
+        }
+        return (rgba);
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace Test
+{
+    // block types of the deflate streams written by the test encoder, MIXED cycles through the three
+    enum class DeflateBlock
+    {
+        STORED,
+        FIXED,
+        DYNAMIC,
+        MIXED
+    };
+
+    struct PngOptions
+    {
+        uint8_t colorType;
+        uint8_t bitDepth;
+        bool interlaced;
+        DeflateBlock block;
+        size_t maxBlockSize; // bytes of input per deflate block
+        std::vector<uint8_t> palette; // PLTE, RGB triples
+        std::vector<uint8_t> transparency; // tRNS content, written when not empty
+
+        PngOptions()
+        {
+            colorType = 6;
+            bitDepth = 8;
+            interlaced = false;
+            block = DeflateBlock::DYNAMIC;
+            maxBlockSize = 1000;
+        }
+    };
+
+    size_t GetNbChannel(uint8_t colorType);
+
+    // zlib stream of data, with LZ77 matches in the FIXED and DYNAMIC blocks
+    std::string ZlibCompress(const std::vector<uint8_t> &data, DeflateBlock block, size_t maxBlockSize);
+    // the filtered scanlines of every pass, each row using the filter type row % 5
+    std::vector<uint8_t> FilterScanlines(uint32_t width, uint32_t height, const std::vector<uint32_t> &samples, const PngOptions &options);
+    std::string PngChunk(const char *type, const std::string &content);
+    std::string PngHeader(uint32_t width, uint32_t height, const PngOptions &options); // signature and IHDR, then PLTE and tRNS
+    // samples holds the nbChannel values of every pixel, each below 2^bitDepth
+    std::string EncodePng(uint32_t width, uint32_t height, const std::vector<uint32_t> &samples, const PngOptions &options);
+
+    // what the decoder must give for these samples, RGBA8 with 16 bits channels keeping their high byte
+    std::vector<uint8_t> ExpectedRgba(uint32_t width, uint32_t height, const std::vector<uint32_t> &samples, const PngOptions &options);
+}
@@ -0,0 +1,64 @@
+#include "Test.hpp"
+#include "GlbParser/ThreadPool.hpp"
+#include <chrono>
+#include <sys/resource.h>
+
+static double GetCpuSeconds()
+{
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6);
+}
+
+TEST(ThreadPoolParallelFor)
+{
+    Glb::ThreadPool pool(4);
+    std::vector<int> values(10000, 0);
+    pool.ParallelFor(values.size(), [&](size_t i) { values[i] = i * 2; });
+    for (size_t i = 0; i < values.size(); i++)
+        CHECK(values[i] == static_cast<int>(i * 2));
+
+    // from inside a task, and with an exception
+    std::atomic<size_t> sum(0);
+    pool.ParallelFor(8, [&](size_t i)
+    {
+        pool.ParallelFor(100, [&](size_t j) { sum += i * 100 + j; });
+    });
+    CHECK(sum == 800 * 799 / 2);
+    CHECK_THROWS(pool.ParallelFor(100, [](size_t i)
+    {
+        if (i == 50)
+            throw(std::runtime_error("task failed"));
+    }));
+}
+
+TEST(ThreadPoolIdleWorkersSleep)
+{
+    Glb::ThreadPool pool(4);
+    std::atomic<size_t> nbDone(0);
+    size_t nbTask = 0;
+
+    // tasks pushed from outside while the workers steal from each other's queues
+    for (size_t round = 0; round < 50; round++)
+    {
+        std::vector<std::thread> submitters;
+        for (size_t t = 0; t < 2; t++)
+        {
+            submitters.emplace_back([&]()
+            {
+                for (size_t i = 0; i < 200; i++)
+                    pool.Submit([&]() { nbDone++; });
+            });
+        }
+        for (std::thread &submitter: submitters)
+            submitter.join();
+        nbTask += 400;
+        while (nbDone < nbTask)
+            std::this_thread::yield();
+    }
+
+    // a pending task counter gone below zero keeps the idle workers spinning
+    double cpuStart = GetCpuSeconds();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    CHECK(GetCpuSeconds() - cpuStart < 0.05);
+}
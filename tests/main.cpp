@@ -0,0 +1,40 @@
+#include "Test.hpp"
+#include <cstring>
+#include <iostream>
+
+namespace Test
+{
+    std::vector<TestCase> &GetTests()
+    {
+        static std::vector<TestCase> tests;
+        return (tests);
+    }
+}
+
+// GlbTests [filter], runs the tests whose name contains the filter
+int main(int argc, char **argv)
+{
+    const char *filter = argc > 1 ? argv[1] : "";
+    size_t nbRun = 0;
+    size_t nbFailed = 0;
+    for (const Test::TestCase &test: Test::GetTests())
+    {
+        if (!std::strstr(test.name, filter))
+            continue;
+
+        nbRun++;
+        try
+        {
+            test.function();
+            std::cout << "[ OK ] " << test.name << std::endl;
+        }
+        catch (const std::exception &e)
+        {
+            nbFailed++;
+            std::cout << "[FAIL] " << test.name << ": " << e.what() << std::endl;
+        }
+    }
+
+    std::cout << nbRun - nbFailed << "/" << nbRun << " tests passed" << std::endl;
+    return (nbFailed > 0 || nbRun == 0 ? 1 : 0);
+}
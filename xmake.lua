@@ -19,4 +19,27 @@ target("GlbParser")
     add_files("srcs/**.cpp")
     add_deps("Json::Json")
     add_deps("Matrix::Matrix")
-    add_includedirs("srcs", {public = true})
\ No newline at end of file
+    add_includedirs("srcs", {public = true})
+    add_syslinks("pthread", {public = true})
+
+-- xmake build GlbBench && xmake run GlbBench --quick
+target("GlbBench")
+    set_default(false)
+    set_targetdir("./")
+    set_kind("binary")
+    add_files("bench/**.cpp")
+    add_deps("GlbParser")
+    add_deps("Json::Json")
+    add_deps("Matrix::Matrix")
+
+-- xmake build GlbTests && xmake run GlbTests [filter]
+target("GlbTests")
+    set_default(false)
+    set_targetdir("./")
+    set_kind("binary")
+    add_files("tests/**.cpp")
+    add_files("bench/SyntheticGlb.cpp")
+    add_includedirs("bench")
+    add_deps("GlbParser")
+    add_deps("Json::Json")
+    add_deps("Matrix::Matrix")